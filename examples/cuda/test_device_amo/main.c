@@ -0,0 +1,159 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+typedef struct {
+        const char        *name;
+        hb_mc_packet_op_t  op;
+        uint32_t           init;
+        uint32_t           operand;
+        uint32_t           result;
+} amo_case_t;
+
+/* each operation must return init and leave result in memory */
+static const amo_case_t amo_cases[] = {
+        { "amoswap", HB_MC_PACKET_OP_REMOTE_AMOSWAP, 0x12345678, 0xdeadbeef, 0xdeadbeef },
+        { "amoadd",  HB_MC_PACKET_OP_REMOTE_AMOADD,  0xfffffff0, 0x00000020, 0x00000010 },
+        { "amoxor",  HB_MC_PACKET_OP_REMOTE_AMOXOR,  0xff00ff00, 0x0ff00ff0, 0xf0f0f0f0 },
+        { "amoand",  HB_MC_PACKET_OP_REMOTE_AMOAND,  0xff00ff00, 0x0ff00ff0, 0x0f000f00 },
+        { "amoor",   HB_MC_PACKET_OP_REMOTE_AMOOR,   0xff00ff00, 0x0ff00ff0, 0xfff0fff0 },
+        { "amomin",  HB_MC_PACKET_OP_REMOTE_AMOMIN,  0xfffffffe, 0x00000005, 0xfffffffe },
+        { "amomax",  HB_MC_PACKET_OP_REMOTE_AMOMAX,  0xfffffffe, 0x00000005, 0x00000005 },
+        { "amominu", HB_MC_PACKET_OP_REMOTE_AMOMINU, 0xfffffffe, 0x00000005, 0x00000005 },
+        { "amomaxu", HB_MC_PACKET_OP_REMOTE_AMOMAXU, 0xfffffffe, 0x00000005, 0xfffffffe },
+};
+
+#define CASES ARRAY_SIZE(amo_cases)
+
+/*!
+ * Checks a value returned by an atomic against the word's initial value.
+ */
+static int check_old(const char *api, hb_mc_pod_id_t pod, const amo_case_t *c, uint32_t old)
+{
+        if (old != c->init) {
+                bsg_pr_err("pod %d: %s %s: returned 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                           pod, api, c->name, old, c->init);
+                return HB_MC_FAIL;
+        }
+        return HB_MC_SUCCESS;
+}
+
+/*!
+ * Gives every pod a buffer with two words per atomic operation. The
+ * first word of each pair is updated with hb_mc_device_amo() on the
+ * default pod, the second with hb_mc_device_pod_amo() while the default
+ * pod is a different one. Every call must return the initial value and
+ * leave the operation's result in DRAM.
+ */
+int test_device_amo (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        hb_mc_pod_id_t pod;
+        hb_mc_eva_t buf[device.num_pods];
+        uint32_t init[2 * CASES];
+        for (size_t i = 0; i < CASES; i++)
+                init[2 * i] = init[2 * i + 1] = amo_cases[i].init;
+
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(init), &buf[pod]));
+                BSG_CUDA_CALL(hb_mc_device_memcpy(&device, (void *) ((intptr_t) buf[pod]), init,
+                                                  sizeof(init), HB_MC_MEMCPY_TO_DEVICE));
+        }
+
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                for (size_t i = 0; i < CASES; i++) {
+                        const amo_case_t *c = &amo_cases[i];
+                        uint32_t old;
+                        BSG_CUDA_CALL(hb_mc_device_amo(&device, buf[pod] + 2 * i * sizeof(uint32_t),
+                                                       c->op, c->operand, &old));
+                        BSG_CUDA_CALL(check_old("hb_mc_device_amo", pod, c, old));
+                }
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, device.num_pods - 1));
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                for (size_t i = 0; i < CASES; i++) {
+                        const amo_case_t *c = &amo_cases[i];
+                        uint32_t old;
+                        BSG_CUDA_CALL(hb_mc_device_pod_amo(&device, pod,
+                                                           buf[pod] + (2 * i + 1) * sizeof(uint32_t),
+                                                           c->op, c->operand, &old));
+                        BSG_CUDA_CALL(check_old("hb_mc_device_pod_amo", pod, c, old));
+                }
+        }
+
+        int rc = HB_MC_SUCCESS;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                uint32_t stored[2 * CASES];
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_memcpy(&device, stored, (void *) ((intptr_t) buf[pod]),
+                                                  sizeof(stored), HB_MC_MEMCPY_TO_HOST));
+                for (size_t i = 0; i < 2 * CASES; i++) {
+                        const amo_case_t *c = &amo_cases[i / 2];
+                        if (stored[i] != c->result) {
+                                bsg_pr_err("pod %d: %s %s: stored 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                           pod, (i % 2) ? "hb_mc_device_pod_amo" : "hb_mc_device_amo",
+                                           c->name, stored[i], c->result);
+                                rc = HB_MC_FAIL;
+                        }
+                }
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return rc;
+}
+
+declare_program_main("Device AMO", test_device_amo);
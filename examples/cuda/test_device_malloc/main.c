@@ -0,0 +1,179 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define BLOCKS 7
+
+/*!
+ * Compares allocator statistics and reports the first field that differs.
+ */
+static int check_stats(const char *when,
+                       const hb_mc_malloc_stats_t *got,
+                       const hb_mc_malloc_stats_t *expect)
+{
+        if (got->free_bytes != expect->free_bytes ||
+            got->busy_bytes != expect->busy_bytes ||
+            got->largest_free != expect->largest_free ||
+            got->free_extents != expect->free_extents ||
+            got->busy_blocks != expect->busy_blocks) {
+                bsg_pr_err("%s: free %zu/%zu, busy %zu/%zu, largest %zu/%zu, "
+                           "extents %zu/%zu, blocks %zu/%zu (got/expected)\n",
+                           when,
+                           got->free_bytes, expect->free_bytes,
+                           got->busy_bytes, expect->busy_bytes,
+                           got->largest_free, expect->largest_free,
+                           got->free_extents, expect->free_extents,
+                           got->busy_blocks, expect->busy_blocks);
+                return HB_MC_FAIL;
+        }
+        return HB_MC_SUCCESS;
+}
+
+/*!
+ * Allocates a row of blocks from the largest free extent, frees every
+ * other one and checks that the holes are counted as separate extents,
+ * then frees the rest and checks that everything coalesces back to the
+ * starting state. Aligned allocations must land on their alignment and
+ * give back their padding when freed.
+ */
+int test_device_malloc (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        uint32_t block = hb_mc_config_get_vcache_block_size(&device.mc->config);
+        hb_mc_malloc_stats_t base, stats, expect;
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc_stats(&device, device.default_pod_id, &base));
+
+        // Blocks larger than every free extent but the largest are all
+        // carved, in order, from the front of the largest one
+        size_t min_size = base.free_bytes - base.largest_free + block;
+        if (min_size < 16 * block)
+                min_size = 16 * block;
+        uint32_t size = (min_size + block - 1) / block * block;
+        if ((size_t) size * BLOCKS > base.largest_free) {
+                bsg_pr_err("%zu bytes free in the largest extent, need %zu\n",
+                           base.largest_free, (size_t) size * BLOCKS);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_eva_t eva[BLOCKS];
+        for (int i = 0; i < BLOCKS; i++) {
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, size, &eva[i]));
+                if (i > 0 && eva[i] != eva[i-1] + size) {
+                        bsg_pr_err("block %d at 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                   i, eva[i], eva[i-1] + size);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        // Free the odd blocks: each hole sits between two busy blocks
+        for (int i = 1; i < BLOCKS; i += 2)
+                BSG_CUDA_CALL(hb_mc_device_free(&device, eva[i]));
+
+        expect = base;
+        expect.free_bytes -= (BLOCKS / 2 + 1) * size;
+        expect.busy_bytes += (BLOCKS / 2 + 1) * size;
+        expect.largest_free -= BLOCKS * size;
+        expect.free_extents += BLOCKS / 2;
+        expect.busy_blocks += BLOCKS / 2 + 1;
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc_stats(&device, device.default_pod_id, &stats));
+        BSG_CUDA_CALL(check_stats("after freeing odd blocks", &stats, &expect));
+        if (!(stats.fragmentation > base.fragmentation)) {
+                bsg_pr_err("fragmentation %f did not grow from %f\n",
+                           stats.fragmentation, base.fragmentation);
+                return HB_MC_FAIL;
+        }
+
+        // A hole is reused by a request that fits it
+        hb_mc_eva_t reuse;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, size, &reuse));
+        if (reuse != eva[1] && reuse != eva[3] && reuse != eva[5]) {
+                bsg_pr_err("reallocation at 0x%08" PRIx32 " is not in a hole\n", reuse);
+                return HB_MC_FAIL;
+        }
+        BSG_CUDA_CALL(hb_mc_device_free(&device, reuse));
+
+        // Freeing the even blocks merges every hole with its neighbours
+        for (int i = 0; i < BLOCKS; i += 2)
+                BSG_CUDA_CALL(hb_mc_device_free(&device, eva[i]));
+
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc_stats(&device, device.default_pod_id, &stats));
+        BSG_CUDA_CALL(check_stats("after freeing all blocks", &stats, &base));
+
+        // Aligned allocations, with an unaligned one in between to
+        // force padding in front of them
+        uint32_t alignments[] = {4 * block, 4096, 64 * 1024};
+        hb_mc_eva_t pad, aligned[sizeof(alignments)/sizeof(alignments[0])];
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, block, &pad));
+        for (size_t i = 0; i < sizeof(alignments)/sizeof(alignments[0]); i++) {
+                BSG_CUDA_CALL(hb_mc_device_malloc_aligned(&device, block, alignments[i], &aligned[i]));
+                if (aligned[i] % alignments[i] != 0) {
+                        bsg_pr_err("allocation at 0x%08" PRIx32 " is not aligned to %" PRIu32 "\n",
+                                   aligned[i], alignments[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        int err = hb_mc_device_malloc_aligned(&device, block, 3 * block, &reuse);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_err("alignment of %" PRIu32 " bytes: %s, expected %s\n",
+                           3 * block, hb_mc_strerror(err), hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_FAIL;
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_free(&device, pad));
+        for (size_t i = 0; i < sizeof(alignments)/sizeof(alignments[0]); i++)
+                BSG_CUDA_CALL(hb_mc_device_free(&device, aligned[i]));
+
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc_stats(&device, device.default_pod_id, &stats));
+        BSG_CUDA_CALL(check_stats("after freeing aligned blocks", &stats, &base));
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("Device Malloc", test_device_malloc);
@@ -0,0 +1,204 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+
+#define ALLOC_NAME "default_allocator"
+
+// The number of small writes issued after the whole buffer is written
+#define JOBS 64
+
+/*!
+ * Writes a buffer that spans two stripes of the victim caches with one
+ * large DMA job followed by many small, overlapping jobs, all in a
+ * single call to hb_mc_device_dma_to_device. Where jobs overlap, the
+ * later job must win. The buffer is read back with many small DMA
+ * jobs, and again after a kernel has copied it, so that the data seen
+ * by the tiles is checked too.
+ */
+int test_dma_overlap (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s "
+                         "on a grid of 1x1 tile groups\n\n", test_name);
+
+        srand(1);
+
+        hb_mc_dimension_t tg_dim = { .x = 1, .y = 1 };
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1 };
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        /* if DMA is not supported just return SUCCESS */
+        if (!hb_mc_manycore_supports_dma_write(device.mc)
+            || !hb_mc_manycore_supports_dma_read(device.mc)) {
+                bsg_pr_test_info("DMA not supported for this machine: returning success\n");
+                BSG_CUDA_CALL(hb_mc_device_finish(&device));
+                return HB_MC_SUCCESS;
+        }
+
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                bsg_pr_test_info("loading program for %s onto pod %d\n",
+                                 test_name, pod);
+
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+                // one stripe touches every victim cache of the pod
+                const hb_mc_config_t *cfg = &device.mc->config;
+                int block_words = cfg->vcache_block_words;
+                int stripe_words = cfg->pod_shape.x * 2 * block_words;
+                int N = 2 * stripe_words;
+                size_t alignment = stripe_words * sizeof(uint32_t);
+
+                hb_mc_eva_t A_dev, B_dev;
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(uint32_t) * N + alignment, &A_dev));
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(uint32_t) * N + alignment, &B_dev));
+
+                // align A_dev and B_dev to the first cache
+                A_dev += alignment - (A_dev % alignment);
+                B_dev += alignment - (B_dev % alignment);
+
+                /****************************************************/
+                /* Write A: job 0 covers all of A, and each later   */
+                /* job overwrites a few blocks that often straddle  */
+                /* caches. Every fourth job starts inside the last. */
+                /****************************************************/
+                std::vector<std::vector<uint32_t>> src(JOBS + 1);
+                std::vector<hb_mc_dma_htod_t> htod(JOBS + 1);
+                std::vector<uint32_t> expect(N);
+                int off = 0, len = N;
+
+                for (int j = 0; j <= JOBS; j++) {
+                        if (j > 0 && j % 4 == 0) {
+                                off = off + len / 2;
+                                len = 1 + rand() % (3 * block_words);
+                        } else if (j > 0) {
+                                off = rand() % N;
+                                len = 1 + rand() % (3 * block_words);
+                        }
+                        if (off + len > N)
+                                len = N - off;
+
+                        src[j].resize(len);
+                        for (int i = 0; i < len; i++) {
+                                src[j][i] = (j << 16) | (off + i);
+                                expect[off + i] = src[j][i];
+                        }
+
+                        htod[j].d_addr = A_dev + off * sizeof(uint32_t);
+                        htod[j].h_addr = src[j].data();
+                        htod[j].size   = len * sizeof(uint32_t);
+                }
+
+                bsg_pr_test_info("Writing A with %d overlapping jobs\n", JOBS + 1);
+                BSG_CUDA_CALL(hb_mc_device_dma_to_device(&device, htod.data(), htod.size()));
+
+                /*****************************************/
+                /* Read A back in many small pieces      */
+                /*****************************************/
+                std::vector<uint32_t> A_host(N), B_host(N);
+                std::vector<hb_mc_dma_dtoh_t> dtoh;
+
+                for (off = 0; off < N; off += len) {
+                        len = 1 + rand() % (2 * block_words);
+                        if (off + len > N)
+                                len = N - off;
+
+                        hb_mc_dma_dtoh_t job;
+                        job.d_addr = A_dev + off * sizeof(uint32_t);
+                        job.h_addr = &A_host[off];
+                        job.size   = len * sizeof(uint32_t);
+                        dtoh.push_back(job);
+                }
+
+                bsg_pr_test_info("Reading A with %zu jobs\n", dtoh.size());
+                BSG_CUDA_CALL(hb_mc_device_dma_to_host(&device, dtoh.data(), dtoh.size()));
+
+                /*****************************************/
+                /* Copy A to B on the device, and read B */
+                /*****************************************/
+                hb_mc_eva_t kernel_argv[] = {A_dev, B_dev, (hb_mc_eva_t)N};
+
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_dma_overlap",
+                                                    sizeof(kernel_argv)/sizeof(kernel_argv[0]), kernel_argv));
+
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+                hb_mc_dma_dtoh_t B_job = {
+                        .d_addr = B_dev,
+                        .h_addr = B_host.data(),
+                        .size   = N * sizeof(uint32_t)
+                };
+
+                BSG_CUDA_CALL(hb_mc_device_dma_to_host(&device, &B_job, 1));
+
+                /********************************************/
+                /* Check that the last write to a word wins */
+                /********************************************/
+                int rc = HB_MC_SUCCESS;
+                for (int i = 0; i < N; i++) {
+                        if (A_host[i] != expect[i] || B_host[i] != expect[i]) {
+                                bsg_pr_err("%s: Mismatch at word %d: A = 0x%08" PRIx32
+                                           ", B = 0x%08" PRIx32 ", Expected 0x%08" PRIx32
+                                           " (job %" PRIu32 ")\n",
+                                           __func__, i, A_host[i], B_host[i], expect[i],
+                                           expect[i] >> 16);
+                                rc = HB_MC_FAIL;
+                        }
+                }
+
+                if (rc != HB_MC_SUCCESS) {
+                        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+                        return rc;
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_program_finish(&device));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_dma_overlap", test_dma_overlap);
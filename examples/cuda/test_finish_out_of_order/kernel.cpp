@@ -0,0 +1,18 @@
+//Tile groups launched later finish sooner
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_finish_out_of_order(int *done, int spin) {
+
+    int tg = __bsg_tile_group_id;
+    int n = __bsg_grid_dim_x * __bsg_grid_dim_y;
+
+    for (volatile int i = 0; i < (n - tg) * spin; i++);
+
+    if (__bsg_id == 0)
+        done[tg] = tg + 1;
+
+    return 0;
+}
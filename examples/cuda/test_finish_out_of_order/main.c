@@ -0,0 +1,126 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+// Cycles of work per tile group still to be launched after it
+#define SPIN 200
+
+typedef struct {
+        hb_mc_dimension_t grid_dim;
+        hb_mc_dimension_t tg_dim;
+        hb_mc_eva_t       done;
+} grid_t;
+
+/*!
+ * Launches two grids whose tile groups finish in the reverse of their
+ * launch order, so that finish packets arrive interleaved and out of
+ * order. Every tile group must be retired exactly once and report
+ * completion.
+ */
+int test_finish_out_of_order (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        grid_t grids[] = {
+                { .grid_dim = { .x = 8, .y = 2 }, .tg_dim = { .x = 1, .y = 1 } },
+                { .grid_dim = { .x = 2, .y = 2 }, .tg_dim = { .x = 2, .y = 2 } },
+        };
+
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+                for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                        grid_t *g = &grids[i];
+                        uint32_t n = g->grid_dim.x * g->grid_dim.y;
+
+                        BSG_CUDA_CALL(hb_mc_device_malloc(&device, n * sizeof(int), &g->done));
+                        BSG_CUDA_CALL(hb_mc_device_memset(&device, &g->done, 0, n * sizeof(int)));
+
+                        uint32_t kernel_argv[] = {g->done, SPIN};
+
+                        BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, g->grid_dim, g->tg_dim,
+                                                           "kernel_finish_out_of_order",
+                                                           ARRAY_SIZE(kernel_argv), kernel_argv));
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+                int rc = HB_MC_SUCCESS;
+                for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                        grid_t *g = &grids[i];
+                        uint32_t n = g->grid_dim.x * g->grid_dim.y;
+                        int done[n];
+
+                        BSG_CUDA_CALL(hb_mc_device_memcpy(&device, done, (void *) ((intptr_t) g->done),
+                                                          sizeof(done), HB_MC_MEMCPY_TO_HOST));
+
+                        for (uint32_t tg = 0; tg < n; tg++) {
+                                if (done[tg] != (int) tg + 1) {
+                                        bsg_pr_err("pod %d: grid %zu: tile group %" PRIu32 " did not finish\n",
+                                                   pod, i, tg);
+                                        rc = HB_MC_FAIL;
+                                }
+                        }
+                }
+
+                if (rc != HB_MC_SUCCESS) {
+                        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+                        return rc;
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_program_finish(&device));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("Finish Out Of Order", test_finish_out_of_order);
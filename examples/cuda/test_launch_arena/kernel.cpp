@@ -0,0 +1,30 @@
+//Each tile adds its arguments to its tile group's sum, then waits for
+//the rest of the tile group at a hardware barrier
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+#include "bsg_cuda_lite_barrier.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_launch_arena_2(int *sum, int a) {
+
+    bsg_barrier_hw_tile_group_init();
+
+    __atomic_fetch_add(&sum[__bsg_tile_group_id], a, __ATOMIC_SEQ_CST);
+
+    bsg_barrier_hw_tile_group_sync();
+
+    return 0;
+}
+
+extern "C" __attribute__ ((noinline))
+int kernel_launch_arena_5(int *sum, int a, int b, int c, int d) {
+
+    bsg_barrier_hw_tile_group_init();
+
+    __atomic_fetch_add(&sum[__bsg_tile_group_id], a + b + c + d, __ATOMIC_SEQ_CST);
+
+    bsg_barrier_hw_tile_group_sync();
+
+    return 0;
+}
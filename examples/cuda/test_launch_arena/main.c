@@ -0,0 +1,138 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+#define ROUNDS 4
+
+typedef struct {
+        const char       *name;
+        hb_mc_dimension_t grid_dim;
+        hb_mc_dimension_t tg_dim;
+        uint32_t          argc;    // including the sum pointer
+        hb_mc_eva_t       sum;
+} grid_t;
+
+/*!
+ * Launches grids with two argument counts and two tile group shapes
+ * for several rounds, with new argument values each round. Launch
+ * buffers come back from the pod's arena after the first round, so
+ * each round must see its own arguments and a working barrier, and
+ * the allocator's usage must not grow after the first round.
+ */
+int test_launch_arena (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        grid_t grids[] = {
+                { .name = "kernel_launch_arena_2", .grid_dim = { .x = 2, .y = 2 },
+                  .tg_dim = { .x = 2, .y = 2 }, .argc = 2 },
+                { .name = "kernel_launch_arena_5", .grid_dim = { .x = 3, .y = 1 },
+                  .tg_dim = { .x = 4, .y = 1 }, .argc = 5 },
+                { .name = "kernel_launch_arena_2", .grid_dim = { .x = 2, .y = 1 },
+                  .tg_dim = { .x = 4, .y = 1 }, .argc = 2 },
+        };
+
+        for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                uint32_t n = grids[i].grid_dim.x * grids[i].grid_dim.y;
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, n * sizeof(int), &grids[i].sum));
+        }
+
+        hb_mc_malloc_stats_t first;
+        int rc = HB_MC_SUCCESS;
+
+        for (int round = 0; round < ROUNDS && rc == HB_MC_SUCCESS; round++) {
+                for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                        grid_t *g = &grids[i];
+                        uint32_t n = g->grid_dim.x * g->grid_dim.y;
+
+                        BSG_CUDA_CALL(hb_mc_device_memset(&device, &g->sum, 0, n * sizeof(int)));
+
+                        uint32_t kernel_argv[] = {g->sum, 1 + round, 10 * round, 100 * round, 1000 * round};
+
+                        BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, g->grid_dim, g->tg_dim,
+                                                           g->name, g->argc, kernel_argv));
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+                for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                        grid_t *g = &grids[i];
+                        uint32_t n = g->grid_dim.x * g->grid_dim.y;
+                        int sum[n];
+                        int per_tile = g->argc == 5 ? 1 + 1111 * round : 1 + round;
+                        int expect = per_tile * g->tg_dim.x * g->tg_dim.y;
+
+                        BSG_CUDA_CALL(hb_mc_device_memcpy(&device, sum, (void *) ((intptr_t) g->sum),
+                                                          sizeof(sum), HB_MC_MEMCPY_TO_HOST));
+
+                        for (uint32_t tg = 0; tg < n; tg++) {
+                                if (sum[tg] != expect) {
+                                        bsg_pr_err("round %d: %s: tile group %" PRIu32 ": sum %d, expected %d\n",
+                                                   round, g->name, tg, sum[tg], expect);
+                                        rc = HB_MC_FAIL;
+                                }
+                        }
+                }
+
+                hb_mc_malloc_stats_t stats;
+                BSG_CUDA_CALL(hb_mc_device_pod_malloc_stats(&device, device.default_pod_id, &stats));
+                if (round == 0) {
+                        first = stats;
+                } else if (stats.busy_bytes != first.busy_bytes) {
+                        bsg_pr_err("round %d: %zu bytes allocated, %zu after the first round\n",
+                                   round, stats.busy_bytes, first.busy_bytes);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return rc;
+}
+
+declare_program_main("Launch Arena", test_launch_arena);
@@ -0,0 +1,19 @@
+//This kernel is not launched: the host checks the symbols it defines
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+#define N 37
+
+int loader_symbols_data[N] __attribute__((section(".dram")));
+
+extern "C" __attribute__ ((noinline))
+int kernel_loader_symbols(int *A) {
+
+    if (__bsg_id == 0) {
+        for (int i = 0; i < N; i++)
+            loader_symbols_data[i] = A[i];
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+// Must match kernel.cpp
+#define KERNEL_FUNCTION "kernel_loader_symbols"
+#define DATA_SYMBOL     "loader_symbols_data"
+#define DATA_SIZE       (37 * sizeof(int))
+
+/*!
+ * Checks that every lookup through the loader's symbol index agrees
+ * with a scan of the binary's symbol tables, for code, DRAM data, DMEM
+ * data and linker symbols. Also checks symbol sizes, a missing symbol,
+ * and mapping an address back to its function.
+ */
+static int check_symbols(const hb_mc_loader_program_t *program,
+                         const unsigned char *bin, size_t sz)
+{
+        static const char *symbols[] = {
+                "_start",
+                KERNEL_FUNCTION,
+                DATA_SYMBOL,
+                "__bsg_x",
+                "cuda_kernel_ptr",
+                "_bsg_dram_end_addr",
+        };
+
+        for (size_t i = 0; i < ARRAY_SIZE(symbols); i++) {
+                hb_mc_eva_t eva, expect;
+                size_t size;
+
+                BSG_CUDA_CALL(hb_mc_loader_symbol_to_eva(bin, sz, symbols[i], &expect));
+                BSG_CUDA_CALL(hb_mc_loader_program_symbol(program, symbols[i], &eva, &size));
+
+                if (eva != expect) {
+                        bsg_pr_err("%s: indexed EVA 0x%08" PRIx32 " != scanned EVA 0x%08" PRIx32 "\n",
+                                   symbols[i], eva, expect);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        hb_mc_eva_t data_eva;
+        size_t data_size;
+        BSG_CUDA_CALL(hb_mc_loader_program_symbol(program, DATA_SYMBOL, &data_eva, &data_size));
+        if (data_size != DATA_SIZE) {
+                bsg_pr_err("%s: size %zu, expected %zu\n", DATA_SYMBOL, data_size, DATA_SIZE);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_eva_t eva;
+        int err = hb_mc_loader_program_symbol(program, "no_such_symbol", &eva, NULL);
+        if (err != HB_MC_NOTFOUND) {
+                bsg_pr_err("no_such_symbol: expected %s, got %s\n",
+                           hb_mc_strerror(HB_MC_NOTFOUND), hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* an address inside the kernel maps back to the kernel */
+        hb_mc_eva_t kernel_eva;
+        const char *function;
+        size_t offset;
+        BSG_CUDA_CALL(hb_mc_loader_program_symbol(program, KERNEL_FUNCTION, &kernel_eva, NULL));
+        BSG_CUDA_CALL(hb_mc_loader_program_address_to_symbol(program, kernel_eva + 4, &function, &offset));
+        if (strcmp(function, KERNEL_FUNCTION) != 0 || offset != 4) {
+                bsg_pr_err("0x%08" PRIx32 ": got %s+%zu, expected %s+4\n",
+                           kernel_eva + 4, function, offset, KERNEL_FUNCTION);
+                return HB_MC_FAIL;
+        }
+
+        /* data is not a function */
+        err = hb_mc_loader_program_address_to_symbol(program, data_eva, &function, &offset);
+        if (err != HB_MC_NOTFOUND) {
+                bsg_pr_err("0x%08" PRIx32 ": expected %s, got %s\n",
+                           data_eva, hb_mc_strerror(HB_MC_NOTFOUND), hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+int test_loader_symbols (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        unsigned char *bin;
+        size_t sz;
+        hb_mc_loader_program_t *program;
+        int rc;
+
+        BSG_CUDA_CALL(hb_mc_loader_read_program_file(bin_path, &bin, &sz));
+        rc = hb_mc_loader_program_open(bin, sz, &program);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_err("failed to open %s: %s\n", bin_path, hb_mc_strerror(rc));
+                free(bin);
+                return rc;
+        }
+
+        rc = check_symbols(program, bin, sz);
+
+        hb_mc_loader_program_close(program);
+        free(bin);
+
+        if (rc != HB_MC_SUCCESS)
+                return rc;
+
+        /**********************************************************************/
+        /* Load the program through the index on every pod.                   */
+        /**********************************************************************/
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+                BSG_CUDA_CALL(hb_mc_device_program_finish(&device));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("Loader Symbols", test_loader_symbols);
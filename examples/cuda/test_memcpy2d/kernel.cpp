@@ -0,0 +1,10 @@
+//Copies are issued from the host only; this kernel gives the program
+//a symbol table and a DRAM end address to allocate after
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_memcpy2d() {
+        return 0;
+}
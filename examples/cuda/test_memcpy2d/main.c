@@ -0,0 +1,151 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define ROWS         8
+#define FIRST_ROW    2
+#define HEIGHT       4
+#define BACKGROUND   0xbad00000
+
+/*!
+ * Copies a sub-matrix into and out of a larger row-major matrix in DRAM
+ * with hb_mc_device_memcpy2d_to_device() and _to_host(). Rows of the
+ * sub-matrix start just before a DRAM stripe boundary and cross
+ * several, and the pitches on both sides are larger than the width.
+ * Everything outside the sub-matrix, in DRAM and on the host, must be
+ * left untouched.
+ */
+int test_memcpy2d (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        // Device rows are a few stripes and a little more long, so
+        // each row starts at a different offset in its stripe
+        size_t stripe = hb_mc_config_get_vcache_stripe_size(&device.mc->config);
+        size_t pitch = 4 * stripe + 8 * sizeof(uint32_t);
+        size_t col = stripe - 2 * sizeof(uint32_t);
+        size_t width = 2 * stripe + 4 * sizeof(uint32_t);
+        size_t hpitch = width + 3 * sizeof(uint32_t);
+
+        size_t words = ROWS * pitch / sizeof(uint32_t);
+        uint32_t *matrix = (uint32_t *) malloc(ROWS * pitch);
+        uint32_t *expect = (uint32_t *) malloc(ROWS * pitch);
+        uint32_t *src = (uint32_t *) malloc(HEIGHT * hpitch);
+        uint32_t *dst = (uint32_t *) malloc((HEIGHT + 2) * hpitch);
+        if (!matrix || !expect || !src || !dst) {
+                bsg_pr_err("failed to allocate host buffers\n");
+                return HB_MC_NOMEM;
+        }
+
+        for (size_t i = 0; i < words; i++)
+                expect[i] = BACKGROUND | i;
+        for (size_t i = 0; i < HEIGHT * hpitch / sizeof(uint32_t); i++)
+                src[i] = i;
+
+        hb_mc_eva_t eva;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, ROWS * pitch, &eva));
+        BSG_CUDA_CALL(hb_mc_device_memcpy(&device, (void *) ((intptr_t) eva), expect,
+                                          ROWS * pitch, HB_MC_MEMCPY_TO_DEVICE));
+
+        // Write the sub-matrix
+        hb_mc_eva_t corner = eva + FIRST_ROW * pitch + col;
+        BSG_CUDA_CALL(hb_mc_device_memcpy2d_to_device(&device, corner, pitch,
+                                                      src, hpitch, width, HEIGHT));
+        for (size_t r = 0; r < HEIGHT; r++)
+                memcpy((char *) expect + (FIRST_ROW + r) * pitch + col,
+                       (char *) src + r * hpitch, width);
+
+        BSG_CUDA_CALL(hb_mc_device_memcpy(&device, matrix, (void *) ((intptr_t) eva),
+                                          ROWS * pitch, HB_MC_MEMCPY_TO_HOST));
+
+        int rc = HB_MC_SUCCESS;
+        for (size_t i = 0; i < words; i++) {
+                if (matrix[i] != expect[i]) {
+                        bsg_pr_err("to device: row %zu, byte %zu: 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                   i * sizeof(uint32_t) / pitch, i * sizeof(uint32_t) % pitch,
+                                   matrix[i], expect[i]);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        // Read the sub-matrix and the row on either side of it into a
+        // host buffer whose gaps between rows are never written
+        memset(dst, 0xff, (HEIGHT + 2) * hpitch);
+        BSG_CUDA_CALL(hb_mc_device_memcpy2d_to_host(&device, dst, hpitch,
+                                                    corner - pitch, pitch, width, HEIGHT + 2));
+        for (size_t r = 0; r < HEIGHT + 2; r++) {
+                const uint32_t *got = (const uint32_t *) ((char *) dst + r * hpitch);
+                const uint32_t *want = (const uint32_t *) ((char *) expect + (FIRST_ROW - 1 + r) * pitch + col);
+                for (size_t w = 0; w < hpitch / sizeof(uint32_t); w++) {
+                        uint32_t e = w < width / sizeof(uint32_t) ? want[w] : 0xffffffff;
+                        if (got[w] != e) {
+                                bsg_pr_err("to host: row %zu, word %zu: 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                           r, w, got[w], e);
+                                rc = HB_MC_FAIL;
+                        }
+                }
+        }
+
+        // A row may not be wider than its pitch
+        int err = hb_mc_device_memcpy2d_to_device(&device, corner, width - sizeof(uint32_t),
+                                                  src, hpitch, width, HEIGHT);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_err("pitch smaller than width: %s, expected %s\n",
+                           hb_mc_strerror(err), hb_mc_strerror(HB_MC_INVALID));
+                rc = HB_MC_FAIL;
+        }
+
+        free(matrix);
+        free(expect);
+        free(src);
+        free(dst);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return rc;
+}
+
+declare_program_main("Memcpy 2D", test_memcpy2d);
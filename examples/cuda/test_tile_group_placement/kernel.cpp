@@ -0,0 +1,27 @@
+//This kernel checks that no other tile group runs on its tiles while it does
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+// long enough for the host to launch other tile groups meanwhile
+#define SPIN 2000
+
+extern "C" __attribute__ ((noinline))
+int kernel_tile_group_placement(int *occupied, int *overlaps, int *visits,
+                                int mesh_x, int mesh_y, int mesh_dim_x) {
+
+    int x = __bsg_grp_org_x + __bsg_x - mesh_x;
+    int y = __bsg_grp_org_y + __bsg_y - mesh_y;
+    int *tile = &occupied[y * mesh_dim_x + x];
+
+    // a tile group placed over this one would also mark the tile
+    if (__atomic_fetch_add(tile, 1, __ATOMIC_SEQ_CST) != 0)
+        __atomic_fetch_add(overlaps, 1, __ATOMIC_SEQ_CST);
+
+    for (volatile int i = 0; i < SPIN; i++);
+
+    __atomic_fetch_sub(tile, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&visits[__bsg_tile_group_id], 1, __ATOMIC_SEQ_CST);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+typedef struct {
+        hb_mc_dimension_t grid_dim;
+        hb_mc_dimension_t tg_dim;
+        hb_mc_eva_t       visits;
+} grid_t;
+
+/*!
+ * Enqueues grids of tile groups of several shapes, more than fit in
+ * the pod at once, so that tile groups are placed around ones that
+ * are still running. Each tile counts the tile groups running on it
+ * with atomics in DRAM: the count must never exceed one. Each tile
+ * group must have run on all of its tiles.
+ */
+int test_tile_group_placement (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        hb_mc_mesh_t *mesh = device.pods[device.default_pod_id].mesh;
+        hb_mc_idx_t W = hb_mc_dimension_get_x(mesh->dim);
+        hb_mc_idx_t H = hb_mc_dimension_get_y(mesh->dim);
+
+        grid_t grids[] = {
+                { .grid_dim = { .x = 1, .y = 1 }, .tg_dim = { .x = MIN(W, 4), .y = MIN(H, 4) } },
+                { .grid_dim = { .x = 3, .y = 1 }, .tg_dim = { .x = MIN(W, 3), .y = MIN(H, 2) } },
+                { .grid_dim = { .x = 4, .y = 1 }, .tg_dim = { .x = MIN(W, 2), .y = MIN(H, 2) } },
+                { .grid_dim = { .x = 4, .y = 2 }, .tg_dim = { .x = 1,         .y = 1         } },
+                { .grid_dim = { .x = 2, .y = 1 }, .tg_dim = { .x = W,         .y = MIN(H, 4) } },
+                { .grid_dim = { .x = 2, .y = 2 }, .tg_dim = { .x = MIN(W, 4), .y = MIN(H, 4) } },
+        };
+
+        hb_mc_eva_t occupied, overlaps;
+        uint32_t occupied_sz = W * H * sizeof(int);
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, occupied_sz, &occupied));
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(int), &overlaps));
+        BSG_CUDA_CALL(hb_mc_device_memset(&device, &occupied, 0, occupied_sz));
+        BSG_CUDA_CALL(hb_mc_device_memset(&device, &overlaps, 0, sizeof(int)));
+
+        for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                grid_t *g = &grids[i];
+                uint32_t n = g->grid_dim.x * g->grid_dim.y;
+
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, n * sizeof(int), &g->visits));
+                BSG_CUDA_CALL(hb_mc_device_memset(&device, &g->visits, 0, n * sizeof(int)));
+
+                uint32_t kernel_argv[] = {occupied, overlaps, g->visits,
+                                          hb_mc_coordinate_get_x(mesh->origin),
+                                          hb_mc_coordinate_get_y(mesh->origin),
+                                          W};
+
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, g->grid_dim, g->tg_dim,
+                                                   "kernel_tile_group_placement",
+                                                   ARRAY_SIZE(kernel_argv), kernel_argv));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+        int rc = HB_MC_SUCCESS;
+
+        int overlaps_host;
+        BSG_CUDA_CALL(hb_mc_device_memcpy(&device, &overlaps_host, (void *) ((intptr_t) overlaps),
+                                          sizeof(overlaps_host), HB_MC_MEMCPY_TO_HOST));
+        if (overlaps_host != 0) {
+                bsg_pr_err("%d tiles ran more than one tile group at once\n", overlaps_host);
+                rc = HB_MC_FAIL;
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(grids); i++) {
+                grid_t *g = &grids[i];
+                uint32_t n = g->grid_dim.x * g->grid_dim.y;
+                int visits[n];
+
+                BSG_CUDA_CALL(hb_mc_device_memcpy(&device, visits, (void *) ((intptr_t) g->visits),
+                                                  sizeof(visits), HB_MC_MEMCPY_TO_HOST));
+
+                for (uint32_t tg = 0; tg < n; tg++) {
+                        int expect = g->tg_dim.x * g->tg_dim.y;
+                        if (visits[tg] != expect) {
+                                bsg_pr_err("grid %zu: tile group %" PRIu32 " ran on %d tiles, expected %d\n",
+                                           i, tg, visits[tg], expect);
+                                rc = HB_MC_FAIL;
+                        }
+                }
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return rc;
+}
+
+declare_program_main("Tile Group Placement", test_tile_group_placement);
@@ -0,0 +1,15 @@
+//This kernel overwrites an array in DRAM
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_vcache_writeback(int *B, int n) {
+
+    if (__bsg_id == 0) {
+        for (int i = 0; i < n; i++)
+            B[i] = 3 * i + 1;
+    }
+
+    return 0;
+}
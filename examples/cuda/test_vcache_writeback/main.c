@@ -0,0 +1,142 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_regression.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+/*
+ * Read an array back with DMA, which flushes only the cache lines the
+ * host believes may be dirty, and compare it against what was written.
+ */
+static int check(hb_mc_device_t *device, const char *what,
+                 hb_mc_eva_t B_dev, uint32_t *B_host, const uint32_t *expect, int N)
+{
+        hb_mc_dma_dtoh_t dtoh = {
+                .d_addr = B_dev,
+                .h_addr = B_host,
+                .size   = N * sizeof(uint32_t)
+        };
+        int rc = HB_MC_SUCCESS;
+
+        memset(B_host, 0, N * sizeof(uint32_t));
+        BSG_CUDA_CALL(hb_mc_device_dma_to_host(device, &dtoh, 1));
+
+        for (int i = 0; i < N; i++) {
+                if (B_host[i] != expect[i]) {
+                        bsg_pr_err("%s: B[%d] = 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                   what, i, B_host[i], expect[i]);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        return rc;
+}
+
+/*!
+ * Checks that skipping flushes of clean victim cache lines never loses
+ * dirty data. An array is written through the victim caches by the host
+ * and read back with DMA twice, so the second write lands on lines the
+ * first read left clean. Then a kernel overwrites the array and it is
+ * read back with DMA once more.
+ */
+int test_vcache_writeback (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Unified Main %s\n\n", test_name);
+
+        hb_mc_dimension_t tg_dim = { .x = 1, .y = 1 };
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1 };
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        // the array spans several blocks in every cache of the pod
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device.mc);
+        int N = cfg->pod_shape.x * 2 * cfg->vcache_block_words * 4;
+
+        uint32_t *B_host = (uint32_t *) malloc(N * sizeof(uint32_t));
+        uint32_t *expect = (uint32_t *) malloc(N * sizeof(uint32_t));
+        if (!B_host || !expect) {
+                bsg_pr_err("failed to allocate host buffers\n");
+                return HB_MC_NOMEM;
+        }
+
+        hb_mc_eva_t B_dev;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(uint32_t), &B_dev));
+
+        int rc = HB_MC_SUCCESS;
+
+        // host stores, then a range flush
+        for (int round = 0; round < 2; round++) {
+                for (int i = 0; i < N; i++)
+                        expect[i] = ((uint32_t) round << 24) | i;
+
+                BSG_CUDA_CALL(hb_mc_device_memcpy(&device, (void *) ((intptr_t) B_dev), expect,
+                                                  N * sizeof(uint32_t), HB_MC_MEMCPY_TO_DEVICE));
+                if (check(&device, round ? "host store after flush" : "host store",
+                          B_dev, B_host, expect, N) != HB_MC_SUCCESS)
+                        rc = HB_MC_FAIL;
+        }
+
+        // a launch, then a range flush of lines last seen clean
+        hb_mc_eva_t kernel_argv[] = {B_dev, (hb_mc_eva_t) N};
+        char kernel_name[] = "kernel_vcache_writeback";
+
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, grid_dim, tg_dim, kernel_name,
+                                           ARRAY_SIZE(kernel_argv), kernel_argv));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+        for (int i = 0; i < N; i++)
+                expect[i] = 3 * i + 1;
+
+        if (check(&device, "kernel store", B_dev, B_host, expect, N) != HB_MC_SUCCESS)
+                rc = HB_MC_FAIL;
+
+        free(B_host);
+        free(expect);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return rc;
+}
+
+declare_program_main("Victim Cache Write-back", test_vcache_writeback);
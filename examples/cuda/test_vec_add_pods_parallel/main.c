@@ -0,0 +1,187 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <bsg_manycore_regression.h>
+
+#define N            1024
+#define BLOCK_SIZE_X 64
+
+/*!
+ * Runs vector addition on every pod at once with
+ * hb_mc_device_podv_kernels_execute_parallel(), which gives each pod
+ * its own host thread.
+ *
+ * In the first round each pod's worker allocates and copies its own
+ * vectors and enqueues C = A + B before launching. In the second
+ * round C = A + C is enqueued on every pod up front and the workers
+ * only launch. Each pod gets different data, so results that end up
+ * on the wrong pod are caught.
+ */
+
+typedef struct pod_vec_add {
+        uint32_t A_host[N];
+        uint32_t B_host[N];
+        uint32_t C_host[N];
+        hb_mc_eva_t A_device;
+        hb_mc_eva_t B_device;
+        hb_mc_eva_t C_device;
+} pod_vec_add_t;
+
+static const hb_mc_dimension_t tg_dim = { .x = 2, .y = 2 };
+static const hb_mc_dimension_t grid_dim = { .x = N / BLOCK_SIZE_X, .y = 1 };
+
+static int enqueue_vec_add(hb_mc_device_t *device, hb_mc_pod_id_t pod,
+                           hb_mc_eva_t A, hb_mc_eva_t B, hb_mc_eva_t C)
+{
+        uint32_t cuda_argv[5] = {A, B, C, N, BLOCK_SIZE_X};
+
+        return hb_mc_device_pod_kernel_enqueue(device, pod, grid_dim, tg_dim,
+                                               "kernel_vec_add_pods_parallel", 5, cuda_argv);
+}
+
+/*
+ * Runs on the worker thread of each pod, before its kernels are launched.
+ */
+static int setup_vec_add(hb_mc_device_t *device, hb_mc_pod_id_t pod, void *arg)
+{
+        pod_vec_add_t *v = &((pod_vec_add_t *)arg)[pod];
+
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod, N * sizeof(uint32_t), &v->A_device));
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod, N * sizeof(uint32_t), &v->B_device));
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod, N * sizeof(uint32_t), &v->C_device));
+
+        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod, v->A_device,
+                                                        v->A_host, N * sizeof(uint32_t)));
+        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod, v->B_device,
+                                                        v->B_host, N * sizeof(uint32_t)));
+
+        return enqueue_vec_add(device, pod, v->A_device, v->B_device, v->C_device);
+}
+
+int kernel_vec_add_pods_parallel (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Vector Addition Kernel on all pods in parallel.\n\n");
+
+        srand(0);
+
+        /*********************/
+        /* Initialize device */
+        /*********************/
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        int podc = hb_mc_device_pods(&device);
+        hb_mc_pod_id_t *podv = calloc(podc, sizeof(*podv));
+        pod_vec_add_t *vecs = calloc(podc, sizeof(*vecs));
+        if (!podv || !vecs) {
+                bsg_pr_err("%s: failed to allocate pod vectors\n", __func__);
+                free(podv);
+                free(vecs);
+                BSG_CUDA_CALL(hb_mc_device_finish(&device));
+                return HB_MC_NOMEM;
+        }
+
+        /**********************************************/
+        /* Load the program and pick data on each pod */
+        /**********************************************/
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                bsg_pr_test_info("Loading program for %s onto pod %d\n",
+                                 test_name, pod);
+
+                BSG_CUDA_CALL(hb_mc_device_pod_program_init(&device, pod, bin_path));
+
+                podv[pod] = pod;
+                for (int i = 0; i < N; i++) {
+                        vecs[pod].A_host[i] = rand() & 0xFFFF;
+                        vecs[pod].B_host[i] = rand() & 0xFFFF;
+                }
+        }
+
+        /***************************************************/
+        /* Round 1: each worker sets up its pod, C = A + B */
+        /***************************************************/
+        BSG_CUDA_CALL(hb_mc_device_podv_kernels_execute_parallel(&device, podv, podc,
+                                                                 setup_vec_add, vecs));
+
+        /*************************************************/
+        /* Round 2: enqueue C = A + C on every pod first */
+        /*************************************************/
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                BSG_CUDA_CALL(enqueue_vec_add(&device, pod, vecs[pod].A_device,
+                                              vecs[pod].C_device, vecs[pod].C_device));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_podv_kernels_execute_parallel(&device, podv, podc, NULL, NULL));
+
+        /***********************************/
+        /* Read C back and check every pod */
+        /***********************************/
+        int mismatch = 0;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                pod_vec_add_t *v = &vecs[pod];
+
+                BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_host(&device, pod, v->C_host,
+                                                              v->C_device, N * sizeof(uint32_t)));
+                BSG_CUDA_CALL(hb_mc_device_pod_program_finish(&device, pod));
+
+                for (int i = 0; i < N; i++) {
+                        uint32_t expected = 2 * v->A_host[i] + v->B_host[i];
+                        if (v->C_host[i] != expected) {
+                                bsg_pr_err(BSG_RED("Mismatch: ") "pod %d C[%d]: 0x%08" PRIx32
+                                           "\t Expected: 0x%08" PRIx32 "\n",
+                                           pod, i, v->C_host[i], expected);
+                                mismatch = 1;
+                        }
+                }
+        }
+
+        free(podv);
+        free(vecs);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return mismatch ? HB_MC_FAIL : HB_MC_SUCCESS;
+}
+
+declare_program_main("test_vec_add_pods_parallel", kernel_vec_add_pods_parallel);
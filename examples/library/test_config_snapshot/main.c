@@ -0,0 +1,195 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_platform.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_NAME "test_config_snapshot"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+static hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX];
+static hb_mc_config_raw_t other[HB_MC_CONFIG_MAX];
+
+static void snapshot_path(const char *dir, const hb_mc_config_raw_t rom[HB_MC_CONFIG_MAX],
+                          char *path, size_t sz)
+{
+        snprintf(path, sz, "%s/hb_mc_config_%016" PRIx64 ".snapshot",
+                 dir, hb_mc_config_raw_hash(rom));
+}
+
+/*
+ * Overwrite one byte of a snapshot file.
+ */
+static int corrupt(const char *path, long offset)
+{
+        FILE *f = fopen(path, "r+b");
+        int c;
+
+        if (!f)
+                return HB_MC_FAIL;
+
+        fseek(f, offset, SEEK_SET);
+        c = fgetc(f);
+        fseek(f, offset, SEEK_SET);
+        fputc(c ^ 0xff, f);
+        fclose(f);
+        return HB_MC_SUCCESS;
+}
+
+static int test_snapshots(const char *dir)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_config_t loaded;
+        char path[4096], moved[4096];
+        int err;
+
+        // nothing has been saved yet
+        err = hb_mc_config_snapshot_load(dir, raw, &loaded);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("load from an empty directory returned %s\n",
+                            hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_config_snapshot_save(dir, raw, cfg);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to save a snapshot in %s\n", dir);
+                return err;
+        }
+
+        memset(&loaded, 0, sizeof(loaded));
+        err = hb_mc_config_snapshot_load(dir, raw, &loaded);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to load a saved snapshot: %s\n", hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        if (memcmp(&loaded, cfg, sizeof(loaded)) != 0) {
+                test_pr_err("loaded configuration differs from the saved one\n");
+                return HB_MC_FAIL;
+        }
+
+        // a different ROM image must not find this snapshot,
+        // even when the file is placed under its name
+        memcpy(other, raw, sizeof(other));
+        other[HB_MC_CONFIG_VERSION] ^= 1;
+        snapshot_path(dir, raw, path, sizeof(path));
+        snapshot_path(dir, other, moved, sizeof(moved));
+
+        err = hb_mc_config_snapshot_load(dir, other, &loaded);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("snapshot of another ROM image was loaded\n");
+                return HB_MC_FAIL;
+        }
+
+        if (rename(path, moved) != 0) {
+                test_pr_err("failed to rename %s\n", path);
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_config_snapshot_load(dir, other, &loaded);
+        unlink(moved);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("snapshot with a mismatched ROM image was loaded\n");
+                return HB_MC_FAIL;
+        }
+
+        // a snapshot saved by another build is stale; the build
+        // string follows the magic and size words
+        err = hb_mc_config_snapshot_save(dir, raw, cfg);
+        if (err != HB_MC_SUCCESS || corrupt(path, 2 * sizeof(uint32_t)) != HB_MC_SUCCESS) {
+                test_pr_err("failed to write a stale snapshot\n");
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_config_snapshot_load(dir, raw, &loaded);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("snapshot from another build was loaded\n");
+                return HB_MC_FAIL;
+        }
+
+        // a truncated snapshot is rejected
+        if (truncate(path, sizeof(uint32_t)) != 0) {
+                test_pr_err("failed to truncate %s\n", path);
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_config_snapshot_load(dir, raw, &loaded);
+        unlink(path);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("truncated snapshot was loaded\n");
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        char dir[] = "/tmp/" TEST_NAME ".XXXXXX";
+        int rc;
+
+        rc = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (rc != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n", hb_mc_strerror(rc));
+                return HB_MC_FAIL;
+        }
+
+        rc = hb_mc_platform_get_config(mc, raw);
+        if (rc != HB_MC_SUCCESS) {
+                test_pr_err("failed to read the configuration ROM: %s\n", hb_mc_strerror(rc));
+                goto cleanup;
+        }
+
+        if (!mkdtemp(dir)) {
+                test_pr_err("failed to create a snapshot directory\n");
+                rc = HB_MC_FAIL;
+                goto cleanup;
+        }
+
+        rc = test_snapshots(dir);
+        rmdir(dir);
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
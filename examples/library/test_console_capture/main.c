@@ -0,0 +1,224 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_responder.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_NAME "test_console_capture"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+#define STDOUT_EPA 0xEADC
+#define STDERR_EPA 0xEEE0
+
+/*
+ * Deliver one character printed by a tile to the responders, as the
+ * receive path does for a request packet from that tile.
+ */
+static int tile_putc(hb_mc_coordinate_t tile, hb_mc_epa_t epa, char c)
+{
+        hb_mc_request_packet_t rqst;
+        hb_mc_coordinate_t host = hb_mc_manycore_get_host_coordinate(mc);
+
+        memset(&rqst, 0, sizeof(rqst));
+        hb_mc_request_packet_set_x_src(&rqst, hb_mc_coordinate_get_x(tile));
+        hb_mc_request_packet_set_y_src(&rqst, hb_mc_coordinate_get_y(tile));
+        hb_mc_request_packet_set_x_dst(&rqst, hb_mc_coordinate_get_x(host));
+        hb_mc_request_packet_set_y_dst(&rqst, hb_mc_coordinate_get_y(host));
+        hb_mc_request_packet_set_op(&rqst, HB_MC_PACKET_OP_REMOTE_STORE);
+        hb_mc_request_packet_set_epa(&rqst, epa);
+        hb_mc_request_packet_set_data(&rqst, (uint8_t) c);
+
+        return hb_mc_responders_respond(mc, &rqst);
+}
+
+static int tile_puts(hb_mc_coordinate_t tile, hb_mc_epa_t epa, const char *s)
+{
+        for (; *s; s++) {
+                int err = tile_putc(tile, epa, *s);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+        return HB_MC_SUCCESS;
+}
+
+typedef struct {
+        hb_mc_coordinate_t tile;
+        uint32_t           fd;
+        const char        *text;
+} record_t;
+
+/*
+ * Read one record from a capture file and compare it with #expect.
+ */
+static int check_record(FILE *f, size_t i, const record_t *expect)
+{
+        hb_mc_console_record_t rec;
+        char buf[HB_MC_RESPONDER_CONSOLE_LINE_MAX + 1];
+        size_t sz = strlen(expect->text);
+
+        if (fread(&rec, sizeof(rec), 1, f) != 1) {
+                test_pr_err("record %zu: missing\n", i);
+                return HB_MC_FAIL;
+        }
+
+        if (rec.x != hb_mc_coordinate_get_x(expect->tile) ||
+            rec.y != hb_mc_coordinate_get_y(expect->tile) ||
+            rec.fd != expect->fd || rec.sz != sz) {
+                test_pr_err("record %zu: tile (%" PRIu32 ",%" PRIu32 "), fd %" PRIu32 ", %" PRIu32 " bytes; "
+                            "expected tile (%d,%d), fd %" PRIu32 ", %zu bytes\n",
+                            i, rec.x, rec.y, rec.fd, rec.sz,
+                            hb_mc_coordinate_get_x(expect->tile), hb_mc_coordinate_get_y(expect->tile),
+                            expect->fd, sz);
+                return HB_MC_FAIL;
+        }
+
+        if (fread(buf, 1, rec.sz, f) != rec.sz || memcmp(buf, expect->text, sz) != 0) {
+                test_pr_err("record %zu: output does not match\n", i);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        char path[] = "/tmp/" TEST_NAME ".XXXXXX";
+        static char long_line[HB_MC_RESPONDER_CONSOLE_LINE_MAX + 12];
+        FILE *f = NULL;
+        int err, fd, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        fd = mkstemp(path);
+        if (fd < 0) {
+                test_pr_err("failed to create a capture file\n");
+                goto cleanup;
+        }
+        close(fd);
+
+        err = hb_mc_responder_console_capture(mc, path);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to start capture: %s\n", hb_mc_strerror(err));
+                goto remove;
+        }
+
+        {
+                const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+                hb_mc_coordinate_t a = hb_mc_config_get_origin_vcore(cfg);
+                hb_mc_coordinate_t b = hb_mc_coordinate(hb_mc_coordinate_get_x(a) + 1,
+                                                        hb_mc_coordinate_get_y(a));
+                const char *hello = "hello\n", *world = "world\n";
+
+                // Two tiles print a line each, a character at a time
+                for (size_t i = 0; hello[i] && err == HB_MC_SUCCESS; i++) {
+                        err = tile_putc(a, STDOUT_EPA, hello[i]);
+                        if (err == HB_MC_SUCCESS)
+                                err = tile_putc(b, STDOUT_EPA, world[i]);
+                }
+
+                // A line too long for the buffer is written in pieces
+                memset(long_line, 'x', sizeof(long_line) - 2);
+                long_line[sizeof(long_line) - 2] = '\n';
+
+                if (err == HB_MC_SUCCESS)
+                        err = tile_puts(b, STDOUT_EPA, "partial");
+                if (err == HB_MC_SUCCESS)
+                        err = tile_puts(a, STDERR_EPA, "oops\n");
+                if (err == HB_MC_SUCCESS)
+                        err = tile_puts(a, STDOUT_EPA, long_line);
+                if (err == HB_MC_SUCCESS)
+                        err = hb_mc_responder_console_flush_tile(mc, b);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to print: %s\n", hb_mc_strerror(err));
+                        goto remove;
+                }
+
+                err = hb_mc_responder_console_capture(mc, NULL);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to stop capture: %s\n", hb_mc_strerror(err));
+                        goto remove;
+                }
+
+                // the first piece of the long line is exactly one buffer
+                char first[HB_MC_RESPONDER_CONSOLE_LINE_MAX + 1];
+                memset(first, 'x', HB_MC_RESPONDER_CONSOLE_LINE_MAX);
+                first[HB_MC_RESPONDER_CONSOLE_LINE_MAX] = '\0';
+
+                record_t expect[] = {
+                        { a, STDOUT_FILENO, "hello\n" },
+                        { b, STDOUT_FILENO, "world\n" },
+                        { a, STDERR_FILENO, "oops\n" },
+                        { a, STDOUT_FILENO, first },
+                        { a, STDOUT_FILENO, long_line + HB_MC_RESPONDER_CONSOLE_LINE_MAX },
+                        { b, STDOUT_FILENO, "partial" },
+                };
+
+                f = fopen(path, "rb");
+                if (f == NULL) {
+                        test_pr_err("failed to open the capture file\n");
+                        goto remove;
+                }
+
+                for (size_t i = 0; i < sizeof(expect)/sizeof(expect[0]); i++) {
+                        if (check_record(f, i, &expect[i]) != HB_MC_SUCCESS)
+                                goto remove;
+                }
+
+                if (fgetc(f) != EOF) {
+                        test_pr_err("unexpected data after the last record\n");
+                        goto remove;
+                }
+        }
+
+        rc = HB_MC_SUCCESS;
+
+remove:
+        if (f)
+                fclose(f);
+        unlink(path);
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
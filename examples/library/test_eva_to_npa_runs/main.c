@@ -0,0 +1,216 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_eva.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_config_pod.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_eva_to_npa_runs"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+#define MAX_RUNS 512
+
+hb_mc_npa_t npas     [MAX_RUNS];
+size_t      szs      [MAX_RUNS];
+hb_mc_npa_t ref_npas [MAX_RUNS];
+size_t      ref_szs  [MAX_RUNS];
+
+/*
+ * Translate a range one segment at a time with the map's own
+ * translation, merging segments that continue the previous run.
+ */
+static int reference_runs(const hb_mc_coordinate_t *src, hb_mc_eva_t eva, size_t sz, size_t *nruns)
+{
+        size_t n = 0;
+
+        while (sz > 0) {
+                hb_mc_npa_t npa;
+                size_t npa_sz;
+                int err = default_map.eva_to_npa(mc, default_map.priv, src, &eva, &npa, &npa_sz);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                size_t xfer_sz = sz < npa_sz ? sz : npa_sz;
+                if (n > 0
+                    && hb_mc_npa_get_x(&ref_npas[n-1]) == hb_mc_npa_get_x(&npa)
+                    && hb_mc_npa_get_y(&ref_npas[n-1]) == hb_mc_npa_get_y(&npa)
+                    && hb_mc_npa_get_epa(&ref_npas[n-1]) + ref_szs[n-1] == hb_mc_npa_get_epa(&npa)) {
+                        ref_szs[n-1] += xfer_sz;
+                } else if (n < MAX_RUNS) {
+                        ref_npas[n] = npa;
+                        ref_szs[n] = xfer_sz;
+                        n++;
+                } else {
+                        return HB_MC_NOMEM;
+                }
+
+                sz -= xfer_sz;
+                eva += xfer_sz;
+        }
+
+        *nruns = n;
+        return HB_MC_SUCCESS;
+}
+
+static int compare_runs(const char *what, size_t n)
+{
+        char got_str[256], exp_str[256];
+        size_t i;
+
+        for (i = 0; i < n; i++) {
+                if (hb_mc_npa_get_x(&npas[i]) != hb_mc_npa_get_x(&ref_npas[i]) ||
+                    hb_mc_npa_get_y(&npas[i]) != hb_mc_npa_get_y(&ref_npas[i]) ||
+                    hb_mc_npa_get_epa(&npas[i]) != hb_mc_npa_get_epa(&ref_npas[i]) ||
+                    szs[i] != ref_szs[i]) {
+                        test_pr_err("%s: run %zu: %s + %zu, expected %s + %zu\n", what, i,
+                                    hb_mc_npa_to_string(&npas[i], got_str, sizeof(got_str)), szs[i],
+                                    hb_mc_npa_to_string(&ref_npas[i], exp_str, sizeof(exp_str)), ref_szs[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Translate a range from a tile in every pod, all at once and with the
+ * number of runs limited to two, and compare with the segment by
+ * segment translation.
+ */
+static int test_range(hb_mc_eva_t eva, size_t sz)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod;
+        char what[64];
+        int err;
+
+        hb_mc_config_foreach_pod(pod, cfg) {
+                hb_mc_coordinate_t src = hb_mc_config_pod_vcore_origin(cfg, pod);
+                size_t nruns, ref_nruns;
+
+                snprintf(what, sizeof(what), "pod (%d,%d), EVA 0x%08" PRIx32 " + %zu",
+                         pod.x, pod.y, eva, sz);
+
+                err = reference_runs(&src, eva, sz, &ref_nruns);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("%s: failed to translate: %s\n", what, hb_mc_strerror(err));
+                        return err;
+                }
+
+                err = hb_mc_eva_to_npa_runs(mc, &default_map, &src, &eva, sz,
+                                            npas, szs, MAX_RUNS, &nruns);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("%s: failed to translate runs: %s\n", what, hb_mc_strerror(err));
+                        return err;
+                }
+
+                if (nruns != ref_nruns) {
+                        test_pr_err("%s: %zu runs, expected %zu\n", what, nruns, ref_nruns);
+                        return HB_MC_FAIL;
+                }
+
+                err = compare_runs(what, nruns);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                // A short array gets the leading runs
+                err = hb_mc_eva_to_npa_runs(mc, &default_map, &src, &eva, sz,
+                                            npas, szs, 2, &nruns);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("%s: failed to translate two runs: %s\n", what, hb_mc_strerror(err));
+                        return err;
+                }
+
+                size_t expect = ref_nruns < 2 ? ref_nruns : 2;
+                if (nruns != expect) {
+                        test_pr_err("%s: %zu runs of at most two, expected %zu\n", what, nruns, expect);
+                        return HB_MC_FAIL;
+                }
+
+                err = compare_runs(what, nruns);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        {
+                const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+                hb_mc_eva_t dram = 0x80000000;
+                size_t stripe = hb_mc_config_get_vcache_stripe_size(cfg);
+                // one stripe in every bank of the north and south rows
+                size_t row = 2 * hb_mc_config_get_dimension_vcore(cfg).x * stripe;
+
+                struct { hb_mc_eva_t eva; size_t sz; } ranges[] = {
+                        // starts and ends inside stripes, crosses a few
+                        { dram + stripe - 4, 3 * stripe },
+                        // every bank in both rows, and on into the next EPA
+                        { dram + 3 * stripe / 2, row + stripe },
+                        // a short range crossing from the last bank back to the first
+                        { dram + 5 * row - 8, 16 },
+                        // tile-local memory, not striped
+                        { 0x100, 64 },
+                };
+
+                for (size_t i = 0; i < sizeof(ranges)/sizeof(ranges[0]); i++) {
+                        err = test_range(ranges[i].eva, ranges[i].sz);
+                        if (err != HB_MC_SUCCESS)
+                                goto cleanup;
+                }
+        }
+
+        rc = HB_MC_SUCCESS;
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,229 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_manycore_async"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// More words than there are load ids, so that requests from
+// different calls must share them.
+#define WORDS 128
+
+hb_mc_npa_t    target_npas [WORDS];
+uint32_t       out         [WORDS];
+uint32_t       in          [WORDS];
+uint32_t       in_mem      [WORDS];
+hb_mc_ticket_t tickets     [WORDS];
+
+/*
+ * Spread target_npas across the DRAM banks of the first pod.
+ */
+static void initialize_target_npas(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        hb_mc_idx_t y = hb_mc_config_pod_dram_y(cfg, pod, 0);
+        hb_mc_idx_t columns = hb_mc_dimension_get_x(hb_mc_config_get_dimension_vcore(cfg));
+        hb_mc_idx_t base_x = hb_mc_config_get_vcore_base_x(cfg);
+        int i;
+
+        for (i = 0; i < WORDS; i++)
+                target_npas[i] = hb_mc_npa_from_x_y(base_x + (i % columns), y,
+                                                    (i / columns) * sizeof(uint32_t));
+}
+
+static int write_out_data(void)
+{
+        int i, err;
+
+        for (i = 0; i < WORDS; i++) {
+                out[i] = (uint32_t)rand();
+                err = hb_mc_manycore_write32_async(mc, &target_npas[i], out[i], &tickets[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to start write %d: %s\n",
+                                    i, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        for (i = 0; i < WORDS; i++) {
+                err = hb_mc_manycore_request_wait(mc, tickets[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to wait on write %d: %s\n",
+                                    i, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int read_in_data(void)
+{
+        int i, err, done = 0;
+
+        for (i = 0; i < WORDS; i++) {
+                err = hb_mc_manycore_read32_async(mc, &target_npas[i], &in[i], &tickets[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to start read %d: %s\n",
+                                    i, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        // Poll the last read until it completes, then release all
+        // tickets in reverse order.
+        while (!done) {
+                err = hb_mc_manycore_request_poll(mc, tickets[WORDS-1], &done);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to poll read %d: %s\n",
+                                    WORDS-1, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        for (i = WORDS-1; i >= 0; i--) {
+                err = hb_mc_manycore_request_wait(mc, tickets[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to wait on read %d: %s\n",
+                                    i, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Read the words written to the first column with read_mem_async,
+ * while a blocking read is interleaved with it.
+ */
+static int read_in_mem(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_idx_t columns = hb_mc_dimension_get_x(hb_mc_config_get_dimension_vcore(cfg));
+        size_t words = WORDS / columns;
+        hb_mc_ticket_t ticket;
+        uint32_t word;
+        int err;
+
+        err = hb_mc_manycore_read_mem_async(mc, &target_npas[0], in_mem,
+                                            words * sizeof(uint32_t), &ticket);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to start read_mem: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_read32(mc, &target_npas[1], &word);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to read word 1: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_request_wait(mc, ticket);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to wait on read_mem: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        if (word != out[1]) {
+                test_pr_err("word 1: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                            out[1], word);
+                return HB_MC_FAIL;
+        }
+
+        for (size_t i = 0; i < words; i++) {
+                if (in_mem[i] != out[i * columns]) {
+                        test_pr_err("read_mem word %zu: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                    i, out[i * columns], in_mem[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int compare(void)
+{
+        int i;
+
+        for (i = 0; i < WORDS; i++) {
+                if (out[i] != in[i]) {
+                        test_pr_err("word %d: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                    i, out[i], in[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        initialize_target_npas();
+
+        err = write_out_data();
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        err = read_in_data();
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        err = compare();
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        rc = read_in_mem();
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -42,6 +42,65 @@
 
 #include <bsg_manycore_regression.h>
 
+typedef struct {
+        const char        *name;
+        hb_mc_packet_op_t  op;
+        uint32_t           init;
+        uint32_t           operand;
+        uint32_t           result;
+} amo_case_t;
+
+/* each operation must return init and leave result in memory */
+static const amo_case_t amo_cases[] = {
+        { "amoswap", HB_MC_PACKET_OP_REMOTE_AMOSWAP, 0x12345678, 0xdeadbeef, 0xdeadbeef },
+        { "amoadd",  HB_MC_PACKET_OP_REMOTE_AMOADD,  0xfffffff0, 0x00000020, 0x00000010 },
+        { "amoxor",  HB_MC_PACKET_OP_REMOTE_AMOXOR,  0xff00ff00, 0x0ff00ff0, 0xf0f0f0f0 },
+        { "amoand",  HB_MC_PACKET_OP_REMOTE_AMOAND,  0xff00ff00, 0x0ff00ff0, 0x0f000f00 },
+        { "amoor",   HB_MC_PACKET_OP_REMOTE_AMOOR,   0xff00ff00, 0x0ff00ff0, 0xfff0fff0 },
+        { "amomin",  HB_MC_PACKET_OP_REMOTE_AMOMIN,  0xfffffffe, 0x00000005, 0xfffffffe },
+        { "amomax",  HB_MC_PACKET_OP_REMOTE_AMOMAX,  0xfffffffe, 0x00000005, 0x00000005 },
+        { "amominu", HB_MC_PACKET_OP_REMOTE_AMOMINU, 0xfffffffe, 0x00000005, 0x00000005 },
+        { "amomaxu", HB_MC_PACKET_OP_REMOTE_AMOMAXU, 0xfffffffe, 0x00000005, 0xfffffffe },
+};
+
+/*!
+ * Runs every atomic operation against one word with hb_mc_manycore_amo32()
+ * and checks the value returned and the value left behind.
+ */
+static int test_amo32(hb_mc_manycore_t *mc, const char *where, const hb_mc_npa_t *npa)
+{
+        for (size_t i = 0; i < sizeof(amo_cases)/sizeof(amo_cases[0]); i++) {
+                const amo_case_t *c = &amo_cases[i];
+                uint32_t old, stored;
+
+                BSG_CUDA_CALL(hb_mc_manycore_write32(mc, npa, c->init));
+                BSG_CUDA_CALL(hb_mc_manycore_amo32(mc, npa, c->op, c->operand, &old));
+                BSG_CUDA_CALL(hb_mc_manycore_read32(mc, npa, &stored));
+
+                if (old != c->init || stored != c->result) {
+                        bsg_pr_test_err("%s: %s 0x%08" PRIx32 ", 0x%08" PRIx32 ": "
+                                        "returned 0x%08" PRIx32 ", stored 0x%08" PRIx32 ", "
+                                        "expected 0x%08" PRIx32 ", 0x%08" PRIx32 "\n",
+                                        where, c->name, c->init, c->operand,
+                                        old, stored, c->init, c->result);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        /* the previous value is optional */
+        BSG_CUDA_CALL(hb_mc_manycore_amo32(mc, npa, HB_MC_PACKET_OP_REMOTE_AMOADD, 1, NULL));
+
+        /* only atomic opcodes are accepted */
+        int err = hb_mc_manycore_amo32(mc, npa, HB_MC_PACKET_OP_REMOTE_LOAD, 0, NULL);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_test_err("%s: a load through amo32 returned %s, expected %s\n",
+                                where, hb_mc_strerror(err), hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_FAIL;
+        }
+
+        bsg_pr_test_info("%s: all atomic operations passed\n", where);
+        return HB_MC_SUCCESS;
+}
 
 int test_manycore_atomic_packets(int argc, char *argv[]) {
         hb_mc_manycore_t manycore = {0}, *mc = &manycore;
@@ -126,6 +185,14 @@ int test_manycore_atomic_packets(int argc, char *argv[]) {
             }
         }
 
+        /****************************************************/
+        /* Test every atomic operation on DRAM and on a tile */
+        /****************************************************/
+        BSG_CUDA_CALL(test_amo32(mc, "DRAM", &npa));
+
+        hb_mc_npa_t dmem_npa = hb_mc_npa(vcore_base, HB_MC_TILE_EPA_DMEM_BASE + 0x100);
+        BSG_CUDA_CALL(test_amo32(mc, "DMEM", &dmem_npa));
+
         /*******/
         /* END */
         /*******/
@@ -0,0 +1,168 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_manycore_broadcast"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// The number of words written to each destination
+#define WORDS 64
+
+// memset a sub-range of each destination
+#define MEMSET_START 8
+#define MEMSET_WORDS 40
+#define MEMSET_VAL   0x3c
+
+#define MAX_NPAS 1024
+
+hb_mc_npa_t npas [MAX_NPAS];
+uint32_t    out  [WORDS];
+uint32_t    in   [WORDS];
+
+/*
+ * Check that each of #n NPAs holds #out.
+ */
+static int compare(const char *what, size_t n)
+{
+        char npa_str[256];
+        size_t i;
+        int j, err;
+
+        for (i = 0; i < n; i++) {
+                err = hb_mc_manycore_read_mem(mc, &npas[i], in, sizeof(in));
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("%s: failed to read_mem: %s\n", what, hb_mc_strerror(err));
+                        return err;
+                }
+
+                for (j = 0; j < WORDS; j++) {
+                        if (in[j] != out[j]) {
+                                test_pr_err("%s: %s: word %d: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                            what, hb_mc_npa_to_string(&npas[i], npa_str, sizeof(npa_str)),
+                                            j, out[j], in[j]);
+                                return HB_MC_FAIL;
+                        }
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Broadcast a buffer to #n NPAs, then memset a sub-range of each of them.
+ */
+static int test_broadcast(const char *what, size_t n)
+{
+        hb_mc_npa_t starts[MAX_NPAS];
+        size_t i;
+        int err;
+
+        for (i = 0; i < WORDS; i++)
+                out[i] = (uint32_t)rand();
+
+        err = hb_mc_manycore_write_mem_broadcast(mc, npas, n, out, sizeof(out));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("%s: failed to write_mem_broadcast: %s\n", what, hb_mc_strerror(err));
+                return err;
+        }
+
+        err = compare(what, n);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (i = 0; i < n; i++) {
+                starts[i] = npas[i];
+                hb_mc_npa_set_epa(&starts[i], hb_mc_npa_get_epa(&npas[i]) + MEMSET_START * sizeof(uint32_t));
+        }
+
+        err = hb_mc_manycore_memset_broadcast(mc, starts, n, MEMSET_VAL, MEMSET_WORDS * sizeof(uint32_t));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("%s: failed to memset_broadcast: %s\n", what, hb_mc_strerror(err));
+                return err;
+        }
+
+        // the words around the memset range keep the broadcast data
+        memset(&out[MEMSET_START], MEMSET_VAL, MEMSET_WORDS * sizeof(uint32_t));
+
+        return compare(what, n);
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        const hb_mc_config_t *cfg;
+        hb_mc_coordinate_t pod = {.x=0, .y=0}, coord;
+        size_t n;
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        cfg = hb_mc_manycore_get_config(mc);
+
+        // the DMEM of every core in the first pod
+        n = 0;
+        hb_mc_config_pod_foreach_vcore(coord, pod, cfg) {
+                if (n < MAX_NPAS)
+                        npas[n++] = hb_mc_npa(coord, HB_MC_TILE_EPA_DMEM_BASE);
+        }
+
+        err = test_broadcast("DMEM", n);
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        // every DRAM bank of the first pod
+        n = 0;
+        hb_mc_config_pod_foreach_dram(coord, pod, cfg) {
+                if (n < MAX_NPAS)
+                        npas[n++] = hb_mc_npa(coord, 0);
+        }
+
+        rc = test_broadcast("DRAM", n);
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,179 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_manycore_counters"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+#define expect_err(call, expect)                                        \
+        do {                                                            \
+                int __r = (call);                                       \
+                if (__r != (expect)) {                                  \
+                        test_pr_err("%s: %s, expected %s\n", #call,     \
+                                    hb_mc_strerror(__r), hb_mc_strerror(expect)); \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+/* Let time pass: tiles that are running keep counting. */
+static int wait_a_while(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_npa_t npa = hb_mc_npa(hb_mc_config_dram(cfg, 0), 0);
+        uint32_t data = 0;
+        int i, err;
+
+        for (i = 0; i < 4; i++) {
+                err = hb_mc_manycore_write_mem(mc, &npa, &data, sizeof(data));
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Read the counters of every tile into a new array.
+ * Every tile must be a vanilla core, in the same order as #tiles if given.
+ */
+static int read_counters(hb_mc_tile_counters_t **counters, size_t ntiles, int delta,
+                         const hb_mc_tile_counters_t *tiles)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        size_t n, i;
+
+        *counters = (hb_mc_tile_counters_t *) calloc(ntiles + 1, sizeof(**counters));
+        if (!*counters)
+                return HB_MC_NOMEM;
+
+        expect_err(hb_mc_manycore_get_counters(mc, *counters, ntiles, &n, delta), HB_MC_SUCCESS);
+        if (n != ntiles) {
+                test_pr_err("%zu tiles have counters, expected %zu\n", n, ntiles);
+                return HB_MC_FAIL;
+        }
+
+        for (i = 0; i < ntiles; i++) {
+                hb_mc_coordinate_t tile = (*counters)[i].tile;
+                if (!hb_mc_config_is_vanilla_core(cfg, tile)
+                    || (tiles && (hb_mc_coordinate_get_x(tile) != hb_mc_coordinate_get_x(tiles[i].tile)
+                                  || hb_mc_coordinate_get_y(tile) != hb_mc_coordinate_get_y(tiles[i].tile)))) {
+                        test_pr_err("counters %zu: unexpected tile (%d,%d)\n", i,
+                                    hb_mc_coordinate_get_x(tile), hb_mc_coordinate_get_y(tile));
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int test_counters(void)
+{
+        hb_mc_tile_counters_t *before = NULL, *delta = NULL, *after = NULL, one;
+        size_t ntiles, n, i;
+        int itype, rc = HB_MC_FAIL;
+
+        // invalid arguments
+        expect_err(hb_mc_manycore_get_counters(mc, NULL, 0, NULL, 0), HB_MC_INVALID);
+        expect_err(hb_mc_manycore_get_counters(mc, NULL, 1, &ntiles, 0), HB_MC_INVALID);
+
+        // n = 0 gets only the number of tiles
+        expect_err(hb_mc_manycore_get_counters(mc, NULL, 0, &ntiles, 0), HB_MC_SUCCESS);
+        bsg_pr_test_info(TEST_NAME ": %zu tiles have counters\n", ntiles);
+
+        // a short array gets the first tiles, and the full count
+        if (ntiles > 1) {
+                expect_err(hb_mc_manycore_get_counters(mc, &one, 1, &n, 0), HB_MC_SUCCESS);
+                if (n != ntiles) {
+                        test_pr_err("short read: %zu tiles, expected %zu\n", n, ntiles);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        // A delta is the change between two delta reads. Both fall
+        // between the absolute reads around them, so a delta can be no
+        // more than the change across those. Counters are 32 bits and
+        // wrap. A delta read of no tiles still sets the baseline.
+        if (read_counters(&before, ntiles, 0, NULL) != HB_MC_SUCCESS
+            || hb_mc_manycore_get_counters(mc, NULL, 0, &n, 1) != HB_MC_SUCCESS
+            || wait_a_while() != HB_MC_SUCCESS
+            || read_counters(&delta, ntiles, 1, before) != HB_MC_SUCCESS
+            || wait_a_while() != HB_MC_SUCCESS
+            || read_counters(&after, ntiles, 0, before) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        for (i = 0; i < ntiles; i++) {
+                for (itype = 0; itype < HB_MC_INSTR_TYPE_MAX; itype++) {
+                        uint32_t change = (uint32_t) (after[i].icount[itype] - before[i].icount[itype]);
+                        if (delta[i].icount[itype] > change) {
+                                test_pr_err("tile (%d,%d): type %d: delta %" PRIu64 " exceeds change %" PRIu32 "\n",
+                                            hb_mc_coordinate_get_x(delta[i].tile),
+                                            hb_mc_coordinate_get_y(delta[i].tile),
+                                            itype, delta[i].icount[itype], change);
+                                goto cleanup;
+                        }
+                }
+        }
+
+        rc = HB_MC_SUCCESS;
+
+cleanup:
+        free(before);
+        free(delta);
+        free(after);
+        return rc;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        rc = test_counters();
+
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
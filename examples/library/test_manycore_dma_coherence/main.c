@@ -0,0 +1,170 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_manycore_dma_coherence"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// Spans several cache blocks, so that some of them are dirty in the
+// victim cache when DMA reads DRAM.
+#define WORDS 64
+
+uint32_t out [WORDS];
+uint32_t in  [WORDS];
+
+static int compare(const char *what, const hb_mc_npa_t *npa)
+{
+        char npa_str[256];
+        int i;
+
+        for (i = 0; i < WORDS; i++) {
+                if (out[i] != in[i]) {
+                        test_pr_err("%s: %s: word %d: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                    what, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)),
+                                    i, out[i], in[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static void randomize(void)
+{
+        int i;
+
+        for (i = 0; i < WORDS; i++)
+                out[i] = (uint32_t)rand();
+        memset(in, 0, sizeof(in));
+}
+
+/*
+ * Write through the network and read back with DMA. The victim cache
+ * must be flushed by hb_mc_manycore_dma_read().
+ */
+static int test_network_to_dma(const hb_mc_npa_t *npa)
+{
+        int err;
+
+        randomize();
+
+        err = hb_mc_manycore_write_mem(mc, npa, out, sizeof(out));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to write_mem: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_dma_read(mc, npa, in, sizeof(in));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to dma_read: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        return compare("network write, DMA read", npa);
+}
+
+/*
+ * Write with DMA and read back through the network. Stale lines left
+ * in the victim cache by test_network_to_dma() must be invalidated by
+ * hb_mc_manycore_dma_write().
+ */
+static int test_dma_to_network(const hb_mc_npa_t *npa)
+{
+        int err;
+
+        randomize();
+
+        err = hb_mc_manycore_dma_write(mc, npa, out, sizeof(out));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to dma_write: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_read_mem(mc, npa, in, sizeof(in));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to read_mem: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        return compare("DMA write, network read", npa);
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        const hb_mc_config_t *cfg;
+        hb_mc_coordinate_t pod, dram;
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        if (!hb_mc_manycore_supports_dma_write(mc) ||
+            !hb_mc_manycore_supports_dma_read(mc)) {
+                bsg_pr_test_info(TEST_NAME ": DMA not supported on this platform\n");
+                rc = HB_MC_SUCCESS;
+                goto cleanup;
+        }
+
+        cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_config_foreach_pod(pod, cfg) {
+                hb_mc_config_pod_foreach_dram(dram, pod, cfg) {
+                        hb_mc_npa_t npa = hb_mc_npa(dram, 0);
+
+                        err = test_network_to_dma(&npa);
+                        if (err != HB_MC_SUCCESS)
+                                goto cleanup;
+
+                        err = test_dma_to_network(&npa);
+                        if (err != HB_MC_SUCCESS)
+                                goto cleanup;
+                }
+        }
+
+        rc = HB_MC_SUCCESS;
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,134 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_printing.h>
+
+#define TEST_NAME "test_manycore_rx_timeout"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// No kernel is running, so nothing is sent to the host and every
+// bounded receive must expire.
+#define TIMEOUT 1000
+
+/*
+ * Receive a request with a bounded timeout, and check that it expires
+ * no sooner than #TIMEOUT cycles.
+ */
+static int test_request_rx(void)
+{
+        hb_mc_request_packet_t rqst;
+        uint64_t start, end;
+        int err;
+
+        err = hb_mc_manycore_get_cycle(mc, &start);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to read cycle counter: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_request_rx(mc, &rqst, TIMEOUT);
+        if (err != HB_MC_TIMEOUT) {
+                test_pr_err("request_rx: expected %s, got %s\n",
+                            hb_mc_strerror(HB_MC_TIMEOUT), hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_manycore_get_cycle(mc, &end);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to read cycle counter: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        if (end - start < TIMEOUT) {
+                test_pr_err("request_rx: timed out after %" PRIu64 " cycles, expected at least %d\n",
+                            end - start, TIMEOUT);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int test_wait_finish(void)
+{
+        int err;
+
+        err = hb_mc_manycore_wait_finish(mc, TIMEOUT);
+        if (err != HB_MC_TIMEOUT) {
+                test_pr_err("wait_finish: expected %s, got %s\n",
+                            hb_mc_strerror(HB_MC_TIMEOUT), hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        hb_mc_request_packet_t rqst;
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        // a zero timeout polls; platforms without bounded receives say so
+        err = hb_mc_manycore_request_rx(mc, &rqst, 0);
+        if (err == HB_MC_NOIMPL) {
+                bsg_pr_test_info(TEST_NAME ": bounded receives not supported on this platform\n");
+                rc = HB_MC_SUCCESS;
+                goto cleanup;
+        }
+
+        if (err != HB_MC_TIMEOUT) {
+                test_pr_err("request_rx: expected %s, got %s\n",
+                            hb_mc_strerror(HB_MC_TIMEOUT), hb_mc_strerror(err));
+                goto cleanup;
+        }
+
+        err = test_request_rx();
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        rc = test_wait_finish();
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
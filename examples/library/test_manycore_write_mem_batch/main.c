@@ -0,0 +1,141 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_manycore_write_mem_batch"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// Not a multiple of the 256-packet transmit batch, so that the last
+// batch of write_mem and memset is partial.
+#define WORDS 1000
+
+// memset a sub-range whose ends fall inside a batch
+#define MEMSET_START 100
+#define MEMSET_WORDS 600
+#define MEMSET_VAL   0xa5
+
+uint32_t expect [WORDS];
+uint32_t in     [WORDS];
+
+static int read_and_compare(const char *what, const hb_mc_npa_t *npa)
+{
+        int i, err;
+
+        memset(in, 0, sizeof(in));
+        err = hb_mc_manycore_read_mem(mc, npa, in, sizeof(in));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("%s: failed to read_mem: %s\n", what, hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < WORDS; i++) {
+                if (expect[i] != in[i]) {
+                        test_pr_err("%s: word %d: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                    what, i, expect[i], in[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int test_write_mem(const hb_mc_npa_t *npa)
+{
+        int i, err;
+
+        for (i = 0; i < WORDS; i++)
+                expect[i] = (uint32_t)rand();
+
+        err = hb_mc_manycore_write_mem(mc, npa, expect, sizeof(expect));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to write_mem: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        return read_and_compare("write_mem", npa);
+}
+
+static int test_memset(const hb_mc_npa_t *npa)
+{
+        hb_mc_npa_t start = *npa;
+        int err;
+
+        hb_mc_npa_set_epa(&start, hb_mc_npa_get_epa(npa) + MEMSET_START * sizeof(uint32_t));
+
+        err = hb_mc_manycore_memset(mc, &start, MEMSET_VAL, MEMSET_WORDS * sizeof(uint32_t));
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to memset: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        // the words around the memset range keep the write_mem data
+        memset(&expect[MEMSET_START], MEMSET_VAL, MEMSET_WORDS * sizeof(uint32_t));
+
+        return read_and_compare("memset", npa);
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        const hb_mc_config_t *cfg;
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        hb_mc_npa_t npa;
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        cfg = hb_mc_manycore_get_config(mc);
+        npa = hb_mc_npa(hb_mc_config_pod_dram(cfg, pod, 0), 0);
+
+        err = test_write_mem(&npa);
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        rc = test_memset(&npa);
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,256 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_pc_histogram.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_pc_histogram"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+#define expect_err(call, expect)                                        \
+        do {                                                            \
+                int __r = (call);                                       \
+                if (__r != (expect)) {                                  \
+                        test_pr_err("%s: %s, expected %s\n", #call,     \
+                                    hb_mc_strerror(__r), hb_mc_strerror(expect)); \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+/* Let time pass: tiles that are running keep being sampled. */
+static int wait_a_while(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_npa_t npa = hb_mc_npa(hb_mc_config_dram(cfg, 0), 0);
+        uint32_t data = 0;
+        int i, err;
+
+        for (i = 0; i < 4; i++) {
+                err = hb_mc_manycore_write_mem(mc, &npa, &data, sizeof(data));
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Get the samples of a window into a new array, and check that they
+ * are nonzero and most frequent first.
+ */
+static int snapshot(hb_mc_pc_histogram_t *window, hb_mc_pc_sample_t **samples, size_t *n)
+{
+        size_t nsamples, i;
+
+        expect_err(hb_mc_pc_histogram_snapshot(window, NULL, 0, n), HB_MC_SUCCESS);
+
+        *samples = (hb_mc_pc_sample_t *) calloc(*n + 1, sizeof(**samples));
+        if (!*samples)
+                return HB_MC_NOMEM;
+
+        expect_err(hb_mc_pc_histogram_snapshot(window, *samples, *n, &nsamples), HB_MC_SUCCESS);
+        if (nsamples != *n) {
+                test_pr_err("window has %zu samples, then %zu\n", *n, nsamples);
+                return HB_MC_FAIL;
+        }
+
+        for (i = 0; i < *n; i++) {
+                if ((*samples)[i].count == 0
+                    || (i > 0 && (*samples)[i].count > (*samples)[i - 1].count)) {
+                        test_pr_err("sample %zu: count %" PRIu64 " is zero or out of order\n",
+                                    i, (*samples)[i].count);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int same_sample(const hb_mc_pc_sample_t *a, const hb_mc_pc_sample_t *b)
+{
+        return a->tile.x == b->tile.x && a->tile.y == b->tile.y && a->pc == b->pc;
+}
+
+/*
+ * Dump the most frequent sample of a window and check the header
+ * against a snapshot of the window.
+ */
+static int check_dump(hb_mc_pc_histogram_t *window, const hb_mc_pc_sample_t *samples, size_t n)
+{
+        char line[256], label[64];
+        uint64_t total = 0, dumped_total;
+        size_t entries, dumped_entries, lines = 0, i;
+        FILE *f;
+
+        for (i = 0; i < n; i++)
+                total += samples[i].count;
+        entries = n < 1 ? n : 1;
+
+        f = tmpfile();
+        if (!f) {
+                test_pr_err("failed to open a file for the dump\n");
+                return HB_MC_FAIL;
+        }
+
+        expect_err(hb_mc_pc_histogram_dump(window, NULL, "outer", 1, f), HB_MC_SUCCESS);
+
+        rewind(f);
+        if (!fgets(line, sizeof(line), f)
+            || sscanf(line, "window,%63[^,],%" SCNu64 ",%zu", label, &dumped_total, &dumped_entries) != 3
+            || strcmp(label, "outer") != 0
+            || dumped_total != total
+            || dumped_entries != entries) {
+                test_pr_err("bad dump header, expected window,outer,%" PRIu64 ",%zu\n", total, entries);
+                fclose(f);
+                return HB_MC_FAIL;
+        }
+
+        while (fgets(line, sizeof(line), f))
+                lines++;
+        fclose(f);
+
+        if (lines != entries) {
+                test_pr_err("dump has %zu entries, expected %zu\n", lines, entries);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int test_windows(hb_mc_pc_histogram_t *outer)
+{
+        hb_mc_pc_histogram_t *inner = NULL;
+        hb_mc_pc_sample_t *outer_samples = NULL, *inner_samples = NULL, *again = NULL;
+        size_t nouter, ninner, nagain, i, j;
+        int rc = HB_MC_FAIL;
+
+        // the inner window is open for part of the outer one
+        if (wait_a_while() != HB_MC_SUCCESS
+            || hb_mc_pc_histogram_start(mc, &inner) != HB_MC_SUCCESS
+            || wait_a_while() != HB_MC_SUCCESS
+            || hb_mc_pc_histogram_stop(inner) != HB_MC_SUCCESS
+            || wait_a_while() != HB_MC_SUCCESS
+            || hb_mc_pc_histogram_stop(outer) != HB_MC_SUCCESS
+            || hb_mc_pc_histogram_stop(outer) != HB_MC_SUCCESS) {
+                test_pr_err("failed to open and close windows\n");
+                goto cleanup;
+        }
+
+        if (snapshot(outer, &outer_samples, &nouter) != HB_MC_SUCCESS
+            || snapshot(inner, &inner_samples, &ninner) != HB_MC_SUCCESS
+            || snapshot(outer, &again, &nagain) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        bsg_pr_test_info(TEST_NAME ": outer window has %zu samples, inner window %zu\n",
+                         nouter, ninner);
+
+        // a stopped window no longer changes
+        if (nagain != nouter || memcmp(again, outer_samples, nouter * sizeof(*again)) != 0) {
+                test_pr_err("stopped window changed\n");
+                goto cleanup;
+        }
+
+        // the outer window saw every sample the inner window did
+        for (i = 0; i < ninner; i++) {
+                for (j = 0; j < nouter && !same_sample(&inner_samples[i], &outer_samples[j]); j++)
+                        ;
+                if (j == nouter || outer_samples[j].count < inner_samples[i].count) {
+                        test_pr_err("inner sample %zu: (%d,%d) pc 0x%08" PRIx32 " exceeds the outer window\n",
+                                    i, inner_samples[i].tile.x, inner_samples[i].tile.y, inner_samples[i].pc);
+                        goto cleanup;
+                }
+        }
+
+        rc = check_dump(outer, outer_samples, nouter);
+
+cleanup:
+        hb_mc_pc_histogram_release(inner);
+        free(outer_samples);
+        free(inner_samples);
+        free(again);
+        return rc;
+}
+
+static int test_pc_histogram(void)
+{
+        hb_mc_pc_histogram_t *outer = NULL;
+        size_t n;
+        int err, rc;
+
+        expect_err(hb_mc_pc_histogram_start(mc, NULL), HB_MC_INVALID);
+
+        err = hb_mc_pc_histogram_start(mc, &outer);
+        if (err == HB_MC_NOIMPL) {
+                bsg_pr_test_info(TEST_NAME ": PC histogram not supported on this platform\n");
+                return HB_MC_SUCCESS;
+        } else if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to start a window: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        if (hb_mc_pc_histogram_snapshot(outer, NULL, 1, &n) != HB_MC_INVALID
+            || hb_mc_pc_histogram_dump(outer, NULL, NULL, 0, stdout) != HB_MC_INVALID) {
+                test_pr_err("invalid arguments were accepted\n");
+                hb_mc_pc_histogram_release(outer);
+                return HB_MC_FAIL;
+        }
+
+        rc = test_windows(outer);
+        hb_mc_pc_histogram_release(outer);
+        return rc;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        rc = test_pc_histogram();
+
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
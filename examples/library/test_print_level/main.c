@@ -0,0 +1,136 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore_printing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_NAME "test_print_level"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+#define LONG_SIZE (BSG_PRINT_BUFFER_SIZE + 100)
+
+static int evaluated = 0;
+static char long_msg[LONG_SIZE + 1];
+static char expect[2 * LONG_SIZE];
+static char got[2 * LONG_SIZE];
+
+/*
+ * Print at several runtime levels, capturing stderr in a file.
+ * Returns the number of failed checks made while printing.
+ */
+static int print_messages(void)
+{
+        int failed = 0;
+
+        bsg_pr_set_level(BSG_PRINT_LEVEL_WARN);
+        // disabled levels do not evaluate their arguments
+        bsg_pr_info("%d\n", ++evaluated);
+        bsg_pr_dbg("%d\n", ++evaluated);
+        bsg_pr_warn("one\ntwo\n");
+        bsg_pr_err("partial ");
+        bsg_pr_err("line\n");
+
+        bsg_pr_set_level(BSG_PRINT_LEVEL_INFO);
+        bsg_pr_info("%s\n", "info");
+        // longer than the stack buffer
+        bsg_pr_info("%s\n", long_msg);
+
+        bsg_pr_set_level(BSG_PRINT_LEVEL_ERROR);
+        bsg_pr_warn("%d\n", ++evaluated);
+        // an explicit prefix prints regardless of level
+        bsg_pr_prefix(BSG_PRINT_PREFIX_WARN, "prefix\n");
+
+        if (bsg_pr_level(BSG_PRINT_LEVEL_DEBUG + 1, "bad level\n") >= 0)
+                failed++;
+
+        return failed;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        char path[] = "/tmp/" TEST_NAME ".XXXXXX";
+        int saved_level = bsg_pr_runtime_level;
+        int fd, saved, failed, rc = HB_MC_FAIL;
+        FILE *f;
+        size_t n;
+
+        memset(long_msg, 'a', LONG_SIZE);
+        snprintf(expect, sizeof(expect),
+                 BSG_PRINT_PREFIX_WARN "one\n"
+                 BSG_PRINT_PREFIX_WARN "two\n"
+                 BSG_PRINT_PREFIX_ERROR "partial line\n"
+                 BSG_PRINT_PREFIX_INFO "info\n"
+                 BSG_PRINT_PREFIX_INFO "%s\n"
+                 BSG_PRINT_PREFIX_WARN "prefix\n",
+                 long_msg);
+
+        fd = mkstemp(path);
+        if (fd < 0) {
+                test_pr_err("failed to create a file for stderr\n");
+                return HB_MC_FAIL;
+        }
+
+        fflush(stderr);
+        saved = dup(STDERR_FILENO);
+        dup2(fd, STDERR_FILENO);
+
+        failed = print_messages();
+
+        fflush(stderr);
+        dup2(saved, STDERR_FILENO);
+        close(saved);
+        close(fd);
+        bsg_pr_set_level(saved_level);
+
+        f = fopen(path, "r");
+        n = f ? fread(got, 1, sizeof(got) - 1, f) : 0;
+        got[n] = '\0';
+        if (f)
+                fclose(f);
+        unlink(path);
+
+        if (failed) {
+                test_pr_err("an invalid level was printed\n");
+        } else if (evaluated != 0) {
+                test_pr_err("arguments of %d disabled prints were evaluated\n", evaluated);
+        } else if (strcmp(got, expect) != 0) {
+                test_pr_err("stderr does not match: got\n%s\nexpected\n%s\n", got, expect);
+        } else {
+                rc = HB_MC_SUCCESS;
+        }
+
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
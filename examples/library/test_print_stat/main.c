@@ -0,0 +1,213 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_responder.h>
+#include <bsg_manycore_print_stat.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_print_stat"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+#define TAG_A 2
+#define TAG_B 3
+
+/*
+ * Deliver a bsg_print_stat() tag from a tile to the responders, as the
+ * receive path does for a request packet from that tile.
+ */
+static int print_stat(hb_mc_coordinate_t tile, hb_mc_print_stat_type_t type, uint32_t tag)
+{
+        hb_mc_request_packet_t rqst;
+        hb_mc_coordinate_t host = hb_mc_manycore_get_host_coordinate(mc);
+        uint32_t data = ((uint32_t) type << HB_MC_PRINT_STAT_TYPE_SHIFT)
+                | (hb_mc_coordinate_get_y(tile) << HB_MC_PRINT_STAT_Y_SHIFT)
+                | (hb_mc_coordinate_get_x(tile) << HB_MC_PRINT_STAT_X_SHIFT)
+                | (tag << HB_MC_PRINT_STAT_TAG_SHIFT);
+
+        memset(&rqst, 0, sizeof(rqst));
+        hb_mc_request_packet_set_x_src(&rqst, hb_mc_coordinate_get_x(tile));
+        hb_mc_request_packet_set_y_src(&rqst, hb_mc_coordinate_get_y(tile));
+        hb_mc_request_packet_set_x_dst(&rqst, hb_mc_coordinate_get_x(host));
+        hb_mc_request_packet_set_y_dst(&rqst, hb_mc_coordinate_get_y(host));
+        hb_mc_request_packet_set_op(&rqst, HB_MC_PACKET_OP_REMOTE_STORE);
+        hb_mc_request_packet_set_epa(&rqst, HB_MC_PRINT_STAT_EPA);
+        hb_mc_request_packet_set_data(&rqst, data);
+
+        return hb_mc_responders_respond(mc, &rqst);
+}
+
+#define start(tile, tag) print_stat(tile, HB_MC_PRINT_STAT_TYPE_START, tag)
+#define end(tile, tag)   print_stat(tile, HB_MC_PRINT_STAT_TYPE_END, tag)
+
+#define expect_err(call, expect)                                        \
+        do {                                                            \
+                int __r = (call);                                       \
+                if (__r != (expect)) {                                  \
+                        test_pr_err("%s: %s, expected %s\n", #call,     \
+                                    hb_mc_strerror(__r), hb_mc_strerror(expect)); \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+/* check the pair count of a summary, and that its cycles are consistent */
+static int check_summary(const char *what, const hb_mc_print_stat_summary_t *s, uint64_t count)
+{
+        if (s->count != count) {
+                test_pr_err("%s: %" PRIu64 " pairs, expected %" PRIu64 "\n", what, s->count, count);
+                return HB_MC_FAIL;
+        }
+
+        if (count != 0 && (s->min_cycles > s->max_cycles
+                           || s->cycles < s->min_cycles * count
+                           || s->cycles > s->max_cycles * count)) {
+                test_pr_err("%s: %" PRIu64 " cycles, min %" PRIu64 ", max %" PRIu64 " are inconsistent\n",
+                            what, s->cycles, s->min_cycles, s->max_cycles);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int check_tag(uint32_t tag, uint64_t count)
+{
+        hb_mc_print_stat_summary_t s;
+        char what[32];
+
+        expect_err(hb_mc_print_stat_get_summary(mc, tag, &s), HB_MC_SUCCESS);
+        snprintf(what, sizeof(what), "tag %" PRIu32, tag);
+        return check_summary(what, &s, count);
+}
+
+static int test_print_stat(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t a = hb_mc_config_get_origin_vcore(cfg);
+        hb_mc_coordinate_t b = hb_mc_coordinate(hb_mc_coordinate_get_x(a) + 1,
+                                                hb_mc_coordinate_get_y(a));
+        hb_mc_print_stat_summary_t s;
+        hb_mc_print_stat_kernel_t kernels[2];
+        size_t nkernels;
+        FILE *f;
+
+        expect_err(hb_mc_print_stat_reset(mc), HB_MC_SUCCESS);
+        expect_err(hb_mc_print_stat_get_summary(mc, HB_MC_PRINT_STAT_TAG_MAX, &s), HB_MC_INVALID);
+
+        // nested tags pair innermost first; an end without a start is dropped
+        expect_err(start(a, TAG_A), HB_MC_SUCCESS);
+        expect_err(start(a, TAG_A), HB_MC_SUCCESS);
+        expect_err(end(a, TAG_A), HB_MC_SUCCESS);
+        expect_err(end(a, TAG_A), HB_MC_SUCCESS);
+        expect_err(end(a, TAG_B), HB_MC_SUCCESS);
+        if (check_tag(TAG_A, 2) != HB_MC_SUCCESS || check_tag(TAG_B, 0) != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+
+        // a kernel lasts until every tile that started it has ended
+        expect_err(start(a, HB_MC_PRINT_STAT_TAG_KERNEL), HB_MC_SUCCESS);
+        expect_err(start(b, HB_MC_PRINT_STAT_TAG_KERNEL), HB_MC_SUCCESS);
+        expect_err(start(b, TAG_B), HB_MC_SUCCESS);
+        expect_err(end(b, TAG_B), HB_MC_SUCCESS);
+        expect_err(end(a, HB_MC_PRINT_STAT_TAG_KERNEL), HB_MC_SUCCESS);
+
+        expect_err(hb_mc_print_stat_get_kernels(mc, kernels, 2, &nkernels), HB_MC_SUCCESS);
+        if (nkernels != 0) {
+                test_pr_err("%zu kernels completed while a tile was running, expected 0\n", nkernels);
+                return HB_MC_FAIL;
+        }
+
+        expect_err(end(b, HB_MC_PRINT_STAT_TAG_KERNEL), HB_MC_SUCCESS);
+
+        expect_err(hb_mc_print_stat_get_kernels(mc, kernels, 2, &nkernels), HB_MC_SUCCESS);
+        if (nkernels != 1) {
+                test_pr_err("%zu kernels completed, expected 1\n", nkernels);
+                return HB_MC_FAIL;
+        }
+
+        if (kernels[0].end_cycle < kernels[0].start_cycle
+            || check_summary("kernel tiles", &kernels[0].tiles, 2) != HB_MC_SUCCESS
+            || check_summary("kernel tag A", &kernels[0].tags[TAG_A], 0) != HB_MC_SUCCESS
+            || check_summary("kernel tag B", &kernels[0].tags[TAG_B], 1) != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+
+        if (check_tag(HB_MC_PRINT_STAT_TAG_KERNEL, 2) != HB_MC_SUCCESS
+            || check_tag(TAG_A, 2) != HB_MC_SUCCESS
+            || check_tag(TAG_B, 1) != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+
+        f = tmpfile();
+        if (!f) {
+                test_pr_err("failed to open a file for the report\n");
+                return HB_MC_FAIL;
+        }
+        expect_err(hb_mc_print_stat_report(mc, f), HB_MC_SUCCESS);
+        fclose(f);
+
+        // reset discards everything
+        expect_err(hb_mc_print_stat_reset(mc), HB_MC_SUCCESS);
+        expect_err(hb_mc_print_stat_get_kernels(mc, kernels, 2, &nkernels), HB_MC_SUCCESS);
+        if (nkernels != 0) {
+                test_pr_err("%zu kernels after reset, expected 0\n", nkernels);
+                return HB_MC_FAIL;
+        }
+
+        if (check_tag(HB_MC_PRINT_STAT_TAG_KERNEL, 0) != HB_MC_SUCCESS
+            || check_tag(TAG_A, 0) != HB_MC_SUCCESS
+            || check_tag(TAG_B, 0) != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        rc = test_print_stat();
+
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,180 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_responder.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_responder_epa"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// EPAs no built-in responder listens to
+#define EPA_A 0x1230
+#define EPA_B 0x1234
+
+typedef struct {
+        int      calls;
+        uint32_t last_data;
+        uint8_t  last_x;
+} epa_count_t;
+
+static int count_request(hb_mc_manycore_t *m, const hb_mc_request_packet_t *rqst, void *arg)
+{
+        epa_count_t *count = (epa_count_t *) arg;
+        count->calls++;
+        count->last_data = hb_mc_request_packet_get_data(rqst);
+        count->last_x = hb_mc_request_packet_get_x_src(rqst);
+        return HB_MC_SUCCESS;
+}
+
+static int fail_request(hb_mc_manycore_t *m, const hb_mc_request_packet_t *rqst, void *arg)
+{
+        return HB_MC_FAIL;
+}
+
+/*
+ * Deliver a store from a tile to the responders, as the receive path
+ * does for a request packet from that tile.
+ */
+static int tile_store(hb_mc_coordinate_t tile, hb_mc_epa_t epa, uint32_t data)
+{
+        hb_mc_request_packet_t rqst;
+        hb_mc_coordinate_t host = hb_mc_manycore_get_host_coordinate(mc);
+
+        memset(&rqst, 0, sizeof(rqst));
+        hb_mc_request_packet_set_x_src(&rqst, hb_mc_coordinate_get_x(tile));
+        hb_mc_request_packet_set_y_src(&rqst, hb_mc_coordinate_get_y(tile));
+        hb_mc_request_packet_set_x_dst(&rqst, hb_mc_coordinate_get_x(host));
+        hb_mc_request_packet_set_y_dst(&rqst, hb_mc_coordinate_get_y(host));
+        hb_mc_request_packet_set_op(&rqst, HB_MC_PACKET_OP_REMOTE_STORE);
+        hb_mc_request_packet_set_epa(&rqst, epa);
+        hb_mc_request_packet_set_data(&rqst, data);
+
+        return hb_mc_responders_respond(mc, &rqst);
+}
+
+#define expect_err(call, expect)                                        \
+        do {                                                            \
+                int __r = (call);                                       \
+                if (__r != (expect)) {                                  \
+                        test_pr_err("%s: %s, expected %s\n", #call,     \
+                                    hb_mc_strerror(__r), hb_mc_strerror(expect)); \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+#define expect_count(count, n)                                          \
+        do {                                                            \
+                if ((count).calls != (n)) {                             \
+                        test_pr_err("line %d: %s called %d times, expected %d\n", \
+                                    __LINE__, #count, (count).calls, (n)); \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+static int test_epa(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t a = hb_mc_config_get_origin_vcore(cfg);
+        hb_mc_coordinate_t b = hb_mc_coordinate(hb_mc_coordinate_get_x(a) + 1,
+                                                hb_mc_coordinate_get_y(a));
+        epa_count_t count_a = {0}, count_b = {0};
+
+        expect_err(hb_mc_responder_register_epa("A", EPA_A, count_request, &count_a), HB_MC_SUCCESS);
+        expect_err(hb_mc_responder_register_epa("B", EPA_B, count_request, &count_b), HB_MC_SUCCESS);
+
+        // one registration per EPA, and it needs a function
+        expect_err(hb_mc_responder_register_epa("A again", EPA_A, count_request, &count_b), HB_MC_BUSY);
+        expect_err(hb_mc_responder_register_epa("no function", 0x1238, NULL, NULL), HB_MC_INVALID);
+
+        // requests from any tile reach the function for their EPA only
+        expect_err(tile_store(a, EPA_A, 17), HB_MC_SUCCESS);
+        expect_err(tile_store(b, EPA_A, 18), HB_MC_SUCCESS);
+        expect_err(tile_store(a, EPA_B, 19), HB_MC_SUCCESS);
+        expect_err(tile_store(a, 0x1238, 20), HB_MC_SUCCESS);
+        expect_count(count_a, 2);
+        expect_count(count_b, 1);
+        if (count_a.last_data != 18 || count_a.last_x != hb_mc_coordinate_get_x(b)) {
+                test_pr_err("EPA A saw data %" PRIu32 " from x %d, expected 18 from x %d\n",
+                            count_a.last_data, count_a.last_x, hb_mc_coordinate_get_x(b));
+                return HB_MC_FAIL;
+        }
+
+        // an unregistered EPA is no longer dispatched, and can be registered again
+        expect_err(hb_mc_responder_unregister_epa(EPA_A), HB_MC_SUCCESS);
+        expect_err(hb_mc_responder_unregister_epa(EPA_A), HB_MC_NOTFOUND);
+        expect_err(tile_store(a, EPA_A, 21), HB_MC_SUCCESS);
+        expect_count(count_a, 2);
+
+        // an error from the function is returned to the receive path
+        expect_err(hb_mc_responder_register_epa("A failing", EPA_A, fail_request, NULL), HB_MC_SUCCESS);
+        expect_err(tile_store(a, EPA_A, 22), HB_MC_FAIL);
+        expect_err(tile_store(a, EPA_B, 23), HB_MC_SUCCESS);
+        expect_count(count_b, 2);
+
+        expect_err(hb_mc_responder_unregister_epa(EPA_A), HB_MC_SUCCESS);
+        expect_err(hb_mc_responder_unregister_epa(EPA_B), HB_MC_SUCCESS);
+
+        // a responder without a respond function is rejected
+        static hb_mc_request_packet_id_t ids [] = {
+                RQST_ID( RQST_ID_ANY_X, RQST_ID_ANY_Y, RQST_ID_ADDR(EPA_A) ),
+                { /* sentinel */ },
+        };
+        static hb_mc_responder_t silent = { .name = "silent", .ids = ids };
+        expect_err(hb_mc_responder_add(&silent), HB_MC_INVALID);
+        expect_err(tile_store(a, EPA_A, 24), HB_MC_SUCCESS);
+
+        return HB_MC_SUCCESS;
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        rc = test_epa();
+
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
@@ -0,0 +1,283 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore_printing.h>
+#include <bsg_manycore_trace.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_NAME "test_trace_format"
+#define TRACE_PATH TEST_NAME ".trace"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+// Records are appended round-robin from these tiles. Every tile is
+// left with a partial block when the trace is closed, and tiles[0]
+// sorts last, so its partial block is the last one in the file.
+#define TILES   3
+#define EVENTS  31
+#define RECORDS 4
+
+static const hb_mc_coordinate_t tiles[TILES] = {
+        {.x = 3, .y = 2},
+        {.x = 0, .y = 1},
+        {.x = 2, .y = 5},
+};
+
+typedef enum {
+        CUT_NONE,  // closed normally
+        CUT_INDEX, // the index and footer are missing
+        CUT_BLOCK, // the last block is also cut short
+} cut_t;
+
+static hb_mc_trace_event_t trace_event(int i)
+{
+        hb_mc_trace_event_t ev;
+        ev.tile = tiles[i % TILES];
+        ev.kind = HB_MC_TRACE_KIND_BRANCH;
+        // pairs of records share a cycle, so ties are broken by arrival
+        ev.cycle = i / 2;
+        ev.data = 0x1000 + 0x11 * i;
+        return ev;
+}
+
+/*
+ * Whether record i should be read back from a trace.
+ */
+static int trace_kept(int i, hb_mc_trace_mode_t mode, cut_t cut)
+{
+        int t = i % TILES, rank = i / TILES;
+        int count = (EVENTS - t + TILES - 1) / TILES;
+        // the rank of the first record in this tile's last block
+        int last = (mode == HB_MC_TRACE_MODE_RING) ?
+                count - RECORDS : count - count % RECORDS;
+
+        if (mode == HB_MC_TRACE_MODE_RING && rank < last)
+                return 0;
+
+        if (cut == CUT_BLOCK && t == 0 && rank >= last)
+                return 0;
+
+        return 1;
+}
+
+static int write_trace(hb_mc_trace_mode_t mode)
+{
+        hb_mc_trace_writer_t *w;
+        int i, err, close_err;
+
+        err = hb_mc_trace_writer_open(TRACE_PATH, mode, RECORDS, &w);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to open trace writer: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < EVENTS; i++) {
+                hb_mc_trace_event_t ev = trace_event(i);
+                err = hb_mc_trace_writer_append(w, ev.tile, ev.kind, ev.cycle, ev.data);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to append record %d: %s\n",
+                                    i, hb_mc_strerror(err));
+                        break;
+                }
+        }
+
+        close_err = hb_mc_trace_writer_close(w);
+        if (err == HB_MC_SUCCESS && close_err != HB_MC_SUCCESS) {
+                test_pr_err("failed to close trace writer: %s\n", hb_mc_strerror(close_err));
+                err = close_err;
+        }
+
+        return err;
+}
+
+/*
+ * Truncate a closed trace, as if the program writing it had stopped early.
+ */
+static int cut_trace(cut_t cut)
+{
+        hb_mc_trace_footer_t footer;
+        off_t end;
+        FILE *f;
+        int ok;
+
+        f = fopen(TRACE_PATH, "rb");
+        if (!f) {
+                test_pr_err("failed to open '%s': %m\n", TRACE_PATH);
+                return HB_MC_FAIL;
+        }
+
+        ok = fseeko(f, -(off_t)sizeof(footer), SEEK_END) == 0
+                && fread(&footer, sizeof(footer), 1, f) == 1
+                && strncmp(footer.magic, HB_MC_TRACE_INDEX_MAGIC, sizeof(footer.magic)) == 0;
+        fclose(f);
+        if (!ok) {
+                test_pr_err("failed to read the footer of '%s'\n", TRACE_PATH);
+                return HB_MC_FAIL;
+        }
+
+        end = (off_t)footer.index_offset;
+        if (cut == CUT_BLOCK)
+                end -= sizeof(hb_mc_trace_record_t) / 2;
+
+        if (truncate(TRACE_PATH, end) != 0) {
+                test_pr_err("failed to truncate '%s': %m\n", TRACE_PATH);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+static int check_records(hb_mc_trace_mode_t mode, cut_t cut)
+{
+        hb_mc_trace_reader_t *r;
+        hb_mc_trace_event_t ev;
+        int i, err;
+
+        err = hb_mc_trace_reader_open(TRACE_PATH, &r);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to open trace reader: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < EVENTS; i++) {
+                hb_mc_trace_event_t expect = trace_event(i);
+                if (!trace_kept(i, mode, cut))
+                        continue;
+
+                err = hb_mc_trace_reader_next(r, &ev);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to read record %d: %s\n", i, hb_mc_strerror(err));
+                        goto close;
+                }
+
+                if (!hb_mc_coordinate_eq(ev.tile, expect.tile) || ev.kind != expect.kind
+                    || ev.cycle != expect.cycle || ev.data != expect.data) {
+                        test_pr_err("record %d: expected (%d,%d) cycle %" PRIu64 " data %08" PRIx32
+                                    ", got (%d,%d) cycle %" PRIu64 " data %08" PRIx32 "\n",
+                                    i, expect.tile.x, expect.tile.y, expect.cycle, expect.data,
+                                    ev.tile.x, ev.tile.y, ev.cycle, ev.data);
+                        err = HB_MC_FAIL;
+                        goto close;
+                }
+        }
+
+        err = hb_mc_trace_reader_next(r, &ev);
+        if (err != HB_MC_NOTFOUND) {
+                test_pr_err("trace has more records than expected\n");
+                err = HB_MC_FAIL;
+                goto close;
+        }
+        err = HB_MC_SUCCESS;
+
+close:
+        hb_mc_trace_reader_close(r);
+        return err;
+}
+
+static int check_text(hb_mc_trace_mode_t mode, cut_t cut)
+{
+        char expect[128], line[128];
+        FILE *text;
+        int i, err;
+
+        text = tmpfile();
+        if (!text) {
+                test_pr_err("failed to create a temporary file: %m\n");
+                return HB_MC_FAIL;
+        }
+
+        err = hb_mc_trace_to_text(TRACE_PATH, text);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to convert trace to text: %s\n", hb_mc_strerror(err));
+                goto close;
+        }
+
+        rewind(text);
+        for (i = 0; i < EVENTS; i++) {
+                hb_mc_trace_event_t ev = trace_event(i);
+                if (!trace_kept(i, mode, cut))
+                        continue;
+
+                snprintf(expect, sizeof(expect), "hbmc_branch_trace x=%d y=%d data=%x\n",
+                         ev.tile.x, ev.tile.y, ev.data);
+                if (!fgets(line, sizeof(line), text) || strcmp(line, expect) != 0) {
+                        test_pr_err("record %d: expected text '%s'\n", i, expect);
+                        err = HB_MC_FAIL;
+                        goto close;
+                }
+        }
+
+        if (fgets(line, sizeof(line), text)) {
+                test_pr_err("text has more lines than expected\n");
+                err = HB_MC_FAIL;
+        }
+
+close:
+        fclose(text);
+        return err;
+}
+
+static int test_trace_format(int argc, char *argv[])
+{
+        static const struct {
+                const char *name;
+                hb_mc_trace_mode_t mode;
+                cut_t cut;
+        } cases[] = {
+                {"stream",                    HB_MC_TRACE_MODE_STREAM, CUT_NONE},
+                {"stream without index",      HB_MC_TRACE_MODE_STREAM, CUT_INDEX},
+                {"stream with a cut block",   HB_MC_TRACE_MODE_STREAM, CUT_BLOCK},
+                {"ring",                      HB_MC_TRACE_MODE_RING,   CUT_NONE},
+                {"ring without index",        HB_MC_TRACE_MODE_RING,   CUT_INDEX},
+                {"ring with a cut block",     HB_MC_TRACE_MODE_RING,   CUT_BLOCK},
+        };
+        int err = HB_MC_SUCCESS;
+
+        for (size_t c = 0; c < sizeof(cases)/sizeof(cases[0]) && err == HB_MC_SUCCESS; c++) {
+                bsg_pr_test_info("Checking %s trace\n", cases[c].name);
+
+                err = write_trace(cases[c].mode);
+                if (err == HB_MC_SUCCESS && cases[c].cut != CUT_NONE)
+                        err = cut_trace(cases[c].cut);
+                if (err == HB_MC_SUCCESS)
+                        err = check_records(cases[c].mode, cases[c].cut);
+                if (err == HB_MC_SUCCESS)
+                        err = check_text(cases[c].mode, cases[c].cut);
+
+                unlink(TRACE_PATH);
+        }
+
+        return err;
+}
+
+declare_program_main(TEST_NAME, test_trace_format);
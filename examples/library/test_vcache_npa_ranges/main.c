@@ -0,0 +1,215 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NAME "test_vcache_npa_ranges"
+
+#define test_pr_err(msg, ...)                           \
+        bsg_pr_err(TEST_NAME ": " msg , ##__VA_ARGS__)
+
+hb_mc_manycore_t manycore, *mc = &manycore;
+
+// Two ranges in each DRAM bank: several whole cache blocks, and one
+// word in the middle of a block further on.
+#define RANGES_PER_BANK 2
+#define MAX_BANKS       256
+#define MAX_RANGES      (RANGES_PER_BANK * MAX_BANKS)
+#define MAX_RANGE_WORDS 64
+
+hb_mc_npa_t npas [MAX_RANGES];
+size_t      szs  [MAX_RANGES];
+uint32_t    out  [MAX_RANGES][MAX_RANGE_WORDS];
+uint32_t    in   [MAX_RANGES][MAX_RANGE_WORDS];
+
+static size_t initialize_ranges(void)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0}, dram;
+        size_t block = hb_mc_config_get_vcache_block_size(cfg);
+        size_t n = 0;
+
+        hb_mc_config_pod_foreach_dram(dram, pod, cfg) {
+                if (n + RANGES_PER_BANK > MAX_RANGES)
+                        break;
+
+                npas[n] = hb_mc_npa(dram, 0);
+                szs[n] = 3 * block;
+                if (szs[n] > sizeof(out[n]))
+                        szs[n] = sizeof(out[n]);
+                n++;
+
+                npas[n] = hb_mc_npa(dram, 64 * block + block / 2);
+                szs[n] = sizeof(uint32_t);
+                n++;
+        }
+
+        return n;
+}
+
+static void randomize(size_t n)
+{
+        size_t i, j;
+
+        for (i = 0; i < n; i++)
+                for (j = 0; j < szs[i] / sizeof(uint32_t); j++)
+                        out[i][j] = (uint32_t)rand();
+        memset(in, 0, sizeof(in));
+}
+
+static int compare(const char *what, size_t n)
+{
+        char npa_str[256];
+        size_t i, j;
+
+        for (i = 0; i < n; i++) {
+                for (j = 0; j < szs[i] / sizeof(uint32_t); j++) {
+                        if (out[i][j] != in[i][j]) {
+                                test_pr_err("%s: %s: word %zu: expected %08" PRIx32 ", got %08" PRIx32 "\n",
+                                            what, hb_mc_npa_to_string(&npas[i], npa_str, sizeof(npa_str)),
+                                            j, out[i][j], in[i][j]);
+                                return HB_MC_FAIL;
+                        }
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/*
+ * Write each range through the victim caches, flush all ranges with
+ * one call, and read DRAM directly with DMA.
+ */
+static int test_flush(size_t n)
+{
+        size_t i;
+        int err;
+
+        randomize(n);
+
+        for (i = 0; i < n; i++) {
+                err = hb_mc_manycore_write_mem(mc, &npas[i], out[i], szs[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to write_mem: %s\n", hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        err = hb_mc_manycore_vcache_flush_npa_ranges(mc, npas, szs, n);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to flush ranges: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < n; i++) {
+                err = hb_mc_manycore_dma_read_no_cache_afl(mc, &npas[i], in[i], szs[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to dma_read: %s\n", hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        return compare("flush", n);
+}
+
+/*
+ * Write DRAM directly with DMA behind the lines left in the victim
+ * caches by test_flush(), invalidate all ranges with one call, and
+ * read each range back through the victim caches.
+ */
+static int test_invalidate(size_t n)
+{
+        size_t i;
+        int err;
+
+        randomize(n);
+
+        for (i = 0; i < n; i++) {
+                err = hb_mc_manycore_dma_write_no_cache_ainv(mc, &npas[i], out[i], szs[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to dma_write: %s\n", hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        err = hb_mc_manycore_vcache_invalidate_npa_ranges(mc, npas, szs, n);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to invalidate ranges: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < n; i++) {
+                err = hb_mc_manycore_read_mem(mc, &npas[i], in[i], szs[i]);
+                if (err != HB_MC_SUCCESS) {
+                        test_pr_err("failed to read_mem: %s\n", hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        return compare("invalidate", n);
+}
+
+static int run_tests(int argc, char *argv[])
+{
+        size_t n;
+        int err, rc = HB_MC_FAIL;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                test_pr_err("failed to initialize manycore: %s\n",
+                            hb_mc_strerror(err));
+                goto done;
+        }
+
+        if (!hb_mc_manycore_supports_dma_write(mc) ||
+            !hb_mc_manycore_supports_dma_read(mc)) {
+                bsg_pr_test_info(TEST_NAME ": DMA not supported on this platform\n");
+                rc = HB_MC_SUCCESS;
+                goto cleanup;
+        }
+
+        n = initialize_ranges();
+
+        err = test_flush(n);
+        if (err != HB_MC_SUCCESS)
+                goto cleanup;
+
+        rc = test_invalidate(n);
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+done:
+        return rc;
+}
+
+declare_program_main(TEST_NAME, run_tests);
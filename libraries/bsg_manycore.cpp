@@ -45,9 +45,12 @@
 #include <cassert>
 
 #include <type_traits>
+#include <algorithm>
 #include <stack>
 #include <map>
+#include <mutex>
 #include <queue>
+#include <set>
 #include <vector>
 
 #define array_size(x)                           \
@@ -56,6 +59,9 @@
 #define sarray_size(x)                          \
         ((ssize_t)array_size(x))
 
+/* the number of store packets formatted before handing them to the platform */
+#define HB_MC_MANYCORE_TX_BATCH_MAX 256
+
 /* these are convenience macros that are only good for one line prints */
 #define manycore_pr_dbg(mc, fmt, ...)                   \
         bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
@@ -69,6 +75,17 @@
 #define manycore_pr_info(mc, fmt, ...)                  \
         bsg_pr_info("%s: " fmt, mc->name, ##__VA_ARGS__)
 
+/*
+ * The packet path (platform FIFOs, bulk transfers, DMA and outstanding
+ * request tracking) is shared by every host thread using a manycore.
+ * Entry points hold this lock for their duration; it is recursive
+ * because they call one another.
+ */
+static std::recursive_mutex &hb_mc_manycore_packet_lock(hb_mc_manycore_t *mc);
+
+#define hb_mc_manycore_packet_guard(mc)                                 \
+        std::lock_guard<std::recursive_mutex> packet_guard(hb_mc_manycore_packet_lock(mc))
+
 
 /////////////////////////////////
 /* Flow Control Help Functions */
@@ -89,6 +106,8 @@ static int hb_mc_manycore_get_remote_load_cap(hb_mc_manycore_t *mc, unsigned *ca
  */
 int hb_mc_manycore_host_request_fence(hb_mc_manycore_t *mc, long timeout)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_fence(mc, timeout);
 }
 
@@ -96,22 +115,47 @@ int hb_mc_manycore_host_request_fence(hb_mc_manycore_t *mc, long timeout)
 // Init/Exit API //
 ///////////////////
 
+/* defined with the outstanding request API below */
+static int hb_mc_manycore_requests_init(hb_mc_manycore_t *mc);
+static void hb_mc_manycore_requests_cleanup(hb_mc_manycore_t *mc);
+
+/* defined with the victim cache dirty tracking API below */
+static void hb_mc_manycore_vcache_track_requests(hb_mc_manycore_t *mc,
+                                                 const hb_mc_request_packet_t *requests,
+                                                 size_t n);
+static void hb_mc_manycore_vcache_track_tile(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile);
+static void hb_mc_manycore_vcache_dirty_npa_ranges(hb_mc_manycore_t *mc,
+                                                   const hb_mc_npa_t *npas,
+                                                   const size_t *szs,
+                                                   size_t n,
+                                                   std::vector<hb_mc_npa_t> &dirty_npas,
+                                                   std::vector<size_t> &dirty_szs);
+static void hb_mc_manycore_vcache_clean_npa_ranges(hb_mc_manycore_t *mc,
+                                                   const hb_mc_npa_t *npas,
+                                                   const size_t *szs,
+                                                   size_t n);
+static bool hb_mc_manycore_vcache_is_dirty(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram);
+static void hb_mc_manycore_vcache_clean(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram);
 
 /* initialize configuration */
 static int hb_mc_manycore_init_config(hb_mc_manycore_t *mc)
 {
         int err;
-        uintptr_t addr;
-        int idx;
         hb_mc_config_raw_t config[HB_MC_CONFIG_MAX];
 
-        for (idx = HB_MC_CONFIG_MIN; idx < HB_MC_CONFIG_MAX; idx++) {
-                err = hb_mc_platform_get_config_at(mc, idx, &config[idx]);
-                if (err != HB_MC_SUCCESS){
-                        manycore_pr_err(mc, "%s: Failed to read configuration"
-                                        " index %d\n", __func__, idx);
-                        return err;
-                }
+        err = hb_mc_platform_get_config(mc, config);
+        if (err != HB_MC_SUCCESS){
+                manycore_pr_err(mc, "%s: Failed to read configuration ROM\n",
+                                __func__);
+                return err;
+        }
+
+        // reuse the configuration decoded by an earlier run on this machine
+        const char *snapshot_dir = getenv(HB_MC_CONFIG_SNAPSHOT_DIR_ENV);
+        if (snapshot_dir && *snapshot_dir
+            && hb_mc_config_snapshot_load(snapshot_dir, config, &(mc->config)) == HB_MC_SUCCESS) {
+                manycore_pr_dbg(mc, "Initialized configuration from snapshot\n");
+                return HB_MC_SUCCESS;
         }
 
         err = hb_mc_config_init(config, &(mc->config));
@@ -124,6 +168,11 @@ static int hb_mc_manycore_init_config(hb_mc_manycore_t *mc)
 
         manycore_pr_dbg(mc, "Initialized configuration from ROM\n");
 
+        if (snapshot_dir && *snapshot_dir
+            && hb_mc_config_snapshot_save(snapshot_dir, config, &(mc->config)) != HB_MC_SUCCESS)
+                manycore_pr_warn(mc, "%s: Failed to save configuration snapshot in %s\n",
+                                 __func__, snapshot_dir);
+
         return HB_MC_SUCCESS;
 }
 
@@ -166,8 +215,16 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
                 return err;
         }
 
+        // Initialize outstanding request tracking
+        if ((err = hb_mc_manycore_requests_init(mc)) != HB_MC_SUCCESS){
+                free((void*)mc->name);
+                hb_mc_platform_cleanup(mc);
+                return err;
+        }
+
         // Initialize EVA Maps
         if ((err = hb_mc_manycore_eva_init(mc)) != HB_MC_SUCCESS){
+                hb_mc_manycore_requests_cleanup(mc);
                 free((void*)mc->name);
                 hb_mc_platform_cleanup(mc);
                 return err;
@@ -175,6 +232,8 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
 
         // initialize responders
         if ((err = hb_mc_responders_init(mc))){
+                hb_mc_manycore_eva_cleanup(mc);
+                hb_mc_manycore_requests_cleanup(mc);
                 hb_mc_platform_cleanup(mc);
                 free((void*)mc->name);
                 return err;
@@ -182,6 +241,8 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
 
         // wait for reset to complete
         if ((err = hb_mc_platform_wait_reset_done(mc)) != HB_MC_SUCCESS) {
+                hb_mc_manycore_eva_cleanup(mc);
+                hb_mc_manycore_requests_cleanup(mc);
                 hb_mc_platform_cleanup(mc);
                 free((void*)mc->name);
                 return err;
@@ -189,6 +250,8 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
 
         // enable dram
         if ((err = hb_mc_manycore_enable_dram(mc)) != HB_MC_SUCCESS){
+                hb_mc_manycore_eva_cleanup(mc);
+                hb_mc_manycore_requests_cleanup(mc);
                 hb_mc_platform_cleanup(mc);
                 free((void*)mc->name);
                 return err;
@@ -196,6 +259,8 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
 
         // initialize vcaches
         if ((err = hb_mc_manycore_vcache_init(mc)) != HB_MC_SUCCESS) {
+                hb_mc_manycore_eva_cleanup(mc);
+                hb_mc_manycore_requests_cleanup(mc);
                 hb_mc_platform_cleanup(mc);
                 free((void*)mc->name);
                 return err;
@@ -203,6 +268,8 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
 
         // initialize dma
         if ((err = hb_mc_dma_init(mc)) != HB_MC_SUCCESS) {
+                hb_mc_manycore_eva_cleanup(mc);
+                hb_mc_manycore_requests_cleanup(mc);
                 hb_mc_platform_cleanup(mc);
                 free((void*)mc->name);
                 return err;
@@ -224,6 +291,8 @@ int hb_mc_manycore_exit(hb_mc_manycore_t *mc)
                            __func__, hb_mc_strerror(err));
                 return err;
         }
+        hb_mc_manycore_eva_cleanup(mc);
+        hb_mc_manycore_requests_cleanup(mc);
         hb_mc_platform_cleanup(mc);
         free((void*)mc->name);
         return HB_MC_SUCCESS;
@@ -238,6 +307,8 @@ int hb_mc_manycore_exit(hb_mc_manycore_t *mc)
  */
 int hb_mc_manycore_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         if(time == nullptr){
                 bsg_pr_err("%s: Nullptr provided as argument time\n",
                            __func__);
@@ -255,28 +326,54 @@ int hb_mc_manycore_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
  * Transmit a request packet to manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A request packet to transmit to manycore hardware
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_request_tx(hb_mc_manycore_t *mc,
                               hb_mc_request_packet_t *request,
                               long timeout)
 {
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_vcache_track_requests(mc, request, 1);
+
         /* send the request packet */
         return hb_mc_platform_transmit(mc, (hb_mc_packet_t*)request, HB_MC_FIFO_TX_REQ, timeout);
 }
 
+/**
+ * Transmit a batch of request packets to manycore hardware, in order
+ * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] requests An array of #n request packets to transmit to manycore hardware
+ * @param[in] n        The number of packets in #requests
+ * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_request_tx_batch(hb_mc_manycore_t *mc,
+                                    hb_mc_request_packet_t *requests,
+                                    size_t n,
+                                    long timeout)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_vcache_track_requests(mc, requests, n);
+
+        return hb_mc_platform_transmit_batch(mc, (hb_mc_packet_t*)requests, n, HB_MC_FIFO_TX_REQ, timeout);
+}
+
 /**
  * Receive a response packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response A packet into which data should be read
- * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_response_rx(hb_mc_manycore_t *mc,
                                hb_mc_response_packet_t *response,
                                long timeout)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         /* receive the response packet */
         return hb_mc_platform_receive(mc, (hb_mc_packet_t*)response, HB_MC_FIFO_RX_RSP, timeout);
 }
@@ -285,13 +382,15 @@ int hb_mc_manycore_response_rx(hb_mc_manycore_t *mc,
  * Transmit a response packet to manycore hardware
  * @param[in] mc        A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response  A response packet to transmit to manycore hardware
- * @param[in] timeout   A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout   A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_response_tx(hb_mc_manycore_t *mc,
                                hb_mc_response_packet_t *response,
                                long timeout)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_transmit(mc, (hb_mc_packet_t*)response, HB_MC_FIFO_TX_RSP, timeout);
 }
 
@@ -299,18 +398,28 @@ int hb_mc_manycore_response_tx(hb_mc_manycore_t *mc,
  * Receive a request packet from manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A packet into which data should be read
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_request_rx(hb_mc_manycore_t *mc,
                               hb_mc_request_packet_t *request,
                               long timeout)
 {
+        // Held across the platform's wait as well: the simulated
+        // platforms advance the clock while they wait, and must not
+        // be driven by two threads at once. Callers that share #mc
+        // bound the wait instead.
+        hb_mc_manycore_packet_guard(mc);
+
         int err;
         err = hb_mc_platform_receive(mc, (hb_mc_packet_t*)request, HB_MC_FIFO_RX_REQ, timeout);
         if (err != HB_MC_SUCCESS)
                 return err;
 
+        // a tile that sends requests is running, and may be writing to DRAM
+        hb_mc_manycore_vcache_track_tile(mc, hb_mc_coordinate(hb_mc_request_packet_get_x_src(request),
+                                                              hb_mc_request_packet_get_y_src(request)));
+
         err = hb_mc_responders_respond(mc, request);
         if (err != HB_MC_SUCCESS) {
                 char request_str[64];
@@ -326,7 +435,7 @@ int hb_mc_manycore_request_rx(hb_mc_manycore_t *mc,
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] packet  A packet to transmit to manycore hardware
  * @param[in] type    Is this packet a request or response packet?
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_packet_tx(hb_mc_manycore_t *mc,
@@ -348,7 +457,7 @@ int hb_mc_manycore_packet_tx(hb_mc_manycore_t *mc,
  * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] packet A packet into which data should be read
  * @param[in] type   Is this packet a request or response packet?
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_packet_rx(hb_mc_manycore_t *mc,
@@ -368,9 +477,10 @@ int hb_mc_manycore_packet_rx(hb_mc_manycore_t *mc,
 /**
  * Wait for a finish packet from the Manycore instance. 
  * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
  * @return HB_MC_SUCCESS on packet that writes to HB_MC_HOST_EPA_FINISH, 
- *         HB_MC_FAIL on a packet that writes to HB_MC_HOST_EPA_FAIL or underlying failure, 
+ *         HB_MC_FAIL on a packet that writes to HB_MC_HOST_EPA_FAIL or underlying failure,
+ *         HB_MC_TIMEOUT if #timeout expired, 
  *         HB_MC_INVALID otherwise.
  */
 int hb_mc_manycore_wait_finish(hb_mc_manycore_t *mc,
@@ -379,10 +489,14 @@ int hb_mc_manycore_wait_finish(hb_mc_manycore_t *mc,
         hb_mc_packet_t packet;
         hb_mc_epa_t epa;
         int err;
-        err = hb_mc_manycore_packet_rx(mc, &packet, HB_MC_FIFO_RX_REQ, -1);
+        err = hb_mc_manycore_packet_rx(mc, &packet, HB_MC_FIFO_RX_REQ, timeout);
+        if (err == HB_MC_TIMEOUT)
+                return err;
+
         if(err != HB_MC_SUCCESS){
                 manycore_pr_err(mc, "%s: Failed to receive request packet: %s\n",
                                 __func__, hb_mc_strerror(err));
+                return err;
         }
 
         epa = hb_mc_request_packet_get_epa(&packet.request);
@@ -476,72 +590,99 @@ static int hb_mc_manycore_format_cache_op_request_packet(hb_mc_manycore_t *mc,
 /************************/
 
 /**
- * Apply cache operation to NPA
- * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t (must map to DRAM) - start of the range to invalidate
- * @param[in]  sz     The size of the range to invalidate in bytes
+ * Apply cache operation to a list of NPA ranges
+ *
+ * One request is sent for each cache line in each range. Requests are
+ * formatted in chunks and handed to the platform as a batch.
+ *
+ * @param[in]  mc        A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas      An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range
+ * @param[in]  szs       An array of #n sizes in bytes, one for each range
+ * @param[in]  n         The number of ranges
+ * @param[in]  cache_op  The cache operation to apply to each line
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-static
-int hb_mc_manycore_vcache_apply_to_npa(hb_mc_manycore_t *mc,
-                                       const hb_mc_npa_t *npa,
-                                       hb_mc_packet_cache_op_t cache_op)
+static int hb_mc_manycore_vcache_apply_to_npa_ranges(hb_mc_manycore_t *mc,
+                                                     const hb_mc_npa_t *npas,
+                                                     const size_t *szs,
+                                                     size_t n,
+                                                     hb_mc_packet_cache_op_t cache_op)
 {
         if (!hb_mc_manycore_has_cache(mc))
                 return HB_MC_SUCCESS;
 
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        ssize_t bsize = static_cast<ssize_t>(hb_mc_config_get_vcache_block_size(cfg));
+        hb_mc_request_packet_t pkts[HB_MC_MANYCORE_TX_BATCH_MAX];
+        size_t npkts = 0;
         int err;
-        hb_mc_request_packet_t pkt;
 
-        if ((err = hb_mc_manycore_format_cache_op_request_packet(mc, &pkt, npa, cache_op)))
-                return err;
+        for (size_t r = 0; r < n; r++) {
+                hb_mc_epa_t epa = hb_mc_npa_get_epa(&npas[r]);
+                ssize_t sz = static_cast<ssize_t>(szs[r]);
+
+                // align npa to closest cache line
+                sz += (epa & (bsize - 1));
+                epa &= -bsize;
+
+                // until we've applied op the entire range...
+                while (sz > 0) {
+                        // apply op to line address
+                        hb_mc_npa_t line_npa = npas[r];
+                        hb_mc_npa_set_epa(&line_npa, epa);
+
+                        err = hb_mc_manycore_format_cache_op_request_packet(mc, &pkts[npkts++], &line_npa, cache_op);
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+
+                        // send a full batch
+                        if (npkts == HB_MC_MANYCORE_TX_BATCH_MAX) {
+                                err = hb_mc_manycore_request_tx_batch(mc, pkts, npkts, -1);
+                                if (err != HB_MC_SUCCESS) {
+                                        manycore_pr_err(mc, "%s: Failed to send request packets: %s\n",
+                                                        __func__, hb_mc_strerror(err));
+                                        return err;
+                                }
+                                npkts = 0;
+                        }
+
+                        // next line
+                        sz -= std::min(sz, bsize);
+                        epa += bsize;
+                }
+        }
 
-        err = hb_mc_manycore_request_tx(mc, &pkt, -1);
+        err = hb_mc_manycore_request_tx_batch(mc, pkts, npkts, -1);
         if (err != HB_MC_SUCCESS) {
-                manycore_pr_err(mc, "%s: Failed to send request packet: %s\n",
+                manycore_pr_err(mc, "%s: Failed to send request packets: %s\n",
                                 __func__, hb_mc_strerror(err));
         }
 
-        return HB_MC_SUCCESS;
+        return err;
 }
 
 /**
- * Apply cache operation to a range of NPAs
+ * Invalidate a list of ranges of manycore DRAM addresses.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t (must map to DRAM) - start of the range to invalidate
- * @param[in]  sz     The size of the range to invalidate in bytes
+ * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range to invalidate
+ * @param[in]  szs    An array of #n sizes in bytes, one for each range
+ * @param[in]  n      The number of ranges
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-static int hb_mc_manycore_vcache_apply_to_npa_range(hb_mc_manycore_t *mc,
-                                                    const hb_mc_npa_t *npa,
-                                                    size_t range_sz,
-                                                    hb_mc_packet_cache_op_t cache_op)
+int hb_mc_manycore_vcache_invalidate_npa_ranges(hb_mc_manycore_t *mc,
+                                                const hb_mc_npa_t *npas,
+                                                const size_t *szs,
+                                                size_t n)
 {
-        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
-        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
-        ssize_t sz = static_cast<ssize_t>(range_sz);
-        ssize_t bsize = static_cast<ssize_t>(hb_mc_config_get_vcache_block_size(cfg));
-        int err;
-
-        // align npa to closest cache line
-        sz += (epa & (bsize - 1));
-        epa &= -bsize;
-
-        // until we've applied op the entire range...
-        while (sz > 0) {
-                // apply op to line address
-                hb_mc_npa_t line_npa = *npa;
-                hb_mc_npa_set_epa(&line_npa, epa);
-
-                err = hb_mc_manycore_vcache_apply_to_npa(mc, npa, cache_op);
-                if (err != HB_MC_SUCCESS)
-                        return err;
+        hb_mc_manycore_packet_guard(mc);
 
-                // next line
-                sz -= std::min(sz, bsize);
-                epa += bsize;
-        }
+        int err;
+        err = hb_mc_manycore_vcache_apply_to_npa_ranges(mc, npas, szs, n,
+                                                        HB_MC_PACKET_CACHE_OP_AINV);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
+        hb_mc_manycore_vcache_clean_npa_ranges(mc, npas, szs, n);
         return HB_MC_SUCCESS;
 }
 
@@ -556,33 +697,69 @@ int hb_mc_manycore_vcache_invalidate_npa_range(hb_mc_manycore_t *mc,
                                                const hb_mc_npa_t *npa,
                                                size_t sz)
 {
-        return hb_mc_manycore_vcache_apply_to_npa_range(mc, npa, sz,
-                                                        HB_MC_PACKET_CACHE_OP_AINV);
+        return hb_mc_manycore_vcache_invalidate_npa_ranges(mc, npa, &sz, 1);
 }
 
 /**
- * Flush a range of manycore DRAM addresses.
+ * Flush a list of ranges of manycore DRAM addresses.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t (must map to DRAM) - start of the range to flush
- * @param[in]  sz     The size of the range to flush in bytes
+ * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range to flush
+ * @param[in]  szs    An array of #n sizes in bytes, one for each range
+ * @param[in]  n      The number of ranges
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-int hb_mc_manycore_vcache_flush_npa_range(hb_mc_manycore_t *mc,
-                                          const hb_mc_npa_t *npa,
-                                          size_t sz)
+int hb_mc_manycore_vcache_flush_npa_ranges(hb_mc_manycore_t *mc,
+                                           const hb_mc_npa_t *npas,
+                                           const size_t *szs,
+                                           size_t n)
 {
         if (!hb_mc_manycore_has_cache(mc))
                 return HB_MC_SUCCESS;
 
+        hb_mc_manycore_packet_guard(mc);
+
+        // only the parts of each range that may be dirty need flushing
+        std::vector<hb_mc_npa_t> dirty_npas;
+        std::vector<size_t> dirty_szs;
+        hb_mc_manycore_vcache_dirty_npa_ranges(mc, npas, szs, n, dirty_npas, dirty_szs);
+        if (dirty_npas.empty())
+                return HB_MC_SUCCESS;
+
         int err;
-        err = hb_mc_manycore_vcache_apply_to_npa_range(mc, npa, sz,
-                                                       HB_MC_PACKET_CACHE_OP_AFL);
+        err = hb_mc_manycore_vcache_apply_to_npa_ranges(mc, dirty_npas.data(), dirty_szs.data(),
+                                                        dirty_npas.size(), HB_MC_PACKET_CACHE_OP_AFL);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        // read a single word from cache - when it completes, assume flush is done
-        uint32_t dummy;
-        return hb_mc_manycore_read32(mc, npa, &dummy);
+        // read a single word from each cache that was flushed
+        // when it completes, assume flush is done
+        std::set<std::pair<hb_mc_idx_t, hb_mc_idx_t>> caches;
+        for (const hb_mc_npa_t &npa : dirty_npas) {
+                if (!caches.emplace(hb_mc_npa_get_x(&npa), hb_mc_npa_get_y(&npa)).second)
+                        continue;
+
+                uint32_t dummy;
+                err = hb_mc_manycore_read32(mc, &npa, &dummy);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        hb_mc_manycore_vcache_clean_npa_ranges(mc, dirty_npas.data(), dirty_szs.data(), dirty_npas.size());
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Flush a range of manycore DRAM addresses.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t (must map to DRAM) - start of the range to flush
+ * @param[in]  sz     The size of the range to flush in bytes
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_vcache_flush_npa_range(hb_mc_manycore_t *mc,
+                                          const hb_mc_npa_t *npa,
+                                          size_t sz)
+{
+        return hb_mc_manycore_vcache_flush_npa_ranges(mc, npa, &sz, 1);
 }
 
 int hb_mc_manycore_vcache_flush_tag(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa)
@@ -638,7 +815,9 @@ static int hb_mc_manycore_pod_apply_to_vcache(hb_mc_manycore_t *mc, hb_mc_coordi
  */
 int hb_mc_manycore_pod_invalidate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
 {
-        return hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
+        hb_mc_manycore_packet_guard(mc);
+
+        int err = hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
                         // write way_id (no valid bit)
                         char npa_str [256];
                         manycore_pr_dbg(mc, "Invalidating vcache tag @ %s\n",
@@ -646,6 +825,15 @@ int hb_mc_manycore_pod_invalidate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_
 
                         return hb_mc_manycore_write32(mc, way_addr, 0);
                 });
+
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_coordinate_t dram;
+        hb_mc_config_pod_foreach_dram(dram, pod, &mc->config) {
+                hb_mc_manycore_vcache_clean(mc, dram);
+        }
+        return HB_MC_SUCCESS;
 }
 
 /**
@@ -674,21 +862,43 @@ int hb_mc_manycore_pod_flush_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod
         if (!hb_mc_manycore_has_cache(mc))
                 return HB_MC_SUCCESS;
 
-        int err = hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
-                        // flush tag
-                        char npa_str[256];
-                        manycore_pr_dbg(mc, "Flushing vcach tag @ %s\n",
-                                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)));
-                        return hb_mc_manycore_vcache_flush_tag(mc, way_addr);
-                });
+        hb_mc_manycore_packet_guard(mc);
 
-        if (err != HB_MC_SUCCESS)
-                return err;
-
-        // read a word from each cache
+        // skip caches that hold no dirty lines
+        std::vector<hb_mc_epa_t> cache_ids;
         hb_mc_coordinate_t dram;
         hb_mc_config_pod_foreach_dram(dram, pod, &mc->config) {
-                hb_mc_epa_t cache_id = static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram));
+                if (hb_mc_manycore_vcache_is_dirty(mc, dram))
+                        cache_ids.push_back(static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram)));
+        }
+
+        if (cache_ids.empty()) {
+                manycore_pr_dbg(mc, "%s: vcaches in pod (%" PRIu32 ",%" PRIu32 ") are clean\n",
+                                __func__, pod.x, pod.y);
+                return HB_MC_SUCCESS;
+        }
+
+        hb_mc_epa_t ways = hb_mc_vcache_num_ways(mc);
+        hb_mc_epa_t sets = hb_mc_vcache_num_sets(mc);
+        int err;
+
+        for (hb_mc_epa_t way_id = 0; way_id < ways; way_id++) {
+                for (hb_mc_epa_t set_id = 0; set_id < sets; set_id++) {
+                        for (hb_mc_epa_t cache_id : cache_ids) {
+                                // flush tag
+                                char npa_str[256];
+                                hb_mc_npa_t way_addr = hb_mc_vcache_way_npa(mc, cache_id, set_id, way_id);
+                                manycore_pr_dbg(mc, "Flushing vcach tag @ %s\n",
+                                                hb_mc_npa_to_string(&way_addr, npa_str, sizeof(npa_str)));
+                                err = hb_mc_manycore_vcache_flush_tag(mc, &way_addr);
+                                if (err != HB_MC_SUCCESS)
+                                        return err;
+                        }
+                }
+        }
+
+        // read a word from each cache
+        for (hb_mc_epa_t cache_id : cache_ids) {
                 hb_mc_npa_t way_addr = hb_mc_vcache_way_npa(mc, cache_id, 0, 0);
                 hb_mc_npa_set_epa(&way_addr, 0);
                 uint32_t dummy;
@@ -696,6 +906,10 @@ int hb_mc_manycore_pod_flush_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod
                 if (err != HB_MC_SUCCESS)
                         return err;
         }
+
+        hb_mc_config_pod_foreach_dram(dram, pod, &mc->config) {
+                hb_mc_manycore_vcache_clean(mc, dram);
+        }
         return HB_MC_SUCCESS;
 }
 
@@ -751,6 +965,319 @@ int hb_mc_manycore_flush_vcache(hb_mc_manycore_t *mc)
         return HB_MC_SUCCESS;
 }
 
+/////////////////////////////////////
+// Victim Cache Dirty Tracking API //
+/////////////////////////////////////
+
+/*
+ * The host tracks which DRAM ranges each victim cache may hold dirty
+ * lines for, so that flushes of clean caches and ranges can be skipped.
+ * Host stores to DRAM mark the range they write. Kernels may write
+ * anywhere, so a host store to a tile, or a request from a tile, marks
+ * every cache in the tile's pod dirty. Flushes and invalidates mark the
+ * ranges they cover clean.
+ *
+ * Ranges are [start, end) EPAs, kept sorted and disjoint.
+ */
+typedef std::map<uint64_t, uint64_t> hb_mc_manycore_dirty_ranges_t;
+
+/* dirty ranges, by victim cache id */
+typedef std::map<hb_mc_idx_t, hb_mc_manycore_dirty_ranges_t> hb_mc_manycore_dirty_map_t;
+
+/* defined with the outstanding request API below */
+static hb_mc_manycore_dirty_map_t &hb_mc_manycore_get_dirty(hb_mc_manycore_t *mc);
+
+/* one past the last EPA that maps to DRAM */
+static const uint64_t hb_mc_manycore_dirty_epa_end = HB_MC_VCACHE_EPA_OFFSET_TAG;
+
+static void hb_mc_manycore_dirty_ranges_add(hb_mc_manycore_dirty_ranges_t &ranges,
+                                            uint64_t lo, uint64_t hi)
+{
+        // merge with a range that overlaps or abuts from below
+        auto it = ranges.upper_bound(lo);
+        if (it != ranges.begin()) {
+                auto prev = std::prev(it);
+                if (prev->second >= lo) {
+                        lo = prev->first;
+                        hi = std::max(hi, prev->second);
+                        it = ranges.erase(prev);
+                }
+        }
+
+        // merge with ranges that start inside [lo, hi]
+        while (it != ranges.end() && it->first <= hi) {
+                hi = std::max(hi, it->second);
+                it = ranges.erase(it);
+        }
+
+        ranges[lo] = hi;
+}
+
+static void hb_mc_manycore_dirty_ranges_remove(hb_mc_manycore_dirty_ranges_t &ranges,
+                                               uint64_t lo, uint64_t hi)
+{
+        // split a range that starts below lo
+        auto it = ranges.upper_bound(lo);
+        if (it != ranges.begin()) {
+                auto prev = std::prev(it);
+                uint64_t start = prev->first, end = prev->second;
+                if (end > lo) {
+                        ranges.erase(prev);
+                        if (start < lo)
+                                ranges[start] = lo;
+                        if (end > hi)
+                                ranges[hi] = end;
+                }
+        }
+
+        // trim ranges that start inside [lo, hi)
+        it = ranges.lower_bound(lo);
+        while (it != ranges.end() && it->first < hi) {
+                uint64_t end = it->second;
+                it = ranges.erase(it);
+                if (end > hi) {
+                        ranges[hi] = end;
+                        break;
+                }
+        }
+}
+
+static hb_mc_manycore_dirty_ranges_t *hb_mc_manycore_vcache_get_dirty(hb_mc_manycore_t *mc,
+                                                                      hb_mc_coordinate_t dram)
+{
+        hb_mc_manycore_dirty_map_t &dirty = hb_mc_manycore_get_dirty(mc);
+        auto it = dirty.find(hb_mc_config_dram_id(&mc->config, dram));
+        return it == dirty.end() ? nullptr : &it->second;
+}
+
+static void hb_mc_manycore_vcache_mark_dirty(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram,
+                                             uint64_t lo, uint64_t hi)
+{
+        hb_mc_manycore_dirty_map_t &dirty = hb_mc_manycore_get_dirty(mc);
+        hb_mc_manycore_dirty_ranges_add(dirty[hb_mc_config_dram_id(&mc->config, dram)],
+                                        lo, std::min(hi, hb_mc_manycore_dirty_epa_end));
+}
+
+static void hb_mc_manycore_vcache_mark_clean(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram,
+                                             uint64_t lo, uint64_t hi)
+{
+        hb_mc_manycore_dirty_map_t &dirty = hb_mc_manycore_get_dirty(mc);
+        auto it = dirty.find(hb_mc_config_dram_id(&mc->config, dram));
+        if (it == dirty.end())
+                return;
+
+        hb_mc_manycore_dirty_ranges_remove(it->second, lo, hi);
+        if (it->second.empty())
+                dirty.erase(it);
+}
+
+/* check if a victim cache may hold dirty lines */
+static bool hb_mc_manycore_vcache_is_dirty(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram)
+{
+        return hb_mc_manycore_vcache_get_dirty(mc, dram) != nullptr;
+}
+
+/* mark a victim cache clean */
+static void hb_mc_manycore_vcache_clean(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram)
+{
+        hb_mc_manycore_dirty_map_t &dirty = hb_mc_manycore_get_dirty(mc);
+        dirty.erase(hb_mc_config_dram_id(&mc->config, dram));
+}
+
+/* tiles in a pod are running: they may write to any DRAM address through the pod's caches */
+static void hb_mc_manycore_vcache_track_pod(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t dram;
+        hb_mc_config_pod_foreach_dram(dram, pod, cfg) {
+                hb_mc_manycore_dirty_ranges_t *ranges = hb_mc_manycore_vcache_get_dirty(mc, dram);
+                // the common case: already marked
+                if (ranges != nullptr && ranges->size() == 1
+                    && ranges->begin()->first == 0
+                    && ranges->begin()->second == hb_mc_manycore_dirty_epa_end)
+                        continue;
+
+                hb_mc_manycore_vcache_mark_dirty(mc, dram, 0, hb_mc_manycore_dirty_epa_end);
+        }
+}
+
+static void hb_mc_manycore_vcache_track_tile(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        if (!hb_mc_manycore_has_cache(mc) || !hb_mc_config_is_vanilla_core(cfg, tile))
+                return;
+
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_vcache_track_pod(mc, hb_mc_config_pod(cfg, tile));
+}
+
+/* update dirty ranges for request packets the host is about to send */
+static void hb_mc_manycore_vcache_track_requests(hb_mc_manycore_t *mc,
+                                                 const hb_mc_request_packet_t *requests,
+                                                 size_t n)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        if (!hb_mc_manycore_has_cache(mc))
+                return;
+
+        // stores to consecutive words of a cache are merged into one range
+        bool run = false;
+        hb_mc_coordinate_t run_dram = hb_mc_coordinate(0, 0);
+        uint64_t run_lo = 0, run_hi = 0;
+
+        // stores to tiles are usually to one pod
+        hb_mc_coordinate_t tracked_pod = hb_mc_coordinate(0, 0);
+        bool tracked = false;
+
+        for (size_t i = 0; i < n; i++) {
+                const hb_mc_request_packet_t *rqst = &requests[i];
+                uint8_t op = hb_mc_request_packet_get_op(rqst);
+                if (op == HB_MC_PACKET_OP_REMOTE_LOAD || op == HB_MC_PACKET_OP_CACHE_OP)
+                        continue;
+
+                hb_mc_coordinate_t dst = hb_mc_coordinate(hb_mc_request_packet_get_x_dst(rqst),
+                                                          hb_mc_request_packet_get_y_dst(rqst));
+
+                if (!hb_mc_config_is_dram(cfg, dst)) {
+                        // a store to a tile can start a kernel
+                        if (!hb_mc_config_is_vanilla_core(cfg, dst))
+                                continue;
+
+                        hb_mc_coordinate_t pod = hb_mc_config_pod(cfg, dst);
+                        if (!tracked || pod.x != tracked_pod.x || pod.y != tracked_pod.y) {
+                                hb_mc_manycore_vcache_track_pod(mc, pod);
+                                tracked_pod = pod;
+                                tracked = true;
+                        }
+                        continue;
+                }
+
+                // tags and control registers are not cached
+                uint64_t epa = hb_mc_request_packet_get_epa(rqst);
+                if (epa >= hb_mc_manycore_dirty_epa_end)
+                        continue;
+
+                if (run && dst.x == run_dram.x && dst.y == run_dram.y
+                    && epa >= run_lo && epa <= run_hi) {
+                        run_hi = std::max(run_hi, epa + sizeof(uint32_t));
+                        continue;
+                }
+
+                if (run)
+                        hb_mc_manycore_vcache_mark_dirty(mc, run_dram, run_lo, run_hi);
+
+                run = true;
+                run_dram = dst;
+                run_lo = epa;
+                run_hi = epa + sizeof(uint32_t);
+        }
+
+        if (run)
+                hb_mc_manycore_vcache_mark_dirty(mc, run_dram, run_lo, run_hi);
+}
+
+/* find the parts of a list of DRAM ranges that may be dirty */
+static void hb_mc_manycore_vcache_dirty_npa_ranges(hb_mc_manycore_t *mc,
+                                                   const hb_mc_npa_t *npas,
+                                                   const size_t *szs,
+                                                   size_t n,
+                                                   std::vector<hb_mc_npa_t> &dirty_npas,
+                                                   std::vector<size_t> &dirty_szs)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        for (size_t r = 0; r < n; r++) {
+                hb_mc_manycore_dirty_ranges_t *ranges =
+                        hb_mc_manycore_vcache_get_dirty(mc, hb_mc_npa_get_xy(&npas[r]));
+                if (ranges == nullptr || szs[r] == 0)
+                        continue;
+
+                uint64_t lo = hb_mc_npa_get_epa(&npas[r]);
+                uint64_t hi = lo + szs[r];
+
+                auto it = ranges->upper_bound(lo);
+                if (it != ranges->begin())
+                        it = std::prev(it);
+
+                for (; it != ranges->end() && it->first < hi; it++) {
+                        uint64_t start = std::max(lo, it->first);
+                        uint64_t end = std::min(hi, it->second);
+                        if (start >= end)
+                                continue;
+
+                        hb_mc_npa_t npa = npas[r];
+                        hb_mc_npa_set_epa(&npa, static_cast<hb_mc_epa_t>(start));
+                        dirty_npas.push_back(npa);
+                        dirty_szs.push_back(static_cast<size_t>(end - start));
+                }
+        }
+}
+
+/* mark a list of DRAM ranges clean */
+static void hb_mc_manycore_vcache_clean_npa_ranges(hb_mc_manycore_t *mc,
+                                                   const hb_mc_npa_t *npas,
+                                                   const size_t *szs,
+                                                   size_t n)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        for (size_t r = 0; r < n; r++) {
+                uint64_t lo = hb_mc_npa_get_epa(&npas[r]);
+                hb_mc_manycore_vcache_mark_clean(mc, hb_mc_npa_get_xy(&npas[r]), lo, lo + szs[r]);
+        }
+}
+
+/**
+ * Mark a list of ranges of manycore DRAM addresses as possibly dirty in the victim caches.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range
+ * @param[in]  szs    An array of #n sizes in bytes, one for each range
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_vcache_mark_dirty_npa_ranges(hb_mc_manycore_t *mc,
+                                                const hb_mc_npa_t *npas,
+                                                const size_t *szs,
+                                                size_t n)
+{
+        if (!hb_mc_manycore_has_cache(mc))
+                return HB_MC_SUCCESS;
+
+        hb_mc_manycore_packet_guard(mc);
+
+        for (size_t r = 0; r < n; r++) {
+                if (!hb_mc_config_is_dram(&mc->config, hb_mc_npa_get_xy(&npas[r])))
+                        return HB_MC_INVALID;
+
+                uint64_t lo = hb_mc_npa_get_epa(&npas[r]);
+                hb_mc_manycore_vcache_mark_dirty(mc, hb_mc_npa_get_xy(&npas[r]), lo, lo + szs[r]);
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Mark every victim cache in a pod as possibly dirty.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  pod    A pod
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_pod_vcache_mark_dirty(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+{
+        if (!hb_mc_manycore_has_cache(mc))
+                return HB_MC_SUCCESS;
+
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_coordinate_t dram;
+        hb_mc_config_pod_foreach_dram(dram, pod, &mc->config) {
+                hb_mc_manycore_vcache_mark_dirty(mc, dram, 0, hb_mc_manycore_dirty_epa_end);
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 
 ////////////////
 // Memory API //
@@ -812,16 +1339,20 @@ static int hb_mc_manycore_send_read_rqst(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
-/* read a response packet for a read request to an npa */
+/* read a response packet for a read request to an npa, waiting at most #timeout cycles */
 static int hb_mc_manycore_recv_read_rsp(hb_mc_manycore_t *mc,
                                         uint32_t *vp,
-                                        uint32_t *id = nullptr)
+                                        uint32_t *id,
+                                        long timeout)
 {
         hb_mc_packet_t rsp;
         int err;
 
         /* receive a packet from the hardware */
-        err = hb_mc_manycore_response_rx(mc, &rsp.response, -1);
+        err = hb_mc_manycore_response_rx(mc, &rsp.response, timeout);
+        if (err == HB_MC_TIMEOUT || (err == HB_MC_NOIMPL && timeout != -1))
+                return err; // omit the error message if nothing has arrived yet
+
         if (err != HB_MC_SUCCESS) {
                 manycore_pr_err(mc, "%s: Failed to read response packet: %s\n",
                                 __func__, hb_mc_strerror(err));
@@ -837,36 +1368,397 @@ static int hb_mc_manycore_recv_read_rsp(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
-/* read from a memory address on the manycore */
-template <typename UINT>
-static int hb_mc_manycore_read(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, UINT *vp)
+/////////////////////////////
+// Outstanding Request API //
+/////////////////////////////
+
+/* an outstanding load, indexed by its load id */
+typedef struct hb_mc_manycore_load {
+        hb_mc_ticket_t ticket; //!< the ticket this load completes
+        void *dst;             //!< where to write the load data (nullptr if the load id is free)
+        size_t sz;             //!< the size of the load in bytes
+} hb_mc_manycore_load_t;
+
+/* the ticket of loads that complete before their caller returns, or whose ticket was released */
+static const hb_mc_ticket_t hb_mc_manycore_no_ticket = 0;
+
+/* the completion state of a ticket */
+typedef struct hb_mc_manycore_ticket_state {
+        size_t pending;        //!< the number of loads that have not received a response
+        bool fence;            //!< whether the ticket includes stores
+} hb_mc_manycore_ticket_state_t;
+
+/* all requests that have not completed */
+typedef struct hb_mc_manycore_requests {
+        std::stack<uint32_t, std::vector<uint32_t> > ids;                 //!< free load ids
+        std::vector<hb_mc_manycore_load_t> loads;                         //!< loads, indexed by load id
+        std::map<hb_mc_ticket_t, hb_mc_manycore_ticket_state_t> tickets; //!< tickets that have not been waited on
+        hb_mc_ticket_t next_ticket;                                       //!< the next ticket to issue
+        uint32_t discard;                                                 //!< where retired loads write their data
+        std::recursive_mutex lock;                                        //!< serializes the packet path
+        hb_mc_manycore_dirty_map_t dirty;                                 //!< [start, end) EPA ranges that may be dirty, by vcache id
+} hb_mc_manycore_requests_t;
+
+static hb_mc_manycore_requests_t *hb_mc_manycore_get_requests(hb_mc_manycore_t *mc)
+{
+        return reinterpret_cast<hb_mc_manycore_requests_t *>(mc->requests);
+}
+
+static std::recursive_mutex &hb_mc_manycore_packet_lock(hb_mc_manycore_t *mc)
+{
+        return hb_mc_manycore_get_requests(mc)->lock;
+}
+
+static hb_mc_manycore_dirty_map_t &hb_mc_manycore_get_dirty(hb_mc_manycore_t *mc)
 {
+        return hb_mc_manycore_get_requests(mc)->dirty;
+}
+
+/* initialize request tracking: load ids are capped at the maximum number of pending requests */
+static int hb_mc_manycore_requests_init(hb_mc_manycore_t *mc)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        unsigned n_ids = hb_mc_config_get_io_remote_load_cap(cfg);
+        hb_mc_manycore_requests_t *rqsts = new hb_mc_manycore_requests_t;
+
+        if (n_ids == 0) {
+                manycore_pr_err(mc, "%s: Remote load capacity is zero\n", __func__);
+                delete rqsts;
+                return HB_MC_INVALID;
+        }
+
+        for (int i = n_ids - 1; i >= 0; i--)
+                rqsts->ids.push(static_cast<uint32_t>(i));
+
+        rqsts->loads.resize(n_ids, {0, nullptr, 0});
+        rqsts->next_ticket = 1;
+
+        mc->requests = reinterpret_cast<void *>(rqsts);
+        return HB_MC_SUCCESS;
+}
+
+static void hb_mc_manycore_requests_cleanup(hb_mc_manycore_t *mc)
+{
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+
+        if (rqsts == nullptr)
+                return;
+
+        if (!rqsts->tickets.empty())
+                manycore_pr_warn(mc, "%s: %zu tickets were never waited on\n",
+                                 __func__, rqsts->tickets.size());
+
+        delete rqsts;
+        mc->requests = nullptr;
+}
+
+/* create a new ticket with no outstanding requests */
+static hb_mc_ticket_t hb_mc_manycore_ticket_open(hb_mc_manycore_t *mc)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        hb_mc_ticket_t ticket = rqsts->next_ticket++;
+
+        rqsts->tickets[ticket] = {0, false};
+        return ticket;
+}
+
+/* receive one response, waiting at most #timeout cycles, and write its data back to the location marked by its load id */
+static int hb_mc_manycore_complete_load(hb_mc_manycore_t *mc, long timeout = -1)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        uint32_t data, id;
         int err;
 
-        /* send load request */
-        err = hb_mc_manycore_send_read_rqst(mc, npa, sizeof(UINT));
+        err = hb_mc_manycore_recv_read_rsp(mc, &data, &id, timeout);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        /* read back response */
-        uint32_t load_data;
-        err = hb_mc_manycore_recv_read_rsp(mc, &load_data);
+        manycore_pr_dbg(mc, "%s: Received response for load_id = %" PRIu32 "\n",
+                        __func__, id);
+
+        // this should never happen unless something is messed up in hardware
+        if (id >= rqsts->loads.size() || rqsts->loads[id].dst == nullptr) {
+                manycore_pr_err(mc, "%s: Unexpected load id = %" PRIu32 "\n",
+                                __func__, id);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_manycore_load_t &load = rqsts->loads[id];
+
+        /* load data has already been shifted and extended */
+        switch (load.sz) {
+        case 1:
+                *static_cast<uint8_t*>(load.dst) = static_cast<uint8_t>(data);
+                break;
+        case 2:
+                *static_cast<uint16_t*>(load.dst) = static_cast<uint16_t>(data);
+                break;
+        default:
+                *static_cast<uint32_t*>(load.dst) = data;
+                break;
+        }
+
+        auto t = rqsts->tickets.find(load.ticket);
+        if (t != rqsts->tickets.end())
+                t->second.pending--;
+
+        // push the load id onto the stack so we can use it again
+        load.dst = nullptr;
+        rqsts->ids.push(id);
+
+        return HB_MC_SUCCESS;
+}
+
+/* reserve a load id for a load that completes #ticket, waiting for one to free up if necessary */
+static int hb_mc_manycore_alloc_load_id(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket,
+                                        void *dst, size_t sz, uint32_t *id)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        int err;
+
+        // if we're out of load ids, read responses until one is free
+        while (rqsts->ids.empty()) {
+                err = hb_mc_manycore_complete_load(mc);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        *id = rqsts->ids.top();
+        rqsts->ids.pop();
+        rqsts->loads[*id] = {ticket, dst, sz};
+
+        auto t = rqsts->tickets.find(ticket);
+        if (t != rqsts->tickets.end())
+                t->second.pending++;
+
+        return HB_MC_SUCCESS;
+}
+
+/* return a load id whose request was never sent */
+static void hb_mc_manycore_free_load_id(hb_mc_manycore_t *mc, uint32_t id)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        hb_mc_manycore_load_t &load = rqsts->loads[id];
+
+        auto t = rqsts->tickets.find(load.ticket);
+        if (t != rqsts->tickets.end())
+                t->second.pending--;
+
+        load.dst = nullptr;
+        rqsts->ids.push(id);
+}
+
+/*
+ * detach a sent load from its ticket and point it at the discard word,
+ * so that a late response does not write to memory its caller has released
+ */
+static void hb_mc_manycore_retire_load(hb_mc_manycore_t *mc, uint32_t id)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        hb_mc_manycore_load_t &load = rqsts->loads[id];
+
+        if (load.dst == nullptr)
+                return;
+
+        auto t = rqsts->tickets.find(load.ticket);
+        if (t != rqsts->tickets.end())
+                t->second.pending--;
+
+        load.ticket = hb_mc_manycore_no_ticket;
+        load.dst = &rqsts->discard;
+}
+
+/* release a ticket, retiring any of its loads that have not completed */
+static void hb_mc_manycore_ticket_release(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+
+        auto t = rqsts->tickets.find(ticket);
+        if (t == rqsts->tickets.end())
+                return;
+
+        for (uint32_t id = 0; id < rqsts->loads.size() && t->second.pending > 0; id++) {
+                if (rqsts->loads[id].dst != nullptr && rqsts->loads[id].ticket == ticket)
+                        hb_mc_manycore_retire_load(mc, id);
+        }
+
+        rqsts->tickets.erase(t);
+}
+
+/* wait for the response to load #id, retiring it on error */
+static int hb_mc_manycore_wait_load(hb_mc_manycore_t *mc, uint32_t id)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        int err;
+
+        // the id cannot be reissued while we hold the packet lock
+        while (rqsts->loads[id].dst != nullptr) {
+                err = hb_mc_manycore_complete_load(mc);
+                if (err != HB_MC_SUCCESS) {
+                        hb_mc_manycore_retire_load(mc, id);
+                        return err;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/* send a load that completes #ticket; the data is written to #dst when the response arrives */
+static int hb_mc_manycore_issue_load(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket,
+                                     const hb_mc_npa_t *npa, void *dst, size_t sz)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        uint32_t id;
+        int err;
+
+        err = hb_mc_manycore_alloc_load_id(mc, ticket, dst, sz, &id);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        /* mask off unused bits */
-        *vp = static_cast<UINT>(load_data);
+        err = hb_mc_manycore_send_read_rqst(mc, npa, sz, id);
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_free_load_id(mc, id);
+                return err;
+        }
+
+        manycore_pr_dbg(mc, "%s: Sent read request with load_id = %" PRIu32 "\n",
+                        __func__, id);
+
         return HB_MC_SUCCESS;
 }
 
-/* write to a memory address on the manycore */
-static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const void *vp, size_t sz)
+/**
+ * Check whether all requests associated with a ticket have completed
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  ticket A ticket returned by an asynchronous request
+ * @param[out] done   Set to 1 if the ticket's requests have completed, 0 otherwise
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_request_poll(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket, int *done)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        int err;
+
+        auto t = rqsts->tickets.find(ticket);
+        if (t == rqsts->tickets.end()) {
+                manycore_pr_err(mc, "%s: Unknown ticket %" PRIu64 "\n", __func__, ticket);
+                return HB_MC_NOTFOUND;
+        }
+
+        // consume the responses that have already arrived, without waiting for more
+        while (t->second.pending > 0) {
+                err = hb_mc_manycore_complete_load(mc, 0);
+                if (err == HB_MC_TIMEOUT)
+                        break;
+
+                // platforms without bounded receives wait for one response
+                if (err == HB_MC_NOIMPL) {
+                        err = hb_mc_manycore_complete_load(mc);
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+                        break;
+                }
+
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        *done = t->second.pending == 0;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Wait until all requests associated with a ticket have completed, and release the ticket
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  ticket A ticket returned by an asynchronous request
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_request_wait(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        int err;
+
+        auto t = rqsts->tickets.find(ticket);
+        if (t == rqsts->tickets.end()) {
+                manycore_pr_err(mc, "%s: Unknown ticket %" PRIu64 "\n", __func__, ticket);
+                return HB_MC_NOTFOUND;
+        }
+
+        /* read responses (for this ticket or others) until this ticket's loads have returned */
+        while (t->second.pending > 0) {
+                err = hb_mc_manycore_complete_load(mc);
+                if (err != HB_MC_SUCCESS) {
+                        hb_mc_manycore_ticket_release(mc, ticket);
+                        return err;
+                }
+        }
+
+        /* stores do not produce responses; fence to ensure they have landed */
+        if (t->second.fence) {
+                err = hb_mc_manycore_host_request_fence(mc, -1);
+                if (err != HB_MC_SUCCESS) {
+                        hb_mc_manycore_ticket_release(mc, ticket);
+                        return err;
+                }
+        }
+
+        rqsts->tickets.erase(t);
+
+        return HB_MC_SUCCESS;
+}
+
+/* read from a memory address on the manycore */
+template <typename UINT>
+static int hb_mc_manycore_read(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, UINT *vp)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        uint32_t id;
+        int err;
+
+        /* the load completes before we return, so it needs no ticket */
+        err = hb_mc_manycore_alloc_load_id(mc, hb_mc_manycore_no_ticket, vp, sizeof(UINT), &id);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* send load request */
+        err = hb_mc_manycore_send_read_rqst(mc, npa, sizeof(UINT), id);
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_free_load_id(mc, id);
+                return err;
+        }
+
+        /* read back response */
+        return hb_mc_manycore_wait_load(mc, id);
+}
+
+/* format a request packet that writes to a memory address on the manycore */
+static int hb_mc_manycore_format_write_packet(hb_mc_manycore_t *mc, hb_mc_packet_t *rqst,
+                                              const hb_mc_npa_t *npa, const void *vp, size_t sz)
 {
         int err;
-        hb_mc_packet_t rqst;
 
         /* format the request packet */
-        err = hb_mc_manycore_format_request_packet(mc, &rqst.request, npa);
+        err = hb_mc_manycore_format_request_packet(mc, &rqst->request, npa);
         if (err != HB_MC_SUCCESS)
                 return err;
 
@@ -882,25 +1774,38 @@ static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, co
         /* set data and size */
         switch (sz) {
         case 4:
-                hb_mc_request_packet_set_op(&rqst.request, HB_MC_PACKET_OP_REMOTE_SW);
-                hb_mc_request_packet_set_data(&rqst.request, *(const uint32_t*)vp);
+                hb_mc_request_packet_set_op(&rqst->request, HB_MC_PACKET_OP_REMOTE_SW);
+                hb_mc_request_packet_set_data(&rqst->request, *(const uint32_t*)vp);
                 break;
         case 2:
-                hb_mc_request_packet_set_op(&rqst.request, HB_MC_PACKET_OP_REMOTE_STORE);
-                hb_mc_request_packet_set_data(&rqst.request, static_cast<uint32_t>(*(const uint16_t*)vp) << data_shift);
-                hb_mc_request_packet_set_mask(&rqst.request, static_cast<hb_mc_packet_mask_t>(
+                hb_mc_request_packet_set_op(&rqst->request, HB_MC_PACKET_OP_REMOTE_STORE);
+                hb_mc_request_packet_set_data(&rqst->request, static_cast<uint32_t>(*(const uint16_t*)vp) << data_shift);
+                hb_mc_request_packet_set_mask(&rqst->request, static_cast<hb_mc_packet_mask_t>(
                                                       HB_MC_PACKET_REQUEST_MASK_SHORT << mask_shift));
                 break;
         case 1:
-                hb_mc_request_packet_set_op(&rqst.request, HB_MC_PACKET_OP_REMOTE_STORE);
-                hb_mc_request_packet_set_data(&rqst.request, static_cast<uint32_t>(*(const  uint8_t*)vp) << data_shift);
-                hb_mc_request_packet_set_mask(&rqst.request, static_cast<hb_mc_packet_mask_t>(
+                hb_mc_request_packet_set_op(&rqst->request, HB_MC_PACKET_OP_REMOTE_STORE);
+                hb_mc_request_packet_set_data(&rqst->request, static_cast<uint32_t>(*(const  uint8_t*)vp) << data_shift);
+                hb_mc_request_packet_set_mask(&rqst->request, static_cast<hb_mc_packet_mask_t>(
                                                       HB_MC_PACKET_REQUEST_MASK_BYTE << mask_shift));
                 break;
         default:
                 return HB_MC_INVALID;
         }
 
+        return HB_MC_SUCCESS;
+}
+
+/* write to a memory address on the manycore */
+static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const void *vp, size_t sz)
+{
+        int err;
+        hb_mc_packet_t rqst;
+
+        err = hb_mc_manycore_format_write_packet(mc, &rqst, npa, vp, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
         /* transmit the request */
         manycore_pr_dbg(mc, "Sending %d-byte write request to NPA "
                         "(x: %d, y: %d, 0x%08x) (data = 0x%08" PRIx32 ")\n",
@@ -936,6 +1841,54 @@ static int hb_mc_manycore_read_write_mem_check_args(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Write a sequence of words to a series of NPAs
+ *
+ * Store requests are formatted in chunks and handed to the platform
+ * as a batch, so that the platform can fill all available credits at
+ * once rather than waiting on each packet.
+ *
+ * @tparam NPA_OF_I_FUNCTION   Returns the NPA to write at index i.
+ * @tparam WORD_OF_I_FUNCTION  Returns the word to write at index i.
+ *
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa      A function that takes an index i and returns an NPA.
+ * @param[in]  word     A function that takes an index i and returns a word.
+ * @param[in]  n_words  The number of words to write
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+template <typename NPA_OF_I_FUNCTION, typename WORD_OF_I_FUNCTION>
+static int hb_mc_manycore_write_words(hb_mc_manycore_t *mc, NPA_OF_I_FUNCTION npa,
+                                      WORD_OF_I_FUNCTION word, size_t n_words)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        hb_mc_packet_t rqsts[HB_MC_MANYCORE_TX_BATCH_MAX];
+        int err;
+
+        for (size_t i = 0; i < n_words; ) {
+                size_t n = 0;
+
+                /* format up to a full batch of store requests */
+                for (; n < HB_MC_MANYCORE_TX_BATCH_MAX && i < n_words; n++, i++) {
+                        hb_mc_npa_t addr = npa(i);
+                        uint32_t w = word(i);
+                        err = hb_mc_manycore_format_write_packet(mc, &rqsts[n], &addr, &w, sizeof(w));
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+                }
+
+                err = hb_mc_manycore_request_tx_batch(mc, &rqsts[0].request, n, -1);
+                if (err != HB_MC_SUCCESS) {
+                        manycore_pr_err(mc, "%s: Failed to send write requests: %s\n",
+                                        __func__, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        return hb_mc_manycore_host_request_fence(mc, -1);
+}
+
 /**
  * Write memory out to manycore hardware starting at a given NPA
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -947,38 +1900,34 @@ static int hb_mc_manycore_read_write_mem_check_args(hb_mc_manycore_t *mc,
 int hb_mc_manycore_write_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                              const void *data, size_t sz)
 {
-        int err;
+        hb_mc_manycore_packet_guard(mc);
+
+        int err, ferr;
 
         err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, data, sz);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_start_bulk_transfer(mc);
-
         const uint32_t *words = (const uint32_t*)data;
-        size_t n_words = sz >> 2;
-        hb_mc_npa_t addr = *npa;
-
-        /* send store requests one word at a time */
-        for (size_t i = 0; i < n_words; i++) {
-
-                err = hb_mc_manycore_write(mc, &addr, &words[i], 4);
-                if (err != HB_MC_SUCCESS) {
-                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
-                                        __func__, hb_mc_strerror(err));
-                        return err;
-                }
+        const hb_mc_npa_t base = *npa;
 
-                // Increment EPA by 4:
-                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&addr) + 4);
-        }
-
-        err = hb_mc_manycore_host_request_fence(mc, -1);
+        err = hb_mc_platform_start_bulk_transfer(mc);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_finish_bulk_transfer(mc);
-        return HB_MC_SUCCESS;
+        /* ith word => words[i] @ epa + 4i */
+        err = hb_mc_manycore_write_words(mc,
+                                         [=](size_t i) {
+                                                 hb_mc_npa_t addr = base;
+                                                 hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&base) + i * sizeof(uint32_t));
+                                                 return addr;
+                                         },
+                                         [=](size_t i) { return words[i]; },
+                                         sz >> 2);
+
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
+
+        return err != HB_MC_SUCCESS ? err : ferr;
 }
 
 /**
@@ -992,168 +1941,218 @@ int hb_mc_manycore_write_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
 int hb_mc_manycore_memset(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                           uint8_t val, size_t sz)
 {
-        int err;
+        hb_mc_manycore_packet_guard(mc);
+
+        int err, ferr;
 
         err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, NULL, sz);
         if (err != HB_MC_SUCCESS)
                 return err;
 
         const uint32_t word = (val << 24) | (val << 16) | (val << 8) | val;
-        size_t n_words = sz >> 2;
-        hb_mc_npa_t addr = *npa;
+        const hb_mc_npa_t base = *npa;
 
-        hb_mc_platform_start_bulk_transfer(mc);
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
-        /* send store requests one word at a time */
-        for (size_t i = 0; i < n_words; i++) {
+        /* ith word => word @ epa + 4i */
+        err = hb_mc_manycore_write_words(mc,
+                                         [=](size_t i) {
+                                                 hb_mc_npa_t addr = base;
+                                                 hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&base) + i * sizeof(uint32_t));
+                                                 return addr;
+                                         },
+                                         [=](size_t) { return word; },
+                                         sz >> 2);
 
-                err = hb_mc_manycore_write(mc, &addr, &word, 4);
-                if (err != HB_MC_SUCCESS) {
-                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
-                                        __func__, hb_mc_strerror(err));
-                        return err;
-                }
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
 
-                // increment EPA by 1: (EPA's address words)
-                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&addr) + sizeof(uint32_t));
-        }
+        return err != HB_MC_SUCCESS ? err : ferr;
+}
 
-        err = hb_mc_manycore_host_request_fence(mc, -1);
+/**
+ * Write the same buffer out to manycore hardware starting at each of a list of NPAs
+ *
+ * Stores are interleaved across destinations (word 0 to every NPA,
+ * then word 1 to every NPA, and so on) so that writes to different
+ * endpoints are in flight in the network at the same time.
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n_npas valid hb_mc_npa_t
+ * @param[in]  n_npas The number of NPAs in #npas
+ * @param[in]  data   A buffer to be written out manycore hardware
+ * @param[in]  sz     The number of bytes to write at each NPA
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write_mem_broadcast(hb_mc_manycore_t *mc,
+                                       const hb_mc_npa_t *npas, size_t n_npas,
+                                       const void *data, size_t sz)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        int err, ferr;
+
+        err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, data, sz);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_finish_bulk_transfer(mc);
+        if (n_npas == 0)
+                return HB_MC_SUCCESS;
 
-        return HB_MC_SUCCESS;
+        const uint32_t *words = (const uint32_t*)data;
+
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* ith word => words[i / n_npas] @ npas[i % n_npas] + 4 * (i / n_npas) */
+        err = hb_mc_manycore_write_words(mc,
+                                         [=](size_t i) {
+                                                 const hb_mc_npa_t *npa = &npas[i % n_npas];
+                                                 hb_mc_npa_t addr = *npa;
+                                                 hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(npa) + (i / n_npas) * sizeof(uint32_t));
+                                                 return addr;
+                                         },
+                                         [=](size_t i) { return words[i / n_npas]; },
+                                         (sz >> 2) * n_npas);
+
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
+
+        return err != HB_MC_SUCCESS ? err : ferr;
 }
 
 /**
- * Perform #cnt loads from a series of NPAs and return results in an associative container #data.
- * After returning success, #data[i] shall be the data read from the NPA given by #npa(i)
- * for i >= 0 and i < cnt.
+ * Set memory to a given value starting at each of a list of NPAs
+ *
+ * Stores are interleaved across destinations as in
+ * hb_mc_manycore_write_mem_broadcast().
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n_npas valid hb_mc_npa_t
+ * @param[in]  n_npas The number of NPAs in #npas
+ * @param[in]  val    Value to be written out
+ * @param[in]  sz     The number of bytes to write at each NPA
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_memset_broadcast(hb_mc_manycore_t *mc,
+                                    const hb_mc_npa_t *npas, size_t n_npas,
+                                    uint8_t val, size_t sz)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        int err, ferr;
+
+        err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, NULL, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        if (n_npas == 0)
+                return HB_MC_SUCCESS;
+
+        const uint32_t word = (val << 24) | (val << 16) | (val << 8) | val;
+
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* ith word => word @ npas[i % n_npas] + 4 * (i / n_npas) */
+        err = hb_mc_manycore_write_words(mc,
+                                         [=](size_t i) {
+                                                 const hb_mc_npa_t *npa = &npas[i % n_npas];
+                                                 hb_mc_npa_t addr = *npa;
+                                                 hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(npa) + (i / n_npas) * sizeof(uint32_t));
+                                                 return addr;
+                                         },
+                                         [=](size_t) { return word; },
+                                         (sz >> 2) * n_npas);
+
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
+
+        return err != HB_MC_SUCCESS ? err : ferr;
+}
+
+/**
+ * Send #cnt loads from a series of NPAs that complete #ticket.
+ * After #ticket completes, #data[i] shall be the data read from the NPA given by #npa(i)
+ * for i >= 0 and i < cnt. Must be called within a bulk transfer.
  *
  * @tparam UINT               The unsigned integer type for data loads.
  * @tparam UINTV              An associative container of UNT words (indexed by i).
  * @tparam NPA_OF_I_FUNCTION  Returns an NPA given an index i.
  *
- * @param[in]  mc    A manycore instance.
- * @param[in]  npa   A function that takes an index i and returns an NPA.
- * @param[out] data  A mutable associative container by which load data is returned.
- * @param[in]  cnt   The number of loads to perform.
+ * @param[in]  mc     A manycore instance.
+ * @param[in]  npa    A function that takes an index i and returns an NPA.
+ * @param[out] data   A mutable associative container by which load data is returned.
+ * @param[in]  cnt    The number of loads to perform.
+ * @param[in]  ticket The ticket the loads complete.
  *
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 template <typename UINT, typename UINTV, typename NPA_OF_I_FUNCTION>
-static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
+static int hb_mc_manycore_read_mem_transfer(hb_mc_manycore_t *mc,
                                             NPA_OF_I_FUNCTION npa,
-                                            UINTV & data, size_t cnt)
+                                            UINTV & data, size_t cnt,
+                                            hb_mc_ticket_t ticket)
 {
-        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
-        size_t rsp_i = 0, rqst_i = 0;
-        uint32_t occupancy;
-        unsigned n_ids;
         int err;
 
-        /* cap the number of load ids to the maximum number of pending requests */
-        n_ids = hb_mc_config_get_io_remote_load_cap(cfg);
+        /* request every word; responses are read back as load ids run out */
+        for (size_t i = 0; i < cnt; i++) {
+                // get the NPA of the next load address
+                hb_mc_npa_t rqst_addr = npa(i);
 
-        hb_mc_platform_start_bulk_transfer(mc);
-
-        /* track requests and responses with ids and id_to_rsp_i */
-        std::stack <uint32_t, std::vector<uint32_t> > ids;
-        for (int i = n_ids - 1; i >= 0; i--)
-                ids.push(static_cast<uint32_t>(i));
-
-        std::map<uint32_t, uint32_t> id_to_rsp_i;
-        hb_mc_npa_t id_to_npa[n_ids];
-
-        /* until we've received all responses... */
-        while (rsp_i < cnt) {
-
-                /* try to request as many words as we have left */
-                while (rqst_i < cnt) {
-                        // get the NPA of the next load address
-                        hb_mc_npa_t rqst_addr = npa(rqst_i);
-
-                        // if we're out of load ids, break to start reading requests
-                        if (ids.empty())
-                                break;
-
-                        // get an available load id for this load request
-                        uint32_t rqst_load_id = ids.top();
-
-                        // save which request this is
-                        id_to_rsp_i[rqst_load_id] = rqst_i;
-                        id_to_npa[rqst_load_id] = rqst_addr;
-
-                        // send a load request
-                        err = hb_mc_manycore_send_read_rqst(mc, &rqst_addr, sizeof(UINT),
-                                                            rqst_load_id);
-                        if (err == HB_MC_SUCCESS) {
-                                // success; increment succesful requests and pop the load id
-                                rqst_i++;
-                                ids.pop();
-                        } else if (err == HB_MC_BUSY) {
-                                // if we're busy, break to start reading requests
-                                break;
-                        } else {
-                                // we've hit some other error: abort with an error message
-                                manycore_pr_err(mc, "%s: Failed to send read request: %s\n",
-                                                __func__, hb_mc_strerror(err));
-                                return err;
-                        }
-                        manycore_pr_dbg(mc, "%s: Sent read request with load_id = %" PRIu32 "\n",
-                                        __func__, rqst_load_id);
+                err = hb_mc_manycore_issue_load(mc, ticket, &rqst_addr, &data[i], sizeof(UINT));
+                if (err != HB_MC_SUCCESS) {
+                        manycore_pr_err(mc, "%s: Failed to send read request: %s\n",
+                                        __func__, hb_mc_strerror(err));
+                        return err;
                 }
+        }
 
-                /* read all available response packets */
-                while (rsp_i < rqst_i) {
-                        /* read a response and write it back to the location marked by load_id */
-                        uint32_t read_data, load_id;
-                        err = hb_mc_manycore_recv_read_rsp(mc, &read_data, &load_id);
-                        if (err != HB_MC_SUCCESS) {
-                                manycore_pr_err(mc, "%s: Failed to receive read response: %s\n",
-                                                __func__, hb_mc_strerror(err));
-                                return err;
-                        }
-
-                        manycore_pr_dbg(mc, "%s: Received response for load_id = %" PRIu32 "\n",
-                                        __func__, load_id);
+        return HB_MC_SUCCESS;
+}
 
-                        // this should never happen unless something is messed up in hardware
-                        if (load_id >= n_ids) {
-                                manycore_pr_err(mc, "%s: Bad load id = %" PRIu32 "\n",
-                                                __func__, load_id);
-                                return HB_MC_FAIL;
-                        }
+/**
+ * Perform #cnt loads from a series of NPAs and return results in an associative container #data.
+ * After returning success, #data[i] shall be the data read from the NPA given by #npa(i)
+ * for i >= 0 and i < cnt.
+ *
+ * @tparam UINT               The unsigned integer type for data loads.
+ * @tparam UINTV              An associative container of UNT words (indexed by i).
+ * @tparam NPA_OF_I_FUNCTION  Returns an NPA given an index i.
+ *
+ * @param[in]  mc    A manycore instance.
+ * @param[in]  npa   A function that takes an index i and returns an NPA.
+ * @param[out] data  A mutable associative container by which load data is returned.
+ * @param[in]  cnt   The number of loads to perform.
+ *
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+template <typename UINT, typename UINTV, typename NPA_OF_I_FUNCTION>
+static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
+                                            NPA_OF_I_FUNCTION npa,
+                                            UINTV & data, size_t cnt)
+{
+        hb_mc_manycore_packet_guard(mc);
 
-                        // This would be an unexpected response
-                        if (id_to_rsp_i.count(load_id) == 0) {
-                                manycore_pr_err(mc, "%s: Unexpected load id = %" PRIu32 "\n",
-                                                __func__, load_id);
-                                return HB_MC_FAIL;
-                        }
-                        uint32_t idx = id_to_rsp_i[load_id];
-                        
-                        // This would be a runtime writer error... or worse.
-                        if (idx > cnt) {
-                                manycore_pr_err(mc, "%s: Return index outside of array. Idx = %" PRIu32 "\n",
-                                                __func__, idx);
-                                return HB_MC_FAIL;
-                        }
-                        // write 'read_data' back to the correct location
-                        data[idx] = static_cast<UINT>(read_data);
+        hb_mc_ticket_t ticket = hb_mc_manycore_ticket_open(mc);
+        int err, ferr, werr;
 
-                        // increment succesful responses
-                        rsp_i++;
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err == HB_MC_SUCCESS) {
+                err = hb_mc_manycore_read_mem_transfer<UINT>(mc, npa, data, cnt, ticket);
 
-                        // push the load id onto the stack so we can use it again
-                        ids.push(load_id);
-                }
+                /* always close the bulk transfer, even on error */
+                ferr = hb_mc_platform_finish_bulk_transfer(mc);
+                if (err == HB_MC_SUCCESS)
+                        err = ferr;
         }
-        hb_mc_platform_finish_bulk_transfer(mc);
 
-        return HB_MC_SUCCESS;
+        /* wait for any loads that were sent, and release the ticket */
+        werr = hb_mc_manycore_request_wait(mc, ticket);
+
+        return err != HB_MC_SUCCESS ? err : werr;
 }
 
 /**
@@ -1177,6 +2176,167 @@ int hb_mc_manycore_read_mem_scatter_gather(hb_mc_manycore_t *mc, const hb_mc_npa
         return hb_mc_manycore_read_mem_internal<uint32_t>(mc, npa_function(npa), data, words);
 }
 
+/**
+ * Write words to a vector of NPAs
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A vector of valid hb_mc_npa_t of length <= #words
+ * @param[in]  data   A word vector to be written out
+ * @param[in]  words  The number of words to write to manycore hardware
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write_mem_scatter_gather(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                            const uint32_t *data, size_t words)
+{
+        hb_mc_manycore_packet_guard(mc);
+        int err, ferr;
+
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* ith word => data[i] @ npa[i] */
+        err = hb_mc_manycore_write_words(mc,
+                                         [=](size_t i) { return npa[i]; },
+                                         [=](size_t i) { return data[i]; },
+                                         words);
+
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
+
+        return err != HB_MC_SUCCESS ? err : ferr;
+}
+
+/*
+ * Maps a flat word index onto a list of NPA ranges, so that a list of
+ * ranges can be handed to the word-at-a-time transfer functions.
+ */
+class hb_mc_manycore_range_list {
+        std::vector<size_t> first; //!< the index of the first word of each range
+        const hb_mc_npa_t *npas;
+public:
+        hb_mc_manycore_range_list(const hb_mc_npa_t *npas, const size_t *szs, size_t n) :
+                first(n), npas(npas) {
+                size_t words = 0;
+                for (size_t r = 0; r < n; r++) {
+                        first[r] = words;
+                        words += szs[r] >> 2;
+                }
+        }
+
+        /* the range containing word i, and i's offset in words within it */
+        size_t range(size_t i, size_t *offset) const {
+                size_t r = std::upper_bound(first.begin(), first.end(), i) - first.begin() - 1;
+                *offset = i - first[r];
+                return r;
+        }
+
+        /* the NPA of word i */
+        hb_mc_npa_t npa(size_t i) const {
+                size_t off, r = range(i, &off);
+                hb_mc_npa_t addr = npas[r];
+                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&npas[r]) + off * sizeof(uint32_t));
+                return addr;
+        }
+};
+
+/**
+ * Check the arguments of hb_mc_manycore_write_mem_ranges() and hb_mc_manycore_read_mem_ranges()
+ * @return HB_MC_SUCCESS if every range is word aligned, with the total number of words in #words.
+ */
+static int hb_mc_manycore_mem_ranges_check_args(hb_mc_manycore_t *mc, const char *caller_name,
+                                                const void * const *data, const size_t *szs,
+                                                size_t n, size_t *words)
+{
+        int err;
+
+        *words = 0;
+        for (size_t r = 0; r < n; r++) {
+                err = hb_mc_manycore_read_write_mem_check_args(mc, caller_name, data[r], szs[r]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+                *words += szs[r] >> 2;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write a list of host buffers out to a list of NPA ranges
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n valid hb_mc_npa_t - start of each range
+ * @param[in]  data   An array of #n 32-bit aligned host buffers, one for each range
+ * @param[in]  szs    An array of #n sizes in bytes (multiples of 4), one for each range
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write_mem_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                    const void * const *data, const size_t *szs, size_t n)
+{
+        hb_mc_manycore_packet_guard(mc);
+        size_t words;
+        int err, ferr;
+
+        err = hb_mc_manycore_mem_ranges_check_args(mc, __func__, data, szs, n, &words);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        const hb_mc_manycore_range_list ranges(npas, szs, n);
+
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* ith word => the ith word of the concatenated ranges */
+        err = hb_mc_manycore_write_words(mc,
+                                         [&](size_t i) { return ranges.npa(i); },
+                                         [&](size_t i) {
+                                                 size_t off, r = ranges.range(i, &off);
+                                                 return static_cast<const uint32_t *>(data[r])[off];
+                                         },
+                                         words);
+
+        ferr = hb_mc_platform_finish_bulk_transfer(mc);
+
+        return err != HB_MC_SUCCESS ? err : ferr;
+}
+
+/**
+ * Read a list of NPA ranges into a list of host buffers
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n valid hb_mc_npa_t - start of each range
+ * @param[out] data   An array of #n 32-bit aligned host buffers, one for each range
+ * @param[in]  szs    An array of #n sizes in bytes (multiples of 4), one for each range
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_read_mem_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                   void * const *data, const size_t *szs, size_t n)
+{
+        size_t words;
+        int err;
+
+        err = hb_mc_manycore_mem_ranges_check_args(mc, __func__, data, szs, n, &words);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        const hb_mc_manycore_range_list ranges(npas, szs, n);
+
+        /* ith word => the ith word of the concatenated host buffers */
+        struct word_vector {
+                const hb_mc_manycore_range_list &ranges;
+                void * const *data;
+                word_vector(const hb_mc_manycore_range_list &ranges, void * const *data) :
+                        ranges(ranges), data(data) {}
+                uint32_t & operator[](size_t i) {
+                        size_t off, r = ranges.range(i, &off);
+                        return static_cast<uint32_t *>(data[r])[off];
+                }
+        } vec(ranges, data);
+
+        return hb_mc_manycore_read_mem_internal<uint32_t>(mc,
+                                                          [&](size_t i) { return ranges.npa(i); },
+                                                          vec, words);
+}
+
 /**
  * Read memory from manycore hardware starting at a given NPA
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -1285,18 +2445,51 @@ int hb_mc_manycore_write32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, uint32_
 }
 
 /**
- * Do a 32-bit amoadd to manycore hardware at a given NPA (must be a DRAM address)
+ * Check if a request packet opcode is an atomic memory operation
+ * @param[in]  op     A request packet opcode
+ * @return true if #op is one of HB_MC_PACKET_OP_REMOTE_AMO*.
+ */
+static bool hb_mc_manycore_op_is_amo(hb_mc_packet_op_t op)
+{
+        switch (op) {
+        case HB_MC_PACKET_OP_REMOTE_AMOSWAP:
+        case HB_MC_PACKET_OP_REMOTE_AMOADD:
+        case HB_MC_PACKET_OP_REMOTE_AMOXOR:
+        case HB_MC_PACKET_OP_REMOTE_AMOAND:
+        case HB_MC_PACKET_OP_REMOTE_AMOOR:
+        case HB_MC_PACKET_OP_REMOTE_AMOMIN:
+        case HB_MC_PACKET_OP_REMOTE_AMOMAX:
+        case HB_MC_PACKET_OP_REMOTE_AMOMINU:
+        case HB_MC_PACKET_OP_REMOTE_AMOMAXU:
+                return true;
+        default:
+                return false;
+        }
+}
+
+/**
+ * Do a 32-bit atomic memory operation on manycore hardware at a given NPA
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
- * @param[in]  v      A word value to be added to the NPA
- * @param[out] vpo    The previous value at the NPA
+ * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary (DRAM or vanilla core)
+ * @param[in]  op     The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  v      The operand of the operation
+ * @param[out] vpo    The previous value at the NPA (may be NULL)
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-int hb_mc_manycore_amoadd32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const uint32_t v, uint32_t *vpo)
+int hb_mc_manycore_amo32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                         hb_mc_packet_op_t op, uint32_t v, uint32_t *vpo)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         int err;
         hb_mc_packet_t rqst;
 
+        if (!hb_mc_manycore_op_is_amo(op)) {
+                manycore_pr_err(mc, "%s: opcode %d is not an atomic operation\n",
+                                __func__, op);
+                return HB_MC_INVALID;
+        }
+
         /* format the request packet */
         err = hb_mc_manycore_format_request_packet(mc, &rqst.request, npa);
         if (err != HB_MC_SUCCESS)
@@ -1310,29 +2503,41 @@ int hb_mc_manycore_amoadd32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        // AMO are only supported on DRAM regions
-        if (hb_mc_config_is_dram(hb_mc_manycore_get_config(mc), hb_mc_npa_get_xy(npa)) == 0)
-            return HB_MC_INVALID;
+        // AMO are only supported on DRAM and vanilla core regions
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        if (!hb_mc_config_is_dram(cfg, hb_mc_npa_get_xy(npa)) &&
+            !hb_mc_config_is_vanilla_core(cfg, hb_mc_npa_get_xy(npa)))
+                return HB_MC_INVALID;
 
-        hb_mc_request_packet_set_op(&rqst.request, HB_MC_PACKET_OP_REMOTE_AMOADD);
+        hb_mc_request_packet_set_op(&rqst.request, op);
         hb_mc_request_packet_set_data(&rqst.request, v);
 
-        err = hb_mc_manycore_request_tx(mc, &rqst.request, -1);
+        uint32_t load_data, id;
+
+        /* the response completes before we return, so it needs no ticket */
+        err = hb_mc_manycore_alloc_load_id(mc, hb_mc_manycore_no_ticket, &load_data, sizeof(load_data), &id);
         if (err != HB_MC_SUCCESS)
                 return err;
 
+        hb_mc_request_packet_set_load_id(&rqst.request, id);
+
+        err = hb_mc_manycore_request_tx(mc, &rqst.request, -1);
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_free_load_id(mc, id);
+                return err;
+        }
+
         /* transmit the request */
-        manycore_pr_dbg(mc, "Sending %d-byte amo request to NPA "
+        manycore_pr_dbg(mc, "Sending %d-byte amo (op = %d) request to NPA "
                         "(x: %d, y: %d, 0x%08x) (data = 0x%08" PRIx32 ")\n",
-                        sz,
+                        sz, op,
                         hb_mc_npa_get_x(npa),
                         hb_mc_npa_get_y(npa),
                         hb_mc_npa_get_epa(npa),
                         hb_mc_request_packet_get_data(&rqst.request));
 
         /* read back response */
-        uint32_t load_data;
-        err = hb_mc_manycore_recv_read_rsp(mc, &load_data);
+        err = hb_mc_manycore_wait_load(mc, id);
         if (err != HB_MC_SUCCESS)
                 return err;
 
@@ -1341,6 +2546,123 @@ int hb_mc_manycore_amoadd32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Do a 32-bit amoadd to manycore hardware at a given NPA (must be a DRAM address)
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+ * @param[in]  v      A word value to be added to the NPA
+ * @param[out] vpo    The previous value at the NPA
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_amoadd32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const uint32_t v, uint32_t *vpo)
+{
+        // amoadd32 has always been restricted to DRAM
+        if (hb_mc_config_is_dram(hb_mc_manycore_get_config(mc), hb_mc_npa_get_xy(npa)) == 0)
+            return HB_MC_INVALID;
+
+        return hb_mc_manycore_amo32(mc, npa, HB_MC_PACKET_OP_REMOTE_AMOADD, v, vpo);
+}
+
+/**
+ * Start reading a 32-bit word from manycore hardware at a given NPA
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+ * @param[out] vp     A word to be set to the data read. Must remain valid until #ticket completes.
+ * @param[out] ticket A ticket that completes when #vp has been written
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_read32_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                uint32_t *vp, hb_mc_ticket_t *ticket)
+{
+        int err;
+
+        *ticket = hb_mc_manycore_ticket_open(mc);
+
+        err = hb_mc_manycore_issue_load(mc, *ticket, npa, vp, sizeof(*vp));
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_ticket_release(mc, *ticket);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Start writing a 32-bit word to manycore hardware at a given NPA
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+ * @param[in]  v      A word value to be written out
+ * @param[out] ticket A ticket that completes when the write has reached #npa
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write32_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                 uint32_t v, hb_mc_ticket_t *ticket)
+{
+        hb_mc_manycore_requests_t *rqsts = hb_mc_manycore_get_requests(mc);
+        int err;
+
+        *ticket = hb_mc_manycore_ticket_open(mc);
+
+        err = hb_mc_manycore_write(mc, npa, &v, sizeof(v));
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_ticket_release(mc, *ticket);
+                return err;
+        }
+
+        rqsts->tickets[*ticket].fence = true;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Start reading memory from manycore hardware starting at a given NPA
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t
+ * @param[out] data   A buffer into which data will be read. Must remain valid until #ticket completes.
+ * @param[in]  sz     The number of bytes to read from manycore hardware
+ * @param[out] ticket A ticket that completes when #data has been written
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_read_mem_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                  void *data, size_t sz, hb_mc_ticket_t *ticket)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        int err, ferr;
+
+        err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, data, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        uint32_t *words = static_cast<uint32_t*>(data);
+        size_t n_words = sz >> 2;
+
+        /* ith NPA => first NPA + i words */
+        auto npa_function = [=](size_t i) {
+                return hb_mc_npa_from_x_y(hb_mc_npa_get_x(npa),
+                                          hb_mc_npa_get_y(npa),
+                                          hb_mc_npa_get_epa(npa) +
+                                          i*sizeof(uint32_t));
+        };
+
+        *ticket = hb_mc_manycore_ticket_open(mc);
+
+        err = hb_mc_platform_start_bulk_transfer(mc);
+        if (err == HB_MC_SUCCESS) {
+                err = hb_mc_manycore_read_mem_transfer<uint32_t>(mc, npa_function, words, n_words, *ticket);
+
+                /* closing the bulk transfer sends any deferred requests */
+                ferr = hb_mc_platform_finish_bulk_transfer(mc);
+                if (err == HB_MC_SUCCESS)
+                        err = ferr;
+        }
+
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_manycore_ticket_release(mc, *ticket);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
 
 /**
  * Enable DRAM mode on the manycore instance.
@@ -1454,6 +2776,8 @@ int hb_mc_manycore_dma_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
 int hb_mc_manycore_dma_write_no_cache_ainv(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                            const void *data, size_t sz)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         int err;
         if (!hb_mc_manycore_supports_dma_write(mc))
                 return HB_MC_NOIMPL;
@@ -1490,6 +2814,8 @@ int hb_mc_manycore_dma_write_no_cache_ainv(hb_mc_manycore_t *mc, const hb_mc_npa
 int hb_mc_manycore_dma_read_no_cache_afl(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                          void *data, size_t sz)
 {
+        hb_mc_manycore_packet_guard(mc);
+
         int err;
         if (!hb_mc_manycore_supports_dma_read(mc))
                 return HB_MC_NOIMPL;
@@ -1504,6 +2830,76 @@ int hb_mc_manycore_dma_read_no_cache_afl(hb_mc_manycore_t *mc, const hb_mc_npa_t
         return hb_mc_dma_read(mc, npa, data, sz);
 }
 
+/**
+ * Check that a list of NPA ranges can be copied via DMA
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS if every range is in DRAM. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+static int hb_mc_manycore_dma_check_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas, size_t n)
+{
+        if (!hb_mc_manycore_dram_is_enabled(mc))
+                return HB_MC_FAIL;
+
+        for (size_t r = 0; r < n; r++) {
+                if (!hb_mc_manycore_npa_is_dram(mc, &npas[r]))
+                        return HB_MC_INVALID;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write a list of host buffers to a list of DRAM NPA ranges via DMA - unsafe
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs (must map to DRAM)
+ * @param[in]  data   An array of #n host buffers
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_dma_write_ranges_no_cache_ainv(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                  const void * const *data, const size_t *szs,
+                                                  size_t n)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        if (!hb_mc_manycore_supports_dma_write(mc))
+                return HB_MC_NOIMPL;
+
+        int err = hb_mc_manycore_dma_check_ranges(mc, npas, n);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        return hb_mc_dma_write_ranges(mc, npas, data, szs, n);
+}
+
+/**
+ * Read a list of DRAM NPA ranges into a list of host buffers via DMA - unsafe
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs (must map to DRAM)
+ * @param[out] data   An array of #n host buffers
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_dma_read_ranges_no_cache_afl(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                void * const *data, const size_t *szs,
+                                                size_t n)
+{
+        hb_mc_manycore_packet_guard(mc);
+
+        if (!hb_mc_manycore_supports_dma_read(mc))
+                return HB_MC_NOIMPL;
+
+        int err = hb_mc_manycore_dma_check_ranges(mc, npas, n);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        return hb_mc_dma_read_ranges(mc, npas, data, szs, n);
+}
+
 /**
  * Read memory via DMA from manycore DRAM starting at a given NPA
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -1550,7 +2946,68 @@ int hb_mc_manycore_dma_read(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int *count){
-        return hb_mc_platform_get_icount(mc, itype, count);
+        hb_mc_manycore_packet_guard(mc);
+
+        if (itype < 0 || itype >= HB_MC_INSTR_TYPE_MAX)
+                return HB_MC_INVALID;
+
+        // sum the counters of every tile if the platform can read them all at once
+        size_t ntiles;
+        int err = hb_mc_platform_get_counters(mc, nullptr, 0, &ntiles, 0);
+        if (err == HB_MC_NOIMPL)
+                return hb_mc_platform_get_icount(mc, itype, count);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        std::vector<hb_mc_tile_counters_t> counters(ntiles);
+        err = hb_mc_platform_get_counters(mc, counters.data(), counters.size(), &ntiles, 0);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < std::min(ntiles, counters.size()); i++)
+                sum += counters[i].icount[itype];
+
+        *count = static_cast<int>(sum);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get the performance counters of every tile, read in one sweep.
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with counters, which may be more than #n
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        hb_mc_manycore_packet_guard(mc);
+
+        if (ntiles == nullptr || (n != 0 && counters == nullptr))
+                return HB_MC_INVALID;
+
+        return hb_mc_platform_get_counters(mc, counters, n, ntiles, delta);
+}
+
+/**
+ * Get the PC histogram of every tile since reset.
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] samples  An array of at least #n samples
+ * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+ * @param[out] nsamples The number of nonzero (tile, PC) samples, which may be more than #n
+ * @return HB_MC_SUCCESS on success. HB_MC_NOIMPL if the platform has no PC histogram.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                    size_t n, size_t *nsamples){
+        hb_mc_manycore_packet_guard(mc);
+
+        if (nsamples == nullptr || (n != 0 && samples == nullptr))
+                return HB_MC_INVALID;
+
+        return hb_mc_platform_get_pc_histogram(mc, samples, n, nsamples);
 }
 
 /**
@@ -1559,6 +3016,8 @@ int hb_mc_manycore_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_trace_enable(hb_mc_manycore_t *mc){
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_trace_enable(mc);
 }
 
@@ -1568,6 +3027,8 @@ int hb_mc_manycore_trace_enable(hb_mc_manycore_t *mc){
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_trace_disable(hb_mc_manycore_t *mc){
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_trace_disable(mc);
 }
 
@@ -1577,6 +3038,8 @@ int hb_mc_manycore_trace_disable(hb_mc_manycore_t *mc){
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_log_enable(hb_mc_manycore_t *mc){
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_log_enable(mc);
 }
 
@@ -1586,5 +3049,7 @@ int hb_mc_manycore_log_enable(hb_mc_manycore_t *mc){
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_log_disable(hb_mc_manycore_t *mc){
+        hb_mc_manycore_packet_guard(mc);
+
         return hb_mc_platform_log_disable(mc);
 }
@@ -56,8 +56,11 @@ extern "C" {
                 hb_mc_config_t config; //!< configuration of the manycore
                 void *platform;        //!< machine-specific data pointer
                 int dram_enabled;      //!< operating in no-dram mode?
+                void *requests;        //!< outstanding request tracking
         } hb_mc_manycore_t;
 
+        typedef uint64_t hb_mc_ticket_t; //!< identifies a set of asynchronous requests
+
 #define HB_MC_MANYCORE_INIT {0}
         /*********************/
         /* Configuration API */
@@ -106,7 +109,7 @@ extern "C" {
          * Transmit a request packet to manycore hardware
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A request packet to transmit to manycore hardware
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -114,11 +117,25 @@ extern "C" {
                                       hb_mc_request_packet_t *request,
                                       long timeout);
 
+        /**
+         * Transmit a batch of request packets to manycore hardware, in order
+         * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] requests An array of #n request packets to transmit to manycore hardware
+         * @param[in] n        The number of packets in #requests
+         * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_request_tx_batch(hb_mc_manycore_t *mc,
+                                            hb_mc_request_packet_t *requests,
+                                            size_t n,
+                                            long timeout);
+
         /**
          * Receive a response packet from manycore hardware
          * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response A packet into which data should be read
-         * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -130,7 +147,7 @@ extern "C" {
          * Transmit a response packet to manycore hardware
          * @param[in] mc        A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response  A response packet to transmit to manycore hardware
-         * @param[in] timeout   A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout   A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -140,9 +157,15 @@ extern "C" {
 
         /**
          * Receive a request packet from manycore hardware
+         *
+         * The packet path is held for the whole call, including while
+         * waiting for a packet to arrive, so other threads sharing #mc
+         * cannot transmit or receive until it returns. Threads that
+         * share #mc should wait with a bounded #timeout.
+         *
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A packet into which data should be read
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -155,7 +178,7 @@ extern "C" {
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] packet  A packet to transmit to manycore hardware
          * @param[in] type    Is this packet a request or response packet?
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result, deprecated))
@@ -169,7 +192,7 @@ extern "C" {
          * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] packet A packet into which data should be read
          * @param[in] type   Is this packet a request or response packet?
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -180,9 +203,10 @@ extern "C" {
         /**
          * Wait for a finish packet from the Manycore instance. 
          * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
          * @return HB_MC_SUCCESS on packet that writes to HB_MC_HOST_EPA_FINISH, 
-         *         HB_MC_FAIL on a packet that writes to HB_MC_HOST_EPA_FAIL or underlying failure, 
+         *         HB_MC_FAIL on a packet that writes to HB_MC_HOST_EPA_FAIL or underlying failure,
+         *         HB_MC_TIMEOUT if #timeout expired, 
          *         HB_MC_INVALID otherwise.
          */
         __attribute__((warn_unused_result))
@@ -253,6 +277,23 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_write32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, uint32_t v);
 
+        /**
+         * Do a 32-bit atomic memory operation on manycore hardware at a given NPA
+         *
+         * The NPA must be a DRAM address or an address in a vanilla core.
+         * The operation is applied at the endpoint in a single round trip.
+         *
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+         * @param[in]  op     The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  v      The operand of the operation
+         * @param[out] vpo    Pointer to the previous value at the NPA (may be NULL)
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_amo32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                 hb_mc_packet_op_t op, uint32_t v, uint32_t *vpo);
+
         /**
          * Do a 32-bit amoadd to manycore hardware at a given NPA (must be a DRAM address)
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -264,6 +305,73 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_amoadd32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, uint32_t vpi, uint32_t *vpo);
 
+        /**
+         * Start reading a 32-bit word from manycore hardware at a given NPA
+         *
+         * The read is in flight when this function returns. Up to
+         * the remote load capacity of reads may be in flight at once,
+         * across all callers; if none are free, this waits for a
+         * response from an earlier read.
+         *
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+         * @param[out] vp     A word to be set to the data read. Must remain valid until #ticket completes.
+         * @param[out] ticket A ticket that completes when #vp has been written
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_read32_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                        uint32_t *vp, hb_mc_ticket_t *ticket);
+
+        /**
+         * Start writing a 32-bit word to manycore hardware at a given NPA
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A valid hb_mc_npa_t aligned to a four byte boundary
+         * @param[in]  v      A word value to be written out
+         * @param[out] ticket A ticket that completes when the write has reached #npa
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write32_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                         uint32_t v, hb_mc_ticket_t *ticket);
+
+        /**
+         * Start reading memory from manycore hardware starting at a given NPA
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A valid hb_mc_npa_t
+         * @param[out] data   A buffer into which data will be read. Must remain valid until #ticket completes.
+         * @param[in]  sz     The number of bytes to read from manycore hardware
+         * @param[out] ticket A ticket that completes when #data has been written
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_read_mem_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                          void *data, size_t sz, hb_mc_ticket_t *ticket);
+
+        /**
+         * Check whether all requests associated with a ticket have completed
+         *
+         * This consumes the responses (for any ticket) that have
+         * already arrived, and does not wait for more. A completed
+         * ticket must still be released with hb_mc_manycore_request_wait().
+         *
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  ticket A ticket returned by an asynchronous request
+         * @param[out] done   Set to 1 if the ticket's requests have completed, 0 otherwise
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_request_poll(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket, int *done);
+
+        /**
+         * Wait until all requests associated with a ticket have completed, and release the ticket
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  ticket A ticket returned by an asynchronous request
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_request_wait(hb_mc_manycore_t *mc, hb_mc_ticket_t ticket);
+
         /**
          * Set memory to a given value starting at a given NPA
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -288,6 +396,36 @@ extern "C" {
         int hb_mc_manycore_write_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                      const void *data, size_t sz);
 
+        /**
+         * Write the same buffer out to manycore hardware starting at each of a list of NPAs
+         * Stores are interleaved across destinations so that all destinations are written in parallel.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n_npas valid hb_mc_npa_t
+         * @param[in]  n_npas The number of NPAs in #npas
+         * @param[in]  data   A buffer to be written out manycore hardware
+         * @param[in]  sz     The number of bytes to write at each NPA
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_mem_broadcast(hb_mc_manycore_t *mc,
+                                               const hb_mc_npa_t *npas, size_t n_npas,
+                                               const void *data, size_t sz);
+
+        /**
+         * Set memory to a given value starting at each of a list of NPAs
+         * Stores are interleaved across destinations so that all destinations are written in parallel.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n_npas valid hb_mc_npa_t
+         * @param[in]  n_npas The number of NPAs in #npas
+         * @param[in]  val    Value to be written out
+         * @param[in]  sz     The number of bytes to write at each NPA
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_memset_broadcast(hb_mc_manycore_t *mc,
+                                            const hb_mc_npa_t *npas, size_t n_npas,
+                                            uint8_t val, size_t sz);
+
         /**
          * Read memory from manycore hardware starting at a given NPA
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -313,6 +451,46 @@ extern "C" {
         int hb_mc_manycore_read_mem_scatter_gather(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                                    uint32_t *data, size_t words);
 
+        /**
+         * Write words to a vector of NPAs
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A vector of valid hb_mc_npa_t of length <= #words
+         * @param[in]  data   A word vector to be written out
+         * @param[in]  words  The number of words to write to manycore hardware
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_mem_scatter_gather(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                                    const uint32_t *data, size_t words);
+
+        /**
+         * Write a list of host buffers out to a list of NPA ranges
+         * All ranges are written in a single bulk transfer with a single fence.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n valid hb_mc_npa_t - start of each range
+         * @param[in]  data   An array of #n 32-bit aligned host buffers, one for each range
+         * @param[in]  szs    An array of #n sizes in bytes (multiples of 4), one for each range
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_mem_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                            const void * const *data, const size_t *szs, size_t n);
+
+        /**
+         * Read a list of NPA ranges into a list of host buffers
+         * All ranges are read in a single bulk transfer.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n valid hb_mc_npa_t - start of each range
+         * @param[out] data   An array of #n 32-bit aligned host buffers, one for each range
+         * @param[in]  szs    An array of #n sizes in bytes (multiples of 4), one for each range
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_read_mem_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                           void * const *data, const size_t *szs, size_t n);
+
         /***********/
         /* DMA API */
         /***********/
@@ -410,6 +588,45 @@ extern "C" {
         int hb_mc_manycore_dma_read_no_cache_afl(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                                  void *data, size_t sz);
 
+        /**
+         * Write a list of host buffers to a list of DRAM NPA ranges via DMA - unsafe
+         * The ranges are copied as one batch, which the platform may reorder and merge.
+         * Ranges that overlap are written in order.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n NPAs (must map to DRAM)
+         * @param[in]  data   An array of #n host buffers
+         * @param[in]  szs    An array of #n sizes in bytes
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         *
+         * Stale data may remain in the cache, as with hb_mc_manycore_dma_write_no_cache_ainv().
+         * This function is not supported on all HammerBlade platforms.
+         * Please check the return code for HB_MC_NOIMPL.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_dma_write_ranges_no_cache_ainv(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                          const void * const *data, const size_t *szs,
+                                                          size_t n);
+
+        /**
+         * Read a list of DRAM NPA ranges into a list of host buffers via DMA - unsafe
+         * The ranges are copied as one batch, which the platform may reorder and merge.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n NPAs (must map to DRAM)
+         * @param[out] data   An array of #n host buffers
+         * @param[in]  szs    An array of #n sizes in bytes
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         *
+         * Cached data may not be flushed, as with hb_mc_manycore_dma_read_no_cache_afl().
+         * This function is not supported on all HammerBlade platforms.
+         * Please check the return code for HB_MC_NOIMPL.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_dma_read_ranges_no_cache_afl(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                        void * const *data, const size_t *szs,
+                                                        size_t n);
+
         /************************/
         /* Cache Operations API */
         /************************/
@@ -444,6 +661,58 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_vcache_flush_npa_range(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, size_t sz);
 
+        /**
+         * Invalidate a list of ranges of manycore DRAM addresses.
+         * Cache operations for all ranges are sent as one batch.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range to invalidate
+         * @param[in]  szs    An array of #n sizes in bytes, one for each range
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_vcache_invalidate_npa_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                        const size_t *szs, size_t n);
+
+        /**
+         * Flush a list of ranges of manycore DRAM addresses.
+         * Cache operations for all ranges are sent as one batch, and completion
+         * is confirmed with a single read from each victim cache that was flushed.
+         * Parts of the ranges that the host knows are clean are skipped.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range to flush
+         * @param[in]  szs    An array of #n sizes in bytes, one for each range
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_vcache_flush_npa_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                   const size_t *szs, size_t n);
+
+        /**
+         * Mark a list of ranges of manycore DRAM addresses as possibly dirty in the victim caches.
+         * The host tracks its own stores to DRAM. Use this for DRAM written by
+         * other agents, so that later flushes of these ranges are not skipped.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of #n valid hb_mc_npa_t (must map to DRAM) - start of each range
+         * @param[in]  szs    An array of #n sizes in bytes, one for each range
+         * @param[in]  n      The number of ranges
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_vcache_mark_dirty_npa_ranges(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                                        const size_t *szs, size_t n);
+
+        /**
+         * Mark every victim cache in a pod as possibly dirty.
+         * Call this when kernels may have written to DRAM through the pod's caches.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  pod    A pod
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_pod_vcache_mark_dirty(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod);
+
         /**
          * Flush a cache tag.
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -491,6 +760,7 @@ extern "C" {
 
         /**
          * Flush entire victim cache for pod.
+         * Caches that the host knows are clean are skipped.
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
          */
         __attribute__((warn_unused_result))
@@ -564,6 +834,47 @@ extern "C" {
                 e_instr_all = 2 //<! All instructions (including branches, jumps, and control flow)
         } bsg_instr_type_e;
 
+#define HB_MC_INSTR_TYPE_MAX (e_instr_all + 1)
+
+        /* Performance counters of one tile */
+        typedef struct hb_mc_tile_counters {
+                hb_mc_coordinate_t tile;               //!< the tile
+                uint64_t icount[HB_MC_INSTR_TYPE_MAX]; //!< instructions executed, indexed by bsg_instr_type_e
+        } hb_mc_tile_counters_t;
+
+        /**
+         * Get the performance counters of every tile, read in one sweep.
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] counters An array of at least #n counters
+         * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+         * @param[out] ntiles   The number of tiles with counters, which may be more than #n
+         * @param[in]  delta    If nonzero, get the change since the last call with #delta set, and
+         *                      make these counters the baseline for the next call.
+         *                      The first call with #delta set gets the change since reset.
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_manycore_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                        size_t n, size_t *ntiles, int delta);
+
+        /* The number of times one tile was sampled at one PC */
+        typedef struct hb_mc_pc_sample {
+                hb_mc_coordinate_t tile; //!< the tile
+                uint32_t pc;             //!< the program counter, an EVA
+                uint64_t count;          //!< the number of samples at #pc
+        } hb_mc_pc_sample_t;
+
+        /**
+         * Get the PC histogram of every tile since reset.
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] samples  An array of at least #n samples
+         * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+         * @param[out] nsamples The number of nonzero (tile, PC) samples, which may be more than #n
+         * @return HB_MC_SUCCESS on success. HB_MC_NOIMPL if the platform has no PC histogram.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_manycore_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                            size_t n, size_t *nsamples);
+
         /**
          * Get the number of instructions executed for a certain class of instructions
          * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
@@ -32,9 +32,15 @@
 
 #ifdef __cplusplus
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #else
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
 #endif
+#include <inttypes.h>
+#include <unistd.h>
 
 static const char error_init_help [] = "Is your FPGA initialized with an AGFI?";
 
@@ -212,3 +218,105 @@ int hb_mc_config_init(const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
 
         return hb_mc_config_init_check_memsys(config);
 }
+
+/* The build that decoded a snapshot. A new build may decode differently. */
+static const char config_snapshot_build[] = __DATE__ " " __TIME__;
+
+#define CONFIG_SNAPSHOT_MAGIC 0x53434248 // "HBCS"
+
+typedef struct config_snapshot {
+        uint32_t magic;
+        uint32_t config_sz;
+        char build[sizeof(config_snapshot_build)];
+        hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX];
+        hb_mc_config_t config;
+} config_snapshot_t;
+
+uint64_t hb_mc_config_raw_hash(const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX])
+{
+        // FNV-1a
+        uint64_t h = 0xcbf29ce484222325ULL;
+        const unsigned char *p = (const unsigned char *)raw;
+        for (size_t i = 0; i < sizeof(hb_mc_config_raw_t) * HB_MC_CONFIG_MAX; i++) {
+                h ^= p[i];
+                h *= 0x100000001b3ULL;
+        }
+        return h;
+}
+
+static void hb_mc_config_snapshot_path(const char *dir,
+                                       const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
+                                       char *path, size_t sz)
+{
+        snprintf(path, sz, "%s/hb_mc_config_%016" PRIx64 ".snapshot",
+                 dir, hb_mc_config_raw_hash(raw));
+}
+
+int hb_mc_config_snapshot_load(const char *dir,
+                               const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
+                               hb_mc_config_t *config)
+{
+        char path[4096];
+        config_snapshot_t snap;
+        FILE *f;
+        size_t n;
+
+        hb_mc_config_snapshot_path(dir, raw, path, sizeof(path));
+
+        f = fopen(path, "rb");
+        if (!f)
+                return HB_MC_NOTFOUND;
+
+        n = fread(&snap, sizeof(snap), 1, f);
+        fclose(f);
+
+        if (n != 1
+            || snap.magic != CONFIG_SNAPSHOT_MAGIC
+            || snap.config_sz != sizeof(hb_mc_config_t)
+            || memcmp(snap.build, config_snapshot_build, sizeof(snap.build)) != 0
+            || memcmp(snap.raw, raw, sizeof(snap.raw)) != 0) {
+                bsg_pr_dbg("%s: ignoring stale snapshot %s\n", __func__, path);
+                return HB_MC_NOTFOUND;
+        }
+
+        *config = snap.config;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_config_snapshot_save(const char *dir,
+                               const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
+                               const hb_mc_config_t *config)
+{
+        char path[4096], tmp[4096 + 32];
+        config_snapshot_t snap;
+        FILE *f;
+        int err = HB_MC_SUCCESS;
+
+        memset(&snap, 0, sizeof(snap));
+        snap.magic = CONFIG_SNAPSHOT_MAGIC;
+        snap.config_sz = sizeof(hb_mc_config_t);
+        memcpy(snap.build, config_snapshot_build, sizeof(snap.build));
+        memcpy(snap.raw, raw, sizeof(snap.raw));
+        snap.config = *config;
+
+        hb_mc_config_snapshot_path(dir, raw, path, sizeof(path));
+        snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+
+        f = fopen(tmp, "wb");
+        if (!f)
+                return HB_MC_FAIL;
+
+        if (fwrite(&snap, sizeof(snap), 1, f) != 1)
+                err = HB_MC_FAIL;
+
+        if (fclose(f) != 0)
+                err = HB_MC_FAIL;
+
+        if (err == HB_MC_SUCCESS && rename(tmp, path) != 0)
+                err = HB_MC_FAIL;
+
+        if (err != HB_MC_SUCCESS)
+                remove(tmp);
+
+        return err;
+}
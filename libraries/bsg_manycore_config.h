@@ -148,6 +148,45 @@ extern "C" {
 
         int hb_mc_config_init(const hb_mc_config_raw_t mc[HB_MC_CONFIG_MAX], hb_mc_config_t *config);
 
+/* If set, configuration snapshots are kept in the directory named by this variable */
+#define HB_MC_CONFIG_SNAPSHOT_DIR_ENV "BSG_MANYCORE_CONFIG_CACHE"
+
+        /**
+         * Hash a configuration ROM image.
+         * Snapshots are keyed by this hash.
+         * @param[in] raw  A configuration ROM image.
+         * @return A 64-bit hash of #raw.
+         */
+        uint64_t hb_mc_config_raw_hash(const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX]);
+
+        /**
+         * Initialize a configuration from a snapshot saved by hb_mc_config_snapshot_save().
+         * The snapshot is used only if it was saved by this build of the library
+         * from a ROM image identical to #raw.
+         * @param[in]  dir     A directory of snapshots.
+         * @param[in]  raw     A configuration ROM image.
+         * @param[out] config  A configuration to initialize.
+         * @return HB_MC_SUCCESS if a valid snapshot was found. HB_MC_NOTFOUND otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_config_snapshot_load(const char *dir,
+                                       const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
+                                       hb_mc_config_t *config);
+
+        /**
+         * Save a snapshot of a configuration initialized with hb_mc_config_init().
+         * The snapshot is written to a temporary file and renamed into place, so
+         * concurrent processes never read a partial snapshot.
+         * @param[in]  dir     A directory of snapshots.
+         * @param[in]  raw     The configuration ROM image from which #config was initialized.
+         * @param[in]  config  A configuration.
+         * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_config_snapshot_save(const char *dir,
+                                       const hb_mc_config_raw_t raw[HB_MC_CONFIG_MAX],
+                                       const hb_mc_config_t *config);
+
         static inline uint64_t hb_mc_config_id_to_addr(uint64_t addr, hb_mc_config_id_t id)
         {
                 return (addr + (id << 2));
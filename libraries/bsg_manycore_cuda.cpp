@@ -35,9 +35,20 @@
 #include <bsg_manycore_eva.h>
 #include <bsg_manycore_origin_eva_map.h>
 #include <bsg_manycore_config_pod.h>
+#include <bsg_manycore_responder.h>
 
 #ifdef __cplusplus
 #include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #else
 #include <string.h>
 #endif
@@ -184,7 +195,7 @@ static int hb_mc_program_allocator_init (const hb_mc_config_t *cfg,
         program->allocator->id = id;
 
         hb_mc_eva_t program_end_eva;
-        error = hb_mc_loader_symbol_to_eva(program->bin, program->bin_size, "_bsg_dram_end_addr", &program_end_eva);
+        error = hb_mc_loader_program_symbol(program->loader, "_bsg_dram_end_addr", &program_end_eva, NULL);
         if (error != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to acquire _bsg_dram_end_addr eva from binary file.\n", __func__);
                 return HB_MC_INVALID;
@@ -234,7 +245,7 @@ static int hb_mc_program_allocator_exit (hb_mc_allocator_t *allocator) {
                 bsg_pr_err("%s: calling exit on allocator with null memory manager.\n", __func__);
                 return HB_MC_INVALID;
         } else {
-                free ((awsbwhal::MemoryManager *) memory_manager);
+                delete memory_manager;
                 allocator->memory_manager = NULL;
         }
         free(allocator);
@@ -260,6 +271,57 @@ static hb_mc_epa_t hb_mc_tile_group_get_finish_signal_addr(hb_mc_tile_group_t *t
         return finish_addr;
 }
 
+/**
+ * Launched tile groups in a pod, indexed by the origin of the tile
+ * group and the EPA of its finish signal. The value is the index of
+ * the tile group in pod->tile_groups (the array is reallocated as
+ * tile groups are enqueued, so pointers into it are not stable).
+ */
+typedef std::unordered_map<uint64_t, uint32_t> hb_mc_finish_index_t;
+
+static uint64_t hb_mc_finish_index_key(hb_mc_coordinate_t origin, hb_mc_epa_t epa)
+{
+        return (static_cast<uint64_t>(epa) << 32)
+                | (static_cast<uint64_t>(static_cast<uint16_t>(hb_mc_coordinate_get_y(origin))) << 16)
+                | static_cast<uint64_t>(static_cast<uint16_t>(hb_mc_coordinate_get_x(origin)));
+}
+
+static hb_mc_finish_index_t *hb_mc_device_pod_get_finish_index(hb_mc_pod_t *pod)
+{
+        return reinterpret_cast<hb_mc_finish_index_t*>(pod->launched);
+}
+
+/**
+ * Device buffers for tile group launches that are kept for reuse
+ * rather than returned to the pod's allocator when a tile group
+ * exits. They are released along with the program's memory.
+ *
+ * argv buffers are pooled by size in bytes. Barrier configuration
+ * buffers are pooled by tile group shape: a buffer that is returned
+ * to the pool still holds the CSR values for its shape, so reusing
+ * it only requires resetting the barrier lock word.
+ */
+typedef struct {
+        std::vector<int>         image; // host copy of the CSR values (word 0 is the lock)
+        std::vector<hb_mc_eva_t> free;  // device buffers holding #image
+} hb_mc_barcfg_pool_t;
+
+typedef struct {
+        std::unordered_map<uint32_t, std::vector<hb_mc_eva_t>> argv;
+        std::unordered_map<uint32_t, hb_mc_barcfg_pool_t>      barcfg;
+} hb_mc_pod_arena_t;
+
+static hb_mc_pod_arena_t *hb_mc_device_pod_get_arena(hb_mc_pod_t *pod)
+{
+        return reinterpret_cast<hb_mc_pod_arena_t*>(pod->arena);
+}
+
+static uint32_t hb_mc_barcfg_pool_key(hb_mc_dimension_t dim)
+{
+        return (static_cast<uint32_t>(static_cast<uint16_t>(hb_mc_dimension_get_y(dim))) << 16)
+                | static_cast<uint32_t>(static_cast<uint16_t>(hb_mc_dimension_get_x(dim)));
+}
+
 
 
 
@@ -288,7 +350,7 @@ static int tile_set_symbol_val(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_t
         hb_mc_eva_t symbol_dev;
         int r;
 
-        r = hb_mc_loader_symbol_to_eva(program->bin, program->bin_size, symbol, &symbol_dev);
+        r = hb_mc_loader_program_symbol(program->loader, symbol, &symbol_dev, NULL);
         if (r != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to find symbol '%s' in program '%s': %s\n",
                            __func__,
@@ -510,6 +572,8 @@ static int hb_mc_device_pod_init(hb_mc_device_t *device,
         pod->tile_group_capacity = 0;
         pod->num_grids           = 0;
         pod->program_loaded      = 0;
+        pod->launched            = NULL;
+        pod->arena               = NULL;
         return HB_MC_SUCCESS;
 }
 
@@ -762,6 +826,8 @@ int hb_mc_device_pod_tile_groups_init(hb_mc_device_t *device,
         pod->tile_groups = groups;
         pod->tile_group_capacity = capacity;
         pod->num_tile_groups = 0;
+        pod->launched = new hb_mc_finish_index_t;
+        pod->arena = new hb_mc_pod_arena_t;
 
         return HB_MC_SUCCESS;
 
@@ -796,12 +862,11 @@ int hb_mc_device_pod_program_load (hb_mc_device_t *device, hb_mc_pod_t *pod)
 
 
         // Load binary into all tiles
-        r = hb_mc_loader_load (pod->program->bin,
-                               pod->program->bin_size,
-                               device->mc,
-                               &default_map,
-                               tile_list,
-                               mesh_num_tiles(pod->mesh));
+        r = hb_mc_loader_program_load (pod->program->loader,
+                                       device->mc,
+                                       &default_map,
+                                       tile_list,
+                                       mesh_num_tiles(pod->mesh));
         if (r != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to load program '%s': %s\n",
                            __func__,
@@ -945,6 +1010,9 @@ int hb_mc_device_pod_program_init_binary_opts(hb_mc_device_t       *device,
                 program->bin_size = bin_size;
         }
 
+        // validate binary and index its symbols
+        BSG_CUDA_CALL(hb_mc_loader_program_open(program->bin, program->bin_size, &program->loader));
+
         // initialize memory allocator
         const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
         BSG_CUDA_CALL(hb_mc_program_allocator_init (cfg, program, popts->alloc_name, popts->alloc_id));
@@ -1012,6 +1080,14 @@ int hb_mc_device_pod_tile_groups_exit(hb_mc_device_t *device,
         pod->tile_group_capacity = 0;
         pod->num_tile_groups = 0;
 
+        // free the finish signal index
+        delete hb_mc_device_pod_get_finish_index(pod);
+        pod->launched = NULL;
+
+        // forget reusable buffers; their memory is freed with the program's allocator
+        delete hb_mc_device_pod_get_arena(pod);
+        pod->arena = NULL;
+
         return HB_MC_SUCCESS;
 }
 
@@ -1062,6 +1138,10 @@ int hb_mc_device_pod_program_finish(hb_mc_device_t *device,
         // free allocator
         BSG_CUDA_CALL(hb_mc_program_allocator_exit(program->allocator));
 
+        // free parsed binary
+        hb_mc_loader_program_close(program->loader);
+        program->loader = NULL;
+
         // free bin data
         free(const_cast<unsigned char*>(program->bin));
         program->bin = NULL;
@@ -1121,6 +1201,54 @@ int hb_mc_device_pod_malloc(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Allocates memory on device's DRAM associated with the input pod, at an aligned address
+ * hb_mc_device_pod_program_init() should have been called for device and pod
+ * before calling this function to set up a memory allocator.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID with a prorgam initialized
+ * @parma[in]  size          Size of requested memory
+ * @param[in]  alignment     Alignment of the memory in bytes (a power of two)
+ * @param[out] eva           Eva address of the allocated memory
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_malloc_aligned(hb_mc_device_t *device,
+                                    hb_mc_pod_id_t  pod_id,
+                                    uint32_t        size,
+                                    uint32_t        alignment,
+                                    hb_mc_eva_t    *eva)
+{
+        CHECK_POD_ID(device, pod_id);
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+        hb_mc_program_t *program = pod->program;
+        // check pod has program loaded
+        if (program == NULL) {
+                bsg_pr_err("%s: no program load on pod: %s\n",
+                           __func__,
+                           hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_INVALID;
+        }
+
+        // a power of two is a multiple of the allocator's own alignment,
+        // so free extents stay aligned
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+                bsg_pr_err("%s: alignment %" PRIu32 " is not a power of two\n",
+                           __func__, alignment);
+                return HB_MC_INVALID;
+        }
+
+        awsbwhal::MemoryManager *mem_manager = reinterpret_cast<awsbwhal::MemoryManager*>(program->allocator->memory_manager);
+        hb_mc_eva_t result = mem_manager->alloc(size, alignment);
+        if (result == awsbwhal::MemoryManager::mNull) {
+                bsg_pr_err("%s: failed to allocate %" PRIu32 " bytes aligned to %" PRIu32 "\n",
+                           __func__, size, alignment);
+                return HB_MC_NOMEM;
+        }
+
+        *eva = result;
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Frees memory on device's DRAM associated with the input pod
  * hb_mc_device_pod_program_init() should have been called for device and pod
@@ -1151,6 +1279,42 @@ int hb_mc_device_pod_free(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Reports the state of the DRAM allocator associated with the input pod
+ * hb_mc_device_pod_program_init() should have been called for device and pod
+ * before calling this function to set up a memory allocator.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID with a prorgam initialized
+ * @param[out] stats         Allocator statistics
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_malloc_stats(hb_mc_device_t *device,
+                                  hb_mc_pod_id_t  pod_id,
+                                  hb_mc_malloc_stats_t *stats)
+{
+        CHECK_POD_ID(device, pod_id);
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+        hb_mc_program_t *program = pod->program;
+        // check pod has program loaded
+        if (program == NULL) {
+                bsg_pr_err("%s: no program load on pod %d: %s\n",
+                           __func__,
+                           pod_id,
+                           hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_INVALID;
+        }
+
+        awsbwhal::MemoryManager *mem_manager = reinterpret_cast<awsbwhal::MemoryManager*>(program->allocator->memory_manager);
+        awsbwhal::MemoryManager::Stats s = mem_manager->stats();
+        stats->free_bytes = s.freeSize;
+        stats->busy_bytes = s.busySize;
+        stats->largest_free = s.largestFree;
+        stats->free_extents = s.freeExtents;
+        stats->busy_blocks = s.busyBlocks;
+        stats->fragmentation = s.fragmentation;
+        return HB_MC_SUCCESS;
+}
+
 /*******************************/
 /* Pod Interface Data Movement */
 /*******************************/
@@ -1245,6 +1409,88 @@ int hb_mc_device_pod_memcpy_to_host(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Copies a 2D region from the host to pod DRAM, like cudaMemcpy2D.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID
+ * @parma[in]  dst           EVA address of the first destination row
+ * @param[in]  dpitch        Distance in bytes between destination rows
+ * @parma[in]  src           Host address of the first source row
+ * @param[in]  spitch        Distance in bytes between source rows
+ * @param[in]  width         Number of bytes in a row
+ * @param[in]  height        Number of rows
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_memcpy2d_to_device(hb_mc_device_t *device,
+                                        hb_mc_pod_id_t pod_id,
+                                        hb_mc_eva_t dst,
+                                        size_t dpitch,
+                                        const void *src,
+                                        size_t spitch,
+                                        size_t width,
+                                        size_t height)
+{
+        CHECK_POD_ID(device, pod_id);
+
+        if (width > dpitch || width > spitch) {
+                bsg_pr_err("%s: width (%zu) is larger than a pitch (%zu, %zu)\n",
+                           __func__, width, dpitch, spitch);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+
+        BSG_CUDA_CALL(hb_mc_manycore_eva_write_strided(device->mc,
+                                                       &default_map,
+                                                       &pod->mesh->origin,
+                                                       &dst, dpitch,
+                                                       src, spitch,
+                                                       width, height));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Copies a 2D region from pod DRAM to the host, like cudaMemcpy2D.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID
+ * @parma[in]  dst           Host address of the first destination row
+ * @param[in]  dpitch        Distance in bytes between destination rows
+ * @parma[in]  src           EVA address of the first source row
+ * @param[in]  spitch        Distance in bytes between source rows
+ * @param[in]  width         Number of bytes in a row
+ * @param[in]  height        Number of rows
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_memcpy2d_to_host(hb_mc_device_t *device,
+                                      hb_mc_pod_id_t pod_id,
+                                      void *dst,
+                                      size_t dpitch,
+                                      hb_mc_eva_t src,
+                                      size_t spitch,
+                                      size_t width,
+                                      size_t height)
+{
+        CHECK_POD_ID(device, pod_id);
+
+        if (width > dpitch || width > spitch) {
+                bsg_pr_err("%s: width (%zu) is larger than a pitch (%zu, %zu)\n",
+                           __func__, width, dpitch, spitch);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+
+        BSG_CUDA_CALL(hb_mc_manycore_eva_read_strided(device->mc,
+                                                      &default_map,
+                                                      &pod->mesh->origin,
+                                                      &src, spitch,
+                                                      dst, dpitch,
+                                                      width, height));
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Sets memory to a given value starting from an address in pod's DRAM.
  * @param[in]  device        Pointer to device
@@ -1273,6 +1519,37 @@ int hb_mc_device_pod_memset (hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Atomically applies an operation to a word in pod's DRAM or tile memory.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID
+ * @parma[in]  eva           EVA address of the word (four byte aligned)
+ * @param[in]  op            The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  val           The operand of the operation
+ * @param[out] old           The previous value of the word (may be NULL)
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_amo (hb_mc_device_t *device,
+                          hb_mc_pod_id_t pod_id,
+                          hb_mc_eva_t eva,
+                          hb_mc_packet_op_t op,
+                          uint32_t val,
+                          uint32_t *old)
+{
+        CHECK_POD_ID(device, pod_id);
+
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+
+        BSG_CUDA_CALL(hb_mc_manycore_eva_amo(device->mc,
+                                             &default_map,
+                                             &pod->mesh->origin,
+                                             &eva,
+                                             op,
+                                             val,
+                                             old));
+        return HB_MC_SUCCESS;
+}
+
 /***********************************/
 /* Pod Interface Execution Control */
 /***********************************/
@@ -1313,11 +1590,14 @@ static int hb_mc_device_pod_tile_group_init(hb_mc_device_t* device,
 static int hb_mc_device_pod_tile_group_exit(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg)
 {
 
-        // Free the memory location in the device that holds the list of
-        // arguments of tile group's kernel
-        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
-        BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, tg->argv_eva));
-        BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, tg->barcfg_eva));
+        // Return the device buffers that hold the list of arguments of
+        // tile group's kernel and its barrier configuration for reuse
+        if (tg->status == HB_MC_TILE_GROUP_STATUS_LAUNCHED) {
+                hb_mc_pod_arena_t *arena = hb_mc_device_pod_get_arena(pod);
+                arena->argv[tg->kernel->argc * sizeof(*(tg->kernel->argv))].push_back(tg->argv_eva);
+                if (tg->barcfg_eva != 0)
+                        arena->barcfg[hb_mc_barcfg_pool_key(tg->dim)].free.push_back(tg->barcfg_eva);
+        }
 
         // release tile gorup resources
         tg->dim = HB_MC_DIMENSION(0,0);
@@ -1443,6 +1723,73 @@ int hb_mc_device_pod_all_tile_groups_finished(hb_mc_device_t *device, hb_mc_pod_
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Find a free rectangle of tiles in a pod's mesh.
+ *
+ * A summed-area table of busy tiles is built once per call, so that
+ * whether a candidate rectangle is free can be checked in constant
+ * time. Among all free rectangles, the one whose border touches the
+ * most busy tiles and mesh edges is chosen (best fit), so that small
+ * tile groups pack together and leave large free regions intact.
+ * Ties go to the first candidate in the order of foreach_coordinate().
+ * @param[in]  pod     Pointer to pod
+ * @param[in]  dim     Dimension of the rectangle to find
+ * @param[out] origin  Origin of a free rectangle, in absolute coordinates
+ * @return HB_MC_SUCCESS if a free rectangle was found. HB_MC_NOTFOUND otherwise.
+ */
+static int hb_mc_device_pod_mesh_find_free(hb_mc_pod_t *pod,
+                                           hb_mc_dimension_t dim,
+                                           hb_mc_coordinate_t *origin)
+{
+        hb_mc_mesh_t *mesh = pod->mesh;
+        int W = hb_mc_dimension_get_x(mesh->dim), H = hb_mc_dimension_get_y(mesh->dim);
+        int w = hb_mc_dimension_get_x(dim), h = hb_mc_dimension_get_y(dim);
+
+        if (w < 1 || h < 1 || w > W || h > H)
+                return HB_MC_NOTFOUND;
+
+        // busy[y*(W+1)+x] = number of busy tiles in the rectangle [0,x) x [0,y)
+        std::vector<int> busy((W+1) * (H+1), 0);
+        auto area = [&](int x, int y) -> int& { return busy[y * (W+1) + x]; };
+
+        for (int y = 1; y <= H; y++) {
+                for (int x = 1; x <= W; x++) {
+                        hb_mc_coordinate_t xy = hb_mc_coordinate(mesh->origin.x + x - 1,
+                                                                 mesh->origin.y + y - 1);
+                        hb_mc_idx_t tile_id = hb_mc_get_tile_id(mesh->origin, mesh->dim, xy);
+                        int is_busy = mesh->tiles[tile_id].status != HB_MC_TILE_STATUS_FREE;
+                        area(x, y) = is_busy + area(x, y-1) + area(x-1, y) - area(x-1, y-1);
+                }
+        }
+
+        // number of busy tiles in [x0,x1) x [y0,y1), clipped to the mesh
+        auto busy_in = [&](int x0, int y0, int x1, int y1) {
+                x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+                x1 = std::min(x1, W); y1 = std::min(y1, H);
+                return area(x1, y1) - area(x1, y0) - area(x0, y1) + area(x0, y0);
+        };
+
+        int best = -1;
+        for (int x = 0; x + w <= W; x++) {
+                for (int y = 0; y + h <= H; y++) {
+                        if (busy_in(x, y, x + w, y + h) != 0)
+                                continue;
+
+                        // score the border: busy neighbors plus edges of the mesh
+                        int fit = busy_in(x - 1, y - 1, x + w + 1, y + h + 1);
+                        fit += (x == 0 ? h : 0) + (x + w == W ? h : 0);
+                        fit += (y == 0 ? w : 0) + (y + h == H ? w : 0);
+
+                        if (fit > best) {
+                                best = fit;
+                                *origin = hb_mc_coordinate(mesh->origin.x + x, mesh->origin.y + y);
+                        }
+                }
+        }
+
+        return best < 0 ? HB_MC_NOTFOUND : HB_MC_SUCCESS;
+}
+
 /**
  * Allocate a group of free tiles and store their origin in tile_group
  */
@@ -1450,87 +1797,52 @@ __attribute__((warn_unused_result))
 static
 int hb_mc_device_pod_tile_group_allocate_tiles(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tile_group)
 {
-
-
         bsg_pr_dbg("%s: device<%s>: program<%s>: calling\n",
                    __func__, device->name, pod->program->bin_name);
 
-        // calculate boundary condition
-        hb_mc_dimension_t origin_boundary;
-        BSG_CUDA_CALL(hb_mc_coordinate_sub_safe(pod->mesh->dim, tile_group->dim, &origin_boundary));
-        origin_boundary = hb_mc_coordinate_add(origin_boundary, hb_mc_dimension(1,1));
-
-        // scan for contiguous group of free tile groups
+        // find a free group of tiles
         hb_mc_coordinate_t origin;
-        int tiles_are_free = 0;
+        if (hb_mc_device_pod_mesh_find_free(pod, tile_group->dim, &origin) != HB_MC_SUCCESS)
+                return HB_MC_NOTFOUND;
 
 #if defined (DEBUG)
         char origin_str[256];
-        char boundary_str[256];
+        char dim_str[256];
 #endif
 
-        bsg_pr_dbg("%s: scanning orig:%s  dim:%s\n",
+        bsg_pr_dbg("%s: allocating %s at %s\n",
                    __func__,
-                   hb_mc_coordinate_to_string(pod->mesh->origin, origin_str, sizeof(origin_str)),
-                   hb_mc_coordinate_to_string(origin_boundary, boundary_str, sizeof(boundary_str)));
+                   hb_mc_coordinate_to_string(tile_group->dim, dim_str, sizeof(dim_str)),
+                   hb_mc_coordinate_to_string(origin, origin_str, sizeof(origin_str)));
 
-        foreach_coordinate(origin, pod->mesh->origin, origin_boundary)
-        {
-                // check if this group of tiles is free
-                // this group is free if the group of tiles about the origin matching
-                // the required tile group size are all free
-                tiles_are_free = 1;
-                hb_mc_coordinate_t xy;
-                foreach_coordinate(xy, origin, tile_group->dim)
-                {
-                        hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
-                        if (pod->mesh->tiles[tile_id].status != HB_MC_TILE_STATUS_FREE) {
-                                tiles_are_free = 0;
-                                break;
-                        }
-                }
+        // these tiles are free; set the origin as the tile groups origin
+        tile_group->origin = origin;
 
+        // initialize eva map to support tile group addressing
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_exit(tile_group->map));
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_init(tile_group->map, origin));
 
-                bsg_pr_dbg("%s: %s %s\n",
-                           __func__,
-                           hb_mc_coordinate_to_string(origin, origin_str, sizeof(origin_str)),
-                           tiles_are_free ? "free" : "not free");
+        // initialize free group of tiles
+        hb_mc_coordinate_t xy;
+        foreach_coordinate(xy, tile_group->origin, tile_group->dim)
+        {
+                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
 
-                if (!tiles_are_free)
-                        continue;
+                // set bookkeeping fields
+                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
+                tile->origin = origin;
+                tile->tile_group_id = tile_group->id;
+                tile->status = HB_MC_TILE_STATUS_BUSY;
 
-                // these tiles are free; set the origin as the tile groups origin
-                tile_group->origin = origin;
-
-                // initialize free group of tiles
-                foreach_coordinate(xy, tile_group->origin, tile_group->dim)
-                {
-                        hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
-
-                        // initialize eva map to support tile group addressing
-                        BSG_CUDA_CALL(hb_mc_origin_eva_map_exit(tile_group->map));
-                        BSG_CUDA_CALL(hb_mc_origin_eva_map_init(tile_group->map, origin));
-
-                        // set bookkeeping fields
-                        hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
-                        tile->origin = origin;
-                        tile->tile_group_id = tile_group->id;
-                        tile->status = HB_MC_TILE_STATUS_BUSY;
-
-                        // set configuration symbols
-                        BSG_CUDA_CALL(tile_set_config_symbols(device, pod, tile,
-                                                              tile_group->map,
-                                                              tile_group->origin,
-                                                              tile_group->id,
-                                                              tile_group->dim,
-                                                              tile_group->grid_dim));
-                }
-                break; // done
+                // set configuration symbols
+                BSG_CUDA_CALL(tile_set_config_symbols(device, pod, tile,
+                                                      tile_group->map,
+                                                      tile_group->origin,
+                                                      tile_group->id,
+                                                      tile_group->dim,
+                                                      tile_group->grid_dim));
         }
 
-        if (!tiles_are_free)
-                return HB_MC_NOTFOUND;
-
         tile_group->status = HB_MC_TILE_GROUP_STATUS_ALLOCATED;
         return HB_MC_SUCCESS;
 }
@@ -1587,10 +1899,10 @@ static int hb_mc_device_pod_tile_group_barrier_init(hb_mc_device_t *device
         // to do this, look for a symbol "__cuda_barrier_cfg"
         int err;
         hb_mc_eva_t barr_config_ptr;
-        err = hb_mc_loader_symbol_to_eva(pod->program->bin
-                                         , pod->program->bin_size
-                                         , "__cuda_barrier_cfg"
-                                         , &barr_config_ptr);
+        err = hb_mc_loader_program_symbol(pod->program->loader
+                                          , "__cuda_barrier_cfg"
+                                          , &barr_config_ptr
+                                          , NULL);
 
         // if not found, no barrier initialization
         if (err == HB_MC_NOTFOUND) {
@@ -1599,30 +1911,50 @@ static int hb_mc_device_pod_tile_group_barrier_init(hb_mc_device_t *device
         }
 
         // found the barrier pointer
+        // find the csr values for this shape
+        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
+        hb_mc_barcfg_pool_t &pool = hb_mc_device_pod_get_arena(pod)->barcfg[hb_mc_barcfg_pool_key(tg->dim)];
+
+        // reuse a buffer that already holds the csr values
+        // only the amoadd barrier lock needs to be reset
+        if (!pool.free.empty()) {
+                hb_mc_eva_t barcfg_eva = pool.free.back();
+                pool.free.pop_back();
+
+                int lock = 0;
+                BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva, &lock, sizeof(lock)));
+
+                tg->barcfg_eva = barcfg_eva;
+                return HB_MC_SUCCESS;
+        }
+
+        // initialize barcfg the first time this shape is seen
+        if (pool.image.empty()) {
+                pool.image.resize(tg->dim.x * tg->dim.y + 1);
+
+                hb_mc_coordinate_t cord, og = hb_mc_coordinate(0,0);
+                foreach_coordinate(cord, og, tg->dim) {
+                        int id = cord.y * tg->dim.x + cord.x;
+
+                        // compute for id
+                        pool.image[1+id] = hb_mc_hw_barrier_csr_val(&device->mc->config, cord.x, cord.y, tg->dim.x, tg->dim.y);
+                }
+                // word zero holds the amoadd barrier lock
+                pool.image[0] = 0;
+        }
+
         // allocate an array for csr values
         hb_mc_eva_t barcfg_eva;
-        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
         BSG_CUDA_CALL(hb_mc_device_pod_malloc(device
                                               , pod_id
-                                              , (1 + tg->dim.x * tg->dim.y) * sizeof(int)
+                                              , pool.image.size() * sizeof(int)
                                               , &barcfg_eva));
 
-        // initialize barcfg
-        int barcfg [tg->dim.x * tg->dim.y + 1];
-        hb_mc_coordinate_t cord, og = hb_mc_coordinate(0,0);
-        foreach_coordinate(cord, og, tg->dim) {
-                int id = cord.y * tg->dim.x + cord.x;
-
-                // compute for id
-                barcfg[1+id] = hb_mc_hw_barrier_csr_val(&device->mc->config, cord.x, cord.y, tg->dim.x, tg->dim.y);
-        }
-        // word zero holds the amoadd barrier lock
-        barcfg[0] = 0;
-
         // copy csr val vector to device
-        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva, barcfg, sizeof(barcfg)));
+        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva, pool.image.data(),
+                                                        pool.image.size() * sizeof(int)));
 
-        // save so we can free later
+        // save so we can reuse later
         tg->barcfg_eva = barcfg_eva;
 
         return HB_MC_SUCCESS;       
@@ -1637,10 +1969,16 @@ int hb_mc_device_pod_tile_group_launch(hb_mc_device_t *device, hb_mc_pod_t *pod,
                    __func__, device->name, pod->program->bin_name, kernel->name);
 
         // initialize argv
-        // allocate argv
+        // reuse an argv buffer of the same size, or allocate one
         hb_mc_eva_t argv_addr;
         hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
-        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, kernel->argc * sizeof(*(kernel->argv)), &argv_addr));
+        std::vector<hb_mc_eva_t> &argv_free = hb_mc_device_pod_get_arena(pod)->argv[kernel->argc * sizeof(*(kernel->argv))];
+        if (!argv_free.empty()) {
+                argv_addr = argv_free.back();
+                argv_free.pop_back();
+        } else {
+                BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, kernel->argc * sizeof(*(kernel->argv)), &argv_addr));
+        }
         tile_group->argv_eva = argv_addr;
 
         // copy argv over
@@ -1654,8 +1992,11 @@ int hb_mc_device_pod_tile_group_launch(hb_mc_device_t *device, hb_mc_pod_t *pod,
 
         // find kernel
         hb_mc_eva_t kernel_addr;
-        BSG_CUDA_CALL(hb_mc_loader_symbol_to_eva(pod->program->bin, pod->program->bin_size, kernel->name, &kernel_addr));
+        BSG_CUDA_CALL(hb_mc_loader_program_symbol(pod->program->loader, kernel->name, &kernel_addr, NULL));
+
 
+        // the kernel may write anywhere in DRAM
+        BSG_CUDA_CALL(hb_mc_manycore_pod_vcache_mark_dirty(device->mc, pod->pod_coord));
 
         hb_mc_coordinate_t coord;
         foreach_coordinate(coord, tile_group->origin, tile_group->dim)
@@ -1670,15 +2011,24 @@ int hb_mc_device_pod_tile_group_launch(hb_mc_device_t *device, hb_mc_pod_t *pod,
         // make tile group as launched
         tile_group->status = HB_MC_TILE_GROUP_STATUS_LAUNCHED;
 
+        // index by finish signal
+        uint64_t key = hb_mc_finish_index_key(tile_group->origin,
+                                              hb_mc_npa_get_epa(&tile_group->finish_signal_npa));
+        (*hb_mc_device_pod_get_finish_index(pod))[key] = tile_group - pod->tile_groups;
+
         return HB_MC_SUCCESS;
 }
 
+// A deadline (in cycles) that never expires
+#define HB_MC_DEVICE_NO_DEADLINE UINT64_MAX
+
 // forward declaration
 static
 int hb_mc_device_podv_wait_for_tile_group_finish_any(hb_mc_device_t *device,
                                                      hb_mc_pod_id_t *podv,
                                                      int podc,
-                                                     hb_mc_pod_id_t *pod_done);
+                                                     hb_mc_pod_id_t *pod_done,
+                                                     uint64_t deadline);
 
 /**
  * Wait for a tile group to complete for a pod.
@@ -1690,7 +2040,8 @@ int hb_mc_device_pod_wait_for_tile_group_finish_any(hb_mc_device_t *device, hb_m
         pid = hb_mc_device_pod_to_pod_id(device, pod);
         return hb_mc_device_podv_wait_for_tile_group_finish_any(device,
                                                                 &pid, 1,
-                                                                &pid_done);
+                                                                &pid_done,
+                                                                HB_MC_DEVICE_NO_DEADLINE);
 }
 
 /**
@@ -1713,8 +2064,10 @@ int hb_mc_device_pod_try_launch_tile_groups(hb_mc_device_t *device,
                         continue;
 
                 // skip if we know this shape fails
-                if (last_failed.x == tg->dim.x &&
-                    last_failed.y == tg->dim.y)
+                // (so does any shape that contains it)
+                if (last_failed.x != 0 &&
+                    last_failed.x <= tg->dim.x &&
+                    last_failed.y <= tg->dim.y)
                         continue;
 
                 // keep going if we can't allocate
@@ -1799,23 +2152,121 @@ int hb_mc_device_podv_try_launch_tile_groups(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Retire the tile group that sent a finish packet: release its tiles and resources.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pointer to the pod that sent #rqst
+ * @param[in]  rqst          A finish packet
+ * @return HB_MC_SUCCESS if a tile group was retired, HB_MC_NOTFOUND if no launched tile group matches #rqst.
+ *         Otherwise an error code is returned.
+ */
+static
+int hb_mc_device_pod_tile_group_retire(hb_mc_device_t *device,
+                                       hb_mc_pod_t *pod,
+                                       const hb_mc_request_packet_t *rqst)
+{
+        // find the tile group with matching origin and finish signal in pod
+        hb_mc_finish_index_t *launched = hb_mc_device_pod_get_finish_index(pod);
+        if (launched == NULL) {
+                bsg_pr_dbg("%s: finish packet received for pod with no program\n", __func__);
+                return HB_MC_NOTFOUND;
+        }
+
+        hb_mc_coordinate_t src =
+                hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                 hb_mc_request_packet_get_y_src(rqst));
+
+        auto it = launched->find(hb_mc_finish_index_key(src, hb_mc_request_packet_get_epa(rqst)));
+        if (it == launched->end()) {
+                bsg_pr_dbg("%s: packet received with finished signal "
+                           "value but no matching tile-group",
+                           __func__);
+                return HB_MC_NOTFOUND;
+        }
+
+        hb_mc_tile_group_t *tg = &pod->tile_groups[it->second];
+        launched->erase(it);
+
+        // anything flushed while the kernel ran may have been written again
+        BSG_CUDA_CALL(hb_mc_manycore_pod_vcache_mark_dirty(device->mc, pod->pod_coord));
+
+        #ifdef DEBUG
+        bsg_pr_dbg("%s: received finish packet from (%d,%d)\n",
+                   __func__, tg->origin.x, tg->origin.y);
+        #endif
+        // this is the matching tile group
+        // write out anything its tiles printed without a newline
+        hb_mc_coordinate_t xy;
+        foreach_coordinate(xy, tg->origin, tg->dim) {
+                BSG_CUDA_CALL(hb_mc_responder_console_flush_tile(device->mc, xy));
+        }
+
+        // deallocate tiles
+        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_deallocate_tiles(device, pod, tg));
+
+        // cleanup tile group
+        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_exit(device, pod, tg));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Find the pod that sent a request packet.
+ * @param[in]  device        Pointer to device
+ * @param[in]  rqst          A request packet
+ * @return The ID of the pod containing the packet's source.
+ */
+static
+hb_mc_pod_id_t hb_mc_device_request_packet_pod_id(hb_mc_device_t *device,
+                                                  const hb_mc_request_packet_t *rqst)
+{
+        hb_mc_coordinate_t src =
+                hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                 hb_mc_request_packet_get_y_src(rqst));
+
+        hb_mc_coordinate_t podco = hb_mc_config_pod(&device->mc->config, src);
+        return hb_mc_coordinate_to_index(podco, device->mc->config.pods);
+}
+
 /**
  * Wait for any tile group to complete. Cleanup and release that tile groups resources.
+ * @param[in]  deadline  The cycle count at which to give up, or HB_MC_DEVICE_NO_DEADLINE
  * @return pod_done  The pod on which a tile-group just completed
+ * @return HB_MC_SUCCESS if succesful, HB_MC_TIMEOUT if #deadline passed. Otherwise an error code is returned.
  */
 static
 int hb_mc_device_podv_wait_for_tile_group_finish_any(hb_mc_device_t *device,
                                                      hb_mc_pod_id_t *podv,
                                                      int podc,
-                                                     hb_mc_pod_id_t *pod_done)
+                                                     hb_mc_pod_id_t *pod_done,
+                                                     uint64_t deadline)
 {
         bsg_pr_dbg("%s: calling\n", __func__);
 
         while (true) {
                 hb_mc_request_packet_t rqst;
+                long timeout = -1;
+                int err;
+
+                // bound the read by the time remaining until the deadline
+                if (deadline != HB_MC_DEVICE_NO_DEADLINE) {
+                        uint64_t now;
+                        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device->mc, &now));
+                        if (now >= deadline)
+                                return HB_MC_TIMEOUT;
+                        timeout = static_cast<long>(deadline - now);
+                }
 
                 // perform a blocking read from the request fifo
-                BSG_CUDA_CALL(hb_mc_manycore_request_rx(device->mc, &rqst, -1));
+                err = hb_mc_manycore_request_rx(device->mc, &rqst, timeout);
+                if (err == HB_MC_TIMEOUT)
+                        return err;
+
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to receive request packet: %s\n",
+                                   __func__, hb_mc_strerror(err));
+                        return err;
+                }
 
                 #ifdef DEBUG
                 char pkt_str[256];
@@ -1832,51 +2283,18 @@ int hb_mc_device_podv_wait_for_tile_group_finish_any(hb_mc_device_t *device,
                 }
 
                 // identify the pod
-                hb_mc_coordinate_t src =
-                        hb_mc_coordinate(hb_mc_request_packet_get_x_src(&rqst),
-                                         hb_mc_request_packet_get_y_src(&rqst));
-
-                hb_mc_coordinate_t podco = hb_mc_config_pod(&device->mc->config, src);
-                hb_mc_pod_id_t pid = hb_mc_coordinate_to_index(podco, device->mc->config.pods);
-                hb_mc_pod_t *pod = &device->pods[pid];
-
-                // find the tile group with matching origin in pod
-                hb_mc_tile_group_t *tg;
-                pod_foreach_tile_group(pod, tg)
-                {
-                        // only look for launched tile groups
-                        if (tg->status != HB_MC_TILE_GROUP_STATUS_LAUNCHED) {
-                                continue;
-                        }
+                hb_mc_pod_id_t pid = hb_mc_device_request_packet_pod_id(device, &rqst);
 
-                        // origin matches?
-                        if (!(tg->origin.x == src.x && tg->origin.y == src.y))
-                                continue;
-
-                        // finish signal epa matches?
-                        if (hb_mc_request_packet_get_epa(&rqst)
-                            != hb_mc_npa_get_epa(&tg->finish_signal_npa))
-                                continue;
-
-                        #ifdef DEBUG
-                        bsg_pr_dbg("%s: received finish packet from (%d,%d)\n",
-                                   __func__, tg->origin.x, tg->origin.y);
-                        #endif
-                        // this is the matching tile group
-                        // deallocate tiles
-                        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_deallocate_tiles(device, pod, tg));
-
-                        // cleanup tile group
-                        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_exit(device, pod, tg));
+                err = hb_mc_device_pod_tile_group_retire(device, &device->pods[pid], &rqst);
+                if (err == HB_MC_NOTFOUND)
+                        continue;
 
-                        // mark this pod as having completed a tile-group
-                        *pod_done = pid;
-                        return HB_MC_SUCCESS;
-                }
+                if (err != HB_MC_SUCCESS)
+                        return err;
 
-                bsg_pr_dbg("%s: packet received with finished signal "
-                           "value but no matching tile-group",
-                           __func__);
+                // mark this pod as having completed a tile-group
+                *pod_done = pid;
+                return HB_MC_SUCCESS;
         }
 }
 
@@ -1896,6 +2314,35 @@ int hb_mc_device_podv_kernels_execute(hb_mc_device_t *device,
                                       hb_mc_pod_id_t *podv,
                                       int podc)
 {
+        return hb_mc_device_podv_kernels_execute_timeout(device, podv, podc, -1);
+}
+
+/**
+ * Launches all kernel invocations enqueued on pods, giving up after a number of cycles.
+ * These kernel invocations are enqueued by
+ * hb_mc_device_pod_kernel_enqueue().
+ *
+ * This function blocks until all kernels have been invoked
+ * and completed, or until #timeout cycles have passed. On a
+ * timeout, tile groups that have not finished remain launched.
+ * @param[in]  device        Pointer to device
+ * @param[in]  podv          Vector of Pod IDs
+ * @param[in]  podc          Number of Pod IDs
+ * @param[in]  timeout       A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS if succesful, HB_MC_TIMEOUT if #timeout expired. Otherwise an error code is returned.
+ */
+int hb_mc_device_podv_kernels_execute_timeout(hb_mc_device_t *device,
+                                              hb_mc_pod_id_t *podv,
+                                              int podc,
+                                              long timeout)
+{
+        uint64_t deadline = HB_MC_DEVICE_NO_DEADLINE;
+
+        if (timeout >= 0) {
+                BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device->mc, &deadline));
+                deadline += timeout;
+        }
+
         /* launch as many tile groups as possible on all pods */
         BSG_CUDA_CALL(hb_mc_device_podv_try_launch_tile_groups(device, podv, podc));
 
@@ -1904,8 +2351,17 @@ int hb_mc_device_podv_kernels_execute(hb_mc_device_t *device,
         {
                 /* wait for any tile group to finish on any pod */
                 hb_mc_pod_id_t pod;
-                BSG_CUDA_CALL(hb_mc_device_podv_wait_for_tile_group_finish_any(device, podv, podc,
-                                                                               &pod));
+                int err = hb_mc_device_podv_wait_for_tile_group_finish_any(device, podv, podc,
+                                                                           &pod, deadline);
+                if (err == HB_MC_TIMEOUT) {
+                        bsg_pr_err("%s: device<%s>: timed out after %ld cycles "
+                                   "waiting for tile groups to finish\n",
+                                   __func__, device->name, timeout);
+                        return err;
+                }
+
+                if (err != HB_MC_SUCCESS)
+                        return err;
 
                 /* try launching launching tile groups on pod with most recent completion */
                 BSG_CUDA_CALL(hb_mc_device_pod_try_launch_tile_groups(device, &device->pods[pod]));
@@ -1934,6 +2390,267 @@ int hb_mc_device_pods_kernels_execute(hb_mc_device_t *device)
         return hb_mc_device_podv_kernels_execute(device, podv, device->num_pods);
 }
 
+// The number of cycles a pod worker waits for a request packet
+// before giving other workers a turn on the packet path
+#define HB_MC_DEVICE_WORKER_RX_CYCLES 1000
+
+// The simulated platforms give up on a single receive after this many
+// seconds of wall-clock time. Pod workers receive in slices, so they
+// apply the same limit to the time since any packet arrived.
+#define HB_MC_DEVICE_WALL_TIMEOUT_ENV "BSG_PLATFORM_WALL_TIMEOUT"
+
+/* state shared by the workers of hb_mc_device_podv_kernels_execute_parallel() */
+typedef struct hb_mc_device_executor {
+        std::mutex lock;
+        std::condition_variable cv;
+        //!< finish packets received by any worker, by the pod that sent them
+        std::unordered_map<hb_mc_pod_id_t, std::deque<hb_mc_request_packet_t> > finished;
+        bool receiving; //!< a worker is reading the request FIFO
+        int err;        //!< the first error returned by any worker
+        double wall_timeout; //!< seconds without a packet before giving up, or 0
+        std::chrono::steady_clock::time_point last_rx; //!< when a packet last arrived
+} hb_mc_device_executor_t;
+
+/**
+ * Route a request packet received by a pod worker.
+ * Finish packets are queued for the worker of the pod that sent them.
+ * Call with the executor's lock held.
+ * @param[in]  device        Pointer to device
+ * @param[in]  ex            The executor the packet was received by
+ * @param[in]  pkt           A request packet
+ */
+static
+void hb_mc_device_executor_route(hb_mc_device_t *device,
+                                 hb_mc_device_executor_t *ex,
+                                 const hb_mc_request_packet_t *pkt)
+{
+        if (hb_mc_request_packet_get_data(pkt) != HB_MC_CUDA_FINISH_SIGNAL_VAL) {
+                bsg_pr_dbg("%s: not a finish packet\n", __func__);
+                return;
+        }
+
+        auto it = ex->finished.find(hb_mc_device_request_packet_pod_id(device, pkt));
+        if (it == ex->finished.end()) {
+                bsg_pr_dbg("%s: finish packet received for pod with no worker\n", __func__);
+                return;
+        }
+
+        it->second.push_back(*pkt);
+}
+
+/**
+ * Wait for a finish packet from a pod on a pod worker.
+ * Workers take turns reading the request FIFO, and route each finish
+ * packet to the pod that sent it.
+ * @param[in]  device        Pointer to device
+ * @param[in]  ex            The executor this worker belongs to
+ * @param[in]  pod_id        The worker's pod
+ * @param[out] rqst          A finish packet from #pod_id
+ * @return HB_MC_SUCCESS if succesful, HB_MC_TIMEOUT if the platform's
+ *         own time limit expired. Otherwise an error code is returned.
+ */
+static
+int hb_mc_device_executor_wait_finish(hb_mc_device_t *device,
+                                      hb_mc_device_executor_t *ex,
+                                      hb_mc_pod_id_t pod_id,
+                                      hb_mc_request_packet_t *rqst)
+{
+        std::unique_lock<std::mutex> lock(ex->lock);
+        std::deque<hb_mc_request_packet_t> &mine = ex->finished[pod_id];
+
+        while (true) {
+                if (!mine.empty()) {
+                        *rqst = mine.front();
+                        mine.pop_front();
+                        return HB_MC_SUCCESS;
+                }
+
+                // another worker failed; stop waiting
+                if (ex->err != HB_MC_SUCCESS)
+                        return ex->err;
+
+                // another worker is reading; it will route our packets
+                if (ex->receiving) {
+                        ex->cv.wait(lock);
+                        continue;
+                }
+
+                // read for a bounded number of cycles so that other
+                // workers can use the packet path in between
+                ex->receiving = true;
+                lock.unlock();
+
+                hb_mc_request_packet_t pkt;
+                uint64_t start = 0, end = 0;
+                bool slice_over = false;
+                int err = hb_mc_manycore_get_cycle(device->mc, &start);
+                if (err == HB_MC_SUCCESS)
+                        err = hb_mc_manycore_request_rx(device->mc, &pkt, HB_MC_DEVICE_WORKER_RX_CYCLES);
+                // a timeout is either the end of this slice or the
+                // platform's own wall-clock limit; the cycle count tells
+                if (err == HB_MC_TIMEOUT && hb_mc_manycore_get_cycle(device->mc, &end) == HB_MC_SUCCESS)
+                        slice_over = end - start >= HB_MC_DEVICE_WORKER_RX_CYCLES;
+
+                lock.lock();
+                ex->receiving = false;
+                ex->cv.notify_all();
+
+                if (slice_over) {
+                        double idle = std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                                                    - ex->last_rx).count();
+                        if (ex->wall_timeout > 0 && idle >= ex->wall_timeout) {
+                                bsg_pr_err("%s: no request packet in %g seconds waiting for pod %d\n",
+                                           __func__, idle, pod_id);
+                                return HB_MC_TIMEOUT;
+                        }
+
+                        lock.unlock();
+                        std::this_thread::yield();
+                        lock.lock();
+                        continue;
+                }
+
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to receive request packet: %s\n",
+                                   __func__, hb_mc_strerror(err));
+                        return err;
+                }
+
+                ex->last_rx = std::chrono::steady_clock::now();
+                hb_mc_device_executor_route(device, ex, &pkt);
+        }
+}
+
+/**
+ * Run a pod's worker: host-side setup, then launch and retire tile groups until all have finished.
+ * @param[in]  device        Pointer to device
+ * @param[in]  ex            The executor this worker belongs to
+ * @param[in]  pod_id        The worker's pod
+ * @param[in]  setup         Host-side work to run first, or NULL
+ * @param[in]  arg           An argument passed to #setup
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+static
+int hb_mc_device_pod_worker_run(hb_mc_device_t *device,
+                                hb_mc_device_executor_t *ex,
+                                hb_mc_pod_id_t pod_id,
+                                hb_mc_pod_worker_fn_t setup,
+                                void *arg)
+{
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+
+        if (setup != NULL)
+                BSG_CUDA_CALL(setup(device, pod_id, arg));
+
+        while (hb_mc_device_pod_all_tile_groups_finished(device, pod) != HB_MC_SUCCESS) {
+                // try launching as many tile groups as possible
+                BSG_CUDA_CALL(hb_mc_device_pod_try_launch_tile_groups(device, pod));
+
+                // wait for one of this pod's tile groups to complete
+                hb_mc_request_packet_t rqst;
+                BSG_CUDA_CALL(hb_mc_device_executor_wait_finish(device, ex, pod_id, &rqst));
+
+                int err = hb_mc_device_pod_tile_group_retire(device, pod, &rqst);
+                if (err != HB_MC_SUCCESS && err != HB_MC_NOTFOUND)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Launches all kernel invocations enqueued on pods, with one host thread per pod.
+ * @param[in]  device        Pointer to device
+ * @param[in]  podv          Vector of Pod IDs
+ * @param[in]  podc          Number of Pod IDs
+ * @param[in]  setup         Host-side work to run on each pod's worker first, or NULL
+ * @param[in]  arg           An argument passed to #setup
+ * @return HB_MC_SUCCESS if succesful. Otherwise the first error returned by any worker.
+ */
+int hb_mc_device_podv_kernels_execute_parallel(hb_mc_device_t *device,
+                                               hb_mc_pod_id_t *podv,
+                                               int podc,
+                                               hb_mc_pod_worker_fn_t setup,
+                                               void *arg)
+{
+        hb_mc_device_executor_t ex;
+        ex.receiving = false;
+        ex.err = HB_MC_SUCCESS;
+        const char *wall = getenv(HB_MC_DEVICE_WALL_TIMEOUT_ENV);
+        ex.wall_timeout = wall ? atof(wall) : 0;
+        ex.last_rx = std::chrono::steady_clock::now();
+
+        for (int podi = 0; podi < podc; podi++) {
+                CHECK_POD_ID(device, podv[podi]);
+                if (!ex.finished.emplace(podv[podi], std::deque<hb_mc_request_packet_t>()).second) {
+                        bsg_pr_err("%s: pod %d appears more than once\n",
+                                   __func__, podv[podi]);
+                        return HB_MC_INVALID;
+                }
+        }
+
+        // Workers share the packet path by receiving for a bounded
+        // number of cycles at a time. Platforms that cannot bound a
+        // receive run the pods on this thread instead.
+        hb_mc_request_packet_t pkt;
+        int err = hb_mc_manycore_request_rx(device->mc, &pkt, 0);
+        if (err == HB_MC_NOIMPL) {
+                bsg_pr_dbg("%s: bounded receive not supported, running pods serially\n",
+                           __func__);
+                if (setup != NULL) {
+                        for (int podi = 0; podi < podc; podi++)
+                                BSG_CUDA_CALL(setup(device, podv[podi], arg));
+                }
+                return hb_mc_device_podv_kernels_execute(device, podv, podc);
+        } else if (err == HB_MC_SUCCESS) {
+                hb_mc_device_executor_route(device, &ex, &pkt);
+        } else if (err != HB_MC_TIMEOUT) {
+                bsg_pr_err("%s: failed to receive request packet: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(podc);
+        for (int podi = 0; podi < podc; podi++) {
+                hb_mc_pod_id_t pod_id = podv[podi];
+                workers.emplace_back([=, &ex] () {
+                                int err = hb_mc_device_pod_worker_run(device, &ex, pod_id, setup, arg);
+                                if (err != HB_MC_SUCCESS) {
+                                        std::lock_guard<std::mutex> lock(ex.lock);
+                                        if (ex.err == HB_MC_SUCCESS)
+                                                ex.err = err;
+                                        ex.cv.notify_all();
+                                }
+                        });
+        }
+
+        for (std::thread &worker : workers)
+                worker.join();
+
+        return ex.err;
+}
+
+/**
+ * Launches all kernel invocations enqueued on all pods, with one host thread per pod.
+ * @param[in]  device        Pointer to device
+ * @param[in]  setup         Host-side work to run on each pod's worker first, or NULL
+ * @param[in]  arg           An argument passed to #setup
+ * @return HB_MC_SUCCESS if succesful. Otherwise the first error returned by any worker.
+ */
+int hb_mc_device_pods_kernels_execute_parallel(hb_mc_device_t *device,
+                                               hb_mc_pod_worker_fn_t setup,
+                                               void *arg)
+{
+        hb_mc_pod_id_t podv[device->num_pods];
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(device, pod)
+        {
+                podv[pod]=pod;
+        }
+        return hb_mc_device_podv_kernels_execute_parallel(device, podv, device->num_pods, setup, arg);
+}
+
 
 /********************/
 /* Legacy Interface */
@@ -2013,6 +2730,21 @@ int hb_mc_device_malloc (hb_mc_device_t *device, uint32_t size, hb_mc_eva_t *eva
         return hb_mc_device_pod_malloc(device, device->default_pod_id, size, eva);
 }
 
+/**
+ * Allocates memory on device DRAM at an aligned address
+ * hb_mc_device_program_init() or hb_mc_device_program_init_binary() should
+ * have been called before calling this function to set up a memory allocator.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  size          Size of requested memory
+ * @param[in]  alignment     Alignment of the memory in bytes (a power of two)
+ * @param[out] eva           Eva address of the allocated memory
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_malloc_aligned (hb_mc_device_t *device, uint32_t size, uint32_t alignment, hb_mc_eva_t *eva)
+{
+        return hb_mc_device_pod_malloc_aligned(device, device->default_pod_id, size, alignment, eva);
+}
+
 
 
 
@@ -2075,6 +2807,54 @@ int hb_mc_device_memcpy_to_host(hb_mc_device_t *device,
                                            haddr, daddr, bytes);
 }
 
+/**
+ * Copies a 2D region from the host to device DRAM, like cudaMemcpy2D.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  dst           EVA address of the first destination row
+ * @param[in]  dpitch        Distance in bytes between destination rows
+ * @parma[in]  src           Host address of the first source row
+ * @param[in]  spitch        Distance in bytes between source rows
+ * @param[in]  width         Number of bytes in a row
+ * @param[in]  height        Number of rows
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_memcpy2d_to_device(hb_mc_device_t *device,
+                                    hb_mc_eva_t dst,
+                                    size_t dpitch,
+                                    const void *src,
+                                    size_t spitch,
+                                    size_t width,
+                                    size_t height)
+{
+        return hb_mc_device_pod_memcpy2d_to_device(device, device->default_pod_id,
+                                                   dst, dpitch, src, spitch, width, height);
+}
+
+/**
+ * Copies a 2D region from device DRAM to the host, like cudaMemcpy2D.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  dst           Host address of the first destination row
+ * @param[in]  dpitch        Distance in bytes between destination rows
+ * @parma[in]  src           EVA address of the first source row
+ * @param[in]  spitch        Distance in bytes between source rows
+ * @param[in]  width         Number of bytes in a row
+ * @param[in]  height        Number of rows
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_memcpy2d_to_host(hb_mc_device_t *device,
+                                  void *dst,
+                                  size_t dpitch,
+                                  hb_mc_eva_t src,
+                                  size_t spitch,
+                                  size_t width,
+                                  size_t height)
+{
+        return hb_mc_device_pod_memcpy2d_to_host(device, device->default_pod_id,
+                                                 dst, dpitch, src, spitch, width, height);
+}
+
 
 /**
  * Sets memory to a give value starting from an address in device's DRAM.
@@ -2093,6 +2873,149 @@ int hb_mc_device_memset (hb_mc_device_t *device,
         return hb_mc_device_pod_memset(device, device->default_pod_id, *eva, data, sz);
 }
 
+/**
+ * Atomically applies an operation to a word in device's DRAM or tile memory.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  eva           EVA address of the word (four byte aligned)
+ * @param[in]  op            The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  val           The operand of the operation
+ * @param[out] old           The previous value of the word (may be NULL)
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_amo (hb_mc_device_t *device,
+                      hb_mc_eva_t eva,
+                      hb_mc_packet_op_t op,
+                      uint32_t val,
+                      uint32_t *old)
+{
+        return hb_mc_device_pod_amo(device, device->default_pod_id, eva, op, val, old);
+}
+
+
+/**
+ * Translate a list of DMA jobs to DRAM NPA ranges.
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod     Pointer to pod
+ * @param[in]  jobs    Vector of DMA jobs
+ * @param[in]  count   Number of DMA jobs
+ * @param[out] npas    The start of each NPA range, in job order
+ * @param[out] ptrs    The host address of each NPA range
+ * @param[out] szs     The size of each NPA range in bytes
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+template <typename DMAJob, typename Ptr>
+static int hb_mc_device_pod_dma_jobs_to_npa_ranges(hb_mc_device_t *device,
+                                                   hb_mc_pod_t *pod,
+                                                   const DMAJob *jobs,
+                                                   size_t count,
+                                                   std::vector<hb_mc_npa_t> &npas,
+                                                   std::vector<Ptr> &ptrs,
+                                                   std::vector<size_t> &szs)
+{
+        for (size_t i = 0; i < count; i++) {
+                hb_mc_eva_t eva = jobs[i].d_addr;
+                const char *ptr = (const char *)jobs[i].h_addr;
+                size_t rem = jobs[i].size;
+
+                // DRAM is striped across victim caches, so a job maps
+                // to one contiguous NPA range per stripe
+                while (rem > 0) {
+                        hb_mc_npa_t npa;
+                        size_t npa_sz;
+                        BSG_CUDA_CALL(hb_mc_eva_to_npa(device->mc, &default_map, &pod->mesh->origin,
+                                                       &eva, &npa, &npa_sz));
+
+                        size_t sz = std::min(rem, npa_sz);
+                        npas.push_back(npa);
+                        ptrs.push_back((Ptr)ptr);
+                        szs.push_back(sz);
+
+                        eva += sz;
+                        ptr += sz;
+                        rem -= sz;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Merge DRAM NPA ranges that overlap or touch, so that each victim
+ * cache line is maintained once however many jobs touch it.
+ * @param[in]  device      Pointer to device
+ * @param[in]  npas        The start of each NPA range
+ * @param[in]  szs         The size of each NPA range in bytes
+ * @param[out] cache_npas  The start of each merged NPA range
+ * @param[out] cache_szs   The size of each merged NPA range in bytes
+ * @param[out] lines       The number of victim cache lines the merged ranges touch
+ */
+static void hb_mc_device_dma_coalesce_npa_ranges(hb_mc_device_t *device,
+                                                 const std::vector<hb_mc_npa_t> &npas,
+                                                 const std::vector<size_t> &szs,
+                                                 std::vector<hb_mc_npa_t> &cache_npas,
+                                                 std::vector<size_t> &cache_szs,
+                                                 size_t *lines)
+{
+        size_t bsize = hb_mc_config_get_vcache_block_size(hb_mc_manycore_get_config(device->mc));
+
+        std::vector<size_t> order(npas.size());
+        for (size_t i = 0; i < order.size(); i++)
+                order[i] = i;
+
+        std::sort(order.begin(), order.end(), [&npas](size_t a, size_t b) {
+                        return std::make_tuple(hb_mc_npa_get_x(&npas[a]), hb_mc_npa_get_y(&npas[a]),
+                                               hb_mc_npa_get_epa(&npas[a]))
+                                < std::make_tuple(hb_mc_npa_get_x(&npas[b]), hb_mc_npa_get_y(&npas[b]),
+                                                  hb_mc_npa_get_epa(&npas[b]));
+                });
+
+        cache_npas.clear();
+        cache_szs.clear();
+        for (size_t i : order) {
+                const hb_mc_npa_t &npa = npas[i];
+                if (!cache_npas.empty()) {
+                        const hb_mc_npa_t &last = cache_npas.back();
+                        size_t &last_sz = cache_szs.back();
+                        hb_mc_epa_t last_end = hb_mc_npa_get_epa(&last) + last_sz;
+                        if (hb_mc_npa_get_x(&last) == hb_mc_npa_get_x(&npa)
+                            && hb_mc_npa_get_y(&last) == hb_mc_npa_get_y(&npa)
+                            && hb_mc_npa_get_epa(&npa) <= last_end) {
+                                hb_mc_epa_t end = hb_mc_npa_get_epa(&npa) + szs[i];
+                                last_sz += end > last_end ? end - last_end : 0;
+                                continue;
+                        }
+                }
+                cache_npas.push_back(npa);
+                cache_szs.push_back(szs[i]);
+        }
+
+        *lines = 0;
+        for (size_t i = 0; i < cache_npas.size(); i++) {
+                size_t off = hb_mc_npa_get_epa(&cache_npas[i]) % bsize;
+                *lines += (off + cache_szs[i] + bsize - 1) / bsize;
+        }
+}
+
+/**
+ * Returns the number of victim cache lines in a pod.
+ * Cache maintenance on more lines than this is cheaper done on the
+ * whole cache, one way at a time, than line by line.
+ */
+static size_t hb_mc_device_pod_vcache_lines(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
+        size_t caches = 0;
+        hb_mc_coordinate_t dram;
+        hb_mc_config_pod_foreach_dram(dram, pod->pod_coord, cfg)
+        {
+                caches++;
+        }
+
+        return caches
+                * hb_mc_config_get_vcache_ways(cfg)
+                * hb_mc_config_get_vcache_sets(cfg);
+}
 
 int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id, const hb_mc_dma_htod_t *jobs, size_t count)
 {
@@ -2104,8 +3027,25 @@ int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id
 
         hb_mc_pod_t *pod = &device->pods[pod_id];
 
+        // plan every job as one batch of DRAM ranges
+        std::vector<hb_mc_npa_t> npas;
+        std::vector<const void *> ptrs;
+        std::vector<size_t> szs;
+        BSG_CUDA_CALL(hb_mc_device_pod_dma_jobs_to_npa_ranges(device, pod, jobs, count, npas, ptrs, szs));
+
+        // find the cache lines affected by these jobs
+        std::vector<hb_mc_npa_t> cache_npas;
+        std::vector<size_t> cache_szs;
+        size_t lines;
+        hb_mc_device_dma_coalesce_npa_ranges(device, npas, szs, cache_npas, cache_szs, &lines);
+
+        // maintain only those lines, unless that's more work than the whole cache
+        bool whole_cache = lines >= hb_mc_device_pod_vcache_lines(device, pod);
+
         // flush cache
-        err = hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord);
+        err = whole_cache
+                ? hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord)
+                : hb_mc_manycore_vcache_flush_npa_ranges(device->mc, cache_npas.data(), cache_szs.data(), cache_npas.size());
         if (err != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to flush victim cache: %s\n",
                            __func__,
@@ -2113,30 +3053,21 @@ int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id
                 return err;
         }
 
-        // for each job...
-        for (size_t i = 0; i < count; i++) {
-
-                // perform dma write
-                const hb_mc_dma_htod_t *dma = &jobs[i];
-                err = hb_mc_manycore_eva_write_dma
-                        (device->mc,
-                         &default_map,
-                         &pod->mesh->origin,
-                         &dma->d_addr,
-                         dma->h_addr,
-                         dma->size);
-
-                if (err != HB_MC_SUCCESS) {
-                        bsg_pr_err("%s: failed to perform DMA write to 0x%" PRIx32 ": %s\n",
-                                   __func__,
-                                   dma->d_addr,
-                                   hb_mc_strerror(err));
-                        return err;
-                }
+        // perform dma write
+        err = hb_mc_manycore_dma_write_ranges_no_cache_ainv(device->mc, npas.data(), ptrs.data(),
+                                                            szs.data(), npas.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to perform DMA write of %zu jobs: %s\n",
+                           __func__,
+                           count,
+                           hb_mc_strerror(err));
+                return err;
         }
 
         // invalidate cache
-        err = hb_mc_manycore_pod_invalidate_vcache(device->mc, pod->pod_coord);
+        err = whole_cache
+                ? hb_mc_manycore_pod_invalidate_vcache(device->mc, pod->pod_coord)
+                : hb_mc_manycore_vcache_invalidate_npa_ranges(device->mc, cache_npas.data(), cache_szs.data(), cache_npas.size());
         if (err != HB_MC_SUCCESS) {
                 return err;
         }
@@ -2153,9 +3084,24 @@ int hb_mc_device_pod_dma_to_host(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
         if (!hb_mc_manycore_supports_dma_read(device->mc))
                 return HB_MC_NOIMPL;
 
-        // flush cache
         hb_mc_pod_t *pod = &device->pods[pod_id];
-        err = hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord);
+
+        // plan every job as one batch of DRAM ranges
+        std::vector<hb_mc_npa_t> npas;
+        std::vector<void *> ptrs;
+        std::vector<size_t> szs;
+        BSG_CUDA_CALL(hb_mc_device_pod_dma_jobs_to_npa_ranges(device, pod, jobs, count, npas, ptrs, szs));
+
+        // find the cache lines affected by these jobs
+        std::vector<hb_mc_npa_t> cache_npas;
+        std::vector<size_t> cache_szs;
+        size_t lines;
+        hb_mc_device_dma_coalesce_npa_ranges(device, npas, szs, cache_npas, cache_szs, &lines);
+
+        // flush only those lines, unless that's more work than the whole cache
+        err = lines >= hb_mc_device_pod_vcache_lines(device, pod)
+                ? hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord)
+                : hb_mc_manycore_vcache_flush_npa_ranges(device->mc, cache_npas.data(), cache_szs.data(), cache_npas.size());
         if (err != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to flush victim cache: %s\n",
                            __func__,
@@ -2163,26 +3109,15 @@ int hb_mc_device_pod_dma_to_host(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
                 return err;
         }
 
-        // for each job...
-        for (size_t i = 0; i < count; i++) {
-
-                // perform dma read
-                const hb_mc_dma_dtoh_t *dma = &jobs[i];
-                err = hb_mc_manycore_eva_read_dma
-                        (device->mc,
-                         &default_map,
-                         &pod->mesh->origin,
-                         &dma->d_addr,
-                         dma->h_addr,
-                         dma->size);
-
-                if (err != HB_MC_SUCCESS) {
-                        bsg_pr_err("%s: failed to perform DMA read from 0x%" PRIx32 ": %s\n",
-                                   __func__,
-                                   dma->d_addr,
-                                   hb_mc_strerror(err));
-                        return err;
-                }
+        // perform dma read
+        err = hb_mc_manycore_dma_read_ranges_no_cache_afl(device->mc, npas.data(), ptrs.data(),
+                                                          szs.data(), npas.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to perform DMA read of %zu jobs: %s\n",
+                           __func__,
+                           count,
+                           hb_mc_strerror(err));
+                return err;
         }
 
         return HB_MC_SUCCESS;
@@ -29,6 +29,7 @@
 #define BSG_MANYCORE_CUDA_H
 #include <bsg_manycore_features.h>
 #include <bsg_manycore_eva.h>
+#include <bsg_manycore_loader.h>
 
 #ifdef __cplusplus
 #include <cstdint>
@@ -111,6 +112,15 @@ extern "C" {
                 void *memory_manager;
         } hb_mc_allocator_t;
 
+        typedef struct {
+                size_t free_bytes;       // total free bytes
+                size_t busy_bytes;       // total allocated bytes
+                size_t largest_free;     // largest free extent in bytes
+                size_t free_extents;     // number of free extents
+                size_t busy_blocks;      // number of allocated blocks
+                double fragmentation;    // 1 - largest_free/free_bytes
+        } hb_mc_malloc_stats_t;
+
 
         typedef struct hb_mc_program_options {
                 hb_mc_allocator_id_t alloc_id;
@@ -127,6 +137,7 @@ extern "C" {
                 const char* bin_name;
                 const unsigned char* bin;
                 size_t bin_size;
+                hb_mc_loader_program_t *loader; // parsed binary with an indexed symbol table
                 hb_mc_allocator_t *allocator;
         } hb_mc_program_t;
 
@@ -141,6 +152,8 @@ extern "C" {
                 uint8_t             num_grids;
                 hb_mc_coordinate_t  pod_coord; // what pod am I in the global manycore?
                 int                 program_loaded;
+                void               *launched; // launched tile groups indexed by finish signal
+                void               *arena;    // argv and barrier buffers reused across launches
         } hb_mc_pod_t;
 
         typedef struct {
@@ -258,6 +271,24 @@ extern "C" {
                                     uint32_t        size,
                                     hb_mc_eva_t    *eva);
 
+        /**
+         * Allocates memory on device's DRAM associated with the input pod, at an aligned address
+         * hb_mc_device_pod_program_init() should have been called for device and pod
+         * before calling this function to set up a memory allocator.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID with a prorgam initialized
+         * @parma[in]  size          Size of requested memory
+         * @param[in]  alignment     Alignment of the memory in bytes (a power of two)
+         * @param[out] eva           Eva address of the allocated memory
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_malloc_aligned(hb_mc_device_t *device,
+                                            hb_mc_pod_id_t  pod,
+                                            uint32_t        size,
+                                            uint32_t        alignment,
+                                            hb_mc_eva_t    *eva);
+
         /**
          * Frees memory on device's DRAM associated with the input pod
          * hb_mc_device_pod_program_init() should have been called for device and pod
@@ -272,6 +303,20 @@ extern "C" {
                                   hb_mc_pod_id_t  pod,
                                   hb_mc_eva_t     eva);
 
+        /**
+         * Reports the state of the DRAM allocator associated with the input pod
+         * hb_mc_device_pod_program_init() should have been called for device and pod
+         * before calling this function to set up a memory allocator.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID with a prorgam initialized
+         * @param[out] stats         Allocator statistics
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_malloc_stats(hb_mc_device_t *device,
+                                          hb_mc_pod_id_t  pod,
+                                          hb_mc_malloc_stats_t *stats);
+
         /*******************************/
         /* Pod Interface Data Movement */
         /*******************************/
@@ -326,6 +371,54 @@ extern "C" {
                                             hb_mc_eva_t daddr,
                                             uint32_t bytes);
 
+        /**
+         * Copies a 2D region from the host to pod DRAM, like cudaMemcpy2D.
+         * Row r is #width bytes from #src + r * #spitch to #dst + r * #dpitch.
+         * All rows are sent in a single bulk transfer.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @parma[in]  dst           EVA address of the first destination row
+         * @param[in]  dpitch        Distance in bytes between destination rows
+         * @parma[in]  src           Host address of the first source row
+         * @param[in]  spitch        Distance in bytes between source rows
+         * @param[in]  width         Number of bytes in a row
+         * @param[in]  height        Number of rows
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_memcpy2d_to_device(hb_mc_device_t *device,
+                                                hb_mc_pod_id_t pod,
+                                                hb_mc_eva_t dst,
+                                                size_t dpitch,
+                                                const void *src,
+                                                size_t spitch,
+                                                size_t width,
+                                                size_t height);
+
+        /**
+         * Copies a 2D region from pod DRAM to the host, like cudaMemcpy2D.
+         * Row r is #width bytes from #src + r * #spitch to #dst + r * #dpitch.
+         * All rows are read in a single bulk transfer.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @parma[in]  dst           Host address of the first destination row
+         * @param[in]  dpitch        Distance in bytes between destination rows
+         * @parma[in]  src           EVA address of the first source row
+         * @param[in]  spitch        Distance in bytes between source rows
+         * @param[in]  width         Number of bytes in a row
+         * @param[in]  height        Number of rows
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_memcpy2d_to_host(hb_mc_device_t *device,
+                                              hb_mc_pod_id_t pod,
+                                              void *dst,
+                                              size_t dpitch,
+                                              hb_mc_eva_t src,
+                                              size_t spitch,
+                                              size_t width,
+                                              size_t height);
+
         /**
          * Sets memory to a given value starting from an address in pod's DRAM.
          * @param[in]  device        Pointer to device
@@ -342,6 +435,24 @@ extern "C" {
                                      uint8_t data,
                                      size_t sz);
 
+        /**
+         * Atomically applies an operation to a word in pod's DRAM or tile memory.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @parma[in]  eva           EVA address of the word (four byte aligned)
+         * @param[in]  op            The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  val           The operand of the operation
+         * @param[out] old           The previous value of the word (may be NULL)
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_amo (hb_mc_device_t *device,
+                                  hb_mc_pod_id_t pod,
+                                  hb_mc_eva_t eva,
+                                  hb_mc_packet_op_t op,
+                                  uint32_t val,
+                                  uint32_t *old);
+
         /***********************************/
         /* Pod Interface Execution Control */
         /***********************************/
@@ -406,6 +517,26 @@ extern "C" {
                                               hb_mc_pod_id_t *podv,
                                               int podc);
 
+        /**
+         * Launches all kernel invocations enqueued on pods, giving up after a number of cycles.
+         * These kernel invocations are enqueued by
+         * hb_mc_device_pod_kernel_enqueue().
+         *
+         * This function blocks until all kernels have been invoked
+         * and completed, or until #timeout cycles have passed. On a
+         * timeout, tile groups that have not finished remain launched.
+         * @param[in]  device        Pointer to device
+         * @param[in]  podv          Vector of Pod IDs
+         * @param[in]  podc          Number of Pod IDs
+         * @param[in]  timeout       A number of simulated cycles to wait. Set to -1 to wait forever.
+         * @return HB_MC_SUCCESS if succesful, HB_MC_TIMEOUT if #timeout expired. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_podv_kernels_execute_timeout(hb_mc_device_t *device,
+                                                      hb_mc_pod_id_t *podv,
+                                                      int podc,
+                                                      long timeout);
+
         /**
          * Launches all kernel invocations enqueued on all pods.
          * These kernel invocations are enqueued by
@@ -419,6 +550,64 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_device_pods_kernels_execute(hb_mc_device_t *device);
 
+        /**
+         * Host-side work for a single pod, run on that pod's worker thread.
+         * It may only use the pod interface for #pod (memcpy, DMA, memset,
+         * malloc, kernel enqueue, ...).
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @param[in]  arg           The argument passed to the executor
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        typedef int (*hb_mc_pod_worker_fn_t)(hb_mc_device_t *device,
+                                             hb_mc_pod_id_t pod,
+                                             void *arg);
+
+        /**
+         * Launches all kernel invocations enqueued on pods, with one host thread per pod.
+         * These kernel invocations are enqueued by
+         * hb_mc_device_pod_kernel_enqueue(), either before calling this
+         * function or from #setup.
+         *
+         * Each pod's worker runs #setup (if not NULL), then launches
+         * and retires that pod's tile groups, so that host-side work
+         * for one pod does not stall launches on the others. Finish
+         * packets received by any worker are routed to the pod that
+         * sent them.
+         *
+         * Workers share the packet path by receiving a few cycles at a
+         * time. On platforms that cannot bound a receive, #setup runs
+         * for each pod in turn and the pods are then executed serially
+         * with hb_mc_device_podv_kernels_execute().
+         *
+         * This function blocks until all workers are done.
+         * @param[in]  device        Pointer to device
+         * @param[in]  podv          Vector of Pod IDs
+         * @param[in]  podc          Number of Pod IDs
+         * @param[in]  setup         Host-side work to run on each pod's worker first, or NULL
+         * @param[in]  arg           An argument passed to #setup
+         * @return HB_MC_SUCCESS if succesful. Otherwise the first error returned by any worker.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_podv_kernels_execute_parallel(hb_mc_device_t *device,
+                                                       hb_mc_pod_id_t *podv,
+                                                       int podc,
+                                                       hb_mc_pod_worker_fn_t setup,
+                                                       void *arg);
+
+        /**
+         * Launches all kernel invocations enqueued on all pods, with one host thread per pod.
+         * See hb_mc_device_podv_kernels_execute_parallel().
+         * @param[in]  device        Pointer to device
+         * @param[in]  setup         Host-side work to run on each pod's worker first, or NULL
+         * @param[in]  arg           An argument passed to #setup
+         * @return HB_MC_SUCCESS if succesful. Otherwise the first error returned by any worker.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pods_kernels_execute_parallel(hb_mc_device_t *device,
+                                                       hb_mc_pod_worker_fn_t setup,
+                                                       void *arg);
+
         /*************************/
         /* Pod Interface Cleanup */
         /*************************/
@@ -531,6 +720,19 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_device_malloc (hb_mc_device_t *device, uint32_t size, hb_mc_eva_t *eva);
 
+        /**
+         * Allocates memory on device DRAM at an aligned address
+         * hb_mc_device_program_init() or hb_mc_device_program_init_binary() should
+         * have been called before calling this function to set up a memory allocator.
+         * @param[in]  device        Pointer to device
+         * @parma[in]  size          Size of requested memory
+         * @param[in]  alignment     Alignment of the memory in bytes (a power of two)
+         * @param[out] eva           Eva address of the allocated memory
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_malloc_aligned (hb_mc_device_t *device, uint32_t size, uint32_t alignment, hb_mc_eva_t *eva);
+
 
 
 
@@ -581,6 +783,46 @@ extern "C" {
                                         hb_mc_eva_t daddr,
                                         uint32_t bytes);
 
+        /**
+         * Copies a 2D region from the host to device DRAM, like cudaMemcpy2D.
+         * @param[in]  device        Pointer to device
+         * @parma[in]  dst           EVA address of the first destination row
+         * @param[in]  dpitch        Distance in bytes between destination rows
+         * @parma[in]  src           Host address of the first source row
+         * @param[in]  spitch        Distance in bytes between source rows
+         * @param[in]  width         Number of bytes in a row
+         * @param[in]  height        Number of rows
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_memcpy2d_to_device(hb_mc_device_t *device,
+                                            hb_mc_eva_t dst,
+                                            size_t dpitch,
+                                            const void *src,
+                                            size_t spitch,
+                                            size_t width,
+                                            size_t height);
+
+        /**
+         * Copies a 2D region from device DRAM to the host, like cudaMemcpy2D.
+         * @param[in]  device        Pointer to device
+         * @parma[in]  dst           Host address of the first destination row
+         * @param[in]  dpitch        Distance in bytes between destination rows
+         * @parma[in]  src           EVA address of the first source row
+         * @param[in]  spitch        Distance in bytes between source rows
+         * @param[in]  width         Number of bytes in a row
+         * @param[in]  height        Number of rows
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_memcpy2d_to_host(hb_mc_device_t *device,
+                                          void *dst,
+                                          size_t dpitch,
+                                          hb_mc_eva_t src,
+                                          size_t spitch,
+                                          size_t width,
+                                          size_t height);
+
 
         /**
          * Sets memory to a give value starting from an address in device's DRAM.
@@ -595,6 +837,22 @@ extern "C" {
                                  uint8_t data,
                                  size_t sz); 
 
+        /**
+         * Atomically applies an operation to a word in device's DRAM or tile memory.
+         * @param[in]  device        Pointer to device
+         * @parma[in]  eva           EVA address of the word (four byte aligned)
+         * @param[in]  op            The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  val           The operand of the operation
+         * @param[out] old           The previous value of the word (may be NULL)
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_amo (hb_mc_device_t *device,
+                              hb_mc_eva_t eva,
+                              hb_mc_packet_op_t op,
+                              uint32_t val,
+                              uint32_t *old);
+
 
 
 
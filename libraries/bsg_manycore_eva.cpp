@@ -45,6 +45,9 @@
 #ifdef __cplusplus
 #include <cmath>
 #include <climits>
+#include <mutex>
+#include <new>
+#include <vector>
 #else
 #include <math.h>
 #include <limits.h>
@@ -362,16 +365,6 @@ static uint32_t default_get_x_dimlog(const hb_mc_config_t *cfg)
         return ceil(log2(hb_mc_dimension_get_x(dim)));
 }
 
-static uint32_t default_get_dram_x_bitidx(const hb_mc_config_t *cfg)
-{
-        uint32_t xdimlog;
-        // The number of bits used for the x index is determined by clog2 of the
-        // x dimension (or the number of bits needed to represent the maximum x
-        // dimension).
-        xdimlog = default_get_x_dimlog(cfg);
-        return MAKE_MASK(xdimlog);
-}
-
 static uint32_t default_get_dram_stripe_size_log(const hb_mc_manycore_t *mc)
 {
         const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
@@ -394,15 +387,37 @@ static uint32_t default_get_dram_x_shift_dep(const hb_mc_manycore_t *mc)
         return hb_mc_config_get_vcache_bitwidth_data_addr(cfg);
 }
 
-// See comments on default_eva_to_npa_dram 
-static int default_eva_get_x_coord_dram(const hb_mc_manycore_t *mc,
-                                        const hb_mc_config_t *cfg,
-                                        const hb_mc_coordinate_t *src,
-                                        const hb_mc_eva_t *eva,
-                                        hb_mc_idx_t *x) {
+/**
+ * Parameters of the DRAM EVA space as seen by a source tile
+ *
+ * These depend only on the configuration and on the pod of the source
+ * tile, so a range translation computes them once and reuses them for
+ * every stripe in the range. See comments on default_eva_to_npa_dram.
+ */
+typedef struct default_dram_xlat {
+        uint32_t stripe_log;   // stripe byte-offset bits
+        uint32_t xdimlog;      // x-coordinate bits
+        hb_mc_idx_t min_x;     // x-coordinate of the pod's first DRAM bank
+        hb_mc_idx_t max_x;     // x-coordinate of the pod's last DRAM bank
+        hb_mc_idx_t north_y;   // y-coordinate of the pod's north DRAM banks
+        hb_mc_idx_t south_y;   // y-coordinate of the pod's south DRAM banks
+        size_t max_dram_sz;    // size of DRAM's addressable range
+} default_dram_xlat_t;
+
+/**
+ * Compute the parameters of the DRAM EVA space for a source tile
+ * @param[in]  mc     An initialized manycore struct
+ * @param[in]  src    Coordinate of the tile issuing DRAM EVAs
+ * @param[out] xlat   Parameters to be set for #src
+ */
+static void default_dram_xlat_init(const hb_mc_manycore_t *mc,
+                                   const hb_mc_coordinate_t *src,
+                                   default_dram_xlat_t *xlat)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
         hb_mc_coordinate_t pod = hb_mc_config_pod(cfg, *src);
-        hb_mc_coordinate_t og = hb_mc_config_pod_vcore_origin(cfg, pod);
 #ifdef DEBUG
+        hb_mc_coordinate_t og = hb_mc_config_pod_vcore_origin(cfg, pod);
         char pod_str[256];
         char src_str [256];
         char og_str [256];
@@ -412,101 +427,72 @@ static int default_eva_get_x_coord_dram(const hb_mc_manycore_t *mc,
         bsg_pr_dbg("%s: Source = %s maps to (Logical) Pod %s with origin %s\n",
                     __func__, src_str, pod_str, og_str);
 #endif
-        uint32_t stripe_log = default_get_dram_stripe_size_log(mc);
-        uint32_t xmask = default_get_dram_x_bitidx(cfg);
+        xlat->stripe_log = default_get_dram_stripe_size_log(mc);
+        xlat->xdimlog = default_get_x_dimlog(cfg);
+        xlat->min_x = default_dram_min_x_coord(cfg, src);
+        xlat->max_x = default_dram_max_x_coord(cfg, src);
+        xlat->north_y = hb_mc_config_pod_dram_north_y(cfg, pod);
+        xlat->south_y = hb_mc_config_pod_dram_south_y(cfg, pod);
+        xlat->max_dram_sz = 1 << default_get_dram_bitwidth(mc);
+}
 
-        uint32_t dram_max_x_coord = default_dram_max_x_coord(cfg, src);
-        uint32_t dram_min_x_coord = default_dram_min_x_coord(cfg, src);
+/**
+ * Converts a DRAM Endpoint Virtual Address to a Network Physical Address and
+ * size using precomputed DRAM parameters
+ * @param[in]  xlat   DRAM parameters from default_dram_xlat_init()
+ * @param[in]  eva    An eva to translate - must map to DRAM
+ * @param[out] npa    An npa to be set by translating #eva
+ * @param[out] sz     The size in bytes of the NPA segment for the #eva
+ * @return HB_MC_INVALID if #eva is out of range. HB_MC_SUCCESS otherwise.
+ */
+static int default_dram_xlat_eva_to_npa(const default_dram_xlat_t *xlat,
+                                        const hb_mc_eva_t *eva,
+                                        hb_mc_npa_t *npa,
+                                        size_t *sz)
+{
+        uint32_t addr = hb_mc_eva_addr(eva);
+        uint32_t stripe_log = xlat->stripe_log;
+        uint32_t xdimlog = xlat->xdimlog;
 
-        *x = (hb_mc_eva_addr(eva) >> stripe_log) & xmask;
-        *x += hb_mc_coordinate_get_x(og);
-        if (*x > dram_max_x_coord || *x < dram_min_x_coord) {
+        // The X coordinate is selected by the bits above the stripe offset
+        hb_mc_idx_t x = xlat->min_x + ((addr >> stripe_log) & MAKE_MASK(xdimlog));
+        if (x > xlat->max_x) {
                 bsg_pr_err("%s: Translation of EVA 0x%08" PRIx32 " failed. The X-coordinate "
                            "of the NPA of requested DRAM bank (%d) is outside of "
                            "DRAM X-coordinate range [%d, %d]\n.",
-                           __func__, hb_mc_eva_addr(eva),
-                           *x, dram_min_x_coord, dram_max_x_coord);
+                           __func__, addr,
+                           x, xlat->min_x, xlat->max_x);
                 return HB_MC_INVALID;
         }
-        return HB_MC_SUCCESS;
-}
-
-// See comments on default_eva_to_npa_dram 
-static int default_eva_get_y_coord_dram(const hb_mc_manycore_t *mc,
-                                        const hb_mc_config_t *cfg,
-                                        const hb_mc_coordinate_t *src,
-                                        const hb_mc_eva_t *eva,
-                                        hb_mc_idx_t *y) { 
 
         // Y can either be the North or South boundary of the chip
-        uint32_t shift
-                = default_get_dram_stripe_size_log(mc) // stripe byte-offset bits
-                + default_get_x_dimlog(cfg); // x-coordinate bits
-
-        uint32_t is_south = (hb_mc_eva_addr(eva) >> shift) & 1;
-        hb_mc_coordinate_t pod = hb_mc_config_pod(cfg, *src);
-
-        *y = is_south
-            ? hb_mc_config_pod_dram_south_y(cfg, pod)
-            : hb_mc_config_pod_dram_north_y(cfg, pod);
-
-        bsg_pr_dbg("%s: Translating Y-coordinate = %u for EVA 0x%08" PRIx32 "\n",
-                   __func__, *y, *eva);
-
-        return HB_MC_SUCCESS;
-}
-
-// See comments on default_eva_to_npa_dram 
-static int default_eva_get_epa_dram (const hb_mc_manycore_t *mc,
-                                     const hb_mc_config_t *cfg,
-                                     const hb_mc_eva_t *eva,
-                                     hb_mc_epa_t *epa,
-                                     size_t *sz) { 
- 
-        uint32_t xdimlog    = default_get_x_dimlog(cfg);
-        uint32_t stripe_log = default_get_dram_stripe_size_log(mc);
-        uint32_t shift
-                = stripe_log // stripe byte-offset bits
-                + xdimlog    // x-coordinate bits
-                + 1;         // north-south bit
-
-        // Refer to comments on default_eva_to_npa_dram for more clarification
-        // DRAM EPA  =  EPA_top + block_offset + word_addressible  
-        // Construct (block_offset + word_addressible) portion of EPA
-        // i.e. the <stripe_log> lower bits of the EVA 
-        *epa = (hb_mc_eva_addr(eva) & MAKE_MASK(stripe_log));
-        // Construct the EPA_top portion of EPA and append to lower bits  
-        // Shift right by (stripe_log + x_dimlog) and shift left by stripe_log
-        // to remove the X_coord porition of EVA 
-        *epa |= (((hb_mc_eva_addr(eva) & MAKE_MASK(DEFAULT_DRAM_BITIDX)) >> shift ) << stripe_log);
-
-
-        // The EPA portion of an EVA is technically determined by EPA_top + 
-        // block_offset + word_addressible (refer to the comments above this function).
-        // However, this creates undefined behavior when (addrbits + 1 +
-        // xdimlog) != DEFAULT_DRAM_BITIDX, since there are unused bits between
-        // the x index and EPA.  To avoid really awful debugging, we check this
+        uint32_t is_south = (addr >> (stripe_log + xdimlog)) & 1;
+        hb_mc_idx_t y = is_south ? xlat->south_y : xlat->north_y;
+
+        // DRAM EPA  =  EPA_top + block_offset + word_addressible
+        // The lower <stripe_log> bits of the EVA are the block offset;
+        // EPA_top follows the x-coordinate and north-south bits.
+        hb_mc_epa_t epa = (addr & MAKE_MASK(stripe_log));
+        epa |= (((addr & MAKE_MASK(DEFAULT_DRAM_BITIDX)) >> (stripe_log + xdimlog + 1)) << stripe_log);
+
+        // This creates undefined behavior when (addrbits + 1 + xdimlog) !=
+        // DEFAULT_DRAM_BITIDX, since there are unused bits between the x
+        // index and EPA. To avoid really awful debugging, we check this
         // situation.
-        uint32_t addrbits = default_get_dram_bitwidth(mc);
-        uint32_t errmask = MAKE_MASK(addrbits);
-        size_t max_dram_sz = 1 << addrbits;
-
-        if (*epa >= max_dram_sz){
+        if (epa >= xlat->max_dram_sz){
                 bsg_pr_err("%s: Translation of EVA 0x%08" PRIx32 " failed. "
                            "Requested EPA 0x%08" PRIx32 " is outside of "
                            "DRAM's addressable range 0x%08" PRIx32 ".\n",
-                           __func__,
-                           hb_mc_eva_addr(eva),
-                           *epa,
-                           uint32_t(max_dram_sz));
+                           __func__, addr, epa,
+                           uint32_t(xlat->max_dram_sz));
                 return HB_MC_INVALID;
         }
 
+        *npa = hb_mc_epa_to_npa(hb_mc_coordinate(x,y), epa);
 
-        // Maximum permitted size to write starting from this epa is from 
+        // Maximum permitted size to write starting from this epa is from
         // the block offset until the end of the striped block.
-        uint32_t max_striped_block_size = 1 << stripe_log;
-        *sz = max_striped_block_size - (hb_mc_eva_addr(eva) & MAKE_MASK(stripe_log));
+        *sz = (1 << stripe_log) - (addr & MAKE_MASK(stripe_log));
 
         return HB_MC_SUCCESS;
 }
@@ -542,40 +528,18 @@ static int default_eva_to_npa_dram(const hb_mc_manycore_t *mc,
                                    size_t *sz)
 {
         int rc;
-        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
-        hb_mc_idx_t x,y;
-        hb_mc_epa_t epa;
+        default_dram_xlat_t xlat;
 
-        // Calculate X coordinate of NPA from EVA
-        rc = default_eva_get_x_coord_dram (mc, cfg, src, eva, &x); 
-        if (rc != HB_MC_SUCCESS) { 
-                bsg_pr_err("%s: failed to generate x coordinate from eva 0x%08" PRIx32 ".\n",
-                           __func__,
-                           hb_mc_eva_addr(eva));
-                return rc;
-        }
+        default_dram_xlat_init(mc, src, &xlat);
 
-        // Calculate Y coordinate of NPA from EVA
-        rc = default_eva_get_y_coord_dram (mc, cfg, src, eva, &y);
-        if (rc != HB_MC_SUCCESS) { 
-                bsg_pr_err("%s: failed to generate y coordinate from eva 0x%08" PRIx32 ".\n",
-                           __func__,
-                           hb_mc_eva_addr(eva));
-                return rc;
-        }
-
-
-        // Calculate EPA Portion of NPA from EVA
-        rc = default_eva_get_epa_dram (mc, cfg, eva, &epa, sz);
-        if (rc != HB_MC_SUCCESS) { 
+        rc = default_dram_xlat_eva_to_npa(&xlat, eva, npa, sz);
+        if (rc != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to generate npa from eva 0x%08" PRIx32 ".\n",
                            __func__,
                            hb_mc_eva_addr(eva));
                 return rc;
         }
 
-        *npa = hb_mc_epa_to_npa(hb_mc_coordinate(x,y), epa);
-
         bsg_pr_dbg("%s: Translating EVA 0x%08" PRIx32 " for tile (x: %d y: %d) to NPA {x: %d y: %d, EPA: 0x%08" PRIx32 "} sz = %08x. \n",
                    __func__, hb_mc_eva_addr(eva),
                    hb_mc_coordinate_get_x(*src),
@@ -1018,14 +982,113 @@ static int default_eva_map_init(const hb_mc_config_t *cfg)
         return HB_MC_SUCCESS;
 }
 
+/**
+ * A small fully-associative cache of EVA to NPA translations
+ *
+ * Each entry holds the segment returned by a translation, so that any
+ * EVA inside the segment hits. Entries are tagged with the manycore and
+ * the source tile, since both affect the translation.
+ */
+struct __hb_mc_eva_cache_t {
+        static const unsigned ENTRIES = 8;
+
+        struct entry {
+                const hb_mc_manycore_t *mc;
+                hb_mc_coordinate_t src;
+                hb_mc_eva_t eva;
+                size_t sz;
+                hb_mc_npa_t npa;
+        };
+
+        std::mutex lock;
+        entry entries[ENTRIES];
+        unsigned valid = 0; // number of valid entries
+        unsigned next = 0;  // next entry to replace
+
+        bool lookup(const hb_mc_manycore_t *mc, const hb_mc_coordinate_t *src,
+                    hb_mc_eva_t eva, hb_mc_npa_t *npa, size_t *sz) {
+                std::lock_guard<std::mutex> guard(lock);
+                for (unsigned i = 0; i < valid; i++) {
+                        const entry &e = entries[i];
+                        size_t off = eva - e.eva;
+                        if (e.mc != mc || off >= e.sz
+                            || !hb_mc_coordinate_eq(e.src, *src))
+                                continue;
+
+                        *npa = e.npa;
+                        hb_mc_npa_set_epa(npa, hb_mc_npa_get_epa(&e.npa) + off);
+                        *sz = e.sz - off;
+                        return true;
+                }
+                return false;
+        }
+
+        void insert(const hb_mc_manycore_t *mc, const hb_mc_coordinate_t *src,
+                    hb_mc_eva_t eva, const hb_mc_npa_t *npa, size_t sz) {
+                std::lock_guard<std::mutex> guard(lock);
+                entries[next] = {mc, *src, eva, sz, *npa};
+                next = (next + 1) % ENTRIES;
+                if (valid < ENTRIES)
+                        valid++;
+        }
+
+        void flush() {
+                std::lock_guard<std::mutex> guard(lock);
+                valid = 0;
+                next = 0;
+        }
+};
+
+static hb_mc_eva_cache_t default_cache;
+
 hb_mc_eva_map_t default_map = {
         .eva_map_name = "Default EVA space",
         .priv = (const void *)(&default_origin),
         .eva_to_npa = default_eva_to_npa,
         .eva_size = default_eva_size,
         .npa_to_eva  = default_npa_to_eva,
+        .cache = &default_cache,
 };
 
+static size_t min_size_t(size_t x, size_t y)
+{
+        return x < y ? x : y;
+}
+
+/**
+ * Set up a translation cache for an EVA map
+ * @param[in]  map    An eva map
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_eva_map_cache_init(hb_mc_eva_map_t *map)
+{
+        map->cache = new (std::nothrow) hb_mc_eva_cache_t;
+        if (!map->cache)
+                return HB_MC_NOMEM;
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Discard all translations cached for an EVA map
+ * @param[in]  map    An eva map
+ */
+void hb_mc_eva_map_cache_flush(const hb_mc_eva_map_t *map)
+{
+        if (map->cache)
+                map->cache->flush();
+}
+
+/**
+ * Tear down the translation cache of an EVA map
+ * @param[in]  map    An eva map set up with hb_mc_eva_map_cache_init()
+ */
+void hb_mc_eva_map_cache_exit(hb_mc_eva_map_t *map)
+{
+        delete map->cache;
+        map->cache = NULL;
+}
+
 /**
  * Translate a Network Physical Address to an Endpoint Virtual Address in a
  * target tile's address space
@@ -1071,10 +1134,94 @@ int hb_mc_eva_to_npa(hb_mc_manycore_t *mc,
 {
         int err;
 
+        if (map->cache && map->cache->lookup(mc, src, *eva, npa, sz))
+                return HB_MC_SUCCESS;
+
         err = map->eva_to_npa(mc, map->priv, src, eva, npa, sz);
         if (err != HB_MC_SUCCESS)
                 return err;
 
+        if (map->cache)
+                map->cache->insert(mc, src, *eva, npa, *sz);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Translate a range of Endpoint Virtual Addresses in a source tile's
+ * address space to a list of Network Physical Address runs
+ * @param[in]  mc        An initialized manycore struct
+ * @param[in]  map       An eva map for computing the eva to npa translation
+ * @param[in]  src       Coordinate of the tile issuing this #eva
+ * @param[in]  eva       The start of the range to translate
+ * @param[in]  sz        The size of the range in bytes
+ * @param[out] npas      An array of #max_runs NPAs - the start of each run
+ * @param[out] szs       An array of #max_runs sizes - the size of each run in bytes
+ * @param[in]  max_runs  The capacity of #npas and #szs
+ * @param[out] nruns     The number of runs produced
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_eva_to_npa_runs(hb_mc_manycore_t *mc,
+                          const hb_mc_eva_map_t *map,
+                          const hb_mc_coordinate_t *src,
+                          const hb_mc_eva_t *eva, size_t sz,
+                          hb_mc_npa_t *npas, size_t *szs,
+                          size_t max_runs, size_t *nruns)
+{
+        int err;
+        size_t n = 0;
+        hb_mc_eva_t curr_eva = *eva;
+
+        // DRAM is striped, so a large range is many small segments.
+        // For the default EVA space, the DRAM parameters are computed
+        // once and each stripe is translated with a few shifts and
+        // masks. Stripes would only thrash the translation cache, so
+        // they bypass it.
+        bool dram_fast = map->eva_to_npa == default_eva_to_npa;
+        bool dram_init = false;
+        default_dram_xlat_t dram;
+
+        if (max_runs == 0)
+                return HB_MC_INVALID;
+
+        while (sz > 0) {
+                hb_mc_npa_t npa;
+                size_t npa_sz;
+
+                if (dram_fast && default_eva_is_dram(&curr_eva)) {
+                        if (!dram_init) {
+                                default_dram_xlat_init(mc, src, &dram);
+                                dram_init = true;
+                        }
+                        err = default_dram_xlat_eva_to_npa(&dram, &curr_eva, &npa, &npa_sz);
+                } else {
+                        err = hb_mc_eva_to_npa(mc, map, src, &curr_eva, &npa, &npa_sz);
+                }
+
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                size_t xfer_sz = min_size_t(sz, npa_sz);
+
+                // extend the last run if this segment continues it
+                if (n > 0
+                    && hb_mc_npa_get_x(&npas[n-1]) == hb_mc_npa_get_x(&npa)
+                    && hb_mc_npa_get_y(&npas[n-1]) == hb_mc_npa_get_y(&npa)
+                    && hb_mc_npa_get_epa(&npas[n-1]) + szs[n-1] == hb_mc_npa_get_epa(&npa)) {
+                        szs[n-1] += xfer_sz;
+                } else if (n < max_runs) {
+                        npas[n] = npa;
+                        szs[n] = xfer_sz;
+                        n++;
+                } else {
+                        break;
+                }
+
+                sz -= xfer_sz;
+                curr_eva += xfer_sz;
+        }
+
+        *nruns = n;
         return HB_MC_SUCCESS;
 }
 
@@ -1099,12 +1246,6 @@ int hb_mc_eva_size(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
-
-static size_t min_size_t(size_t x, size_t y)
-{
-        return x < y ? x : y;
-}
-
 /**
  * Initializes all EVA maps
  * @param[in]  mc     An initialized manycore struct
@@ -1112,9 +1253,25 @@ static size_t min_size_t(size_t x, size_t y)
  */
 int hb_mc_manycore_eva_init(hb_mc_manycore_t *mc)
 {
+        // the default origin may have changed
+        hb_mc_eva_map_cache_flush(&default_map);
         return default_eva_map_init(&(mc->config));
 }
 
+/**
+ * Cleans up all EVA maps
+ * @param[in]  mc     An initialized manycore struct
+ */
+void hb_mc_manycore_eva_cleanup(hb_mc_manycore_t *mc)
+{
+        // cached translations are tagged with #mc, which may be
+        // reused for another manycore
+        hb_mc_eva_map_cache_flush(&default_map);
+}
+
+/* The number of NPA runs translated at a time by eva_write/read_internal */
+#define HB_MC_EVA_RUNS_MAX 64
+
 /**
  * Internal function to write memory out to manycore hardware starting at a given EVA
  * @param[in]  mc     An initialized manycore struct
@@ -1126,6 +1283,8 @@ int hb_mc_manycore_eva_init(hb_mc_manycore_t *mc)
  * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
  *
  * This function implements the general algorithm for writing a contiguous EVA region.
+ * The region is translated into NPA runs in batches, and each batch is
+ * handed to #write_function as a list of ranges.
  */
 template <typename WriteFunction>
 int hb_mc_manycore_eva_write_internal(hb_mc_manycore_t *mc,
@@ -1136,37 +1295,41 @@ int hb_mc_manycore_eva_write_internal(hb_mc_manycore_t *mc,
                                       WriteFunction write_function)
 {
         int err;
-        size_t dest_sz, xfer_sz;
-        hb_mc_npa_t dest_npa;
-        char *destp;
+        hb_mc_npa_t npas[HB_MC_EVA_RUNS_MAX];
+        size_t szs[HB_MC_EVA_RUNS_MAX];
+        const void *ptrs[HB_MC_EVA_RUNS_MAX];
+        size_t nruns;
+        const char *destp = (const char *)data;
         hb_mc_eva_t curr_eva = *eva;
 
-        destp = (char *)data;
         while(sz > 0){
-                err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &dest_npa, &dest_sz);
+                err = hb_mc_eva_to_npa_runs(mc, map, tgt, &curr_eva, sz,
+                                            npas, szs, HB_MC_EVA_RUNS_MAX, &nruns);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
                                    __func__);
                         return err;
                 }
-                xfer_sz = min_size_t(sz, dest_sz);
 
-                char npa_str[256];
-                bsg_pr_dbg("writing %zd bytes to eva %08x (%s)\n",
-                           xfer_sz,
-                           curr_eva,
-                           hb_mc_npa_to_string(&dest_npa, npa_str, sizeof(npa_str)));
+                for (size_t r = 0; r < nruns; r++) {
+                        char npa_str[256];
+                        bsg_pr_dbg("writing %zd bytes to eva %08x (%s)\n",
+                                   szs[r],
+                                   curr_eva,
+                                   hb_mc_npa_to_string(&npas[r], npa_str, sizeof(npa_str)));
+
+                        ptrs[r] = destp;
+                        destp += szs[r];
+                        sz -= szs[r];
+                        curr_eva += szs[r];
+                }
 
-                err = write_function(mc, &dest_npa, destp, xfer_sz);
+                err = write_function(mc, npas, ptrs, szs, nruns);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to copy data from host to NPA\n",
                                    __func__);
                         return err;
                 }
-
-                destp += xfer_sz;
-                sz -= xfer_sz;
-                curr_eva += xfer_sz;
         }
 
         return HB_MC_SUCCESS;
@@ -1189,7 +1352,7 @@ int hb_mc_manycore_eva_write_dma(hb_mc_manycore_t *mc,
                                  const void *data, size_t sz)
 {
         return hb_mc_manycore_eva_write_internal(mc, map, tgt, eva, data, sz,
-                                                 hb_mc_manycore_dma_write_no_cache_ainv);
+                                                 hb_mc_manycore_dma_write_ranges_no_cache_ainv);
 }
 
 /**
@@ -1210,7 +1373,7 @@ int hb_mc_manycore_eva_write(hb_mc_manycore_t *mc,
 {
         // otherwise do write using the manycore mesh network
         return hb_mc_manycore_eva_write_internal(mc,map, tgt, eva, data, sz,
-                                                 hb_mc_manycore_write_mem);
+                                                 hb_mc_manycore_write_mem_ranges);
 }
 
 
@@ -1225,6 +1388,8 @@ int hb_mc_manycore_eva_write(hb_mc_manycore_t *mc,
  * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
  *
  * This function implements the general algorithm for reading a contiguous EVA region.
+ * The region is translated into NPA runs in batches, and each batch is
+ * handed to #read_function as a list of ranges.
  */
 template <typename ReadFunction>
 int hb_mc_manycore_eva_read_internal(hb_mc_manycore_t *mc,
@@ -1235,38 +1400,41 @@ int hb_mc_manycore_eva_read_internal(hb_mc_manycore_t *mc,
                                      ReadFunction read_function)
 {
         int err;
-        size_t src_sz, xfer_sz;
-        hb_mc_npa_t src_npa;
-        char *srcp;
+        hb_mc_npa_t npas[HB_MC_EVA_RUNS_MAX];
+        size_t szs[HB_MC_EVA_RUNS_MAX];
+        void *ptrs[HB_MC_EVA_RUNS_MAX];
+        size_t nruns;
+        char *srcp = (char *)data;
         hb_mc_eva_t curr_eva = *eva;
 
-        srcp = (char *)data;
         while(sz > 0){
-                err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &src_npa, &src_sz);
+                err = hb_mc_eva_to_npa_runs(mc, map, tgt, &curr_eva, sz,
+                                            npas, szs, HB_MC_EVA_RUNS_MAX, &nruns);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
                                    __func__);
                         return err;
                 }
 
-                xfer_sz = min_size_t(sz, src_sz);
-
-                char npa_str[256];
-                bsg_pr_dbg("read %zd bytes from eva %08x (%s)\n",
-                           xfer_sz,
-                           curr_eva,
-                           hb_mc_npa_to_string(&src_npa, npa_str, sizeof(npa_str)));
+                for (size_t r = 0; r < nruns; r++) {
+                        char npa_str[256];
+                        bsg_pr_dbg("read %zd bytes from eva %08x (%s)\n",
+                                   szs[r],
+                                   curr_eva,
+                                   hb_mc_npa_to_string(&npas[r], npa_str, sizeof(npa_str)));
+
+                        ptrs[r] = srcp;
+                        srcp += szs[r];
+                        sz -= szs[r];
+                        curr_eva += szs[r];
+                }
 
-                err = read_function(mc, &src_npa, srcp, xfer_sz);
+                err = read_function(mc, npas, ptrs, szs, nruns);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to copy data from host to NPA\n",
                                    __func__);
                         return err;
                 }
-
-                srcp += xfer_sz;
-                sz -= xfer_sz;
-                curr_eva += xfer_sz;
         }
 
         return HB_MC_SUCCESS;
@@ -1289,7 +1457,7 @@ int hb_mc_manycore_eva_read_dma(hb_mc_manycore_t *mc,
                                 void *data, size_t sz)
 {
         return hb_mc_manycore_eva_read_internal(mc, map, tgt, eva, data, sz,
-                                                hb_mc_manycore_dma_read_no_cache_afl);
+                                                hb_mc_manycore_dma_read_ranges_no_cache_afl);
 }
 
 /**
@@ -1309,7 +1477,150 @@ int hb_mc_manycore_eva_read(hb_mc_manycore_t *mc,
                             void *data, size_t sz)
 {
         return hb_mc_manycore_eva_read_internal(mc, map, tgt, eva, data, sz,
-                                                hb_mc_manycore_read_mem);
+                                                hb_mc_manycore_read_mem_ranges);
+}
+
+/**
+ * Translate a strided EVA region into a list of NPA ranges.
+ * Rows that span more than one NPA region are split into one range per region.
+ * @param[in]  mc          An initialized manycore struct
+ * @param[in]  map         An eva map for computing the eva to npa translation
+ * @param[in]  tgt         Coordinate of the tile issuing this #eva
+ * @param[in]  eva         A valid hb_mc_eva_t - the first row
+ * @param[in]  eva_pitch   The distance in bytes between rows in device memory
+ * @param[in]  data        A host buffer - the first row
+ * @param[in]  data_pitch  The distance in bytes between rows in #data
+ * @param[in]  width       The number of bytes in a row
+ * @param[in]  height      The number of rows
+ * @param[out] npas        The start of each NPA range
+ * @param[out] ptrs        The host address of each NPA range
+ * @param[out] szs         The size of each NPA range in bytes
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+template <typename Ptr>
+static int hb_mc_manycore_eva_strided_to_ranges(hb_mc_manycore_t *mc,
+                                                const hb_mc_eva_map_t *map,
+                                                const hb_mc_coordinate_t *tgt,
+                                                hb_mc_eva_t eva, size_t eva_pitch,
+                                                Ptr data, size_t data_pitch,
+                                                size_t width, size_t height,
+                                                std::vector<hb_mc_npa_t> &npas,
+                                                std::vector<Ptr> &ptrs,
+                                                std::vector<size_t> &szs)
+{
+        int err;
+
+        for (size_t r = 0; r < height; r++) {
+                hb_mc_eva_t curr_eva = eva + r * eva_pitch;
+                char *curr_ptr = (char *)data + r * data_pitch;
+                size_t sz = width;
+
+                while (sz > 0) {
+                        hb_mc_npa_t npa;
+                        size_t npa_sz, xfer_sz;
+
+                        err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &npa, &npa_sz);
+                        if (err != HB_MC_SUCCESS) {
+                                bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
+                                           __func__);
+                                return err;
+                        }
+
+                        xfer_sz = min_size_t(sz, npa_sz);
+
+                        npas.push_back(npa);
+                        ptrs.push_back(static_cast<Ptr>(curr_ptr));
+                        szs.push_back(xfer_sz);
+
+                        curr_ptr += xfer_sz;
+                        curr_eva += xfer_sz;
+                        sz -= xfer_sz;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write a 2D region of host memory out to a strided EVA region
+ * @param[in]  mc          An initialized manycore struct
+ * @param[in]  map         An eva map for computing the eva to npa translation
+ * @param[in]  tgt         Coordinate of the tile issuing this #eva
+ * @param[in]  eva         A valid hb_mc_eva_t - the first row
+ * @param[in]  eva_pitch   The distance in bytes between rows in device memory
+ * @param[in]  data        A 32-bit aligned host buffer - the first row
+ * @param[in]  data_pitch  The distance in bytes between rows in #data
+ * @param[in]  width       The number of bytes in a row (a multiple of 4)
+ * @param[in]  height      The number of rows
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_eva_write_strided(hb_mc_manycore_t *mc,
+                                     const hb_mc_eva_map_t *map,
+                                     const hb_mc_coordinate_t *tgt,
+                                     const hb_mc_eva_t *eva, size_t eva_pitch,
+                                     const void *data, size_t data_pitch,
+                                     size_t width, size_t height)
+{
+        std::vector<hb_mc_npa_t> npas;
+        std::vector<const void *> ptrs;
+        std::vector<size_t> szs;
+        int err;
+
+        err = hb_mc_manycore_eva_strided_to_ranges(mc, map, tgt, *eva, eva_pitch,
+                                                   data, data_pitch, width, height,
+                                                   npas, ptrs, szs);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = hb_mc_manycore_write_mem_ranges(mc, npas.data(), ptrs.data(), szs.data(), npas.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to copy data from host to NPA\n",
+                           __func__);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read a strided EVA region into a 2D region of host memory
+ * @param[in]  mc          An initialized manycore struct
+ * @param[in]  map         An eva map for computing the eva to npa translation
+ * @param[in]  tgt         Coordinate of the tile issuing this #eva
+ * @param[in]  eva         A valid hb_mc_eva_t - the first row
+ * @param[in]  eva_pitch   The distance in bytes between rows in device memory
+ * @param[out] data        A 32-bit aligned host buffer - the first row
+ * @param[in]  data_pitch  The distance in bytes between rows in #data
+ * @param[in]  width       The number of bytes in a row (a multiple of 4)
+ * @param[in]  height      The number of rows
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_eva_read_strided(hb_mc_manycore_t *mc,
+                                    const hb_mc_eva_map_t *map,
+                                    const hb_mc_coordinate_t *tgt,
+                                    const hb_mc_eva_t *eva, size_t eva_pitch,
+                                    void *data, size_t data_pitch,
+                                    size_t width, size_t height)
+{
+        std::vector<hb_mc_npa_t> npas;
+        std::vector<void *> ptrs;
+        std::vector<size_t> szs;
+        int err;
+
+        err = hb_mc_manycore_eva_strided_to_ranges(mc, map, tgt, *eva, eva_pitch,
+                                                   data, data_pitch, width, height,
+                                                   npas, ptrs, szs);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = hb_mc_manycore_read_mem_ranges(mc, npas.data(), ptrs.data(), szs.data(), npas.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to copy data from NPA to host\n",
+                           __func__);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
 }
 
 /**
@@ -1362,3 +1673,41 @@ int hb_mc_manycore_eva_memset(hb_mc_manycore_t *mc,
 
         return HB_MC_SUCCESS;
 }
+
+/**
+ * Do a 32-bit atomic memory operation at a given EVA
+ * @param[in]  mc     An initialized manycore struct
+ * @param[in]  map    An eva map for computing the eva to npa translation
+ * @param[in]  tgt    Coordinate of the tile issuing this #eva
+ * @param[in]  eva    A valid hb_mc_eva_t aligned to a four byte boundary
+ * @param[in]  op     The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  v      The operand of the operation
+ * @param[out] vpo    The previous value at #eva (may be NULL)
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_eva_amo(hb_mc_manycore_t *mc,
+                           const hb_mc_eva_map_t *map,
+                           const hb_mc_coordinate_t *tgt,
+                           const hb_mc_eva_t *eva,
+                           hb_mc_packet_op_t op,
+                           uint32_t v, uint32_t *vpo)
+{
+        int err;
+        size_t sz;
+        hb_mc_npa_t npa;
+
+        err = hb_mc_eva_to_npa(mc, map, tgt, eva, &npa, &sz);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
+                           __func__);
+                return err;
+        }
+
+        if (sz < sizeof(uint32_t)) {
+                bsg_pr_err("%s: EVA 0x%08" PRIx32 " does not map to a full word\n",
+                           __func__, *eva);
+                return HB_MC_INVALID;
+        }
+
+        return hb_mc_manycore_amo32(mc, &npa, op, v, vpo);
+}
@@ -48,6 +48,9 @@ extern "C" {
         typedef uint32_t hb_mc_eva_t;
         typedef hb_mc_eva_t eva_t;
 
+        /* A cache of recent EVA to NPA translations (opaque) */
+        typedef struct __hb_mc_eva_cache_t hb_mc_eva_cache_t;
+
         typedef struct __hb_mc_eva_map_t{
                 const char *eva_map_name;
                 const void *priv;
@@ -99,6 +102,12 @@ extern "C" {
                                   const hb_mc_coordinate_t *tgt,
                                   const hb_mc_npa_t *npa,
                                   hb_mc_eva_t *eva, size_t *sz);
+
+                /**
+                 * Recent translations made with this map, set up with
+                 * hb_mc_eva_map_cache_init(). NULL if translations are not cached.
+                 */
+                hb_mc_eva_cache_t *cache;
         } hb_mc_eva_map_t;
 
         /**
@@ -162,6 +171,12 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_eva_init(hb_mc_manycore_t *mc);
 
+        /**
+         * Clean up all EVA Maps
+         * @param[in]  mc     An initialized manycore struct
+         */
+        void hb_mc_manycore_eva_cleanup(hb_mc_manycore_t *mc);
+
         /**
          * Get the name of an eva map.
          * @param[in] map  An EVA map. Behaviour is undefined if #map is NULL.
@@ -208,6 +223,58 @@ extern "C" {
                              const hb_mc_eva_t *eva,
                              hb_mc_npa_t *npa, size_t *sz);
 
+        /**
+         * Translate a range of Endpoint Virtual Addresses in a source tile's
+         * address space to a list of Network Physical Address runs
+         *
+         * Each run is contiguous in NPA space. Adjacent segments that map to
+         * contiguous addresses on the same endpoint are merged into one run.
+         * At most #max_runs runs are produced; if the range needs more, only a
+         * prefix of it is translated and the caller can continue from #eva
+         * plus the sum of #szs.
+         *
+         * @param[in]  mc        An initialized manycore struct
+         * @param[in]  map       An eva map for computing the eva to npa translation
+         * @param[in]  src       Coordinate of the tile issuing this #eva
+         * @param[in]  eva       The start of the range to translate
+         * @param[in]  sz        The size of the range in bytes
+         * @param[out] npas      An array of #max_runs NPAs - the start of each run
+         * @param[out] szs       An array of #max_runs sizes - the size of each run in bytes
+         * @param[in]  max_runs  The capacity of #npas and #szs
+         * @param[out] nruns     The number of runs produced
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_eva_to_npa_runs(hb_mc_manycore_t *mc,
+                                  const hb_mc_eva_map_t *map,
+                                  const hb_mc_coordinate_t *src,
+                                  const hb_mc_eva_t *eva, size_t sz,
+                                  hb_mc_npa_t *npas, size_t *szs,
+                                  size_t max_runs, size_t *nruns);
+
+        /**
+         * Set up a translation cache for an EVA map
+         * Once set up, hb_mc_eva_to_npa() answers repeated translations
+         * within a recently translated segment without consulting #map.
+         * @param[in]  map    An eva map
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_eva_map_cache_init(hb_mc_eva_map_t *map);
+
+        /**
+         * Discard all translations cached for an EVA map
+         * Must be called if the translation made by #map changes.
+         * @param[in]  map    An eva map
+         */
+        void hb_mc_eva_map_cache_flush(const hb_mc_eva_map_t *map);
+
+        /**
+         * Tear down the translation cache of an EVA map
+         * @param[in]  map    An eva map set up with hb_mc_eva_map_cache_init()
+         */
+        void hb_mc_eva_map_cache_exit(hb_mc_eva_map_t *map);
+
         /**
          * Write memory out to manycore hardware starting at a given EVA
          * @param[in]  mc     An initialized manycore struct
@@ -258,6 +325,77 @@ extern "C" {
                                       const hb_mc_eva_t *eva,
                                       uint8_t val, size_t sz);
 
+        /**
+         * Write a 2D region of host memory out to a strided EVA region
+         *
+         * Row r of #height rows is #width bytes at #data + r * #data_pitch,
+         * and is written to #eva + r * #eva_pitch. All rows are written in
+         * a single bulk transfer.
+         *
+         * @param[in]  mc          An initialized manycore struct
+         * @param[in]  map         An eva map for computing the eva to npa translation
+         * @param[in]  tgt         Coordinate of the tile issuing this #eva
+         * @param[in]  eva         A valid hb_mc_eva_t - the first row
+         * @param[in]  eva_pitch   The distance in bytes between rows in device memory
+         * @param[in]  data        A 32-bit aligned host buffer - the first row
+         * @param[in]  data_pitch  The distance in bytes between rows in #data
+         * @param[in]  width       The number of bytes in a row (a multiple of 4)
+         * @param[in]  height      The number of rows
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_write_strided(hb_mc_manycore_t *mc,
+                                             const hb_mc_eva_map_t *map,
+                                             const hb_mc_coordinate_t *tgt,
+                                             const hb_mc_eva_t *eva, size_t eva_pitch,
+                                             const void *data, size_t data_pitch,
+                                             size_t width, size_t height);
+
+        /**
+         * Read a strided EVA region into a 2D region of host memory
+         *
+         * Row r of #height rows is #width bytes at #eva + r * #eva_pitch,
+         * and is read into #data + r * #data_pitch. All rows are read in a
+         * single bulk transfer.
+         *
+         * @param[in]  mc          An initialized manycore struct
+         * @param[in]  map         An eva map for computing the eva to npa translation
+         * @param[in]  tgt         Coordinate of the tile issuing this #eva
+         * @param[in]  eva         A valid hb_mc_eva_t - the first row
+         * @param[in]  eva_pitch   The distance in bytes between rows in device memory
+         * @param[out] data        A 32-bit aligned host buffer - the first row
+         * @param[in]  data_pitch  The distance in bytes between rows in #data
+         * @param[in]  width       The number of bytes in a row (a multiple of 4)
+         * @param[in]  height      The number of rows
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_read_strided(hb_mc_manycore_t *mc,
+                                            const hb_mc_eva_map_t *map,
+                                            const hb_mc_coordinate_t *tgt,
+                                            const hb_mc_eva_t *eva, size_t eva_pitch,
+                                            void *data, size_t data_pitch,
+                                            size_t width, size_t height);
+
+        /**
+         * Do a 32-bit atomic memory operation at a given EVA
+         * @param[in]  mc     An initialized manycore struct
+         * @param[in]  map    An eva map for computing the eva to npa translation
+         * @param[in]  tgt    Coordinate of the tile issuing this #eva
+         * @param[in]  eva    A valid hb_mc_eva_t aligned to a four byte boundary
+         * @param[in]  op     The operation: one of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  v      The operand of the operation
+         * @param[out] vpo    The previous value at #eva (may be NULL)
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_amo(hb_mc_manycore_t *mc,
+                                   const hb_mc_eva_map_t *map,
+                                   const hb_mc_coordinate_t *tgt,
+                                   const hb_mc_eva_t *eva,
+                                   hb_mc_packet_op_t op,
+                                   uint32_t v, uint32_t *vpo);
+
         /**
          * Returns the EVA associated with a hb_mc_eva_t 
          * @param[in]  eva    A valid eva_t
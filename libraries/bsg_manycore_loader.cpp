@@ -31,7 +31,11 @@
 #include <bsg_manycore_printing.h>
 #include <bsg_manycore_npa.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <elf.h>
 #include <endian.h>
 
@@ -308,12 +312,51 @@ static int hb_mc_loader_load_tile_segment(hb_mc_manycore_t *mc,
 }
 
 /**
- * Load a program segment.
+ * Translate a program segment's load EVA for each of a list of tiles.
+ * Succeeds only if the whole segment is contiguous in each tile's NPA space.
+ * @param[in]  mc       A manycore instance.
+ * @param[in]  map      A EVA to NPA map.
+ * @param[in]  phdr     A program header for the data to be loaded.
+ * @param[in]  tiles    Tiles to load.
+ * @param[in]  ntiles   The number of tiles to load.
+ * @param[out] npas     The segment's NPA for each tile in #tiles.
+ * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+ */
+static int hb_mc_loader_tiles_segment_to_npas(hb_mc_manycore_t *mc,
+                                              const hb_mc_eva_map_t *map,
+                                              const Elf32_Phdr *phdr,
+                                              const hb_mc_coordinate_t *tiles,
+                                              uint32_t ntiles,
+                                              hb_mc_npa_t *npas)
+{
+        hb_mc_eva_t eva = RV32_Addr_to_host(phdr->p_paddr);
+        size_t seg_sz = RV32_Word_to_host(phdr->p_memsz);
+        size_t npa_sz;
+        int rc;
+
+        for (uint32_t i = 0; i < ntiles; i++) {
+                rc = hb_mc_eva_to_npa(mc, map, &tiles[i], &eva, &npas[i], &npa_sz);
+                if (rc != HB_MC_SUCCESS)
+                        return rc;
+
+                if (npa_sz < seg_sz)
+                        return HB_MC_NOIMPL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Load a program segment into a list of tiles.
+ * If the segment is contiguous in every tile's address space, then the
+ * image is broadcast to all tiles at once, with stores interleaved
+ * across tiles. Otherwise each tile is loaded in turn.
  * @param[in] mc       A manycore instance.
  * @param[in] map      A EVA to NPA map.
  * @param[in] phdr     A program header for the data to be loaded.
  * @param[in] segdata  Program data to be loaded.
- * @param[in] tile     A manycore coordinate.
+ * @param[in] tiles    Tiles to load.
+ * @param[in] ntiles   The number of tiles to load.
  * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
  */
 static int hb_mc_loader_load_tiles_segment(hb_mc_manycore_t *mc,
@@ -324,44 +367,94 @@ static int hb_mc_loader_load_tiles_segment(hb_mc_manycore_t *mc,
                                            uint32_t ntiles)
 {
         int rc;
+        size_t seg_sz = RV32_Word_to_host(phdr->p_memsz);
+        size_t file_sz = RV32_Word_to_host(phdr->p_filesz);
+        char segname[64];
+        std::vector<hb_mc_npa_t> npas(ntiles);
 
-        for (uint32_t i = 0; i < ntiles; i++) {
-                rc = hb_mc_loader_load_tile_segment(mc, map, phdr, segdata, tiles[i]);
-                if (rc != HB_MC_SUCCESS)
-                        return rc;
+        hb_mc_loader_segment_to_string(phdr, segname, sizeof(segname));
+
+        /* broadcast requires whole words in word-aligned host memory */
+        bool broadcast = ((uintptr_t)segdata % sizeof(uint32_t) == 0)
+                && (file_sz % sizeof(uint32_t) == 0)
+                && (seg_sz % sizeof(uint32_t) == 0);
+
+        /* the per-tile path reports segments that exceed capacity */
+        for (uint32_t i = 0; i < ntiles && broadcast; i++) {
+                if (hb_mc_loader_get_tile_segment_capacity(mc, map, phdr, tiles[i]) < seg_sz)
+                        broadcast = false;
+        }
+
+        if (broadcast && hb_mc_loader_tiles_segment_to_npas(mc, map, phdr, tiles, ntiles,
+                                                            npas.data()) != HB_MC_SUCCESS)
+                broadcast = false;
+
+        if (!broadcast) {
+                for (uint32_t i = 0; i < ntiles; i++) {
+                        rc = hb_mc_loader_load_tile_segment(mc, map, phdr, segdata, tiles[i]);
+                        if (rc != HB_MC_SUCCESS)
+                                return rc;
+                }
+                return HB_MC_SUCCESS;
+        }
+
+        bsg_pr_dbg("%s: broadcasting program data to %" PRIu32 " tiles: %s\n",
+                   __func__, ntiles, segname);
+
+        /* load initialized data */
+        rc = hb_mc_manycore_write_mem_broadcast(mc, npas.data(), ntiles, segdata, file_sz);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to write %s: %s\n",
+                           __func__, segname, hb_mc_strerror(rc));
+                return rc;
         }
+
+        /* load zeroed data */
+        for (hb_mc_npa_t &npa : npas)
+                hb_mc_npa_set_epa(&npa, hb_mc_npa_get_epa(&npa) + file_sz);
+
+        rc = hb_mc_manycore_memset_broadcast(mc, npas.data(), ntiles, 0, seg_sz - file_sz);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to memset %s: %s\n",
+                           __func__, segname, hb_mc_strerror(rc));
+                return rc;
+        }
+
         return HB_MC_SUCCESS;
 }
 
 /**
- * Load a tile's ICACHE.
+ * Load tiles' ICACHE.
+ * The ICACHE image is the same for every tile, so it is broadcast to
+ * all tiles at once, with stores interleaved across tiles.
  * @param[in] mc       A manycore instance.
  * @param[in] phdr     The program header to be loaded.
  * @param[in] segdata  The program data to be loaded.
- * @param[in] tile     A tile whose ICACHE needs to be initialized.
+ * @param[in] tiles    Tiles whose ICACHE needs to be initialized.
+ * @param[in] ntiles   Number of tiles.
  * @return HB_MC_SUCCESS if succseful. Otherwise an error code is returned.
  */
-static int hb_mc_loader_load_tile_icache(hb_mc_manycore_t *mc,
-                                         const hb_mc_eva_map_t *map,
-                                         const Elf32_Phdr *phdr,
-                                         const unsigned char *segdata,
-                                         hb_mc_coordinate_t tile)
+static int hb_mc_loader_load_tiles_icache(hb_mc_manycore_t *mc,
+                                          const hb_mc_eva_map_t *map,
+                                          const Elf32_Phdr *phdr,
+                                          const unsigned char *segdata,
+                                          const hb_mc_coordinate_t *tiles,
+                                          uint32_t ntiles)
 {
         int rc;
+        std::vector<hb_mc_npa_t> icache_npas(ntiles);
 
-        /* get the NPA of this tiles ICACHE */
-        hb_mc_npa_t icache_npa = hb_mc_npa(tile, HB_MC_TILE_EPA_ICACHE);
+        /* get the NPA of each tile's ICACHE */
+        for (uint32_t i = 0; i < ntiles; i++)
+                icache_npas[i] = hb_mc_npa(tiles[i], HB_MC_TILE_EPA_ICACHE);
 
         /* write min(icache size, segment size) bytes */
         size_t sz = min_size_t(RV32_Word_to_host(phdr->p_filesz),
-                               hb_mc_tile_get_size_icache(mc, &tile));
+                               hb_mc_tile_get_size_icache(mc, &tiles[0]));
 
-        bsg_pr_dbg("%s: writing %zu bytes to (%d,%d)'s icache @ EPA 0x%08" PRIx32 "\n",
-                   __func__, sz,
-                   hb_mc_coordinate_get_x(tile),
-                   hb_mc_coordinate_get_y(tile),
-                   hb_mc_npa_get_epa(&icache_npa)
-                   );
+        bsg_pr_dbg("%s: writing %zu bytes to %" PRIu32 " tiles' icache @ EPA 0x%08" PRIx32 "\n",
+                   __func__, sz, ntiles,
+                   hb_mc_npa_get_epa(&icache_npas[0]));
 
         /*
           The address space of the ICACHE is larger than the ICACHE itself.
@@ -369,18 +462,16 @@ static int hb_mc_loader_load_tile_icache(hb_mc_manycore_t *mc,
           Only bits 0-11 actually index the memory in the ICACHE.
           It's important that bits 10-21 are zero.
         */
-        if (((hb_mc_npa_get_epa(&icache_npa)) + sz - 1) & 0x00FFF000) {
+        if (((hb_mc_npa_get_epa(&icache_npas[0])) + sz - 1) & 0x00FFF000) {
                 bsg_pr_dbg("%s: Oops: ICACHE EPA 0x%08" PRIx32 " sets tag bits\n",
-                           __func__, hb_mc_npa_get_epa(&icache_npa));
+                           __func__, hb_mc_npa_get_epa(&icache_npas[0]));
                 return HB_MC_FAIL;
         }
 
-        rc = hb_mc_manycore_write_mem(mc, &icache_npa, segdata, sz);
+        rc = hb_mc_manycore_write_mem_broadcast(mc, icache_npas.data(), ntiles, segdata, sz);
         if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to write to (%d,%d)'s icache: %s\n",
+                bsg_pr_dbg("%s: failed to write to tiles' icache: %s\n",
                            __func__,
-                           hb_mc_coordinate_get_x(tile),
-                           hb_mc_coordinate_get_y(tile),
                            hb_mc_strerror(rc));
                 return rc;
         }
@@ -388,31 +479,6 @@ static int hb_mc_loader_load_tile_icache(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
-/**
- * Load tiles' ICACHE.
- * @param[in] mc       A manycore instance.
- * @param[in] phdr     The program header to be loaded.
- * @param[in] segdata  The program data to be loaded.
- * @param[in] tiles    Tiles whose ICACHE needs to be initialized.
- * @param[in] ntiles   Number of tiles.
- * @return HB_MC_SUCCESS if succseful. Otherwise an error code is returned.
- */
-static int hb_mc_loader_load_tiles_icache(hb_mc_manycore_t *mc,
-                                          const hb_mc_eva_map_t *map,
-                                          const Elf32_Phdr *phdr,
-                                          const unsigned char *segdata,
-                                          const hb_mc_coordinate_t *tiles,
-                                          uint32_t ntiles)
-{       int rc;
-
-        for (uint32_t i = 0; i < ntiles; i++) {
-                rc = hb_mc_loader_load_tile_icache(mc, map, phdr, segdata, tiles[i]);
-                if (rc != HB_MC_SUCCESS)
-                        return rc;
-        }
-        return HB_MC_SUCCESS;
-}
-
 /**
  * Validate that a buffer contains a valid ELF format
  * @param[in]  bin    A memory buffer containing a valid manycore binary
@@ -686,95 +752,26 @@ static int hb_mc_loader_load_segments(const void *bin, size_t sz,
 }
 
 /**
- * Perform register setup for a tile.
- * @param[in] mc         A manycore instance.
- * @param[in] map        An EVA<->NPA map.
- * @param[in] pc_init    Initial PC address.
- * @param[in] tile       A tile to setup.
- * @param[in] all_tiles  All tiles being loaded.
- * @param[in] ntiles     Number of tiles being loaded.
- * @return
- */
-static int hb_mc_loader_tile_set_registers(hb_mc_manycore_t *mc,
-                                           const hb_mc_eva_map_t *map,
-                                           hb_mc_eva_t pc_init,
-                                           hb_mc_coordinate_t tile,
-                                           const hb_mc_coordinate_t *all_tiles,
-                                           uint32_t ntiles)
-{
-        int rc;
-
-        rc = hb_mc_tile_freeze(mc, &tile);
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to freeze (%" PRId32 ",%" PRId32 "): %s\n",
-                           __func__,
-                           hb_mc_coordinate_get_x(tile),
-                           hb_mc_coordinate_get_y(tile),
-                           hb_mc_strerror(rc));
-                return rc;
-        }
-
-        /* set the origin tile */
-        rc = hb_mc_tile_set_origin(mc, &tile, &all_tiles[0]); // we assume 0 is the origin
-
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to write (%d,%d)'s origin registers: %s\n",
-                           __func__,
-                           hb_mc_coordinate_get_x(tile),
-                           hb_mc_coordinate_get_y(tile),
-                           hb_mc_strerror(rc));
-                return rc;
-        }
-
-        /* set the initial PC value */
-        rc = hb_mc_tile_set_initial_pc(mc, &tile, pc_init);
-
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to write (%d,%d)'s intial PC register: %s\n",
-                           __func__,
-                           hb_mc_coordinate_get_x(tile),
-                           hb_mc_coordinate_get_y(tile),
-                           hb_mc_strerror(rc));
-                return rc;
-        }
-
-        if (rc != HB_MC_SUCCESS) {
-                char tile_str[32];
-                bsg_pr_dbg("%s: failed to %s DRAM-enabled for %s: %s\n",
-                           __func__,
-                           hb_mc_manycore_dram_is_enabled(mc) ? "set" : "clear",
-                           hb_mc_coordinate_to_string(tile, tile_str, sizeof(tile_str)),
-                           hb_mc_strerror(rc));
-                return rc;
-        }
-
-        return HB_MC_SUCCESS;
-}
-
-/**
- * Performance miscellaneous initialization on one tile.
+ * Write the same value to a CSR in each of a list of tiles.
  * @param[in] mc      A manycore instance.
- * @param[in] map     An EVA<->NPA map.
- * @param[in] pc_init Initial PC address.
- * @param[in] tile    A tile to initialize
- * @param[in] tiles   The list of tiles being initialized.
- * @param[in] ntiles  The number of tiles being initialized.
- * @return HB_MC_SUCCESS if an error occured. Otherwise an error code is returned.
+ * @param[in] csr     The EPA of the CSR.
+ * @param[in] val     The value to write.
+ * @param[in] tiles   The list of tiles.
+ * @param[in] ntiles  The number of tiles.
+ * @param[in] npas    Scratch space for #ntiles NPAs.
+ * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
  */
-static int hb_mc_loader_tile_initialize(hb_mc_manycore_t *mc,
-                                        const hb_mc_eva_map_t *map,
-                                        hb_mc_eva_t pc_init,
-                                        hb_mc_coordinate_t tile,
-                                        const hb_mc_coordinate_t *all_tiles,
-                                        uint32_t ntiles)
+static int hb_mc_loader_tiles_set_csr(hb_mc_manycore_t *mc,
+                                      hb_mc_epa_t csr,
+                                      uint32_t val,
+                                      const hb_mc_coordinate_t *tiles,
+                                      uint32_t ntiles,
+                                      hb_mc_npa_t *npas)
 {
-        int rc;
-
-        rc = hb_mc_loader_tile_set_registers(mc, map, pc_init, tile, all_tiles, ntiles);
-        if (rc != HB_MC_SUCCESS)
-                return rc;
+        for (uint32_t i = 0; i < ntiles; i++)
+                npas[i] = hb_mc_npa(tiles[i], csr);
 
-        return HB_MC_SUCCESS;
+        return hb_mc_manycore_write_mem_broadcast(mc, npas, ntiles, &val, sizeof(val));
 }
 
 /**
@@ -811,10 +808,43 @@ static int hb_mc_loader_tiles_initialize(hb_mc_manycore_t *mc,
         if (ntiles == 0)
                 return HB_MC_INVALID;
 
-        for (uint32_t i = 0; i < ntiles; i++) {
-                rc = hb_mc_loader_tile_initialize(mc, map, pc_init, tiles[i], tiles, ntiles);
-                if (rc != HB_MC_SUCCESS)
-                        return rc;
+        std::vector<hb_mc_npa_t> npas(ntiles);
+        hb_mc_coordinate_t origin = tiles[0]; // we assume 0 is the origin
+
+        /*
+          Each register is written to all tiles with one broadcast.
+          Stores to the same tile arrive in order, so every tile is
+          frozen before its origin and initial PC are set.
+        */
+        rc = hb_mc_loader_tiles_set_csr(mc, HB_MC_TILE_EPA_CSR_FREEZE, 1,
+                                        tiles, ntiles, npas.data());
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to freeze tiles: %s\n",
+                           __func__, hb_mc_strerror(rc));
+                return rc;
+        }
+
+        /* set the origin tile */
+        rc = hb_mc_loader_tiles_set_csr(mc, HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_X,
+                                        hb_mc_coordinate_get_x(origin),
+                                        tiles, ntiles, npas.data());
+        if (rc == HB_MC_SUCCESS)
+                rc = hb_mc_loader_tiles_set_csr(mc, HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_Y,
+                                                hb_mc_coordinate_get_y(origin),
+                                                tiles, ntiles, npas.data());
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to write tiles' origin registers: %s\n",
+                           __func__, hb_mc_strerror(rc));
+                return rc;
+        }
+
+        /* set the initial PC value */
+        rc = hb_mc_loader_tiles_set_csr(mc, HB_MC_TILE_EPA_CSR_PC_INIT_VALUE, pc_init,
+                                        tiles, ntiles, npas.data());
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to write tiles' initial PC register: %s\n",
+                           __func__, hb_mc_strerror(rc));
+                return rc;
         }
 
         /* validate all vcache tags if we're in no-DRAM mode */
@@ -827,6 +857,41 @@ static int hb_mc_loader_tiles_initialize(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Load a validated binary object into a list of tiles and DRAM
+ * @param[in]  bin     A memory buffer containing a valid manycore binary
+ * @param[in]  sz      Size of #bin in bytes
+ * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  map     An eva map for computing the eva to npa translation
+ * @param[in]  pc_init The initial program counter of each tile
+ * @param[in]  tiles   A list of manycore to load with #bin, with the origin at 0
+ * @param[in]  ntiles  The number of tiles in #tiles
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+static int hb_mc_loader_load_validated(const void *bin, size_t sz, hb_mc_manycore_t *mc,
+                                       const hb_mc_eva_map_t *map,
+                                       hb_mc_eva_t pc_init,
+                                       const hb_mc_coordinate_t *tiles, uint32_t ntiles)
+{
+        int rc;
+
+        // Set CSRs
+        rc = hb_mc_loader_tiles_initialize(mc, map, pc_init, tiles, ntiles);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to initialize tiles\n", __func__);
+                return rc;
+        }
+
+        // Load segments
+        rc = hb_mc_loader_load_segments(bin, sz, mc, map, tiles, ntiles);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to load segments\n", __func__);
+                return rc;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Loads an ELF file into a list of tiles and DRAM
  * @param[in]  bin    A memory buffer containing a valid manycore binary
@@ -860,21 +925,7 @@ int hb_mc_loader_load(const void *bin, size_t sz, hb_mc_manycore_t *mc,
                 return rc;
         }
 
-        // Set CSRs
-        rc = hb_mc_loader_tiles_initialize(mc, map, pc_init, tiles, ntiles);
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to initialize tiles\n", __func__);
-                return rc;
-        }
-
-        // Load segments
-        rc = hb_mc_loader_load_segments(bin, sz, mc, map, tiles, ntiles);
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to load segments\n", __func__);
-                return rc;
-        }
-
-        return HB_MC_SUCCESS;
+        return hb_mc_loader_load_validated(bin, sz, mc, map, pc_init, tiles, ntiles);
 }
 
 static int hb_mc_loader_get_section(const void *bin, size_t sz, unsigned idx,
@@ -1036,7 +1087,251 @@ int hb_mc_loader_symbol_to_eva(const void *bin, size_t sz, const char *symbol,
 
 
 
+typedef struct hb_mc_loader_symbol {
+        hb_mc_eva_t eva;
+        size_t      size;
+} hb_mc_loader_symbol_t;
+
+typedef struct hb_mc_loader_function {
+        hb_mc_eva_t eva;
+        size_t      size;
+        const std::string *name; //!< a key of hb_mc_loader_program::symbols
+} hb_mc_loader_function_t;
+
+struct hb_mc_loader_program {
+        const void *bin;
+        size_t sz;
+        std::unordered_map<std::string, hb_mc_loader_symbol_t> symbols;
+        std::vector<hb_mc_loader_function_t> functions; //!< sorted by address
+};
+
+/**
+ * Add every named symbol in a symbol table to a program's index.
+ * The first definition of a name wins, matching the search order of
+ * hb_mc_loader_symbol_to_eva().
+ * @param[in]  program      A program with #bin and #sz set.
+ * @param[in]  symtab_shdr  The symbol table section header.
+ * @param[in]  symtab_data  The symbol table section data.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+static int hb_mc_loader_program_index_symbol_table(hb_mc_loader_program_t *program,
+                                                   const Elf32_Shdr *symtab_shdr,
+                                                   const unsigned char *symtab_data)
+{
+        int rc;
+        unsigned strtab_idx = RV32_Word_to_host(symtab_shdr->sh_link);
+        const Elf32_Shdr *strtab_shdr;
+        const unsigned char *strtab_data;
+        const Elf32_Sym *symbol_table = (const Elf32_Sym*)symtab_data, *sym;
+
+        /* get the string table for this section */
+        rc = hb_mc_loader_get_section(program->bin, program->sz, strtab_idx,
+                                      &strtab_shdr, &strtab_data);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to get section %u: %s\n",
+                           __func__, strtab_idx, hb_mc_strerror(rc));
+                return rc;
+        }
+
+        Elf32_Word strtab_sz = RV32_Word_to_host(strtab_shdr->sh_size);
+
+        /* total number of symbols in symtab */
+        Elf32_Word sym_n = RV32_Word_to_host(symtab_shdr->sh_size)/RV32_Word_to_host(symtab_shdr->sh_entsize);
+
+        program->symbols.reserve(program->symbols.size() + sym_n);
+        for (Elf32_Word sym_i = 0; sym_i < sym_n; sym_i++) {
+                sym = &symbol_table[sym_i];
+
+                Elf32_Word sym_name_off = RV32_Word_to_host(sym->st_name);
+
+                /* skip symbols with no name */
+                if (sym_name_off == 0)
+                        continue;
+
+                /* symbol's name is in bounds? */
+                if (sym_name_off >= strtab_sz)
+                        return HB_MC_INVALID;
+
+                /* bound the name by the end of the string table */
+                const char *sym_name = (const char *)&strtab_data[sym_name_off];
+                size_t sym_name_len = strnlen(sym_name, strtab_sz - sym_name_off);
+
+                hb_mc_loader_symbol_t entry;
+                entry.eva = RV32_Addr_to_host(sym->st_value);
+                entry.size = RV32_Word_to_host(sym->st_size);
+                auto it = program->symbols.emplace(std::string(sym_name, sym_name_len), entry).first;
+
+                if (ELF32_ST_TYPE(sym->st_info) == STT_FUNC)
+                        program->functions.push_back({entry.eva, entry.size, &it->first});
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Validate a program and index its symbol tables.
+ * @param[in]  bin     A memory buffer containing a valid manycore binary.
+ * @param[in]  sz      Size of #bin in bytes.
+ * @param[out] program A parsed program. Release with hb_mc_loader_program_close().
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_loader_program_open(const void *bin, size_t sz,
+                              hb_mc_loader_program_t **program)
+{
+        const Elf32_Ehdr *ehdr = (const Elf32_Ehdr*) bin;
+        const Elf32_Shdr *shdr;
+        const unsigned char *section_data;
+        hb_mc_loader_program_t *prog;
+        int rc;
+
+        if (!program)
+                return HB_MC_INVALID;
+
+        rc = hb_mc_loader_elf_validate(bin, sz);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to validate binary\n", __func__);
+                return rc;
+        }
+
+        prog = new hb_mc_loader_program_t;
+        prog->bin = bin;
+        prog->sz = sz;
+
+        for (unsigned idx = 0; idx < RV32_Half_to_host(ehdr->e_shnum); idx++) {
+                rc = hb_mc_loader_get_section(bin, sz, idx, &shdr, &section_data);
+                if (rc != HB_MC_SUCCESS) {
+                        bsg_pr_dbg("%s: failed to get section %u: %s\n",
+                                   __func__, idx, hb_mc_strerror(rc));
+                        delete prog;
+                        return rc;
+                }
+
+                if (!hb_mc_loader_section_is_symbol_table(shdr))
+                        continue;
+
+                rc = hb_mc_loader_program_index_symbol_table(prog, shdr, section_data);
+                if (rc != HB_MC_SUCCESS) {
+                        bsg_pr_dbg("%s: failed to index symbols in section %u: %s\n",
+                                   __func__, idx, hb_mc_strerror(rc));
+                        delete prog;
+                        return rc;
+                }
+        }
+
+        std::sort(prog->functions.begin(), prog->functions.end(),
+                  [](const hb_mc_loader_function_t &a, const hb_mc_loader_function_t &b) {
+                          return a.eva < b.eva;
+                  });
+
+        *program = prog;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Release a program opened with hb_mc_loader_program_open().
+ * @param[in]  program A parsed program. May be NULL.
+ */
+void hb_mc_loader_program_close(hb_mc_loader_program_t *program)
+{
+        delete program;
+}
+
+/**
+ * Look up a symbol in a parsed program.
+ * @param[in]  program A parsed program.
+ * @param[in]  symbol  A program symbol.
+ * @param[out] eva     An EVA that addresses #symbol.
+ * @param[out] size    The size of #symbol in bytes. May be NULL.
+ * @return HB_MC_SUCCESS on success. HB_MC_NOTFOUND if #symbol is not defined. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_loader_program_symbol(const hb_mc_loader_program_t *program,
+                                const char *symbol,
+                                hb_mc_eva_t *eva,
+                                size_t *size)
+{
+        if (!program || !symbol || !eva)
+                return HB_MC_INVALID;
+
+        auto it = program->symbols.find(symbol);
+        if (it == program->symbols.end()) {
+                bsg_pr_dbg("%s: failed to find symbol '%s'\n",
+                           __func__, symbol);
+                return HB_MC_NOTFOUND;
+        }
+
+        *eva = it->second.eva;
+        if (size)
+                *size = it->second.size;
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Find the function that contains an address in a parsed program.
+ * @param[in]  program A parsed program.
+ * @param[in]  eva     An address, such as a program counter.
+ * @param[out] symbol  The name of the function. Valid until #program is closed.
+ * @param[out] offset  The offset of #eva from the start of the function. May be NULL.
+ * @return HB_MC_SUCCESS on success. HB_MC_NOTFOUND if no function contains #eva. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_loader_program_address_to_symbol(const hb_mc_loader_program_t *program,
+                                           hb_mc_eva_t eva,
+                                           const char **symbol,
+                                           size_t *offset)
+{
+        if (!program || !symbol)
+                return HB_MC_INVALID;
+
+        // the last function that starts at or before eva
+        auto it = std::upper_bound(program->functions.begin(), program->functions.end(), eva,
+                                   [](hb_mc_eva_t eva, const hb_mc_loader_function_t &f) {
+                                           return eva < f.eva;
+                                   });
+        if (it == program->functions.begin())
+                return HB_MC_NOTFOUND;
+        --it;
 
+        // functions without a size extend to the next function
+        if (it->size != 0 && eva - it->eva >= it->size)
+                return HB_MC_NOTFOUND;
+
+        *symbol = it->name->c_str();
+        if (offset)
+                *offset = eva - it->eva;
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Loads a parsed program into a list of tiles and DRAM.
+ * @param[in]  program A parsed program.
+ * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  map     An eva map for computing the eva to npa translation
+ * @param[in]  tiles   A list of manycore to load with #program, with the origin at 0
+ * @param[in]  ntiles  The number of tiles in #tiles
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_loader_program_load(const hb_mc_loader_program_t *program,
+                              hb_mc_manycore_t *mc,
+                              const hb_mc_eva_map_t *map,
+                              const hb_mc_coordinate_t *tiles,
+                              uint32_t ntiles)
+{
+        hb_mc_eva_t pc_init;
+        int rc;
+
+        if (!program || ntiles < 1)
+                return HB_MC_INVALID;
+
+        rc = hb_mc_loader_program_symbol(program, "_start", &pc_init, NULL);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_warn("%s: failed to find _start symbol. Defaulting to 0\n", __func__);
+                pc_init = 0;
+        }
+
+        return hb_mc_loader_load_validated(program->bin, program->sz, mc, map,
+                                           pc_init, tiles, ntiles);
+}
 
 /**
  * Takes in the path to a binary and loads the binary into a buffer and set the binary size.
@@ -37,6 +37,14 @@
 extern "C" {
 #endif
 
+        /**
+         * A parsed manycore program. The ELF is validated once when
+         * the program is opened and its symbol tables are indexed
+         * by name, so that repeated symbol lookups do not rescan the
+         * binary.
+         */
+        typedef struct hb_mc_loader_program hb_mc_loader_program_t;
+
         /**
          * Loads a binary object into a list of tiles and DRAM
          * @param[in]  bin    A memory buffer containing a valid manycore binary
@@ -66,6 +74,69 @@ extern "C" {
 
 
 
+        /**
+         * Validate a program and index its symbol tables.
+         * The program refers to #bin, which must remain valid until hb_mc_loader_program_close() is called.
+         * @param[in]  bin     A memory buffer containing a valid manycore binary.
+         * @param[in]  sz      Size of #bin in bytes.
+         * @param[out] program A parsed program. Release with hb_mc_loader_program_close().
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_loader_program_open(const void *bin, size_t sz,
+                                      hb_mc_loader_program_t **program);
+
+        /**
+         * Release a program opened with hb_mc_loader_program_open().
+         * @param[in]  program A parsed program. May be NULL.
+         */
+        void hb_mc_loader_program_close(hb_mc_loader_program_t *program);
+
+        /**
+         * Look up a symbol in a parsed program.
+         * @param[in]  program A parsed program.
+         * @param[in]  symbol  A program symbol. Behavior is undefined if #symbol is not a zero terminated string.
+         * @param[out] eva     An EVA that addresses #symbol.
+         * @param[out] size    The size of #symbol in bytes. May be NULL.
+         * @return HB_MC_SUCCESS on success. HB_MC_NOTFOUND if #symbol is not defined. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_loader_program_symbol(const hb_mc_loader_program_t *program,
+                                        const char *symbol,
+                                        hb_mc_eva_t *eva,
+                                        size_t *size);
+
+        /**
+         * Find the function that contains an address in a parsed program.
+         * @param[in]  program A parsed program.
+         * @param[in]  eva     An address, such as a program counter.
+         * @param[out] symbol  The name of the function. Valid until #program is closed.
+         * @param[out] offset  The offset of #eva from the start of the function. May be NULL.
+         * @return HB_MC_SUCCESS on success. HB_MC_NOTFOUND if no function contains #eva. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_loader_program_address_to_symbol(const hb_mc_loader_program_t *program,
+                                                   hb_mc_eva_t eva,
+                                                   const char **symbol,
+                                                   size_t *offset);
+
+        /**
+         * Loads a parsed program into a list of tiles and DRAM.
+         * Equivalent to hb_mc_loader_load(), but does not revalidate the binary.
+         * @param[in]  program A parsed program.
+         * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  map     An eva map for computing the eva to npa translation
+         * @param[in]  tiles   A list of manycore to load with #program, with the origin at 0
+         * @param[in]  len     The number of tiles in #tiles
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_loader_program_load(const hb_mc_loader_program_t *program,
+                                      hb_mc_manycore_t *mc,
+                                      const hb_mc_eva_map_t *map,
+                                      const hb_mc_coordinate_t *tiles,
+                                      uint32_t len);
+
         /**
          * Takes in the path to a binary and loads it into a buffer and sets the binary size. 
          * @param[in]  file_name A memory buffer containing a valid manycore binary.
@@ -26,11 +26,10 @@
 
 awsbwhal::MemoryManager::MemoryManager(uint64_t size, uint64_t start,
                                        unsigned alignment) : mSize(size), mStart(start), mAlignment(alignment),
-                                                             mCoalesceThreshold(4), mFreeSize(0)
+                                                             mFreeSize(0)
 {
         assert(start % alignment == 0);
-        mFreeBufferList.push_back(std::make_pair(mStart, mSize));
-        mFreeSize = mSize;
+        insertFree(mStart, mSize);
 }
 
 awsbwhal::MemoryManager::~MemoryManager()
@@ -39,38 +38,92 @@ awsbwhal::MemoryManager::~MemoryManager()
 
 }
 
+// Round size up to a multiple of mAlignment
+uint64_t
+awsbwhal::MemoryManager::pad(uint64_t size) const
+{
+        const uint64_t mod_size = size % mAlignment;
+        return size + ((mod_size > 0) ? (mAlignment - mod_size) : 0);
+}
+
+// Caller should have acquired the mutex lock before calling insertFree();
+// Adds [start, start+size) to the free trees, merging it with the
+// extents that end at start and begin at start+size (if any).
+void
+awsbwhal::MemoryManager::insertFree(uint64_t start, uint64_t size)
+{
+        if (size == 0)
+                return;
+
+        mFreeSize += size;
+
+        AddrMap::iterator next = mFreeByAddr.lower_bound(start);
+        if (next != mFreeByAddr.begin()) {
+                AddrMap::iterator prev = std::prev(next);
+                if (prev->first + prev->second == start) {
+                        start = prev->first;
+                        size += prev->second;
+                        eraseFree(prev);
+                }
+        }
+
+        if (next != mFreeByAddr.end() && start + size == next->first) {
+                size += next->second;
+                eraseFree(next);
+        }
+
+        mFreeByAddr.emplace(start, size);
+        mFreeBySize.emplace(size, start);
+}
+
+// Caller should have acquired the mutex lock before calling eraseFree();
+// Removes an extent from the free trees. Does not update mFreeSize.
+void
+awsbwhal::MemoryManager::eraseFree(AddrMap::iterator i)
+{
+        mFreeBySize.erase(std::make_pair(i->second, i->first));
+        mFreeByAddr.erase(i);
+}
+
 uint64_t
 awsbwhal::MemoryManager::alloc(size_t size)
+{
+        return alloc(size, mAlignment);
+}
+
+uint64_t
+awsbwhal::MemoryManager::alloc(size_t size, uint64_t alignment)
 {
         if (size == 0)
                 size = mAlignment;
 
-        uint64_t result = mNull;
-        const size_t mod_size = size % mAlignment;
-        const size_t pad = (mod_size > 0) ? (mAlignment - mod_size) : 0;
-        size += pad;
+        size = pad(size);
+        if (alignment < mAlignment)
+                alignment = mAlignment;
 
         #ifdef _MMAN_MUTEX_
           std::lock_guard<std::mutex> lock(mMemManagerMutex);
         #endif
-        for (PairList::iterator i = mFreeBufferList.begin(), e = mFreeBufferList.end(); i != e; ++i) {
-                if (i->second < size)
+        // Best fit: visit extents from the smallest that is large
+        // enough. With the default alignment the first one fits.
+        for (SizeSet::iterator i = mFreeBySize.lower_bound(std::make_pair(uint64_t(size), uint64_t(0))),
+                     e = mFreeBySize.end(); i != e; ++i) {
+                const uint64_t ext_start = i->second;
+                const uint64_t ext_size = i->first;
+                const uint64_t result = (ext_start + alignment - 1) / alignment * alignment;
+                if (result + size > ext_start + ext_size)
                         continue;
-                result = i->first;
-                if (i->second > size) {
-                        // Resize the existing entry in freelist
-                        i->first += size;
-                        i->second -= size;
-                }
-                else {
-                        // remove the exact match found
-                        mFreeBufferList.erase(i);
-                }
-                mBusyBufferList.push_back(std::make_pair(result, size));
-                mFreeSize -= size;
-                break;
+
+                // Carve [result, result+size) out and return the
+                // leading and trailing pieces to the free trees
+                eraseFree(mFreeByAddr.find(ext_start));
+                mFreeSize -= ext_size;
+                insertFree(ext_start, result - ext_start);
+                insertFree(result + size, ext_start + ext_size - (result + size));
+                mBusy.emplace(result, size);
+                return result;
         }
-        return result;
+        return mNull;
 }
 
 void
@@ -79,60 +132,11 @@ awsbwhal::MemoryManager::free(uint64_t buf)
         #ifdef _MMAN_MUTEX_
           std::lock_guard<std::mutex> lock(mMemManagerMutex);
         #endif
-        PairList::iterator i = find(buf);
-        if (i == mBusyBufferList.end())
+        std::unordered_map<uint64_t, uint64_t>::iterator i = mBusy.find(buf);
+        if (i == mBusy.end())
                 return;
-        mFreeSize += i->second;
-        mFreeBufferList.push_back(std::make_pair(i->first, i->second));
-        mBusyBufferList.erase(i);
-        if (mFreeBufferList.size() > mCoalesceThreshold) {
-                coalesce();
-        }
-}
-
-
-void
-awsbwhal::MemoryManager::coalesce()
-{
-        // First sort the free buffers and then attempt to coalesce the neighbors
-        mFreeBufferList.sort();
-
-        PairList::iterator curr = mFreeBufferList.begin();
-        PairList::iterator next = curr;
-        ++next;
-        PairList::iterator last = mFreeBufferList.end();
-        while (next != last) {
-                if ((curr->first + curr->second) != next->first) {
-                        // Non contiguous blocks
-                        curr = next;
-                        ++next;
-                        continue;
-                }
-                // Coalesce curr and next
-                curr->second += next->second;
-                mFreeBufferList.erase(next);
-                next = curr;
-                ++next;
-        }
-}
-
-// Caller should have acquired the mutex lock before calling find();
-awsbwhal::MemoryManager::PairList::iterator
-awsbwhal::MemoryManager::find(uint64_t buf)
-{
-#if GCC_VERSION >= 40800
-        PairList::iterator i = std::find_if(mBusyBufferList.begin(), mBusyBufferList.end(), [&] (const PairList::value_type& s)
-                                            { return s.first == buf; });
-#else
-        PairList::iterator i = mBusyBufferList.begin();
-        PairList::iterator last  = mBusyBufferList.end();
-        while(i != last) {
-                if (i->first == buf)
-                        break;
-                ++i;
-        }
-#endif
-        return i;
+        insertFree(i->first, i->second);
+        mBusy.erase(i);
 }
 
 void
@@ -141,10 +145,11 @@ awsbwhal::MemoryManager::reset()
         #ifdef _MMAN_MUTEX_
           std::lock_guard<std::mutex> lock(mMemManagerMutex);
         #endif
-        mFreeBufferList.clear();
-        mBusyBufferList.clear();
-        mFreeBufferList.push_back(std::make_pair(mStart, mSize));
+        mFreeByAddr.clear();
+        mFreeBySize.clear();
+        mBusy.clear();
         mFreeSize = 0;
+        insertFree(mStart, mSize);
 }
 
 std::pair<uint64_t, uint64_t>
@@ -153,8 +158,8 @@ awsbwhal::MemoryManager::lookup(uint64_t buf)
         #ifdef _MMAN_MUTEX_
           std::lock_guard<std::mutex> lock(mMemManagerMutex);
         #endif
-        PairList::iterator i = find(buf);
-        if (i != mBusyBufferList.end())
+        std::unordered_map<uint64_t, uint64_t>::iterator i = mBusy.find(buf);
+        if (i != mBusy.end())
                 return *i;
         // Compiler bug -- Some versions of GCC C++11 compiler do not
         // like mNull directly inside std::make_pair, so capture mNull
@@ -177,49 +182,44 @@ awsbwhal::MemoryManager::reserve(uint64_t base, size_t size)
         if (base > (mStart + mSize))
                 return false;
 
-        const size_t mod_size = size % mAlignment;
-        const size_t pad = (mod_size > 0) ? (mAlignment - mod_size) : 0;
-        size += pad;
+        size = pad(size);
 
         #ifdef _MMAN_MUTEX_
           std::lock_guard<std::mutex> lock(mMemManagerMutex);
         #endif
-        for (PairList::iterator i = mFreeBufferList.begin(), e = mFreeBufferList.end(); i != e; ++i) {
-                if (i->second < size)
-                        continue;
-                if (i->first > base)
-                        continue;
-                if ((base + size) > (i->first + i->second))
-                        continue;
-                uint64_t a = i->first;
-                uint64_t b = i->second;
-
-                i->second = base - i->first;
-                if ((i->first == base) && (i->second == 0)) {
-                        //Exact match
-                        mFreeBufferList.erase(i);
-                        break;
-                }
-                if (i->first == base) {
-                        // Hole at the end; Resize exisiting entry
-                        i->first = base + size;
-                        break;
-                }
-                if ((i->first + i->second) == (base + size)) {
-                        // Hole in the beginning; Resize exisiting entry
-                        i->second -= size;
-                        break;
-                }
-                // We have holes on both sides
-                // Resize hole in the beginning
-                i->second = base - i->first;
-
-                // Now create an entry for the hole at the end
-                b = b + a - base - size;
-                a = base + size;
-                mFreeBufferList.insert(++i, std::make_pair(a, b));
-        }
-        mBusyBufferList.push_back(std::make_pair(base, size));
-        mFreeSize -= size;
+        // Find the free extent that starts at or before base
+        AddrMap::iterator i = mFreeByAddr.upper_bound(base);
+        if (i == mFreeByAddr.begin())
+                return false;
+        --i;
+
+        const uint64_t a = i->first;
+        const uint64_t b = i->second;
+        if ((base + size) > (a + b))
+                return false;
+
+        // Split into holes before and after the reserved range
+        eraseFree(i);
+        mFreeSize -= b;
+        insertFree(a, base - a);
+        insertFree(base + size, a + b - (base + size));
+        mBusy.emplace(base, size);
         return true;
 }
+
+awsbwhal::MemoryManager::Stats
+awsbwhal::MemoryManager::stats()
+{
+        #ifdef _MMAN_MUTEX_
+          std::lock_guard<std::mutex> lock(mMemManagerMutex);
+        #endif
+        Stats s;
+        s.freeSize = mFreeSize;
+        s.busySize = mSize - mFreeSize;
+        s.largestFree = mFreeBySize.empty() ? 0 : mFreeBySize.rbegin()->first;
+        s.freeExtents = mFreeByAddr.size();
+        s.busyBlocks = mBusy.size();
+        s.fragmentation = (mFreeSize == 0) ? 0.0 :
+                1.0 - static_cast<double>(s.largestFree) / static_cast<double>(mFreeSize);
+        return s;
+}
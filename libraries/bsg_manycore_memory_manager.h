@@ -23,35 +23,56 @@
 #include <bsg_manycore_features.h>
 
 #include <mutex>
-#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include "xclhal.h"
 
 namespace awsbwhal {
+        /*
+         * Free extents are kept in two ordered trees, one by address
+         * (to coalesce with neighbors on free) and one by size (for
+         * best-fit allocation). Busy blocks are kept in a hash map.
+         * alloc(), free() and lookup() are O(log n) in the number of
+         * extents.
+         */
         class MemoryManager {
                 #ifdef _MMAN_MUTEX_
                   std::mutex mMemManagerMutex;
                 #endif
-                std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-                std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
+                typedef std::map<uint64_t, uint64_t> AddrMap;          // start -> size
+                typedef std::set<std::pair<uint64_t, uint64_t> > SizeSet; // (size, start)
+
+                AddrMap mFreeByAddr;
+                SizeSet mFreeBySize;
+                std::unordered_map<uint64_t, uint64_t> mBusy;        // start -> size
                 const uint64_t mSize;
                 const uint64_t mStart;
                 const uint64_t mAlignment;
-                const unsigned mCoalesceThreshold;
                 uint64_t mFreeSize;
 
-                typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
-
         public:
                 static const uint64_t mNull = 0xffffffffffffffffull;
 
+                struct Stats {
+                        uint64_t freeSize;      // total bytes free
+                        uint64_t busySize;      // total bytes allocated
+                        uint64_t largestFree;   // largest free extent in bytes
+                        uint64_t freeExtents;   // number of free extents
+                        uint64_t busyBlocks;    // number of allocated blocks
+                        double   fragmentation; // 1 - largestFree/freeSize (0 when free space is one extent)
+                };
+
         public:
                 MemoryManager(uint64_t size, uint64_t start, unsigned alignment);
                 ~MemoryManager();
                 uint64_t alloc(size_t size);
+                uint64_t alloc(size_t size, uint64_t alignment);
                 void free(uint64_t buf);
                 void reset();
                 std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
                 bool reserve(uint64_t base, size_t size);
+                Stats stats();
 
                 uint64_t size() const {
                         return mSize;
@@ -71,8 +92,9 @@ namespace awsbwhal {
 
         private:
                 /* Note that these should be called after acquiring mMemManagerMutex */
-                void coalesce();
-                PairList::iterator find(uint64_t buf);
+                void insertFree(uint64_t start, uint64_t size);
+                void eraseFree(AddrMap::iterator i);
+                uint64_t pad(uint64_t size) const;
         };
 }
 
@@ -74,6 +74,13 @@ int  hb_mc_origin_eva_map_init(hb_mc_eva_map_t *map, hb_mc_coordinate_t origin)
 
         memcpy(cpy, &origin, sizeof(origin));
 
+        /* initialize the translation cache */
+        r = hb_mc_eva_map_cache_init(map);
+        if (r != HB_MC_SUCCESS) {
+                free(cpy);
+                goto cleanup;
+        }
+
         /* setup members */
         map->priv = (const void*)cpy;
         map->eva_to_npa = default_eva_to_npa;
@@ -108,6 +115,9 @@ int hb_mc_origin_eva_map_exit(hb_mc_eva_map_t *map)
                 return HB_MC_INVALID;
         }
 
+        /* free the translation cache */
+        hb_mc_eva_map_cache_exit(map);
+
         /* free the private data */
         origin = (hb_mc_coordinate_t*) map->priv;
         if (!origin) {
@@ -0,0 +1,190 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_pc_histogram.h>
+#include <bsg_manycore_printing.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <map>
+#include <tuple>
+#include <vector>
+
+typedef std::tuple<hb_mc_idx_t, hb_mc_idx_t, uint32_t> pc_key; // x, y, pc
+
+struct hb_mc_pc_histogram {
+        hb_mc_manycore_t *mc;
+        std::map<pc_key, uint64_t> baseline; //!< the histogram when the window started
+        bool stopped;
+        std::vector<hb_mc_pc_sample_t> samples; //!< the window's samples once stopped
+};
+
+/* read the histogram since reset */
+static int hb_mc_pc_histogram_read(hb_mc_manycore_t *mc, std::vector<hb_mc_pc_sample_t> &samples)
+{
+        size_t nsamples;
+        int err = hb_mc_manycore_get_pc_histogram(mc, nullptr, 0, &nsamples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        samples.resize(nsamples);
+        err = hb_mc_manycore_get_pc_histogram(mc, samples.data(), samples.size(), &nsamples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        samples.resize(std::min(nsamples, samples.size()));
+        return HB_MC_SUCCESS;
+}
+
+/* the samples taken since the window started, most frequent first */
+static int hb_mc_pc_histogram_window(hb_mc_pc_histogram_t *window, std::vector<hb_mc_pc_sample_t> &samples)
+{
+        if (window->stopped) {
+                samples = window->samples;
+                return HB_MC_SUCCESS;
+        }
+
+        int err = hb_mc_pc_histogram_read(window->mc, samples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        auto end = std::remove_if(samples.begin(), samples.end(),
+                                  [window](hb_mc_pc_sample_t &s) {
+                                          auto it = window->baseline.find(pc_key(s.tile.x, s.tile.y, s.pc));
+                                          // a count below the baseline was reset, so all of it is new
+                                          if (it != window->baseline.end() && s.count >= it->second)
+                                                  s.count -= it->second;
+                                          return s.count == 0;
+                                  });
+        samples.erase(end, samples.end());
+
+        std::sort(samples.begin(), samples.end(),
+                  [](const hb_mc_pc_sample_t &a, const hb_mc_pc_sample_t &b) {
+                          return std::make_tuple(b.count, a.tile.x, a.tile.y, a.pc)
+                                  < std::make_tuple(a.count, b.tile.x, b.tile.y, b.pc);
+                  });
+
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_pc_histogram_start(hb_mc_manycore_t *mc, hb_mc_pc_histogram_t **window)
+{
+        if (window == nullptr)
+                return HB_MC_INVALID;
+
+        std::vector<hb_mc_pc_sample_t> samples;
+        int err = hb_mc_pc_histogram_read(mc, samples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_pc_histogram_t *w = new hb_mc_pc_histogram_t;
+        w->mc = mc;
+        w->stopped = false;
+        for (const hb_mc_pc_sample_t &s : samples)
+                w->baseline[pc_key(s.tile.x, s.tile.y, s.pc)] += s.count;
+
+        *window = w;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_pc_histogram_stop(hb_mc_pc_histogram_t *window)
+{
+        if (window == nullptr)
+                return HB_MC_INVALID;
+
+        if (window->stopped)
+                return HB_MC_SUCCESS;
+
+        int err = hb_mc_pc_histogram_window(window, window->samples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        window->stopped = true;
+        window->baseline.clear();
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_pc_histogram_snapshot(hb_mc_pc_histogram_t *window, hb_mc_pc_sample_t *samples,
+                                size_t n, size_t *nsamples)
+{
+        if (window == nullptr || nsamples == nullptr || (n != 0 && samples == nullptr))
+                return HB_MC_INVALID;
+
+        std::vector<hb_mc_pc_sample_t> v;
+        int err = hb_mc_pc_histogram_window(window, v);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        std::copy_n(v.begin(), std::min(n, v.size()), samples);
+        *nsamples = v.size();
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_pc_histogram_dump(hb_mc_pc_histogram_t *window, const hb_mc_loader_program_t *program,
+                            const char *label, size_t top, FILE *out)
+{
+        if (window == nullptr || label == nullptr || out == nullptr)
+                return HB_MC_INVALID;
+
+        std::vector<hb_mc_pc_sample_t> samples;
+        int err = hb_mc_pc_histogram_window(window, samples);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        uint64_t total = 0;
+        for (const hb_mc_pc_sample_t &s : samples)
+                total += s.count;
+
+        size_t entries = top == 0 ? samples.size() : std::min(top, samples.size());
+        fprintf(out, "window,%s,%" PRIu64 ",%zu\n", label, total, entries);
+
+        for (size_t i = 0; i < entries; i++) {
+                const hb_mc_pc_sample_t &s = samples[i];
+                const char *symbol = "??";
+                size_t offset = 0;
+                if (program != nullptr
+                    && hb_mc_loader_program_address_to_symbol(program, s.pc, &symbol, &offset) != HB_MC_SUCCESS) {
+                        symbol = "??";
+                        offset = 0;
+                }
+
+                fprintf(out, "%d,%d,0x%08" PRIx32 ",%" PRIu64 ",%s+0x%zx\n",
+                        (int)s.tile.x, (int)s.tile.y, s.pc, s.count, symbol, offset);
+        }
+
+        if (fflush(out) != 0) {
+                bsg_pr_err("%s: failed to write window '%s': %m\n", __func__, label);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+void hb_mc_pc_histogram_release(hb_mc_pc_histogram_t *window)
+{
+        delete window;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BSG_MANYCORE_PC_HISTOGRAM_H
+#define BSG_MANYCORE_PC_HISTOGRAM_H
+
+#include <bsg_manycore_features.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_loader.h>
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        /**
+         * A window of the PC histogram. A window counts the samples
+         * taken between hb_mc_pc_histogram_start() and
+         * hb_mc_pc_histogram_stop(), so that a kernel can be
+         * profiled apart from the rest of the program. Any number of
+         * windows may be open at once.
+         */
+        typedef struct hb_mc_pc_histogram hb_mc_pc_histogram_t;
+
+        /**
+         * Open a window of the PC histogram, starting now.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] window A window. Release with hb_mc_pc_histogram_release().
+         * @return HB_MC_SUCCESS on success. HB_MC_NOIMPL if the platform has no PC histogram.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_pc_histogram_start(hb_mc_manycore_t *mc, hb_mc_pc_histogram_t **window);
+
+        /**
+         * Close a window. Later snapshots and dumps of #window return the samples
+         * taken between hb_mc_pc_histogram_start() and this call.
+         * @param[in]  window A window opened with hb_mc_pc_histogram_start()
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_pc_histogram_stop(hb_mc_pc_histogram_t *window);
+
+        /**
+         * Get the samples of a window, most frequent first.
+         * If #window is not stopped, get the samples taken since it started.
+         * @param[in]  window   A window opened with hb_mc_pc_histogram_start()
+         * @param[out] samples  An array of at least #n samples
+         * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+         * @param[out] nsamples The number of nonzero (tile, PC) samples in the window, which may be more than #n
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_pc_histogram_snapshot(hb_mc_pc_histogram_t *window, hb_mc_pc_sample_t *samples,
+                                        size_t n, size_t *nsamples);
+
+        /**
+         * Write the samples of a window to a stream as CSV, most frequent first.
+         * The first line is "window,<label>,<total samples>,<entries>", and each
+         * following line is "<x>,<y>,<pc>,<count>,<function>+<offset>".
+         * @param[in]  window  A window opened with hb_mc_pc_histogram_start()
+         * @param[in]  program The program running on the tiles, used to name PCs. May be NULL.
+         * @param[in]  label   A name for this window, such as the kernel name
+         * @param[in]  top     The number of entries to write. Set to 0 to write every entry.
+         * @param[in]  out     The stream to write to
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_pc_histogram_dump(hb_mc_pc_histogram_t *window, const hb_mc_loader_program_t *program,
+                                    const char *label, size_t top, FILE *out);
+
+        /**
+         * Release a window.
+         * @param[in]  window A window opened with hb_mc_pc_histogram_start(). May be NULL.
+         */
+        void hb_mc_pc_histogram_release(hb_mc_pc_histogram_t *window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
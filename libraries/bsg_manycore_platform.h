@@ -39,20 +39,43 @@ extern "C" {
          * Transmit a request packet to manycore hardware
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A request packet to transmit to manycore hardware
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
-         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
+         * @return HB_MC_SUCCESS on success, HB_MC_TIMEOUT if #timeout expired.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
          */
         int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
                                     hb_mc_packet_t *packet,
                                     hb_mc_fifo_tx_t type,
                                     long timeout);
 
+        /**
+         * Transmit a batch of packets to manycore hardware, in order
+         *
+         * Platforms should push as many packets as the hardware will
+         * accept (i.e. fill all available credits) before advancing
+         * time, rather than waiting on each packet individually.
+         *
+         * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] packets An array of #n packets to transmit to manycore hardware
+         * @param[in] n       The number of packets in #packets
+         * @param[in] type    The FIFO to transmit #packets on
+         * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
+         * @return HB_MC_SUCCESS if all packets were transmitted, HB_MC_TIMEOUT if #timeout expired.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                          hb_mc_packet_t *packets,
+                                          size_t n,
+                                          hb_mc_fifo_tx_t type,
+                                          long timeout);
+
         /**
          * Receive a packet from manycore hardware
          * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response A packet into which data should be read
-         * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
-         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
+         * @return HB_MC_SUCCESS on success, HB_MC_TIMEOUT if #timeout expired.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
          */
         int hb_mc_platform_receive(hb_mc_manycore_t *mc,
                                    hb_mc_packet_t *packet,
@@ -70,6 +93,15 @@ extern "C" {
                                          unsigned int idx,
                                          hb_mc_config_raw_t *config);
 
+        /**
+         * Read the whole configuration ROM
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] config An array of HB_MC_CONFIG_MAX configuration values
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_platform_get_config(hb_mc_manycore_t *mc,
+                                      hb_mc_config_raw_t config[HB_MC_CONFIG_MAX]);
+
         /**
          * Stall until the all requests (and responses) have reached their destination.
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -85,6 +117,12 @@ extern "C" {
          * initialization and cleanup tasks for assisting in doing
          * packet-based bulk transfers from the host and device.
          *
+         * Between start and finish, a platform may defer packets
+         * passed to hb_mc_platform_transmit() and send them as a
+         * batch. Deferred packets must be sent before the platform
+         * receives a packet, fences, or finishes the transfer. Bulk
+         * transfers may be nested.
+         *
          * Unless otherwise needed, most platforms can simply return HB_MC_SUCCESS
          *
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -99,6 +137,9 @@ extern "C" {
          * initialization and cleanup tasks for assisting in doing
          * packet-based bulk transfers from the host and device.
          *
+         * The outermost finish sends any packets deferred since the
+         * matching call to hb_mc_platform_start_bulk_transfer().
+         *
          * Unless otherwise needed, most platforms can simply return HB_MC_SUCCESS
          *
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -124,6 +165,29 @@ extern "C" {
          */
         int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int *count);
 
+        /**
+         * Get the performance counters of every tile
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] counters An array of at least #n counters
+         * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+         * @param[out] ntiles   The number of tiles with counters
+         * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_platform_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                        size_t n, size_t *ntiles, int delta);
+
+        /**
+         * Get the PC histogram of every tile since reset
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] samples  An array of at least #n samples
+         * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+         * @param[out] nsamples The number of nonzero (tile, PC) samples
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_platform_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                            size_t n, size_t *nsamples);
+
         /**
          * Enable trace file generation (vanilla_operation_trace.csv)
          * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
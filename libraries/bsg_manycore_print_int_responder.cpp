@@ -29,6 +29,7 @@
 #include <bsg_manycore_request_packet_id.h>
 #include <bsg_manycore_printing.h>
 #include <bsg_manycore_coordinate.h>
+#include <algorithm>
 #include <stdio.h>
 
 #define SINT_EPA 0xEAE0
@@ -70,32 +71,40 @@ static int respond(hb_mc_responder_t *responder,
 {
         auto data = hb_mc_request_packet_get_data(rqst);
         FILE *f = (FILE*)responder->responder_data;
+        hb_mc_coordinate_t src = hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                                  hb_mc_request_packet_get_y_src(rqst));
         char coordstr[256];
-        hb_mc_coordinate_to_string(hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
-                                                    hb_mc_request_packet_get_y_src(rqst)),
-                                   coordstr,sizeof(coordstr));
+        hb_mc_coordinate_to_string(src, coordstr, sizeof(coordstr));
         utof_t f_data;
+        char line[512];
+        int sz = 0;
 
         switch (hb_mc_request_packet_get_epa(rqst)) {
         case SINT_EPA:
-                fprintf(f, "int32   from %s: %d\n", coordstr, (int)data);
+                sz = snprintf(line, sizeof(line), "int32   from %s: %d\n", coordstr, (int)data);
                 break;
         case UINT_EPA:
-                fprintf(f, "uint32  from %s: %u\n", coordstr, (unsigned)data);
+                sz = snprintf(line, sizeof(line), "uint32  from %s: %u\n", coordstr, (unsigned)data);
                 break;
         case XINT_EPA:
-                fprintf(f, "uint32  from %s: 0x%08x\n", coordstr, (unsigned) data);
+                sz = snprintf(line, sizeof(line), "uint32  from %s: 0x%08x\n", coordstr, (unsigned) data);
                 break;
         case FP32_EPA:
                 f_data.u = data;
-                fprintf(f, "float32 from %s: %f\n", coordstr, f_data.f);
+                sz = snprintf(line, sizeof(line), "float32 from %s: %f\n", coordstr, f_data.f);
                 break;
         case FP32_SCI_EPA:
                 f_data.u = data;
-                fprintf(f, "float32 from %s: %e\n", coordstr, f_data.f);
+                sz = snprintf(line, sizeof(line), "float32 from %s: %e\n", coordstr, f_data.f);
                 break;
         }
-        return 0;
+
+        if (sz <= 0)
+                return 0;
+
+        // shares the tile's line buffer with UART output, so lines stay in order
+        return hb_mc_responder_console_write(mc, f, src, line,
+                                             std::min<size_t>(sz, sizeof(line) - 1));
 }
 
 static hb_mc_responder_t print_int_responder("Print Int", ids, init, quit, respond);
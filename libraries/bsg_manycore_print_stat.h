@@ -0,0 +1,170 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BSG_MANYCORE_PRINT_STAT_H
+#define BSG_MANYCORE_PRINT_STAT_H
+
+#include <bsg_manycore_features.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_epa.h>
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+/* bsg_print_stat() stores a tag to this EPA on the host */
+#define HB_MC_PRINT_STAT_EPA 0x0D0C
+
+/* Fields of bsg_manycore_vanilla_core_stat_tag_s (bsg_manycore_profile_pkg) */
+#define HB_MC_PRINT_STAT_TYPE_SHIFT   30
+#define HB_MC_PRINT_STAT_TYPE_WIDTH   2
+#define HB_MC_PRINT_STAT_TG_ID_SHIFT  16
+#define HB_MC_PRINT_STAT_TG_ID_WIDTH  14
+#define HB_MC_PRINT_STAT_Y_SHIFT      10
+#define HB_MC_PRINT_STAT_Y_WIDTH      6
+#define HB_MC_PRINT_STAT_X_SHIFT      4
+#define HB_MC_PRINT_STAT_X_WIDTH      6
+#define HB_MC_PRINT_STAT_TAG_SHIFT    0
+#define HB_MC_PRINT_STAT_TAG_WIDTH    4
+
+/* The number of distinct tags */
+#define HB_MC_PRINT_STAT_TAG_MAX      (1 << HB_MC_PRINT_STAT_TAG_WIDTH)
+
+/* The tag used by bsg_cuda_print_stat_kernel_start() and bsg_cuda_print_stat_kernel_end() */
+#define HB_MC_PRINT_STAT_TAG_KERNEL   0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        typedef enum __hb_mc_print_stat_type {
+                HB_MC_PRINT_STAT_TYPE_START = 0,
+                HB_MC_PRINT_STAT_TYPE_END   = 1,
+        } hb_mc_print_stat_type_t;
+
+        /* A decoded print stat tag */
+        typedef struct hb_mc_print_stat_tag {
+                hb_mc_print_stat_type_t type; //!< start or end
+                uint32_t tile_group_id;       //!< the tile group id of the sender
+                uint32_t x;                   //!< the x coordinate the sender reported
+                uint32_t y;                   //!< the y coordinate the sender reported
+                uint32_t tag;                 //!< the tag, less than HB_MC_PRINT_STAT_TAG_MAX
+        } hb_mc_print_stat_tag_t;
+
+        static inline uint32_t hb_mc_print_stat_field(uint32_t data, unsigned shift, unsigned width)
+        {
+                return (data >> shift) & ((1u << width) - 1);
+        }
+
+        /**
+         * Decode the data of a print stat request.
+         * @param[in] data  The data of a request to HB_MC_PRINT_STAT_EPA.
+         * @return The decoded tag.
+         */
+        static inline hb_mc_print_stat_tag_t hb_mc_print_stat_tag_decode(uint32_t data)
+        {
+                hb_mc_print_stat_tag_t tag;
+                tag.type = (hb_mc_print_stat_type_t)hb_mc_print_stat_field(data, HB_MC_PRINT_STAT_TYPE_SHIFT,
+                                                                           HB_MC_PRINT_STAT_TYPE_WIDTH);
+                tag.tile_group_id = hb_mc_print_stat_field(data, HB_MC_PRINT_STAT_TG_ID_SHIFT,
+                                                           HB_MC_PRINT_STAT_TG_ID_WIDTH);
+                tag.y   = hb_mc_print_stat_field(data, HB_MC_PRINT_STAT_Y_SHIFT, HB_MC_PRINT_STAT_Y_WIDTH);
+                tag.x   = hb_mc_print_stat_field(data, HB_MC_PRINT_STAT_X_SHIFT, HB_MC_PRINT_STAT_X_WIDTH);
+                tag.tag = hb_mc_print_stat_field(data, HB_MC_PRINT_STAT_TAG_SHIFT, HB_MC_PRINT_STAT_TAG_WIDTH);
+                return tag;
+        }
+
+        /* Cycles between matching start and end tags */
+        typedef struct hb_mc_print_stat_summary {
+                uint64_t count;      //!< the number of start/end pairs
+                uint64_t cycles;     //!< the total cycles of all pairs
+                uint64_t min_cycles; //!< the fewest cycles of any pair
+                uint64_t max_cycles; //!< the most cycles of any pair
+        } hb_mc_print_stat_summary_t;
+
+        /*
+         * One kernel: from the first kernel start tag received while no tile
+         * is in a kernel, until every tile that started has sent its end tag.
+         */
+        typedef struct hb_mc_print_stat_kernel {
+                uint64_t start_cycle;      //!< the cycle the first tile started
+                uint64_t end_cycle;        //!< the cycle the last tile ended
+                hb_mc_print_stat_summary_t tiles; //!< kernel cycles of each tile
+                hb_mc_print_stat_summary_t tags[HB_MC_PRINT_STAT_TAG_MAX]; //!< cycles for each tag ended during the kernel
+        } hb_mc_print_stat_kernel_t;
+
+        /**
+         * Get the cycles between start and end tags for a tag, over all tiles and kernels.
+         * Cycles are counted by the host when each tag is received.
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  tag      A tag, less than HB_MC_PRINT_STAT_TAG_MAX
+         * @param[out] summary  The cycles for #tag
+         * @return HB_MC_SUCCESS if succesful. HB_MC_INVALID if #tag is out of range.
+         * Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_print_stat_get_summary(hb_mc_manycore_t *mc, uint32_t tag,
+                                         hb_mc_print_stat_summary_t *summary);
+
+        /**
+         * Get per-kernel cycle breakdowns, oldest first. Kernels still running are not included.
+         * @param[in]  mc        A manycore instance initialized with hb_mc_manycore_init()
+         * @param[out] kernels   An array of at least #n kernels
+         * @param[in]  n         The number of kernels to get
+         * @param[out] nkernels  The number of kernels that have completed, which may be more than #n
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_print_stat_get_kernels(hb_mc_manycore_t *mc, hb_mc_print_stat_kernel_t *kernels,
+                                         size_t n, size_t *nkernels);
+
+        /**
+         * Discard all print stat data received so far.
+         * @param[in]  mc        A manycore instance initialized with hb_mc_manycore_init()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_print_stat_reset(hb_mc_manycore_t *mc);
+
+        /**
+         * Write per-tag and per-kernel cycle breakdowns to a stream.
+         * @param[in]  mc        A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  f         A stream
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_print_stat_report(hb_mc_manycore_t *mc, FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
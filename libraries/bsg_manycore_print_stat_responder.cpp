@@ -0,0 +1,288 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_responder.h>
+#include <bsg_manycore_request_packet_id.h>
+#include <bsg_manycore_printing.h>
+#include <bsg_manycore_print_stat.h>
+#include <bsg_manycore_coordinate.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+static hb_mc_request_packet_id_t ids [] = {
+        RQST_ID( RQST_ID_ANY_X, RQST_ID_ANY_Y, RQST_ID_ADDR(HB_MC_PRINT_STAT_EPA) ),
+        { /* sentinel */ },
+};
+
+/* start cycles of open intervals, keyed by sending tile and tag */
+typedef std::tuple<hb_mc_idx_t, hb_mc_idx_t, uint32_t> open_key;
+
+typedef struct print_stats {
+        std::mutex lock;
+        std::map<open_key, std::vector<uint64_t> > open;
+        hb_mc_print_stat_summary_t tags[HB_MC_PRINT_STAT_TAG_MAX];
+        std::vector<hb_mc_print_stat_kernel_t> kernels; //!< completed kernels
+        hb_mc_print_stat_kernel_t kernel;               //!< the running kernel
+        size_t kernel_tiles;                            //!< tiles in the running kernel
+        uint64_t unmatched;                             //!< end tags without a start tag
+} print_stats_t;
+
+static std::mutex stats_lock;
+static std::map<const hb_mc_manycore_t *, print_stats_t *> stats;
+
+static print_stats_t *get_stats(const hb_mc_manycore_t *mc)
+{
+        std::lock_guard<std::mutex> guard(stats_lock);
+        auto it = stats.find(mc);
+        return it == stats.end() ? nullptr : it->second;
+}
+
+static void summary_reset(hb_mc_print_stat_summary_t *s)
+{
+        memset(s, 0, sizeof(*s));
+        s->min_cycles = UINT64_MAX;
+}
+
+static void summary_add(hb_mc_print_stat_summary_t *s, uint64_t cycles)
+{
+        s->count++;
+        s->cycles += cycles;
+        s->min_cycles = std::min(s->min_cycles, cycles);
+        s->max_cycles = std::max(s->max_cycles, cycles);
+}
+
+static void kernel_reset(hb_mc_print_stat_kernel_t *k)
+{
+        k->start_cycle = 0;
+        k->end_cycle = 0;
+        summary_reset(&k->tiles);
+        for (hb_mc_print_stat_summary_t &s : k->tags)
+                summary_reset(&s);
+}
+
+static void stats_reset(print_stats_t *s)
+{
+        s->open.clear();
+        for (hb_mc_print_stat_summary_t &t : s->tags)
+                summary_reset(&t);
+        s->kernels.clear();
+        kernel_reset(&s->kernel);
+        s->kernel_tiles = 0;
+        s->unmatched = 0;
+}
+
+static int init(hb_mc_responder_t *responder,
+                hb_mc_manycore_t *mc)
+{
+        bsg_pr_dbg("hello from %s\n", __FILE__);
+        print_stats_t *s = new print_stats_t;
+        stats_reset(s);
+
+        std::lock_guard<std::mutex> guard(stats_lock);
+        if (!stats.emplace(mc, s).second) {
+                delete s;
+                return HB_MC_INITIALIZED_TWICE;
+        }
+        return 0;
+}
+
+static int quit(hb_mc_responder_t *responder,
+                hb_mc_manycore_t *mc)
+{
+        bsg_pr_dbg("goodbye from %s\n", __FILE__);
+        std::lock_guard<std::mutex> guard(stats_lock);
+        auto it = stats.find(mc);
+        if (it != stats.end()) {
+                delete it->second;
+                stats.erase(it);
+        }
+        return 0;
+}
+
+static int respond(hb_mc_responder_t *responder,
+                   hb_mc_manycore_t *mc,
+                   const hb_mc_request_packet_t *rqst)
+{
+        print_stats_t *s = get_stats(mc);
+        if (s == nullptr)
+                return 0;
+
+        hb_mc_print_stat_tag_t tag = hb_mc_print_stat_tag_decode(hb_mc_request_packet_get_data(rqst));
+        open_key key(hb_mc_request_packet_get_x_src(rqst),
+                     hb_mc_request_packet_get_y_src(rqst),
+                     tag.tag);
+
+        // the host's clock stands in for the sender's
+        uint64_t cycle = 0;
+        int err = hb_mc_manycore_get_cycle(mc, &cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        std::lock_guard<std::mutex> guard(s->lock);
+        bool is_kernel = tag.tag == HB_MC_PRINT_STAT_TAG_KERNEL;
+
+        if (tag.type == HB_MC_PRINT_STAT_TYPE_START) {
+                s->open[key].push_back(cycle);
+                if (is_kernel && s->kernel_tiles++ == 0)
+                        s->kernel.start_cycle = cycle;
+                return 0;
+        }
+
+        if (tag.type != HB_MC_PRINT_STAT_TYPE_END)
+                return 0;
+
+        auto it = s->open.find(key);
+        if (it == s->open.end()) {
+                bsg_pr_dbg("%s: end of tag %" PRIu32 " from (%" PRIu32 ",%" PRIu32 ") without a start\n",
+                           __func__, tag.tag, std::get<0>(key), std::get<1>(key));
+                s->unmatched++;
+                return 0;
+        }
+
+        uint64_t cycles = cycle - it->second.back();
+        it->second.pop_back();
+        if (it->second.empty())
+                s->open.erase(it);
+
+        summary_add(&s->tags[tag.tag], cycles);
+
+        if (s->kernel_tiles == 0)
+                return 0;
+
+        if (!is_kernel) {
+                summary_add(&s->kernel.tags[tag.tag], cycles);
+                return 0;
+        }
+
+        summary_add(&s->kernel.tiles, cycles);
+        summary_add(&s->kernel.tags[tag.tag], cycles);
+        if (--s->kernel_tiles == 0) {
+                s->kernel.end_cycle = cycle;
+                s->kernels.push_back(s->kernel);
+                kernel_reset(&s->kernel);
+        }
+
+        return 0;
+}
+
+static hb_mc_responder_t print_stat_responder("Print Stat", ids, init, quit, respond);
+
+source_responder(print_stat_responder)
+
+int hb_mc_print_stat_get_summary(hb_mc_manycore_t *mc, uint32_t tag,
+                                 hb_mc_print_stat_summary_t *summary)
+{
+        if (tag >= HB_MC_PRINT_STAT_TAG_MAX)
+                return HB_MC_INVALID;
+
+        print_stats_t *s = get_stats(mc);
+        if (s == nullptr)
+                return HB_MC_UNINITIALIZED;
+
+        std::lock_guard<std::mutex> guard(s->lock);
+        *summary = s->tags[tag];
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_print_stat_get_kernels(hb_mc_manycore_t *mc, hb_mc_print_stat_kernel_t *kernels,
+                                 size_t n, size_t *nkernels)
+{
+        print_stats_t *s = get_stats(mc);
+        if (s == nullptr)
+                return HB_MC_UNINITIALIZED;
+
+        std::lock_guard<std::mutex> guard(s->lock);
+        std::copy_n(s->kernels.begin(), std::min(n, s->kernels.size()), kernels);
+        *nkernels = s->kernels.size();
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_print_stat_reset(hb_mc_manycore_t *mc)
+{
+        print_stats_t *s = get_stats(mc);
+        if (s == nullptr)
+                return HB_MC_UNINITIALIZED;
+
+        std::lock_guard<std::mutex> guard(s->lock);
+        stats_reset(s);
+        return HB_MC_SUCCESS;
+}
+
+static void report_summary(FILE *f, const char *name, const hb_mc_print_stat_summary_t *sum)
+{
+        if (sum->count == 0)
+                return;
+
+        fprintf(f, "%-8s %10" PRIu64 " %16" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                name, sum->count, sum->cycles, sum->cycles / sum->count,
+                sum->min_cycles, sum->max_cycles);
+}
+
+static void report_tags(FILE *f, const hb_mc_print_stat_summary_t *tags)
+{
+        fprintf(f, "%-8s %10s %16s %12s %12s %12s\n",
+                "tag", "count", "cycles", "mean", "min", "max");
+        for (uint32_t t = 0; t < HB_MC_PRINT_STAT_TAG_MAX; t++) {
+                char name[16];
+                if (t == HB_MC_PRINT_STAT_TAG_KERNEL)
+                        snprintf(name, sizeof(name), "kernel");
+                else
+                        snprintf(name, sizeof(name), "%" PRIu32, t);
+                report_summary(f, name, &tags[t]);
+        }
+}
+
+int hb_mc_print_stat_report(hb_mc_manycore_t *mc, FILE *f)
+{
+        print_stats_t *s = get_stats(mc);
+        if (s == nullptr)
+                return HB_MC_UNINITIALIZED;
+
+        std::lock_guard<std::mutex> guard(s->lock);
+
+        fprintf(f, "print stat: all tiles\n");
+        report_tags(f, s->tags);
+
+        for (size_t k = 0; k < s->kernels.size(); k++) {
+                const hb_mc_print_stat_kernel_t *kernel = &s->kernels[k];
+                fprintf(f, "print stat: kernel %zu: cycles %" PRIu64 "-%" PRIu64 " (%" PRIu64 "), %" PRIu64 " tiles\n",
+                        k, kernel->start_cycle, kernel->end_cycle,
+                        kernel->end_cycle - kernel->start_cycle, kernel->tiles.count);
+                report_tags(f, kernel->tags);
+        }
+
+        if (s->unmatched != 0)
+                fprintf(f, "print stat: %" PRIu64 " end tags without a start tag\n", s->unmatched);
+
+        return HB_MC_SUCCESS;
+}
@@ -27,103 +27,143 @@
 
 #include <bsg_manycore_printing.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
-
-#include <map>
-#include <string>
-
-using std::map;
-using std::string;
+#include <strings.h>
 
 typedef struct prefix_info {
+        const char *prefix;
         FILE *file;
-        bool newline;
-        void (*newline_hook)(struct prefix_info *info, const char *prefix);
+        bool newline;   // the next character printed starts a line
+        bool timestamp; // insert the time into the prefix
 } prefix_info_t;
 
-/* inserts the time into the prefix */
-static void insert_time(prefix_info_t *info, const char *prefix)
+/* indexed by level */
+static prefix_info_t prefixes[] = {
+        {BSG_PRINT_PREFIX_ERROR, BSG_PRINT_STREAM_ERROR, true, false},
+        {BSG_PRINT_PREFIX_WARN,  BSG_PRINT_STREAM_WARN,  true, false},
+        {BSG_PRINT_PREFIX_INFO,  BSG_PRINT_STREAM_INFO,  true, false},
+        {BSG_PRINT_PREFIX_DEBUG, BSG_PRINT_STREAM_DEBUG, true, true},
+};
+
+static const int num_prefixes = sizeof(prefixes)/sizeof(prefixes[0]);
+
+int bsg_pr_runtime_level = BSG_PRINT_LEVEL_DEBUG;
+
+void bsg_pr_set_level(int level)
 {
-        fprintf(info->file, "%s @ (%lu): ", prefix, bsg_utc());
-        return;
+        bsg_pr_runtime_level = level;
 }
 
-typedef map<string, prefix_info_t> prefix_map;
+__attribute__((constructor))
+static void bsg_pr_level_init(void)
+{
+        static const char *names[] = {"error", "warn", "info", "debug"};
+        const char *env = getenv(BSG_PRINT_LEVEL_ENV);
+        if (env == NULL || *env == '\0')
+                return;
+
+        for (int level = 0; level < num_prefixes; level++) {
+                if (strcasecmp(env, names[level]) == 0) {
+                        bsg_pr_set_level(level);
+                        return;
+                }
+        }
 
-static prefix_map fmap = {
-        {BSG_PRINT_PREFIX_DEBUG, {BSG_PRINT_STREAM_DEBUG, true, insert_time}},
-        {BSG_PRINT_PREFIX_ERROR, {BSG_PRINT_STREAM_ERROR, true, 0}},
-        {BSG_PRINT_PREFIX_WARN,  {BSG_PRINT_STREAM_WARN,  true, 0}},
-        {BSG_PRINT_PREFIX_INFO,  {BSG_PRINT_STREAM_INFO,  true, 0}},
-};
+        bsg_pr_set_level(atoi(env));
+}
 
-int bsg_pr_prefix(const char *prefix, const char *fmt, ...)
+/* prints the prefix at the start of a line */
+static void print_prefix(prefix_info_t *info)
 {
-        string prefix_string(prefix);
-        string fmt_string(fmt);
-        prefix_info_t *info;
-        va_list ap;
-        int r = -1, count = 0;
-        bool newline;
-
-        auto it = fmap.find(prefix_string);
-        if (it != fmap.end()) {
-                info = &it->second;
+        if (info->timestamp) {
+                fprintf(info->file, "%s @ (%lu): ", info->prefix, bsg_utc());
         } else {
-                return r;
+                fputs(info->prefix, info->file);
+        }
+}
+
+static int bsg_pr_vprefix(prefix_info_t *info, const char *fmt, va_list ap)
+{
+        char buf[BSG_PRINT_BUFFER_SIZE];
+        char *msg = buf;
+        va_list aq;
+        int n;
+
+        // format the whole message once
+        va_copy(aq, ap);
+        n = vsnprintf(buf, sizeof(buf), fmt, ap);
+        if (n >= 0 && (size_t)n >= sizeof(buf)) {
+                msg = (char *)malloc(n + 1);
+                n = msg ? vsnprintf(msg, n + 1, fmt, aq) : -1;
+        }
+        va_end(aq);
+
+        if (n < 0) {
+                if (msg != buf)
+                        free(msg);
+                return -1;
         }
 
         // lock our file to make our print atomic
         flockfile(info->file);
-        va_start(ap, fmt);
-        newline = info->newline;
-
-        string::size_type  cl_start = 0, cl_end;
-        do { // for each line in fmt
-                // find end of line
-                cl_end = fmt_string.find('\n', cl_start);
-                cl_end = (cl_end == string::npos ? fmt_string.size() : cl_end);
-
-                // print prefix if this is the start of a new line
-                if (newline) {
-                        if (info->newline_hook) {
-                                info->newline_hook(info, prefix);
-                        } else {
-                                fprintf(info->file, "%s", prefix);
-                        }
-                }
 
-                // print to the end of the line
-                string lfmt = fmt_string.substr(cl_start, cl_end-cl_start);
+        // print each line, with a prefix if it starts a new line
+        const char *p = msg, *end = msg + n;
+        while (p < end) {
+                if (info->newline)
+                        print_prefix(info);
 
-                count += vfprintf(info->file, lfmt.c_str(), ap);
+                const char *nl = (const char *)memchr(p, '\n', end - p);
+                size_t len = nl ? (size_t)(nl - p + 1) : (size_t)(end - p);
+                fwrite(p, 1, len, info->file);
 
-                // move cl_start forward
-                cl_start = cl_end;
+                info->newline = (nl != NULL);
+                p += len;
+        }
 
-                // decide on newline
-                if (cl_end != fmt_string.size()) {
-                        // print the newline character and set 'newline' to true
-                        count += fprintf(info->file, "\n");
-                        cl_start++; // advance one so we don't print the 'newline' twice
-                        newline = true;
-                } else {
-                        // this was the last line printed
-                        // if it was an empty line just set newline to false
-                        newline = lfmt.empty() ? true : false;
-                }
+        funlockfile(info->file);
+
+        if (msg != buf)
+                free(msg);
 
-                // until we've reached the end of our format string
-        } while (cl_start < fmt_string.size());
+        return n;
+}
 
-        // success
-        r = count;
+int bsg_pr_level(int level, const char *fmt, ...)
+{
+        va_list ap;
+        int r;
 
- exit_func:
-        // setup for the next call
-        info->newline = newline;
+        if (level < 0 || level >= num_prefixes)
+                return -1;
+
+        va_start(ap, fmt);
+        r = bsg_pr_vprefix(&prefixes[level], fmt, ap);
+        va_end(ap);
+        return r;
+}
+
+int bsg_pr_prefix(const char *prefix, const char *fmt, ...)
+{
+        prefix_info_t *info = NULL;
+        va_list ap;
+        int r;
+
+        for (int level = 0; level < num_prefixes; level++) {
+                if (prefix == prefixes[level].prefix
+                    || strcmp(prefix, prefixes[level].prefix) == 0) {
+                        info = &prefixes[level];
+                        break;
+                }
+        }
+
+        if (info == NULL)
+                return -1;
+
+        va_start(ap, fmt);
+        r = bsg_pr_vprefix(info, fmt, ap);
         va_end(ap);
-        funlockfile(info->file);
         return r;
 }
@@ -64,25 +64,95 @@ extern "C" {
                 return ms;
         }
 
+        /* Print levels, from least to most verbose */
+#define BSG_PRINT_LEVEL_ERROR 0
+#define BSG_PRINT_LEVEL_WARN  1
+#define BSG_PRINT_LEVEL_INFO  2
+#define BSG_PRINT_LEVEL_DEBUG 3
+
+        /*
+          The most verbose level compiled in. Calls to the print
+          macros for more verbose levels compile to nothing.
+        */
+#ifndef BSG_PRINT_LEVEL_MAX
+#if defined(DEBUG)
+#define BSG_PRINT_LEVEL_MAX BSG_PRINT_LEVEL_DEBUG
+#else
+#define BSG_PRINT_LEVEL_MAX BSG_PRINT_LEVEL_INFO
+#endif
+#endif
+
+        /* If set, the initial runtime print level (a level number or name) */
+#define BSG_PRINT_LEVEL_ENV "BSG_PRINT_LEVEL"
+
+        /* The most verbose level printed at runtime. Use bsg_pr_set_level() to change. */
+        extern int bsg_pr_runtime_level;
+
+        /**
+         * Set the most verbose level printed at runtime.
+         * Levels above BSG_PRINT_LEVEL_MAX are never printed.
+         * @param[in] level  A BSG_PRINT_LEVEL_* value.
+         */
+        void bsg_pr_set_level(int level);
+
+        /**
+         * Check if a level is printed at runtime.
+         * @param[in] level  A BSG_PRINT_LEVEL_* value.
+         * @return non-zero if #level is printed.
+         */
+        static inline int bsg_pr_enabled(int level)
+        {
+                return level <= bsg_pr_runtime_level;
+        }
+
+        /**
+         * Print a message with the prefix of a level.
+         * This looks up the prefix by index and formats into a stack
+         * buffer, so it does not allocate unless the message is longer
+         * than BSG_PRINT_BUFFER_SIZE. It does not check the runtime level;
+         * the bsg_pr_* macros do.
+         * @param[in] level  A BSG_PRINT_LEVEL_* value.
+         * @param[in] fmt    A printf format string.
+         * @return The number of characters printed, or a negative value on error.
+         */
+        __attribute__((format(printf, 2, 3)))
+        int bsg_pr_level(int level, const char *fmt, ...);
+
         __attribute__((format(printf, 2, 3)))
         int bsg_pr_prefix(const char *prefix, const char *fmt, ...);
 
+/* Messages up to this long are formatted without allocating */
+#define BSG_PRINT_BUFFER_SIZE 1024
 
-#if defined(DEBUG)
+#define bsg_pr_at_level(level, fmt, ...)                                \
+        do {                                                            \
+                if (bsg_pr_enabled(level))                              \
+                        bsg_pr_level(level, fmt, ##__VA_ARGS__);        \
+        } while (0)
+
+#if BSG_PRINT_LEVEL_MAX >= BSG_PRINT_LEVEL_DEBUG
 #define bsg_pr_dbg(fmt, ...)                                            \
-        bsg_pr_prefix(BSG_PRINT_PREFIX_DEBUG, fmt, ##__VA_ARGS__)
+        bsg_pr_at_level(BSG_PRINT_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
 #else
 #define bsg_pr_dbg(...)
 #endif
 
 #define bsg_pr_err(fmt, ...)                                            \
-        bsg_pr_prefix(BSG_PRINT_PREFIX_ERROR, fmt, ##__VA_ARGS__)
+        bsg_pr_at_level(BSG_PRINT_LEVEL_ERROR, fmt, ##__VA_ARGS__)
 
+#if BSG_PRINT_LEVEL_MAX >= BSG_PRINT_LEVEL_WARN
 #define bsg_pr_warn(fmt, ...)                                           \
-        bsg_pr_prefix(BSG_PRINT_PREFIX_WARN, fmt, ##__VA_ARGS__)
+        bsg_pr_at_level(BSG_PRINT_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define bsg_pr_warn(...)
+#endif
 
+#if BSG_PRINT_LEVEL_MAX >= BSG_PRINT_LEVEL_INFO
 #define bsg_pr_info(fmt, ...)                                           \
-        bsg_pr_prefix(BSG_PRINT_PREFIX_INFO, fmt, ##__VA_ARGS__)
+        bsg_pr_at_level(BSG_PRINT_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define bsg_pr_info(...)
+#endif
 
 
 #if defined(__cplusplus)
@@ -27,13 +27,278 @@
 
 #include <bsg_manycore_responder.h>
 #include <bsg_manycore_errno.h>
+#include <cstdlib>
 #include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <stdint.h>
 
 typedef std::list<hb_mc_responder_t *> responder_list;
 
 static responder_list *responders = nullptr;
 
+/* An ID of a responder, ranked by the responder's position in the list */
+typedef struct responder_entry {
+        size_t rank;
+        hb_mc_responder_t *responder;
+        const hb_mc_request_packet_id_t *id;
+} responder_entry;
+
+typedef std::vector<responder_entry> responder_entry_list;
+
+/*
+  Responders indexed for dispatch. IDs that match a single EPA are
+  looked up by EPA; IDs that match under a mask are checked in turn.
+  Both lists are sorted by rank.
+*/
+typedef struct responder_dispatch {
+        std::unordered_map<hb_mc_epa_t, responder_entry_list> by_epa;
+        responder_entry_list wildcard;
+} responder_dispatch;
+
+static responder_dispatch *dispatch = nullptr;
+
+static void responder_dispatch_build(void)
+{
+        delete dispatch;
+        dispatch = nullptr;
+
+        if (responders == nullptr)
+                return;
+
+        dispatch = new responder_dispatch;
+
+        size_t rank = 0;
+        for (hb_mc_responder_t *responder : *responders) {
+                rank++;
+                if (responder->ids == nullptr)
+                        continue;
+
+                for (const hb_mc_request_packet_id_t *id = responder->ids; id->init != 0; id++) {
+                        responder_entry entry = {rank, responder, id};
+                        if (id->id_addr.a_mask == UINT32_MAX)
+                                dispatch->by_epa[id->id_addr.a_value].push_back(entry);
+                        else
+                                dispatch->wildcard.push_back(entry);
+                }
+        }
+}
+
+/* Output buffered for one tile and stream */
+typedef struct console_line {
+        FILE *stream;
+        std::string buf;
+        uint64_t cycle; // when the first buffered byte arrived
+} console_line;
+
+/* Buffered tile output of one manycore */
+typedef struct console {
+        std::mutex lock;
+        // a tile rarely prints to more than a couple of streams, so
+        // each tile has a short list of lines keyed by stream
+        std::unordered_map<uint64_t, std::vector<console_line>> tiles;
+        FILE *capture = nullptr;
+} console;
+
+typedef std::unordered_map<hb_mc_manycore_t *, console *> console_map;
+
+/* Created and destroyed with the responders in hb_mc_responders_init/quit */
+static console_map consoles;
+
+static uint64_t console_tile_key(hb_mc_coordinate_t tile)
+{
+        return (static_cast<uint64_t>(hb_mc_coordinate_get_x(tile)) << 32)
+                | hb_mc_coordinate_get_y(tile);
+}
+
+static console *console_get(hb_mc_manycore_t *mc)
+{
+        auto it = consoles.find(mc);
+        return it == consoles.end() ? nullptr : it->second;
+}
+
+static int console_line_flush(console *con, hb_mc_coordinate_t tile, console_line &line)
+{
+        size_t sz = line.buf.size();
+        int err = HB_MC_SUCCESS;
+
+        if (sz == 0)
+                return HB_MC_SUCCESS;
+
+        if (con->capture) {
+                hb_mc_console_record_t rec;
+                rec.cycle = line.cycle;
+                rec.x = hb_mc_coordinate_get_x(tile);
+                rec.y = hb_mc_coordinate_get_y(tile);
+                rec.fd = fileno(line.stream);
+                rec.sz = sz;
+                if (fwrite(&rec, sizeof(rec), 1, con->capture) != 1
+                    || fwrite(line.buf.data(), 1, sz, con->capture) != sz)
+                        err = HB_MC_FAIL;
+        } else if (fwrite(line.buf.data(), 1, sz, line.stream) != sz) {
+                err = HB_MC_FAIL;
+        }
+
+        line.buf.clear();
+        return err;
+}
+
+static int console_flush_tile(console *con, uint64_t key, std::vector<console_line> &lines)
+{
+        hb_mc_coordinate_t tile = hb_mc_coordinate(key >> 32, key & 0xFFFFFFFF);
+        for (console_line &line : lines) {
+                int err = console_line_flush(con, tile, line);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+        return HB_MC_SUCCESS;
+}
+
+static int console_init(hb_mc_manycore_t *mc)
+{
+        if (consoles.count(mc))
+                return HB_MC_SUCCESS;
+
+        consoles[mc] = new console;
+
+        const char *path = getenv(HB_MC_RESPONDER_CONSOLE_CAPTURE_ENV);
+        if (path && *path)
+                return hb_mc_responder_console_capture(mc, path);
+
+        return HB_MC_SUCCESS;
+}
+
+static int console_quit(hb_mc_manycore_t *mc)
+{
+        int err = hb_mc_responder_console_flush(mc);
+        int cerr = hb_mc_responder_console_capture(mc, NULL);
+
+        auto it = consoles.find(mc);
+        if (it != consoles.end()) {
+                delete it->second;
+                consoles.erase(it);
+        }
+
+        return err != HB_MC_SUCCESS ? err : cerr;
+}
+
+int hb_mc_responder_console_write(hb_mc_manycore_t *mc, FILE *stream,
+                                  hb_mc_coordinate_t tile,
+                                  const char *buf, size_t sz)
+{
+        console *con = console_get(mc);
+        int err;
+
+        // write through if responders are not initialized
+        if (con == nullptr)
+                return fwrite(buf, 1, sz, stream) == sz ? HB_MC_SUCCESS : HB_MC_FAIL;
+
+        std::lock_guard<std::mutex> guard(con->lock);
+
+        std::vector<console_line> &lines = con->tiles[console_tile_key(tile)];
+        console_line *line = nullptr;
+        for (console_line &l : lines) {
+                if (l.stream == stream) {
+                        line = &l;
+                        break;
+                }
+        }
+
+        if (line == nullptr) {
+                lines.push_back({stream, std::string(), 0});
+                line = &lines.back();
+        }
+
+        for (size_t i = 0; i < sz; i++) {
+                if (line->buf.empty() && con->capture
+                    && hb_mc_manycore_get_cycle(mc, &line->cycle) != HB_MC_SUCCESS)
+                        line->cycle = 0;
+
+                line->buf.push_back(buf[i]);
+
+                if (buf[i] == '\n' || line->buf.size() >= HB_MC_RESPONDER_CONSOLE_LINE_MAX) {
+                        err = console_line_flush(con, tile, *line);
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_responder_console_flush_tile(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile)
+{
+        console *con = console_get(mc);
+        if (con == nullptr)
+                return HB_MC_SUCCESS;
+
+        std::lock_guard<std::mutex> guard(con->lock);
+
+        auto it = con->tiles.find(console_tile_key(tile));
+        if (it == con->tiles.end())
+                return HB_MC_SUCCESS;
+
+        return console_flush_tile(con, it->first, it->second);
+}
+
+int hb_mc_responder_console_flush(hb_mc_manycore_t *mc)
+{
+        console *con = console_get(mc);
+        int err;
+
+        if (con == nullptr)
+                return HB_MC_SUCCESS;
+
+        std::lock_guard<std::mutex> guard(con->lock);
+
+        for (auto &tile : con->tiles) {
+                err = console_flush_tile(con, tile.first, tile.second);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        if (con->capture && fflush(con->capture) != 0)
+                return HB_MC_FAIL;
+
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_responder_console_capture(hb_mc_manycore_t *mc, const char *path)
+{
+        console *con = console_get(mc);
+        int err;
+
+        if (con == nullptr)
+                return HB_MC_INVALID;
+
+        // output buffered so far goes to the old destination
+        err = hb_mc_responder_console_flush(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        std::lock_guard<std::mutex> guard(con->lock);
+
+        if (con->capture) {
+                if (fclose(con->capture) != 0)
+                        err = HB_MC_FAIL;
+                con->capture = nullptr;
+        }
+
+        if (path == nullptr)
+                return err;
+
+        con->capture = fopen(path, "wb");
+        if (con->capture == nullptr) {
+                bsg_pr_err("%s: failed to open console capture file '%s'\n",
+                           __func__, path);
+                return HB_MC_FAIL;
+        }
+
+        return err;
+}
+
 int hb_mc_responder_init(hb_mc_responder_t *responder, hb_mc_manycore_t *mc)
 {
         int err;
@@ -49,6 +314,10 @@ int hb_mc_responder_init(hb_mc_responder_t *responder, hb_mc_manycore_t *mc)
 
 int hb_mc_responders_init(hb_mc_manycore_t *mc)
 {
+        int err = console_init(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
         if (responders == nullptr)
                 return HB_MC_SUCCESS; //  no responders
 
@@ -61,6 +330,9 @@ int hb_mc_responders_init(hb_mc_manycore_t *mc)
                         return err;
         }
 
+        // responders may set up their IDs in init
+        responder_dispatch_build();
+
         return HB_MC_SUCCESS;
 }
 
@@ -81,6 +353,10 @@ int hb_mc_responders_quit(hb_mc_manycore_t *mc)
 {
         int err;
 
+        err = console_quit(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
         if (responders == nullptr)
                 return HB_MC_SUCCESS; // no responders
 
@@ -96,53 +372,58 @@ int hb_mc_responders_quit(hb_mc_manycore_t *mc)
         return HB_MC_SUCCESS;
 }
 
-static int hb_mc_responder_respond(hb_mc_responder_t *responder,
-                                   hb_mc_manycore_t *mc,
-                                   const hb_mc_request_packet_t *rqst)
+int hb_mc_responders_respond(hb_mc_manycore_t *mc, const hb_mc_request_packet_t *rqst)
 {
         int err;
 
-        if (responder->respond == nullptr)
-                return HB_MC_INVALID; // no respond
+        if (dispatch == nullptr)
+                return HB_MC_SUCCESS; // no responders
 
-        if (responder->ids == nullptr)
-                return HB_MC_SUCCESS; // no ids
+        static const responder_entry_list none;
+        auto it = dispatch->by_epa.find(hb_mc_request_packet_get_epa(rqst));
+        const responder_entry_list &exact = it == dispatch->by_epa.end() ? none : it->second;
+        const responder_entry_list &wildcard = dispatch->wildcard;
 
-        for (hb_mc_request_packet_id_t *id = responder->ids;
-             id->init != 0;
-             id++) {
-                if (hb_mc_request_packet_is_match(rqst, id) == 1)
-                        return responder->respond(responder, mc, rqst);
-        }
+        // visit candidates in responder order; each responder responds
+        // to its first matching ID only
+        hb_mc_responder_t *responded = nullptr;
+        size_t i = 0, j = 0;
+        while (i < exact.size() || j < wildcard.size()) {
+                const responder_entry &entry =
+                        (j == wildcard.size()
+                         || (i < exact.size() && exact[i].rank <= wildcard[j].rank))
+                        ? exact[i++] : wildcard[j++];
 
-        return HB_MC_SUCCESS;
-}
+                if (entry.responder == responded
+                    || hb_mc_request_packet_is_match(rqst, entry.id) != 1)
+                        continue;
 
-int hb_mc_responders_respond(hb_mc_manycore_t *mc, const hb_mc_request_packet_t *rqst)
-{
-        int err;
+                if (entry.responder->respond == nullptr)
+                        return HB_MC_INVALID; // no respond
 
-        if (responders == nullptr)
-                return HB_MC_SUCCESS; // no responders
-
-        for (auto it = responders->begin();
-             it != responders->end();
-             it++) {
-                auto responder = *it;
-                err = hb_mc_responder_respond(responder, mc, rqst);
+                responded = entry.responder;
+                err = entry.responder->respond(entry.responder, mc, rqst);
                 if (err != HB_MC_SUCCESS)
                         return err;
         }
+
         return HB_MC_SUCCESS;
 }
 
 
 int hb_mc_responder_add(hb_mc_responder_t *responder)
 {
+        if (responder->respond == nullptr) {
+                bsg_pr_err("%s: responder %s has no respond function\n",
+                           __func__, responder->name);
+                return HB_MC_INVALID;
+        }
+
         if (responders == nullptr)
                 responders = new responder_list;
 
         responders->push_front(responder);
+        responder_dispatch_build();
         return HB_MC_SUCCESS;
 }
 
@@ -152,5 +433,81 @@ int hb_mc_responder_del(hb_mc_responder_t *responder)
                 return HB_MC_FAIL;
 
         responders->remove(responder);
+        responder_dispatch_build();
+        return HB_MC_SUCCESS;
+}
+
+/* A responder registered with hb_mc_responder_register_epa() */
+typedef struct epa_responder {
+        hb_mc_responder_t responder;
+        hb_mc_request_packet_id_t ids[2];
+        hb_mc_responder_epa_func func;
+        void *arg;
+
+        epa_responder(const char *name, hb_mc_epa_t epa,
+                      hb_mc_responder_epa_func func, void *arg) :
+                responder(name, ids, epa_init, epa_quit, epa_respond),
+                func(func), arg(arg) {
+                typedef hb_mc_request_packet_id_t rqst_id;
+                ids[0] = rqst_id(rqst_id::address_value_mask_pair(epa, UINT32_MAX),
+                                 rqst_id::coordinate_x_lo_hi_pair(0, UINT32_MAX),
+                                 rqst_id::coordinate_y_lo_hi_pair(0, UINT32_MAX),
+                                 1);
+                ids[1].init = 0; // sentinel
+                responder.responder_data = this;
+        }
+
+        static int epa_init(hb_mc_responder_t *responder, hb_mc_manycore_t *mc) {
+                return HB_MC_SUCCESS;
+        }
+
+        static int epa_quit(hb_mc_responder_t *responder, hb_mc_manycore_t *mc) {
+                return HB_MC_SUCCESS;
+        }
+
+        static int epa_respond(hb_mc_responder_t *responder, hb_mc_manycore_t *mc,
+                               const hb_mc_request_packet_t *rqst) {
+                epa_responder *self = static_cast<epa_responder *>(responder->responder_data);
+                return self->func(mc, rqst, self->arg);
+        }
+} epa_responder;
+
+static std::unordered_map<hb_mc_epa_t, epa_responder *> epa_responders;
+
+int hb_mc_responder_register_epa(const char *name, hb_mc_epa_t epa,
+                                 hb_mc_responder_epa_func func, void *arg)
+{
+        if (func == nullptr)
+                return HB_MC_INVALID;
+
+        if (epa_responders.count(epa)) {
+                bsg_pr_err("%s: a responder is already registered for EPA 0x%08" PRIx32 "\n",
+                           __func__, epa);
+                return HB_MC_BUSY;
+        }
+
+        epa_responder *r = new epa_responder(name, epa, func, arg);
+        int err = hb_mc_responder_add(&r->responder);
+        if (err != HB_MC_SUCCESS) {
+                delete r;
+                return err;
+        }
+
+        epa_responders[epa] = r;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_responder_unregister_epa(hb_mc_epa_t epa)
+{
+        auto it = epa_responders.find(epa);
+        if (it == epa_responders.end())
+                return HB_MC_NOTFOUND;
+
+        int err = hb_mc_responder_del(&it->second->responder);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        delete it->second;
+        epa_responders.erase(it);
         return HB_MC_SUCCESS;
 }
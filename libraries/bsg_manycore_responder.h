@@ -33,6 +33,19 @@
 #include <bsg_manycore_request_packet_id.h>
 #include <bsg_manycore_printing.h>
 #include <bsg_manycore.h>
+#include <bsg_manycore_coordinate.h>
+
+#ifdef __cplusplus
+#include <cstdio>
+#else
+#include <stdio.h>
+#endif
+
+/* Tile output is written once this many bytes are buffered, even without a newline */
+#define HB_MC_RESPONDER_CONSOLE_LINE_MAX 1024
+
+/* If set, tile output is recorded to the file named by this variable */
+#define HB_MC_RESPONDER_CONSOLE_CAPTURE_ENV "BSG_MANYCORE_CONSOLE_CAPTURE"
 
 #ifdef __cplusplus
 extern "C" {
@@ -126,7 +139,8 @@ extern "C" {
         /**
          * Add a responder to the global list of responders.
          * @param[in] responder  A new responder. This should ** NOT ** be initialized with hb_mc_responder_init().
-         * @return HB_MC_SUCCESS if succesful. An error code otherwise.
+         * @return HB_MC_SUCCESS if succesful. HB_MC_INVALID if #responder has no
+         * respond function. An error code otherwise.
          */
         __attribute__((warn_unused_result))
         int hb_mc_responder_add(hb_mc_responder_t *responder);
@@ -139,6 +153,94 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_responder_del(hb_mc_responder_t *responder);
 
+        typedef int (*hb_mc_responder_epa_func)(hb_mc_manycore_t *mc,
+                                                const hb_mc_request_packet_t *rqst,
+                                                void *arg);
+
+        /**
+         * Call a function for each request packet sent to the host at an EPA.
+         * The function is called from the thread receiving the request. It is
+         * also called for requests received before hb_mc_responders_init().
+         * @param[in] name  A name for the responder.
+         * @param[in] epa   The EPA to respond to. Requests from any tile match.
+         * @param[in] func  The function to call.
+         * @param[in] arg   An argument passed to #func.
+         * @return HB_MC_SUCCESS if succesful. HB_MC_BUSY if a function is already
+         * registered for #epa. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_register_epa(const char *name, hb_mc_epa_t epa,
+                                         hb_mc_responder_epa_func func, void *arg);
+
+        /**
+         * Stop calling the function registered for an EPA.
+         * @param[in] epa   An EPA registered with hb_mc_responder_register_epa().
+         * @return HB_MC_SUCCESS if succesful. HB_MC_NOTFOUND if nothing is
+         * registered for #epa. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_unregister_epa(hb_mc_epa_t epa);
+
+        /**
+         * A record of tile output in a console capture file.
+         * Each record is followed by #sz bytes of output. Fields are in host byte order.
+         */
+        typedef struct hb_mc_console_record {
+                uint64_t cycle;  //!< cycle at which the first byte of output arrived
+                uint32_t x;      //!< x coordinate of the tile
+                uint32_t y;      //!< y coordinate of the tile
+                uint32_t fd;     //!< file descriptor of the stream written
+                uint32_t sz;     //!< number of bytes of output that follow
+        } hb_mc_console_record_t;
+
+        /**
+         * Write output printed by a tile to a stream.
+         * Output is buffered for each tile and stream, and is written when a
+         * newline is printed, when HB_MC_RESPONDER_CONSOLE_LINE_MAX bytes are
+         * buffered, or when it is flushed. While console capture is enabled,
+         * output is recorded to the capture file instead.
+         * @param[in] mc      A manycore initialized with hb_mc_manycore_init().
+         * @param[in] stream  The stream to which output is written.
+         * @param[in] tile    The tile that printed #buf.
+         * @param[in] buf     Output to be written.
+         * @param[in] sz      The size of #buf in bytes.
+         * @return HB_MC_SUCCESS if succesful. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_console_write(hb_mc_manycore_t *mc, FILE *stream,
+                                          hb_mc_coordinate_t tile,
+                                          const char *buf, size_t sz);
+
+        /**
+         * Write out all output buffered for a tile.
+         * @param[in] mc    A manycore initialized with hb_mc_manycore_init().
+         * @param[in] tile  A tile.
+         * @return HB_MC_SUCCESS if succesful. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_console_flush_tile(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile);
+
+        /**
+         * Write out all buffered tile output.
+         * This function is called by hb_mc_responders_quit().
+         * @param[in] mc  A manycore initialized with hb_mc_manycore_init().
+         * @return HB_MC_SUCCESS if succesful. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_console_flush(hb_mc_manycore_t *mc);
+
+        /**
+         * Record tile output to a file rather than writing it to its stream.
+         * Capture is enabled by hb_mc_responders_init() if the environment
+         * variable HB_MC_RESPONDER_CONSOLE_CAPTURE_ENV names a file.
+         * The file is a sequence of hb_mc_console_record_t records.
+         * @param[in] mc    A manycore initialized with hb_mc_manycore_init().
+         * @param[in] path  A file to create. NULL disables capture.
+         * @return HB_MC_SUCCESS if succesful. An error code otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_responder_console_capture(hb_mc_manycore_t *mc, const char *path);
+
 #ifdef __cplusplus
 #define source_responder(rspdr)                                         \
         namespace {                                                     \
@@ -0,0 +1,405 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_trace.h>
+#include <bsg_manycore_printing.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+const char *hb_mc_trace_kind_name(hb_mc_trace_kind_t kind)
+{
+        switch (kind) {
+        case HB_MC_TRACE_KIND_BRANCH:
+                return "branch";
+        default:
+                return "unknown";
+        }
+}
+
+/////////////
+// Writing //
+/////////////
+
+typedef std::tuple<uint32_t, uint32_t, uint32_t> trace_stream_key; // x, y, kind
+
+/* the records of one tile and kind that have not been written */
+typedef struct trace_stream {
+        std::vector<hb_mc_trace_record_t> buf; //!< a ring of records
+        size_t head;                           //!< where the next record goes
+        size_t count;                          //!< the number of records in buf
+} trace_stream_t;
+
+struct hb_mc_trace_writer {
+        FILE *f;
+        hb_mc_trace_mode_t mode;
+        size_t records;
+        uint32_t seq;
+        std::map<trace_stream_key, trace_stream_t> streams;
+        std::vector<hb_mc_trace_index_entry_t> index;
+};
+
+static int hb_mc_trace_write(FILE *f, const void *data, size_t sz)
+{
+        if (sz != 0 && fwrite(data, sz, 1, f) != 1) {
+                bsg_pr_err("%s: failed to write trace: %m\n", __func__);
+                return HB_MC_FAIL;
+        }
+        return HB_MC_SUCCESS;
+}
+
+/* write the buffered records of a stream as one block, oldest first */
+static int hb_mc_trace_writer_write_block(hb_mc_trace_writer_t *w, const trace_stream_key &key,
+                                          trace_stream_t &stream)
+{
+        if (stream.count == 0)
+                return HB_MC_SUCCESS;
+
+        hb_mc_trace_index_entry_t entry;
+        entry.offset = static_cast<uint64_t>(ftello(w->f));
+        entry.block.x = std::get<0>(key);
+        entry.block.y = std::get<1>(key);
+        entry.block.kind = std::get<2>(key);
+        entry.block.nrecords = static_cast<uint32_t>(stream.count);
+
+        size_t cap = stream.buf.size();
+        size_t start = (stream.head + cap - stream.count) % cap;
+        size_t first = std::min(stream.count, cap - start);
+
+        int err = hb_mc_trace_write(w->f, &entry.block, sizeof(entry.block));
+        if (err == HB_MC_SUCCESS)
+                err = hb_mc_trace_write(w->f, &stream.buf[start], first * sizeof(hb_mc_trace_record_t));
+        if (err == HB_MC_SUCCESS)
+                err = hb_mc_trace_write(w->f, &stream.buf[0], (stream.count - first) * sizeof(hb_mc_trace_record_t));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        w->index.push_back(entry);
+        stream.head = 0;
+        stream.count = 0;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_trace_writer_open(const char *path, hb_mc_trace_mode_t mode, size_t records,
+                            hb_mc_trace_writer_t **writer)
+{
+        if (records == 0 || records > UINT32_MAX)
+                return HB_MC_INVALID;
+
+        FILE *f = fopen(path, "wb");
+        if (!f) {
+                bsg_pr_err("%s: failed to open '%s': %m\n", __func__, path);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_trace_header_t hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        strncpy(hdr.magic, HB_MC_TRACE_MAGIC, sizeof(hdr.magic));
+        hdr.version = HB_MC_TRACE_VERSION;
+        hdr.record_sz = sizeof(hb_mc_trace_record_t);
+        hdr.mode = mode;
+
+        int err = hb_mc_trace_write(f, &hdr, sizeof(hdr));
+        if (err != HB_MC_SUCCESS) {
+                fclose(f);
+                return err;
+        }
+
+        hb_mc_trace_writer_t *w = new hb_mc_trace_writer_t;
+        w->f = f;
+        w->mode = mode;
+        w->records = records;
+        w->seq = 0;
+        *writer = w;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_trace_writer_append(hb_mc_trace_writer_t *w, hb_mc_coordinate_t tile,
+                              hb_mc_trace_kind_t kind, uint64_t cycle, uint32_t data)
+{
+        trace_stream_key key(tile.x, tile.y, kind);
+        trace_stream_t &stream = w->streams[key];
+        if (stream.buf.empty()) {
+                stream.buf.resize(w->records);
+                stream.head = 0;
+                stream.count = 0;
+        }
+
+        hb_mc_trace_record_t &rec = stream.buf[stream.head];
+        rec.cycle = cycle;
+        rec.seq = w->seq++;
+        rec.data = data;
+
+        stream.head = (stream.head + 1) % stream.buf.size();
+        stream.count = std::min(stream.count + 1, stream.buf.size());
+
+        // a full ring overwrites its oldest record
+        if (w->mode == HB_MC_TRACE_MODE_STREAM && stream.count == stream.buf.size())
+                return hb_mc_trace_writer_write_block(w, key, stream);
+
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_trace_writer_close(hb_mc_trace_writer_t *w)
+{
+        int err = HB_MC_SUCCESS;
+
+        for (auto &it : w->streams) {
+                err = hb_mc_trace_writer_write_block(w, it.first, it.second);
+                if (err != HB_MC_SUCCESS)
+                        break;
+        }
+
+        if (err == HB_MC_SUCCESS) {
+                hb_mc_trace_footer_t footer;
+                memset(&footer, 0, sizeof(footer));
+                footer.index_offset = static_cast<uint64_t>(ftello(w->f));
+                footer.nblocks = w->index.size();
+                strncpy(footer.magic, HB_MC_TRACE_INDEX_MAGIC, sizeof(footer.magic));
+
+                err = hb_mc_trace_write(w->f, w->index.data(),
+                                        w->index.size() * sizeof(hb_mc_trace_index_entry_t));
+                if (err == HB_MC_SUCCESS)
+                        err = hb_mc_trace_write(w->f, &footer, sizeof(footer));
+        }
+
+        if (fclose(w->f) != 0 && err == HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to close trace: %m\n", __func__);
+                err = HB_MC_FAIL;
+        }
+
+        delete w;
+        return err;
+}
+
+/////////////
+// Reading //
+/////////////
+
+/* the blocks of one tile and kind, and the block being read */
+typedef struct trace_reader_stream {
+        hb_mc_trace_block_t block;                 //!< tile and kind
+        std::vector<hb_mc_trace_index_entry_t> blocks;
+        size_t next_block;
+        std::vector<hb_mc_trace_record_t> buf;
+        size_t pos;
+} trace_reader_stream_t;
+
+/* a stream's next record, ordered by arrival */
+typedef struct trace_reader_head {
+        uint64_t cycle;
+        uint32_t seq;
+        size_t stream;
+        bool operator<(const trace_reader_head &o) const {
+                // std::priority_queue pops the greatest element
+                if (cycle != o.cycle)
+                        return cycle > o.cycle;
+                return static_cast<int32_t>(seq - o.seq) > 0;
+        }
+} trace_reader_head_t;
+
+struct hb_mc_trace_reader {
+        FILE *f;
+        std::vector<trace_reader_stream_t> streams;
+        std::priority_queue<trace_reader_head_t> heads;
+};
+
+static int hb_mc_trace_read_at(FILE *f, uint64_t offset, void *data, size_t sz)
+{
+        if (fseeko(f, static_cast<off_t>(offset), SEEK_SET) != 0)
+                return HB_MC_FAIL;
+        if (sz != 0 && fread(data, sz, 1, f) != 1)
+                return HB_MC_FAIL;
+        return HB_MC_SUCCESS;
+}
+
+/* read the index, or find the blocks of a trace that was not closed */
+static int hb_mc_trace_reader_read_index(hb_mc_trace_reader_t *r,
+                                         std::vector<hb_mc_trace_index_entry_t> &index)
+{
+        hb_mc_trace_footer_t footer;
+        if (fseeko(r->f, 0, SEEK_END) != 0)
+                return HB_MC_FAIL;
+
+        uint64_t end = static_cast<uint64_t>(ftello(r->f));
+        if (end >= sizeof(hb_mc_trace_header_t) + sizeof(footer)
+            && hb_mc_trace_read_at(r->f, end - sizeof(footer), &footer, sizeof(footer)) == HB_MC_SUCCESS
+            && strncmp(footer.magic, HB_MC_TRACE_INDEX_MAGIC, sizeof(footer.magic)) == 0
+            && footer.index_offset + footer.nblocks * sizeof(hb_mc_trace_index_entry_t) + sizeof(footer) == end) {
+                index.resize(footer.nblocks);
+                return hb_mc_trace_read_at(r->f, footer.index_offset, index.data(),
+                                           index.size() * sizeof(hb_mc_trace_index_entry_t));
+        }
+
+        bsg_pr_warn("%s: trace has no index: scanning for blocks\n", __func__);
+
+        uint64_t offset = sizeof(hb_mc_trace_header_t);
+        hb_mc_trace_index_entry_t entry;
+        while (offset + sizeof(entry.block) <= end
+               && hb_mc_trace_read_at(r->f, offset, &entry.block, sizeof(entry.block)) == HB_MC_SUCCESS) {
+                uint64_t next = offset + sizeof(entry.block)
+                        + static_cast<uint64_t>(entry.block.nrecords) * sizeof(hb_mc_trace_record_t);
+                // drop a block that was cut short
+                if (next > end)
+                        break;
+
+                entry.offset = offset;
+                index.push_back(entry);
+                offset = next;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/* load a stream's next block, if it has one */
+static int hb_mc_trace_reader_load(hb_mc_trace_reader_t *r, size_t s)
+{
+        trace_reader_stream_t &stream = r->streams[s];
+        stream.buf.clear();
+        stream.pos = 0;
+
+        while (stream.buf.empty() && stream.next_block < stream.blocks.size()) {
+                const hb_mc_trace_index_entry_t &entry = stream.blocks[stream.next_block++];
+                stream.buf.resize(entry.block.nrecords);
+                int err = hb_mc_trace_read_at(r->f, entry.offset + sizeof(entry.block), stream.buf.data(),
+                                              stream.buf.size() * sizeof(hb_mc_trace_record_t));
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to read block at offset %" PRIu64 "\n",
+                                   __func__, entry.offset);
+                        return err;
+                }
+        }
+
+        if (!stream.buf.empty())
+                r->heads.push({stream.buf[0].cycle, stream.buf[0].seq, s});
+
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_trace_reader_open(const char *path, hb_mc_trace_reader_t **reader)
+{
+        FILE *f = fopen(path, "rb");
+        if (!f) {
+                bsg_pr_err("%s: failed to open '%s': %m\n", __func__, path);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_trace_header_t hdr;
+        if (fread(&hdr, sizeof(hdr), 1, f) != 1
+            || strncmp(hdr.magic, HB_MC_TRACE_MAGIC, sizeof(hdr.magic)) != 0
+            || hdr.version != HB_MC_TRACE_VERSION
+            || hdr.record_sz != sizeof(hb_mc_trace_record_t)) {
+                bsg_pr_err("%s: '%s' is not a version %d trace file\n",
+                           __func__, path, HB_MC_TRACE_VERSION);
+                fclose(f);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_trace_reader_t *r = new hb_mc_trace_reader_t;
+        r->f = f;
+
+        std::vector<hb_mc_trace_index_entry_t> index;
+        int err = hb_mc_trace_reader_read_index(r, index);
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_trace_reader_close(r);
+                return err;
+        }
+
+        // group blocks by tile and kind, keeping file order within each
+        std::map<trace_stream_key, size_t> ids;
+        for (const hb_mc_trace_index_entry_t &entry : index) {
+                trace_stream_key key(entry.block.x, entry.block.y, entry.block.kind);
+                auto it = ids.find(key);
+                if (it == ids.end()) {
+                        it = ids.emplace(key, r->streams.size()).first;
+                        r->streams.push_back({entry.block, {}, 0, {}, 0});
+                }
+                r->streams[it->second].blocks.push_back(entry);
+        }
+
+        for (size_t s = 0; s < r->streams.size(); s++) {
+                err = hb_mc_trace_reader_load(r, s);
+                if (err != HB_MC_SUCCESS) {
+                        hb_mc_trace_reader_close(r);
+                        return err;
+                }
+        }
+
+        *reader = r;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_trace_reader_next(hb_mc_trace_reader_t *r, hb_mc_trace_event_t *event)
+{
+        if (r->heads.empty())
+                return HB_MC_NOTFOUND;
+
+        size_t s = r->heads.top().stream;
+        r->heads.pop();
+
+        trace_reader_stream_t &stream = r->streams[s];
+        const hb_mc_trace_record_t &rec = stream.buf[stream.pos++];
+        event->tile = hb_mc_coordinate(stream.block.x, stream.block.y);
+        event->kind = static_cast<hb_mc_trace_kind_t>(stream.block.kind);
+        event->cycle = rec.cycle;
+        event->data = rec.data;
+
+        if (stream.pos < stream.buf.size()) {
+                const hb_mc_trace_record_t &next = stream.buf[stream.pos];
+                r->heads.push({next.cycle, next.seq, s});
+                return HB_MC_SUCCESS;
+        }
+
+        return hb_mc_trace_reader_load(r, s);
+}
+
+void hb_mc_trace_reader_close(hb_mc_trace_reader_t *r)
+{
+        fclose(r->f);
+        delete r;
+}
+
+int hb_mc_trace_to_text(const char *path, FILE *out)
+{
+        hb_mc_trace_reader_t *r;
+        int err = hb_mc_trace_reader_open(path, &r);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_trace_event_t ev;
+        while ((err = hb_mc_trace_reader_next(r, &ev)) == HB_MC_SUCCESS) {
+                fprintf(out, "hbmc_%s_trace x=%d y=%d data=%x\n",
+                        hb_mc_trace_kind_name(ev.kind), (int)ev.tile.x, (int)ev.tile.y, (int)ev.data);
+        }
+
+        hb_mc_trace_reader_close(r);
+        return err == HB_MC_NOTFOUND ? HB_MC_SUCCESS : err;
+}
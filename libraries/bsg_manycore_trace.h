@@ -0,0 +1,202 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BSG_MANYCORE_TRACE_H
+#define BSG_MANYCORE_TRACE_H
+
+#include <bsg_manycore_features.h>
+#include <bsg_manycore_coordinate.h>
+#include <bsg_manycore_errno.h>
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+/*
+ * Binary trace files
+ *
+ * A trace file is a header, followed by blocks of records, followed by
+ * an index of the blocks and a footer. Each block holds records from
+ * one tile and trace kind, in the order they arrived. If a trace was not
+ * closed and has no index, readers find the blocks by scanning the file.
+ * All fields are in host byte order.
+ */
+
+/* If set, tile traces are written in binary to the file named by this variable */
+#define HB_MC_TRACE_FILE_ENV "BSG_MANYCORE_TRACE_FILE"
+
+/* If set, only the last this many records of each tile are kept */
+#define HB_MC_TRACE_RING_ENV "BSG_MANYCORE_TRACE_RING"
+
+/* The number of records buffered for each tile before they are written */
+#define HB_MC_TRACE_RECORDS_PER_BLOCK 4096
+
+#define HB_MC_TRACE_MAGIC        "HBMCTRC"
+#define HB_MC_TRACE_INDEX_MAGIC  "HBMCIDX"
+#define HB_MC_TRACE_VERSION      1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        typedef enum __hb_mc_trace_kind {
+                HB_MC_TRACE_KIND_BRANCH = 0, //!< branch trace packets (EPA 0xEEE4)
+                HB_MC_TRACE_KIND_MAX,
+        } hb_mc_trace_kind_t;
+
+        typedef enum __hb_mc_trace_mode {
+                HB_MC_TRACE_MODE_STREAM = 0, //!< keep every record
+                HB_MC_TRACE_MODE_RING   = 1, //!< keep the last records of each tile
+        } hb_mc_trace_mode_t;
+
+        typedef struct hb_mc_trace_header {
+                char     magic[8];   //!< HB_MC_TRACE_MAGIC
+                uint32_t version;    //!< HB_MC_TRACE_VERSION
+                uint32_t record_sz;  //!< sizeof(hb_mc_trace_record_t)
+                uint32_t mode;       //!< hb_mc_trace_mode_t
+                uint32_t reserved;
+        } hb_mc_trace_header_t;
+
+        typedef struct hb_mc_trace_block {
+                uint32_t x;          //!< x coordinate of the tile
+                uint32_t y;          //!< y coordinate of the tile
+                uint32_t kind;       //!< hb_mc_trace_kind_t
+                uint32_t nrecords;   //!< the number of records that follow
+        } hb_mc_trace_block_t;
+
+        typedef struct hb_mc_trace_record {
+                uint64_t cycle;      //!< the host cycle at which the packet arrived
+                uint32_t seq;        //!< arrival order across all tiles
+                uint32_t data;       //!< the packet data
+        } hb_mc_trace_record_t;
+
+        typedef struct hb_mc_trace_index_entry {
+                uint64_t offset;     //!< file offset of a block header
+                hb_mc_trace_block_t block;
+        } hb_mc_trace_index_entry_t;
+
+        typedef struct hb_mc_trace_footer {
+                uint64_t index_offset; //!< file offset of the first index entry
+                uint64_t nblocks;      //!< the number of index entries
+                char     magic[8];     //!< HB_MC_TRACE_INDEX_MAGIC
+        } hb_mc_trace_footer_t;
+
+        /* One record, as returned by a reader */
+        typedef struct hb_mc_trace_event {
+                hb_mc_coordinate_t tile;
+                hb_mc_trace_kind_t kind;
+                uint64_t cycle;
+                uint32_t data;
+        } hb_mc_trace_event_t;
+
+        typedef struct hb_mc_trace_writer hb_mc_trace_writer_t;
+        typedef struct hb_mc_trace_reader hb_mc_trace_reader_t;
+
+        /**
+         * Get the name of a trace kind, as used in text traces.
+         * @param[in] kind  A trace kind.
+         * @return The name of #kind.
+         */
+        const char *hb_mc_trace_kind_name(hb_mc_trace_kind_t kind);
+
+        /**
+         * Create a binary trace file.
+         * @param[in]  path      The file to create.
+         * @param[in]  mode      Whether to keep every record, or the last #records of each tile.
+         * @param[in]  records   The number of records to buffer for each tile.
+         * @param[out] writer    A trace writer.
+         * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_writer_open(const char *path, hb_mc_trace_mode_t mode, size_t records,
+                                    hb_mc_trace_writer_t **writer);
+
+        /**
+         * Add a record to a tile's buffer. Full buffers are written as one block.
+         * @param[in]  writer    A trace writer.
+         * @param[in]  tile      The tile that sent the trace packet.
+         * @param[in]  kind      The kind of trace packet.
+         * @param[in]  cycle     The cycle at which the packet arrived.
+         * @param[in]  data      The packet data.
+         * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_writer_append(hb_mc_trace_writer_t *writer, hb_mc_coordinate_t tile,
+                                      hb_mc_trace_kind_t kind, uint64_t cycle, uint32_t data);
+
+        /**
+         * Write all buffered records and the index, and close a trace file.
+         * @param[in]  writer    A trace writer. It is freed, even if an error is returned.
+         * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_writer_close(hb_mc_trace_writer_t *writer);
+
+        /**
+         * Open a binary trace file for reading.
+         * @param[in]  path      A trace file.
+         * @param[out] reader    A trace reader.
+         * @return HB_MC_SUCCESS if successful. HB_MC_INVALID if #path is not a trace file.
+         * Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_reader_open(const char *path, hb_mc_trace_reader_t **reader);
+
+        /**
+         * Read the next record of a trace, in the order records arrived across all tiles.
+         * @param[in]  reader    A trace reader.
+         * @param[out] event     The next record.
+         * @return HB_MC_SUCCESS if successful. HB_MC_NOTFOUND at the end of the trace.
+         * Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_reader_next(hb_mc_trace_reader_t *reader, hb_mc_trace_event_t *event);
+
+        /**
+         * Close a trace reader.
+         * @param[in]  reader    A trace reader.
+         */
+        void hb_mc_trace_reader_close(hb_mc_trace_reader_t *reader);
+
+        /**
+         * Convert a binary trace file to the text format printed by the trace responder.
+         * @param[in]  path      A trace file.
+         * @param[in]  out       A stream to write text to.
+         * @return HB_MC_SUCCESS if successful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_trace_to_text(const char *path, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,7 +28,11 @@
 #include <bsg_manycore_responder.h>
 #include <bsg_manycore_request_packet_id.h>
 #include <bsg_manycore_printing.h>
+#include <bsg_manycore_trace.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <mutex>
 
 enum hb_mc_trace_epa_indx {
         BRANCH_TRACE_EPA_INDX, 
@@ -39,6 +43,7 @@ enum hb_mc_trace_epa_indx {
 typedef struct {
         FILE* f;
         const char* type;
+        hb_mc_trace_kind_t kind;
 } trace_config_t;
 
 static hb_mc_request_packet_id_t ids [] = {
@@ -47,15 +52,61 @@ static hb_mc_request_packet_id_t ids [] = {
 };
 
 static trace_config_t trace_config [] = {
-        {.f = stderr, .type = "branch"},
+        {.f = stderr, .type = "branch", .kind = HB_MC_TRACE_KIND_BRANCH},
 };
 
+// When BSG_MANYCORE_TRACE_FILE is set, trace packets are appended to a
+// binary trace instead of being printed to stderr.
+static std::mutex writers_lock;
+static std::map<const hb_mc_manycore_t *, hb_mc_trace_writer_t *> writers;
+
+static int writer_open(hb_mc_manycore_t *mc)
+{
+        const char *path = getenv(HB_MC_TRACE_FILE_ENV);
+        if (path == nullptr || *path == '\0')
+                return HB_MC_SUCCESS;
+
+        hb_mc_trace_mode_t mode = HB_MC_TRACE_MODE_STREAM;
+        size_t records = HB_MC_TRACE_RECORDS_PER_BLOCK;
+        const char *ring = getenv(HB_MC_TRACE_RING_ENV);
+        if (ring != nullptr && *ring != '\0') {
+                mode = HB_MC_TRACE_MODE_RING;
+                records = strtoul(ring, nullptr, 0);
+        }
+
+        hb_mc_trace_writer_t *w;
+        int err = hb_mc_trace_writer_open(path, mode, records, &w);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to open trace '%s': %s\n",
+                           __func__, path, hb_mc_strerror(err));
+                return err;
+        }
+
+        std::lock_guard<std::mutex> guard(writers_lock);
+        writers[mc] = w;
+        return HB_MC_SUCCESS;
+}
+
+static int writer_close(hb_mc_manycore_t *mc)
+{
+        hb_mc_trace_writer_t *w;
+        {
+                std::lock_guard<std::mutex> guard(writers_lock);
+                auto it = writers.find(mc);
+                if (it == writers.end())
+                        return HB_MC_SUCCESS;
+                w = it->second;
+                writers.erase(it);
+        }
+        return hb_mc_trace_writer_close(w);
+}
+
 static int init(hb_mc_responder_t *responder,
                 hb_mc_manycore_t *mc)
 {
         bsg_pr_dbg("hello from %s\n", __FILE__);
         responder->responder_data = trace_config;
-        return 0;
+        return writer_open(mc);
 }
 
 static int quit(hb_mc_responder_t *responder,
@@ -63,7 +114,7 @@ static int quit(hb_mc_responder_t *responder,
 {
         bsg_pr_dbg("goodbye from %s\n", __FILE__);
         responder->responder_data = nullptr;
-        return 0;
+        return writer_close(mc);
 }
 
 static int respond(hb_mc_responder_t *responder,
@@ -77,6 +128,18 @@ static int respond(hb_mc_responder_t *responder,
         for(int i=0; i<HB_MC_NUM_TRACE_EPAS; i++) {
                 if(hb_mc_request_packet_is_match(rqst, &responder->ids[i])) {
                         trace_config_t config = ((trace_config_t*) responder->responder_data)[i];
+
+                        std::lock_guard<std::mutex> guard(writers_lock);
+                        auto it = writers.find(mc);
+                        if (it != writers.end()) {
+                                uint64_t cycle = 0;
+                                int err = hb_mc_manycore_get_cycle(mc, &cycle);
+                                if (err != HB_MC_SUCCESS && err != HB_MC_NOIMPL)
+                                        return err;
+                                return hb_mc_trace_writer_append(it->second, hb_mc_coordinate(src_x, src_y),
+                                                                 config.kind, cycle, data);
+                        }
+
                         fprintf(config.f, 
                                 "hbmc_%s_trace x=%d y=%d data=%x\n", 
                                 config.type, src_x, src_y, (int)data);
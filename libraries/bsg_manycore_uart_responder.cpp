@@ -68,13 +68,15 @@ static int respond(hb_mc_responder_t *responder,
                    hb_mc_manycore_t *mc,
                    const hb_mc_request_packet_t *rqst)
 {
-        auto data = hb_mc_request_packet_get_data(rqst);
+        char c = (char)hb_mc_request_packet_get_data(rqst);
+        hb_mc_coordinate_t src = hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                                  hb_mc_request_packet_get_y_src(rqst));
 
         for(int i=STDOUT_EPA_INDX; i<HB_MC_NUM_UART_EPAS; i++) {
                 if(hb_mc_request_packet_is_match(rqst, &responder->ids[i])) {
                         FILE *f = ((FILE**)responder->responder_data)[i];
-                        fputc((int)data, f);
-                        break;
+                        // buffered per tile and written a line at a time
+                        return hb_mc_responder_console_write(mc, f, src, &c, 1);
                 }
         }
         return 0;
@@ -49,6 +49,35 @@ int hb_mc_dma_write(hb_mc_manycore_t *mc,
                     const hb_mc_npa_t *npa,
                     const void *data, size_t sz);
 
+/**
+ * Write a list of host buffers out to manycore DRAM via C++ backdoor
+ * Ranges that overlap are written in order.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n buffers to be written out to manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_write_ranges(hb_mc_manycore_t *mc,
+                           const hb_mc_npa_t *npas,
+                           const void * const *data,
+                           const size_t *szs, size_t n);
+
+/**
+ * Read a list of ranges of manycore DRAM via C++ backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n host buffers to be read into from manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_read_ranges(hb_mc_manycore_t *mc,
+                          const hb_mc_npa_t *npas,
+                          void * const *data,
+                          const size_t *szs, size_t n);
+
 int hb_mc_dma_init(hb_mc_manycore_t *mc);
 
 #endif
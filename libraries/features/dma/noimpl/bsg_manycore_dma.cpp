@@ -59,6 +59,60 @@ int __attribute__((weak)) hb_mc_dma_read(hb_mc_manycore_t *mc,
         return HB_MC_NOIMPL;
 }
 
+/**
+ * Write a list of host buffers out to manycore DRAM via DMA, one range at a time
+ *
+ * NOTE: This method is declared with __attribute__((weak)) so that a
+ * platform that defines hb_mc_dma_write() gets ranges for free.
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n buffers to be written out to manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int __attribute__((weak)) hb_mc_dma_write_ranges(hb_mc_manycore_t *mc,
+                                                 const hb_mc_npa_t *npas,
+                                                 const void * const *data,
+                                                 const size_t *szs, size_t n)
+{
+        for (size_t r = 0; r < n; r++) {
+                int err = hb_mc_dma_write(mc, &npas[r], data[r], szs[r]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read a list of ranges of manycore DRAM via DMA, one range at a time
+ *
+ * NOTE: This method is declared with __attribute__((weak)) so that a
+ * platform that defines hb_mc_dma_read() gets ranges for free.
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n host buffers to be read into from manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int __attribute__((weak)) hb_mc_dma_read_ranges(hb_mc_manycore_t *mc,
+                                                const hb_mc_npa_t *npas,
+                                                void * const *data,
+                                                const size_t *szs, size_t n)
+{
+        for (size_t r = 0; r < n; r++) {
+                int err = hb_mc_dma_read(mc, &npas[r], data[r], szs[r]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 __attribute__((weak))
 int hb_mc_dma_init(hb_mc_manycore_t *mc)
 {
@@ -4,6 +4,9 @@
 #include <bsg_manycore_printing.h>
 #include <bsg_manycore_config_pod.h>
 #include <bsg_manycore_chip_id.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
 
 /* these are convenience macros that are only good for one line prints */
 #define dma_pr_dbg(mc, fmt, ...)                   \
@@ -234,15 +237,16 @@ int hb_mc_dma_init(hb_mc_manycore_t *mc)
 }
 
 /**
- * Given an NPA that maps to DRAM, return a buffer that holds the data for that address.
- * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
- * @param[in]  sz     The number of bytes to write to manycore hardware - used for sanity check
- * @param[out] buffer The valid buffer
+ * Given an NPA that maps to DRAM, return the memory and the channel address that hold it.
+ * @param[in]  mc        A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa       A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[out] id        The memory channel
+ * @param[out] memory    The memory of channel #id
+ * @param[out] cache_addr The address in the channel, before the physical address mapping
  * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
  */
-static int hb_mc_dma_npa_to_buffer(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, size_t sz,
-                                        unsigned char **buffer)
+static int hb_mc_dma_npa_to_channel(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                    parameter_t *id, Memory **memory, address_t *cache_addr)
 {
         /*
           Our system supports having multiple caches per memory channel.
@@ -269,29 +273,50 @@ static int hb_mc_dma_npa_to_buffer(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
           Figure out which memory channel and bank this NPA maps to.
         */
         hb_mc_idx_t cache_id = hb_mc_config_dram_id(cfg, hb_mc_npa_get_xy(npa)); // which cache
-        parameter_t id = cache_id_to_memory_id[cache_id];
+        *id = cache_id_to_memory_id[cache_id];
         parameter_t bank = cache_id_to_bank_id[cache_id]; // which bank within channel
 
         /*
           Use the backdoor to our non-synthesizable memory.
         */
-        Memory *memory = bsg_mem_dma_get_memory(id);
-        parameter_t bank_size = memory->size()/caches_per_channel;
-
-        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        *memory = bsg_mem_dma_get_memory(*id);
         char npa_str[256];
 
-        if (memory == nullptr) {
+        if (*memory == nullptr) {
                 dma_pr_err(mc, " %s: Could not get the memory for endpoint at %s\n",
                                 __func__, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
 
                 return HB_MC_FAIL;
         }
 
+        parameter_t bank_size = (*memory)->size()/caches_per_channel;
+
         // this is the address that comes out of cache_to_test_dram_tx
-        address_t cache_addr = bank*bank_size + epa;
-        address_t addr = hb_mc_memsys_map_to_physical_channel_address(&cfg->memsys, cache_addr);
+        *cache_addr = bank*bank_size + hb_mc_npa_get_epa(npa);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Given an NPA that maps to DRAM, return a buffer that holds the data for that address.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  sz     The number of bytes to write to manycore hardware - used for sanity check
+ * @param[out] buffer The valid buffer
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+static int hb_mc_dma_npa_to_buffer(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, size_t sz,
+                                        unsigned char **buffer)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        parameter_t id;
+        Memory *memory;
+        address_t cache_addr;
+        int err = hb_mc_dma_npa_to_channel(mc, npa, &id, &memory, &cache_addr);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
+        address_t addr = hb_mc_memsys_map_to_physical_channel_address(&cfg->memsys, cache_addr);
+        char npa_str[256];
 
         dma_pr_dbg(mc, "%s: Mapped %s to Channel %2lu, Address 0x%08lx\n",
                         __func__, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)), id, addr);
@@ -305,6 +330,105 @@ static int hb_mc_dma_npa_to_buffer(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
         return HB_MC_SUCCESS;
 }
 
+/* A piece of a DMA batch that is contiguous in both a memory channel and the host */
+typedef struct hb_mc_dma_extent {
+        parameter_t id;       //!< the memory channel
+        Memory *memory;       //!< the memory of channel #id
+        address_t addr;       //!< the physical address in #memory
+        unsigned char *host;  //!< the host buffer
+        size_t sz;            //!< the size in bytes
+        size_t order;         //!< the position of this extent in the batch
+} hb_mc_dma_extent_t;
+
+/**
+ * Plan a batch of DMA ranges as a list of extents sorted by physical
+ * address, with adjacent extents merged into one copy.
+ * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas    An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data    An array of #n host buffers
+ * @param[in]  szs     An array of #n sizes in bytes
+ * @param[in]  n       The number of ranges
+ * @param[in]  ordered If true, overlapping extents must be copied in batch order
+ * @param[out] plan    The extents to copy
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+template <typename Ptr>
+static int hb_mc_dma_plan(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas, Ptr const *data,
+                          const size_t *szs, size_t n, bool ordered,
+                          std::vector<hb_mc_dma_extent_t> &plan)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        size_t bsize = hb_mc_config_get_vcache_block_size(cfg);
+        std::vector<hb_mc_dma_extent_t> extents;
+
+        for (size_t r = 0; r < n; r++) {
+                hb_mc_dma_extent_t ext;
+                address_t cache_addr;
+                int err = hb_mc_dma_npa_to_channel(mc, &npas[r], &ext.id, &ext.memory, &cache_addr);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                ext.host = (unsigned char *)data[r];
+                size_t rem = szs[r];
+
+                // the physical address map only keeps a cache block
+                // contiguous, so map each block on its own
+                while (rem > 0) {
+                        ext.sz = std::min(rem, bsize - cache_addr % bsize);
+                        ext.addr = hb_mc_memsys_map_to_physical_channel_address(&cfg->memsys, cache_addr);
+                        ext.order = extents.size();
+
+                        /*
+                          Don't overflow memory if you can help it.
+                        */
+                        assert(ext.addr + ext.sz <= ext.memory->size());
+                        extents.push_back(ext);
+
+                        cache_addr += ext.sz;
+                        ext.host += ext.sz;
+                        rem -= ext.sz;
+                }
+        }
+
+        std::sort(extents.begin(), extents.end(),
+                  [](const hb_mc_dma_extent_t &a, const hb_mc_dma_extent_t &b) {
+                          return std::tie(a.id, a.addr, a.order) < std::tie(b.id, b.addr, b.order);
+                  });
+
+        // overlapping writes must land in batch order, so don't reorder them
+        if (ordered) {
+                for (size_t i = 1; i < extents.size(); i++) {
+                        const hb_mc_dma_extent_t &prev = extents[i-1];
+                        if (prev.id == extents[i].id && prev.addr + prev.sz > extents[i].addr) {
+                                std::sort(extents.begin(), extents.end(),
+                                          [](const hb_mc_dma_extent_t &a, const hb_mc_dma_extent_t &b) {
+                                                  return a.order < b.order;
+                                          });
+                                break;
+                        }
+                }
+        }
+
+        plan.clear();
+        for (const hb_mc_dma_extent_t &ext : extents) {
+                if (!plan.empty()) {
+                        hb_mc_dma_extent_t &last = plan.back();
+                        if (last.id == ext.id
+                            && last.addr + last.sz == ext.addr
+                            && last.host + last.sz == ext.host) {
+                                last.sz += ext.sz;
+                                continue;
+                        }
+                }
+                plan.push_back(ext);
+        }
+
+        dma_pr_dbg(mc, "%s: %zu ranges planned as %zu copies\n",
+                   __func__, n, plan.size());
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Write memory out to manycore DRAM via C++ backdoor
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -360,3 +484,55 @@ int hb_mc_dma_read(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Write a list of host buffers out to manycore DRAM via C++ backdoor
+ * The ranges are sorted by physical address, and adjacent ranges are copied together.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n buffers to be written out to manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_write_ranges(hb_mc_manycore_t *mc,
+                           const hb_mc_npa_t *npas,
+                           const void * const *data,
+                           const size_t *szs, size_t n)
+{
+        std::vector<hb_mc_dma_extent_t> plan;
+        int err = hb_mc_dma_plan(mc, npas, data, szs, n, true, plan);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (const hb_mc_dma_extent_t &ext : plan)
+                memcpy(ext.memory->get_ptr(ext.addr), ext.host, ext.sz);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read a list of ranges of manycore DRAM via C++ backdoor
+ * The ranges are sorted by physical address, and adjacent ranges are copied together.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n host buffers to be read into from manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_read_ranges(hb_mc_manycore_t *mc,
+                          const hb_mc_npa_t *npas,
+                          void * const *data,
+                          const size_t *szs, size_t n)
+{
+        std::vector<hb_mc_dma_extent_t> plan;
+        int err = hb_mc_dma_plan(mc, npas, data, szs, n, false, plan);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (const hb_mc_dma_extent_t &ext : plan)
+                memcpy(ext.host, ext.memory->get_ptr(ext.addr), ext.sz);
+
+        return HB_MC_SUCCESS;
+}
+
@@ -51,6 +51,20 @@ int hb_mc_profiler_get_icount(hb_mc_profiler_t p, bsg_instr_type_e itype, int *c
         return HB_MC_NOIMPL;
 }
 
+/**
+ * Get the counters of every tile with a profiler, in one sweep
+ * @param[in]  p        A hb_mc_profiler_t instance initialized with hb_mc_profiler_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with a profiler
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_profiler_get_counters(hb_mc_profiler_t p, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        return HB_MC_NOIMPL;
+}
+
 /**
  * Enable trace file generation
  * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
@@ -30,12 +30,21 @@
 #include <bsg_manycore_printing.h>
 #include <bsg_manycore_coordinate.h>
 #include <bsg_manycore_config.h>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <vector>
 using namespace bsg_nonsynth_dpi;
 using namespace std;
 
+// The profilers of every tile, and the counters they reported at the
+// last call to hb_mc_profiler_get_counters() with delta set.
+typedef struct profilers {
+        vector<dpi_vanilla_core_profiler *> profs;
+        vector<hb_mc_coordinate_t> tiles;
+        vector<uint32_t> baseline; // HB_MC_INSTR_TYPE_MAX counters for each tile
+} profilers_t;
+
 /**
  * Initialize an hb_mc_profiler_t instance
  * @param[in] p    A pointer to the hb_mc_profiler_t instance to initialize
@@ -77,7 +86,7 @@ int hb_mc_profiler_init(hb_mc_profiler_t *p, hb_mc_idx_t x, hb_mc_idx_t y, strin
 
         // We construct a dpi_vanilla_core_profiler instance for each
         // profiler in the HDL, and track it using a vector.
-        vector<dpi_vanilla_core_profiler* > *profilers = new vector<dpi_vanilla_core_profiler* >();
+        profilers_t *profilers = new profilers_t;
         
         // Construct the objects, and strings.
         for(int iy = HB_MC_CONFIG_VCORE_BASE_Y-1; iy <= y; ++iy){
@@ -87,12 +96,17 @@ int hb_mc_profiler_init(hb_mc_profiler_t *p, hb_mc_idx_t x, hb_mc_idx_t y, strin
                         // If the scope does not exist, then there is
                         // not a profiler module bound to a tile at
                         // that location. Do not instantiate an object
-                        if(svGetScopeFromName(stream.str().c_str()))
-                                profilers->push_back(new dpi_vanilla_core_profiler(stream.str()));
+                        if(svGetScopeFromName(stream.str().c_str())){
+                                profilers->profs.push_back(new dpi_vanilla_core_profiler(stream.str()));
+                                profilers->tiles.push_back(hb_mc_coordinate(ix, iy));
+                        }
                 }
         }
-        
-        // Save the 2D vector
+
+        // Counters are zero at reset
+        profilers->baseline.resize(profilers->profs.size() * HB_MC_INSTR_TYPE_MAX, 0);
+
+        // Save the profilers
         *p = reinterpret_cast<hb_mc_profiler_t>(profilers);
         return HB_MC_SUCCESS;
 }
@@ -102,15 +116,14 @@ int hb_mc_profiler_init(hb_mc_profiler_t *p, hb_mc_idx_t x, hb_mc_idx_t y, strin
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_profiler_cleanup(hb_mc_profiler_t *p){
-        vector<dpi_vanilla_core_profiler *> *profilers =
-                reinterpret_cast<vector<dpi_vanilla_core_profiler *> *>(*p);
+        profilers_t *profilers = reinterpret_cast<profilers_t *>(*p);
         dpi_vanilla_core_profiler * prof;
         // From last to first (reverse order) remove elements from the
         // vectors, and delete the associated bojects.
-        while (!profilers->empty()){
-                prof = profilers->back();
+        while (!profilers->profs.empty()){
+                prof = profilers->profs.back();
                 delete prof;
-                profilers->pop_back();
+                profilers->profs.pop_back();
         }
 
         delete profilers;
@@ -128,10 +141,9 @@ int hb_mc_profiler_cleanup(hb_mc_profiler_t *p){
 int hb_mc_profiler_get_icount(hb_mc_profiler_t p, bsg_instr_type_e itype, int *count){
         int err;
         int sum = 0, cur;
-        vector<dpi_vanilla_core_profiler *> *profilers =
-                reinterpret_cast<vector<dpi_vanilla_core_profiler *> *>(p);
+        profilers_t *profilers = reinterpret_cast<profilers_t *>(p);
 
-        for (auto it = profilers->begin() ; it != profilers->end(); ++it){
+        for (auto it = profilers->profs.begin() ; it != profilers->profs.end(); ++it){
                 err = (*it)->get_instr_count(itype, &cur);
                 sum += cur;
                 if(err != BSG_NONSYNTH_DPI_SUCCESS){
@@ -145,3 +157,52 @@ int hb_mc_profiler_get_icount(hb_mc_profiler_t p, bsg_instr_type_e itype, int *c
         return HB_MC_SUCCESS;
 }
 
+
+/**
+ * Get the counters of every tile with a profiler, in one sweep
+ * @param[in]  p        A hb_mc_profiler_t instance initialized with hb_mc_profiler_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with a profiler
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set,
+ *                      and make these counters the baseline for the next call.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ *
+ * NOTE: Profilers are read through DPI, which must be called from the
+ * simulation thread, so tiles are read one after another. Reading
+ * every counter of a tile at once saves a sweep for each counter.
+ */
+int hb_mc_profiler_get_counters(hb_mc_profiler_t p, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        profilers_t *profilers = reinterpret_cast<profilers_t *>(p);
+        size_t nprofs = profilers->profs.size();
+        int err, cur;
+
+        *ntiles = nprofs;
+
+        // with delta set, every tile is read so the baseline stays consistent
+        size_t nread = delta ? nprofs : min(n, nprofs);
+
+        for (size_t t = 0; t < nread; ++t){
+                for (int itype = 0; itype < HB_MC_INSTR_TYPE_MAX; ++itype){
+                        err = profilers->profs[t]->get_instr_count(static_cast<bsg_instr_type_e>(itype), &cur);
+                        if(err != BSG_NONSYNTH_DPI_SUCCESS){
+                                if(err == BSG_NONSYNTH_DPI_NOT_WINDOW)
+                                        bsg_pr_err("%s: Called while not in valid clock window. (is reset still high?)\n", __func__);
+                                return HB_MC_FAIL;
+                        }
+
+                        // counters are 32 bits and wrap
+                        uint32_t &base = profilers->baseline[t * HB_MC_INSTR_TYPE_MAX + itype];
+                        uint32_t val = static_cast<uint32_t>(cur);
+                        if (t < n){
+                                counters[t].tile = profilers->tiles[t];
+                                counters[t].icount[itype] = delta ? static_cast<uint32_t>(val - base) : val;
+                        }
+                        if (delta)
+                                base = val;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
@@ -41,12 +41,15 @@ LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_eva.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_loader.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_memory_manager.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.cpp
+LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_pc_histogram.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_print_int_responder.cpp
+LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_print_stat_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_printing.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_request_packet_id.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_tile.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_uart_responder.cpp
+LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_trace.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_trace_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_vcache.cpp
 
@@ -59,10 +62,13 @@ LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_eva.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_loader.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_memory_manager.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.h
+LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_pc_histogram.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_printing.h
+LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_print_stat.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_request_packet_id.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_responder.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_tile.h
+LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_trace.h
 
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_vcache.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_errno.h
@@ -85,7 +91,10 @@ LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_loader.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_packet_id.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_eva.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.o
+LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_pc_histogram.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_print_int_responder.o
+LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_print_stat_responder.o
+LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_trace.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_memsys.o
 
 # Object in the pod replication extension for CUDA
@@ -110,6 +119,9 @@ $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so.1.0: INCLUDES :=
 
 include $(BSG_PLATFORM_PATH)/library.mk
 
+# CUDA-lite runs one host thread per pod (see hb_mc_device_podv_kernels_execute_parallel)
+$(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so.1.0: LDFLAGS += -lpthread
+
 $(LIB_OBJECTS) $(LIB_OBJECTS_CUDA_POD_REPL) $(LIB_OBJECTS_REGRESSION): INCLUDES := -I$(LIBRARIES_PATH)
 $(LIB_OBJECTS) $(LIB_OBJECTS_CUDA_POD_REPL) $(LIB_OBJECTS_REGRESSION): INCLUDES += -I$(LIBRARIES_PATH)/xcl
 $(LIB_OBJECTS) $(LIB_OBJECTS_CUDA_POD_REPL) $(LIB_OBJECTS_REGRESSION): INCLUDES += -I$(LIBRARIES_PATH)/features/dma
@@ -0,0 +1,187 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file implements the DMA feature for the functional model
+// platform. DMA accesses go directly to the model's DRAM storage.
+
+#include <bsg_manycore_dma.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_printing.h>
+
+#include <bsg_manycore_model.hpp>
+
+/* these are convenience macros that are only good for one line prints */
+#define dma_pr_dbg(mc, fmt, ...)                   \
+        bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define dma_pr_err(mc, fmt, ...)                   \
+        bsg_pr_err("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define dma_pr_warn(mc, fmt, ...)                          \
+        bsg_pr_warn("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define dma_pr_info(mc, fmt, ...)                          \
+        bsg_pr_info("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+/**
+ * Check that a DMA targets a DRAM bank and stays within it
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  sz     The number of bytes to transfer
+ * @return HB_MC_INVALID if the DMA is not valid. HB_MC_SUCCESS otherwise.
+ */
+static int hb_mc_dma_check_npa(hb_mc_manycore_t *mc,
+                               const hb_mc_npa_t *npa,
+                               size_t sz)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        char npa_str[256];
+
+        if (!hb_mc_config_is_dram(cfg, hb_mc_npa_get_xy(npa))) {
+                dma_pr_err(mc, "%s: %s is not a DRAM address\n",
+                           __func__, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+                return HB_MC_INVALID;
+        }
+
+        if (hb_mc_npa_get_epa(npa) + sz > hb_mc_config_get_dram_bank_size(cfg)) {
+                dma_pr_err(mc, "%s: %zu bytes at %s exceed the DRAM bank\n",
+                           __func__, sz, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+                return HB_MC_INVALID;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write memory out to manycore DRAM via the model backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  data   A buffer to be written out manycore hardware
+ * @param[in]  sz     The number of bytes to write to manycore hardware
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_write(hb_mc_manycore_t *mc,
+                    const hb_mc_npa_t *npa,
+                    const void *data, size_t sz)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err = hb_mc_dma_check_npa(mc, npa, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+#ifdef DEBUG
+        char npa_str[256];
+#endif
+        dma_pr_dbg(mc, "%s: Writing %3zu bytes to %s\n",
+                        __func__, sz, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+
+        return platform->model->write(npa, data, sz);
+}
+
+/**
+ * Read memory from manycore DRAM via the model backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  data   A host buffer to be read into from manycore hardware
+ * @param[in]  sz     The number of bytes to read from manycore hardware
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_read(hb_mc_manycore_t *mc,
+                   const hb_mc_npa_t *npa,
+                   void *data, size_t sz)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err = hb_mc_dma_check_npa(mc, npa, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+#ifdef DEBUG
+        char npa_str[256];
+#endif
+        dma_pr_dbg(mc, "%s: Reading %3zu bytes from %s\n",
+                        __func__, sz, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+
+        return platform->model->read(npa, data, sz);
+}
+
+/**
+ * Write a list of host buffers out to manycore DRAM via the model backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n buffers to be written out to manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_write_ranges(hb_mc_manycore_t *mc,
+                           const hb_mc_npa_t *npas,
+                           const void * const *data,
+                           const size_t *szs, size_t n)
+{
+        for (size_t r = 0; r < n; r++) {
+                int err = hb_mc_dma_write(mc, &npas[r], data[r], szs[r]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read a list of ranges of manycore DRAM via the model backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of #n NPAs - must be L2 cache coordinates
+ * @param[in]  data   An array of #n host buffers to be read into from manycore hardware
+ * @param[in]  szs    An array of #n sizes in bytes
+ * @param[in]  n      The number of ranges
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_read_ranges(hb_mc_manycore_t *mc,
+                          const hb_mc_npa_t *npas,
+                          void * const *data,
+                          const size_t *szs, size_t n)
+{
+        for (size_t r = 0; r < n; r++) {
+                int err = hb_mc_dma_read(mc, &npas[r], data[r], szs[r]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Initialize DMA for the model. The model's DRAM storage needs no
+ * setup, so this always succeeds.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS
+ */
+int hb_mc_dma_init(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
@@ -0,0 +1,295 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file implements the ModelWrapper object, an in-process
+// functional model of the manycore memory system.
+
+#include <bsg_manycore_model.hpp>
+#include <bsg_manycore_printing.h>
+#include <bsg_manycore_request_packet.h>
+#include <bsg_manycore_response_packet.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+ModelWrapper::ModelWrapper() :
+        last_key(~0ULL), last_page(nullptr), cycle(0), packets(0)
+{
+        memset(rom, 0, sizeof(rom));
+        memset(&cfg, 0, sizeof(cfg));
+}
+
+ModelWrapper::~ModelWrapper(){
+        for (auto &p : pages)
+                delete [] p.second;
+        pages.clear();
+}
+
+int ModelWrapper::loadROM(const std::string &path){
+        std::ifstream f(path);
+        std::string line;
+        unsigned int idx = 0;
+
+        if (!f.is_open()) {
+                bsg_pr_err("%s: Failed to open ROM file '%s'\n",
+                           __func__, path.c_str());
+                return HB_MC_INVALID;
+        }
+
+        // Each line is one ROM word, formatted as an ASCII binary
+        // string (MSB first) by bsg_bladerunner_configuration.rom
+        while (std::getline(f, line)) {
+                if (line.empty())
+                        continue;
+
+                if (idx >= HB_MC_CONFIG_MAX) {
+                        bsg_pr_err("%s: ROM file '%s' has more than %d entries\n",
+                                   __func__, path.c_str(), HB_MC_CONFIG_MAX);
+                        return HB_MC_INVALID;
+                }
+
+                rom[idx++] = static_cast<hb_mc_config_raw_t>(strtoul(line.c_str(), nullptr, 2));
+        }
+
+        if (idx != HB_MC_CONFIG_MAX) {
+                bsg_pr_err("%s: ROM file '%s' has %u entries, expected %d\n",
+                           __func__, path.c_str(), idx, HB_MC_CONFIG_MAX);
+                return HB_MC_INVALID;
+        }
+
+        return hb_mc_config_init(rom, &cfg);
+}
+
+uint8_t *ModelWrapper::getPage(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa){
+        uint64_t key =
+                (static_cast<uint64_t>(x & 0xFFFF) << 48) |
+                (static_cast<uint64_t>(y & 0xFFFF) << 32) |
+                (epa >> page_logsz);
+
+        if (key == last_key)
+                return last_page;
+
+        auto it = pages.find(key);
+        uint8_t *page;
+        if (it == pages.end()) {
+                page = new uint8_t [page_sz]();
+                pages[key] = page;
+        } else {
+                page = it->second;
+        }
+
+        last_key = key;
+        last_page = page;
+        return page;
+}
+
+uint32_t ModelWrapper::load32(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa){
+        uint32_t data;
+        uint8_t *page = getPage(x, y, epa);
+        memcpy(&data, &page[epa & (page_sz - 1) & ~0x3], sizeof(data));
+        return data;
+}
+
+void ModelWrapper::store32(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa,
+                           uint32_t data, uint8_t mask){
+        uint8_t *word = &getPage(x, y, epa)[epa & (page_sz - 1) & ~0x3];
+
+        if (mask == HB_MC_PACKET_REQUEST_MASK_WORD) {
+                memcpy(word, &data, sizeof(data));
+                return;
+        }
+
+        for (int i = 0; i < 4; i++)
+                if (mask & (1 << i))
+                        word[i] = static_cast<uint8_t>(data >> (8 * i));
+}
+
+void ModelWrapper::respond(const hb_mc_request_packet_t *rqst, uint32_t data){
+        hb_mc_response_packet_t rsp = {};
+
+        hb_mc_response_packet_set_x_dst(&rsp, hb_mc_request_packet_get_x_src(rqst));
+        hb_mc_response_packet_set_y_dst(&rsp, hb_mc_request_packet_get_y_src(rqst));
+        hb_mc_response_packet_set_load_id(&rsp, hb_mc_request_packet_get_load_id(rqst));
+        hb_mc_response_packet_set_data(&rsp, data);
+        hb_mc_response_packet_set_op(&rsp, hb_mc_request_packet_get_op(rqst));
+
+        rsp_fifo.push_back(rsp);
+}
+
+int ModelWrapper::request(const hb_mc_request_packet_t *rqst){
+        hb_mc_idx_t x = hb_mc_request_packet_get_x_dst(rqst);
+        hb_mc_idx_t y = hb_mc_request_packet_get_y_dst(rqst);
+        hb_mc_epa_t epa = hb_mc_request_packet_get_epa(rqst);
+        uint32_t data = hb_mc_request_packet_get_data(rqst);
+        hb_mc_coordinate_t dst = hb_mc_coordinate(x, y);
+        bool is_dram = hb_mc_config_is_dram(&cfg, dst);
+        uint32_t old, upd;
+
+        cycle++;
+        packets++;
+
+        if (!is_dram && !hb_mc_config_is_vanilla_core(&cfg, dst)) {
+                char pkt_str[128];
+                bsg_pr_err("%s: No endpoint at destination of packet %s\n",
+                           __func__,
+                           hb_mc_request_packet_to_string(rqst, pkt_str, sizeof(pkt_str)));
+                return HB_MC_INVALID;
+        }
+
+        switch (hb_mc_request_packet_get_op(rqst)) {
+        case HB_MC_PACKET_OP_REMOTE_LOAD: {
+                hb_mc_request_packet_load_info_t info =
+                        hb_mc_request_packet_get_load_info(rqst);
+                old = load32(x, y, epa) >> (8 * info.part_sel);
+                if (info.is_byte_op)
+                        old = info.is_unsigned_op ? (old & 0xFF)
+                                : static_cast<uint32_t>(static_cast<int8_t>(old));
+                else if (info.is_hex_op)
+                        old = info.is_unsigned_op ? (old & 0xFFFF)
+                                : static_cast<uint32_t>(static_cast<int16_t>(old));
+                respond(rqst, old);
+                return HB_MC_SUCCESS;
+        }
+        case HB_MC_PACKET_OP_REMOTE_STORE:
+                store32(x, y, epa, data, hb_mc_request_packet_get_mask(rqst));
+                return HB_MC_SUCCESS;
+        case HB_MC_PACKET_OP_REMOTE_SW:
+                store32(x, y, epa, data, HB_MC_PACKET_REQUEST_MASK_WORD);
+                return HB_MC_SUCCESS;
+        case HB_MC_PACKET_OP_CACHE_OP:
+                // The model's victim caches are always coherent with
+                // DRAM, so cache operations have no effect.
+                if (!is_dram) {
+                        bsg_pr_err("%s: Cache operation sent to a non-cache "
+                                   "endpoint (x: %d, y: %d)\n",
+                                   __func__, x, y);
+                        return HB_MC_INVALID;
+                }
+                return HB_MC_SUCCESS;
+        default:
+                break;
+        }
+
+        // Everything else is an atomic
+        old = load32(x, y, epa);
+        switch (hb_mc_request_packet_get_op(rqst)) {
+        case HB_MC_PACKET_OP_REMOTE_AMOSWAP: upd = data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOADD:  upd = old + data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOXOR:  upd = old ^ data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOAND:  upd = old & data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOOR:   upd = old | data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOMIN:
+                upd = (static_cast<int32_t>(old) < static_cast<int32_t>(data)) ? old : data;
+                break;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAX:
+                upd = (static_cast<int32_t>(old) > static_cast<int32_t>(data)) ? old : data;
+                break;
+        case HB_MC_PACKET_OP_REMOTE_AMOMINU: upd = old < data ? old : data; break;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAXU: upd = old > data ? old : data; break;
+        default:
+                bsg_pr_err("%s: Unknown packet op %d\n",
+                           __func__, hb_mc_request_packet_get_op(rqst));
+                return HB_MC_INVALID;
+        }
+
+        store32(x, y, epa, upd, HB_MC_PACKET_REQUEST_MASK_WORD);
+        respond(rqst, old);
+        return HB_MC_SUCCESS;
+}
+
+int ModelWrapper::receive(hb_mc_packet_t *pkt, hb_mc_fifo_rx_t type){
+        switch (type) {
+        case HB_MC_FIFO_RX_RSP:
+                if (rsp_fifo.empty())
+                        return HB_MC_NOTFOUND;
+                pkt->response = rsp_fifo.front();
+                rsp_fifo.pop_front();
+                break;
+        case HB_MC_FIFO_RX_REQ:
+                if (req_fifo.empty())
+                        return HB_MC_NOTFOUND;
+                pkt->request = req_fifo.front();
+                req_fifo.pop_front();
+                break;
+        default:
+                return HB_MC_INVALID;
+        }
+
+        cycle++;
+        return HB_MC_SUCCESS;
+}
+
+int ModelWrapper::drain(hb_mc_fifo_rx_t type){
+        switch (type) {
+        case HB_MC_FIFO_RX_RSP:
+                rsp_fifo.clear();
+                return HB_MC_SUCCESS;
+        case HB_MC_FIFO_RX_REQ:
+                req_fifo.clear();
+                return HB_MC_SUCCESS;
+        default:
+                return HB_MC_INVALID;
+        }
+}
+
+int ModelWrapper::read(const hb_mc_npa_t *npa, void *data, size_t sz){
+        hb_mc_idx_t x = hb_mc_npa_get_x(npa);
+        hb_mc_idx_t y = hb_mc_npa_get_y(npa);
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(data);
+
+        while (sz > 0) {
+                size_t off = epa & (page_sz - 1);
+                size_t xfer = page_sz - off < sz ? page_sz - off : sz;
+                memcpy(dst, &getPage(x, y, epa)[off], xfer);
+                dst += xfer;
+                epa += xfer;
+                sz  -= xfer;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+int ModelWrapper::write(const hb_mc_npa_t *npa, const void *data, size_t sz){
+        hb_mc_idx_t x = hb_mc_npa_get_x(npa);
+        hb_mc_idx_t y = hb_mc_npa_get_y(npa);
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+
+        while (sz > 0) {
+                size_t off = epa & (page_sz - 1);
+                size_t xfer = page_sz - off < sz ? page_sz - off : sz;
+                memcpy(&getPage(x, y, epa)[off], src, xfer);
+                src += xfer;
+                epa += xfer;
+                sz  -= xfer;
+        }
+
+        return HB_MC_SUCCESS;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef __BSG_MANYCORE_MODEL_HPP
+#define __BSG_MANYCORE_MODEL_HPP
+
+// This file declares the ModelWrapper object, an in-process
+// functional model of the manycore memory system. It stands in for
+// the DPI endpoint that the simulation platforms talk to: requests
+// from the host are applied immediately to a sparse model of tile
+// DMEM/CSRs, victim caches and DRAM, and loads/atomics produce
+// response packets in the order they were issued.
+//
+// The model is functional only: vanilla cores do not execute
+// instructions, and victim caches are modeled as always coherent
+// with DRAM (cache operations complete immediately). Time advances
+// by one cycle for each packet that crosses the host interface.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_packet.h>
+#include <bsg_manycore_fifo.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+class ModelWrapper{
+        // Backing storage is allocated in pages on first
+        // touch. Unwritten memory reads as zero.
+        static const uint32_t page_logsz = 12;
+        static const uint32_t page_sz = 1 << page_logsz;
+
+        hb_mc_config_raw_t rom[HB_MC_CONFIG_MAX];
+        hb_mc_config_t cfg;
+
+        std::unordered_map<uint64_t, uint8_t *> pages;
+        // The last page touched. Almost every access is
+        // sequential, so this skips the hash lookup.
+        uint64_t last_key;
+        uint8_t *last_page;
+
+        std::deque<hb_mc_response_packet_t> rsp_fifo;
+        std::deque<hb_mc_request_packet_t> req_fifo;
+
+        uint64_t cycle;
+        uint64_t packets;
+
+        uint8_t *getPage(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa);
+        uint32_t load32(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa);
+        void store32(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa,
+                     uint32_t data, uint8_t mask);
+        void respond(const hb_mc_request_packet_t *rqst, uint32_t data);
+public:
+        ModelWrapper();
+        ~ModelWrapper();
+
+        // Load the configuration ROM from an ASCII ROM file (one
+        // binary-formatted word per line), as generated for the
+        // simulation platforms.
+        int loadROM(const std::string &path);
+
+        const hb_mc_config_raw_t *getROM() const { return rom; }
+        const hb_mc_config_t *getConfig() const { return &cfg; }
+
+        // Apply a request packet to the model. Loads and atomics
+        // enqueue a response for the requester.
+        int request(const hb_mc_request_packet_t *rqst);
+
+        // Dequeue a packet destined for the host. Returns
+        // HB_MC_NOTFOUND if there is nothing to dequeue.
+        int receive(hb_mc_packet_t *pkt, hb_mc_fifo_rx_t type);
+
+        // Discard all packets destined for the host.
+        int drain(hb_mc_fifo_rx_t type);
+
+        // Backdoor access to the memory of an endpoint. These do not
+        // advance time and do not generate packets.
+        int read(const hb_mc_npa_t *npa, void *data, size_t sz);
+        int write(const hb_mc_npa_t *npa, const void *data, size_t sz);
+
+        // Advance time without any traffic, e.g. to model a
+        // receive that times out.
+        void advance(uint64_t cycles) { cycle += cycles; }
+
+        uint64_t getCycle() const { return cycle; }
+        uint64_t getPackets() const { return packets; }
+};
+
+// The platform state for this platform. It is shared with the DMA
+// feature implementation (bsg_manycore_dma.cpp), which accesses
+// model memory directly.
+typedef struct hb_mc_platform_t {
+        ModelWrapper *model;
+        hb_mc_manycore_id_t id;
+} hb_mc_platform_t;
+
+#endif
@@ -0,0 +1,442 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <bsg_manycore_platform.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_printing.h>
+
+#include <bsg_manycore_model.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <map>
+
+/* these are convenience macros that are only good for one line prints */
+#define manycore_pr_dbg(mc, fmt, ...)                   \
+        bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_err(mc, fmt, ...)                   \
+        bsg_pr_err("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_warn(mc, fmt, ...)                          \
+        bsg_pr_warn("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_info(mc, fmt, ...)                          \
+        bsg_pr_info("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+// The environment variable that holds the path to the machine's
+// configuration ROM (bsg_bladerunner_configuration.rom). execution.mk
+// sets it from BSG_MACHINE_PATH.
+#define HB_MC_MODEL_ROM_ENV "BSG_MODEL_CONFIGURATION_ROM"
+
+/* read all unread packets from a fifo (rx only) */
+int hb_mc_platform_drain(hb_mc_manycore_t *mc, hb_mc_fifo_rx_t type)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err;
+
+        err = platform->model->drain(type);
+        if (err != HB_MC_SUCCESS) {
+                manycore_pr_err(mc, "%s: Unknown packet type\n", __func__);
+                return HB_MC_NOIMPL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+// These track active manycore machine IDs, and top-level
+// instantiations.
+static std::set<hb_mc_manycore_id_t> active_ids;
+static std::map<hb_mc_manycore_id_t,ModelWrapper*> machines;
+
+/**
+ * Clean up the runtime platform
+ * @param[in] mc    A manycore to clean up
+ */
+void hb_mc_platform_cleanup(hb_mc_manycore_t *mc)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        // Remove the key
+        auto key = active_ids.find(platform->id);
+        active_ids.erase(key);
+
+        auto m = machines.find(platform->id);
+        if(m != machines.end()){
+                delete m->second;
+                machines.erase(m);
+        } else {
+                // Possible causes: Cleanup before init, memory corruption
+                manycore_pr_err(mc, "Machine ID %d was not found during platform cleanup. Memory corruption?", platform->id);
+        }
+
+        platform->model = nullptr;
+        platform->id = 0;
+        delete platform;
+        mc->platform = nullptr;
+
+        return;
+}
+
+/**
+ * Initialize the runtime platform
+ * @param[in] mc    A manycore to initialize
+ * @param[in] id    ID which selects the physical hardware from which this manycore is configured
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
+{
+        int err;
+        const char *rom;
+
+        // check if mc is already initialized
+        if (mc->platform)
+                return HB_MC_INITIALIZED_TWICE;
+
+        if (id != 0) {
+                manycore_pr_err(mc, "Failed to init platform: invalid ID\n");
+                return HB_MC_INVALID;
+        }
+
+        // Check if the ID has already been initialized
+        if(active_ids.find(id) != active_ids.end()){
+                manycore_pr_err(mc, "Already initialized ID\n");
+                return HB_MC_INVALID;
+        }
+
+        rom = getenv(HB_MC_MODEL_ROM_ENV);
+        if (rom == nullptr) {
+                manycore_pr_err(mc, "Failed to init platform: "
+                                HB_MC_MODEL_ROM_ENV " is not set\n");
+                return HB_MC_INVALID;
+        }
+
+        // The model is rebuilt on every init, so that memory starts
+        // out zeroed like a freshly reset machine.
+        ModelWrapper *model = new ModelWrapper();
+        err = model->loadROM(rom);
+        if (err != HB_MC_SUCCESS) {
+                manycore_pr_err(mc, "Failed to init platform: "
+                                "could not load configuration ROM %s\n", rom);
+                delete model;
+                return err;
+        }
+
+        hb_mc_platform_t *platform = new hb_mc_platform_t;
+        platform->id = id;
+        platform->model = model;
+
+        active_ids.insert(id);
+        machines[id] = model;
+
+        mc->platform = reinterpret_cast<void *>(platform);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Transmit a packet to manycore hardware
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] request A request packet to transmit to manycore hardware
+ * @param[in] timeout A timeout counter. Unused - the model never stalls on transmit.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
+                            hb_mc_packet_t *packet,
+                            hb_mc_fifo_tx_t type,
+                            long timeout)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err;
+
+        if (type == HB_MC_FIFO_TX_RSP) {
+                manycore_pr_err(mc, "TX Response Not Supported!\n");
+                return HB_MC_NOIMPL;
+        }
+
+        err = platform->model->request(&packet->request);
+        if (err != HB_MC_SUCCESS) {
+                manycore_pr_err(mc, "%s: Failed to transmit packet: %s\n",
+                                __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Transmit a batch of packets to manycore hardware, in order
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets in #packets
+ * @param[in] type    The FIFO to transmit #packets on
+ * @param[in] timeout A timeout counter. Unused - the model never stalls on transmit.
+ * @return HB_MC_SUCCESS if all packets were transmitted. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
+{
+        int err;
+
+        // The model applies each request immediately, so there is
+        // nothing to gain from deferring them.
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_platform_transmit(mc, &packets[i], type, timeout);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Receive a packet from manycore hardware
+ * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] response A packet into which data should be read
+ * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_receive(hb_mc_manycore_t *mc,
+                           hb_mc_packet_t *packet,
+                           hb_mc_fifo_rx_t type,
+                           long timeout)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err;
+
+        if (type != HB_MC_FIFO_RX_REQ && type != HB_MC_FIFO_RX_RSP) {
+                manycore_pr_err(mc, "%s: Unknown packet type\n", __func__);
+                return HB_MC_NOIMPL;
+        }
+
+        // Every packet the model will ever produce is produced by
+        // transmit, so an empty FIFO here would block forever on
+        // a real machine. Report it instead of hanging.
+        err = platform->model->receive(packet, type);
+        if (err == HB_MC_NOTFOUND && timeout >= 0) {
+                // A bounded wait simply runs out the clock.
+                platform->model->advance(timeout);
+                return HB_MC_TIMEOUT;
+        } else if (err == HB_MC_NOTFOUND) {
+                manycore_pr_err(mc, "%s: No packet in %s fifo: "
+                                "the functional model does not execute tiles\n",
+                                __func__, hb_mc_fifo_rx_to_string(type));
+                return HB_MC_FAIL;
+        }
+
+        return err;
+}
+
+/**
+ * Read the configuration register at an index
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  idx    Configuration register index to access
+ * @param[out] config Configuration value at index
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config_at(hb_mc_manycore_t *mc,
+                                 unsigned int idx,
+                                 hb_mc_config_raw_t *config)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        if(idx < HB_MC_CONFIG_MAX){
+                *config = platform->model->getROM()[idx];
+                return HB_MC_SUCCESS;
+        }
+
+        return HB_MC_INVALID;
+}
+
+/**
+ * Read the whole configuration ROM
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] config An array of HB_MC_CONFIG_MAX configuration values
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config(hb_mc_manycore_t *mc,
+                              hb_mc_config_raw_t config[HB_MC_CONFIG_MAX])
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        memcpy(config, platform->model->getROM(), sizeof(hb_mc_config_raw_t) * HB_MC_CONFIG_MAX);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Stall until the all requests (and responses) have reached their destination.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] timeout A timeout counter. Unused - the model never stalls.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_fence(hb_mc_manycore_t *mc, long timeout)
+{
+        // Requests are applied to the model as they are
+        // transmitted, so there is never anything in flight.
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Signal the hardware to start a bulk transfer over the network
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_start_bulk_transfer(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Signal the hardware to end a bulk transfer over the network
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_finish_bulk_transfer(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get the current cycle counter of the Manycore Platform
+ *
+ * The model advances one cycle for each packet that crosses the
+ * host interface.
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] time   The current counter value.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        *time = platform->model->getCycle();
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get the number of instructions executed for a certain class of instructions
+ *
+ * Tiles do not execute in the model, so every count is zero.
+ *
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] itype An enum defining the class of instructions to query.
+ * @param[out] count The number of instructions executed in the queried class.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int *count){
+        *count = 0;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Tiles do not execute in the model, so no tile has counters.
+ *
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with counters
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        *ntiles = 0;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Tiles do not execute in the model, so the histogram is empty.
+ *
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] samples  An array of at least #n samples
+ * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+ * @param[out] nsamples The number of nonzero (tile, PC) samples
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                    size_t n, size_t *nsamples){
+        *nsamples = 0;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Enable trace file generation (vanilla_operation_trace.csv)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_trace_enable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Disable trace file generation (vanilla_operation_trace.csv)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_trace_disable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Enable log file generation (vanilla.log)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_log_enable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Disable log file generation (vanilla.log)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_log_disable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Check if chip reset has completed.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_wait_reset_done(hb_mc_manycore_t *mc)
+{
+        // The model comes out of reset when it is constructed.
+        return HB_MC_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#include <stdint.h>
+#include <unistd.h>
+#include <bsg_manycore_regression.h>
+#include <dlfcn.h>
+
+// This is the entry point for programs run on the functional model.
+//
+// The simulation platforms load the program (main.so) into the
+// simulator executable and call vcs_main from cosim_main. The model
+// has no simulator executable, so this small launcher plays that
+// role instead: it is invoked as
+//
+//     bsg_manycore_model <path to main.so> [program arguments...]
+//
+// and calls vcs_main with the program arguments. argv[0] is
+// preserved so that programs see the launcher as their executable.
+int main(int argc, char *argv[]) {
+        char *error;
+
+        if (argc < 2) {
+                bsg_pr_err("Usage: %s <path to main.so> [args...]\n", argv[0]);
+                return 1;
+        }
+
+        void *handle = dlopen(argv[1], RTLD_LAZY | RTLD_DEEPBIND);
+        if (handle == NULL) {
+                bsg_pr_err("Error when loading %s: %s\n", argv[1], dlerror());
+                return 1;
+        }
+
+        int (*vcs_main)(int , char **) = dlsym(handle, "vcs_main");
+
+        error = dlerror();
+        if (error != NULL) {
+                bsg_pr_err("Error when finding dynamically loaded symbol vcs_main: %s\n", error);
+                dlclose(handle);
+                return 1;
+        }
+
+        // Drop the path to main.so from the argument list
+        argv[1] = argv[0];
+        int rc = (*vcs_main)(argc - 1, &argv[1]);
+
+        dlclose(handle);
+        return rc == HB_MC_SUCCESS ? 0 : 1;
+}
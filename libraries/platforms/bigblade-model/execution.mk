@@ -0,0 +1,52 @@
+# Copyright (c) 2019, University of Washington All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this list
+# of conditions and the following disclaimer.
+#
+# Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+#
+# Neither the name of the copyright holder nor the names of its contributors may
+# be used to endorse or promote products derived from this software without
+# specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+# ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# These are the execution rules for the binaries. The model reads the
+# machine's configuration ROM at runtime from the path in
+# BSG_MODEL_CONFIGURATION_ROM. Users can specify C-style arguments
+# using the C_ARGS make variable.
+
+.PRECIOUS: exec.log
+.PHONY: platform.execution.clean
+
+exec.log: $(BSG_PLATFORM_PATH)/bsg_manycore_model $(BSG_MACHINE_PATH)/bsg_bladerunner_configuration.rom
+
+%.log: main.so $(BSG_MANYCORE_KERNELS)
+	BSG_MODEL_CONFIGURATION_ROM=$(BSG_MACHINE_PATH)/bsg_bladerunner_configuration.rom \
+	$(BSG_PLATFORM_PATH)/bsg_manycore_model $(CURDIR)/main.so $(C_ARGS) 2>&1 | tee $@
+
+platform.execution.clean:
+	rm -rf exec.log
+
+execution.clean: platform.execution.clean
+
+help:
+	@echo "Usage:"
+	@echo "make {clean | exec.log }"
+	@echo "      exec.log: Run program on the in-process functional model"
+	@echo "      clean: Remove all subdirectory-specific outputs"
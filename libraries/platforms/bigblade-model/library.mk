@@ -0,0 +1,90 @@
+# Copyright (c) 2019, University of Washington All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this list
+# of conditions and the following disclaimer.
+#
+# Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+#
+# Neither the name of the copyright holder nor the names of its contributors may
+# be used to endorse or promote products derived from this software without
+# specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+# ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# The functional model platform runs entirely in-process: the model
+# of the manycore memory system is compiled into
+# libbsg_manycore_runtime.so, and no DPI endpoint or simulator is
+# required.
+PLATFORM_CXXSOURCES += $(BSG_PLATFORM_PATH)/bsg_manycore_model.cpp
+PLATFORM_CXXSOURCES += $(BSG_PLATFORM_PATH)/bsg_manycore_platform.cpp
+PLATFORM_CXXSOURCES += $(BSG_PLATFORM_PATH)/bsg_manycore_dma.cpp
+
+# The launcher is linked into an executable by link.mk, not into
+# libbsg_manycore_regression.so
+PLATFORM_LAUNCHER_CSOURCES += $(BSG_PLATFORM_PATH)/bsg_manycore_regression_platform.c
+
+PLATFORM_OBJECTS += $(patsubst %cpp,%o,$(PLATFORM_CXXSOURCES))
+PLATFORM_OBJECTS += $(patsubst %c,%o,$(PLATFORM_CSOURCES))
+
+PLATFORM_REGRESSION_OBJECTS += $(patsubst %cpp,%o,$(PLATFORM_REGRESSION_CXXSOURCES))
+PLATFORM_REGRESSION_OBJECTS += $(patsubst %c,%o,$(PLATFORM_REGRESSION_CSOURCES))
+
+PLATFORM_LAUNCHER_OBJECTS += $(patsubst %c,%o,$(PLATFORM_LAUNCHER_CSOURCES))
+
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): INCLUDES := -I$(LIBRARIES_PATH)
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): INCLUDES += -I$(LIBRARIES_PATH)/features/dma
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): INCLUDES += -I$(LIBRARIES_PATH)/features/profiler
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): INCLUDES += -I$(BSG_PLATFORM_PATH)
+
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): CFLAGS    = -std=c11 -fPIC -O2 -D_GNU_SOURCE -D_BSD_SOURCE -D_DEFAULT_SOURCE $(INCLUDES)
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS): CXXFLAGS  = -std=c++11 -fPIC -O2 -D_GNU_SOURCE -D_BSD_SOURCE -D_DEFAULT_SOURCE $(INCLUDES)
+$(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS): LDFLAGS   = -fPIC
+$(PLATFORM_REGRESSION_OBJECTS): LDFLAGS   = -ldl
+
+$(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so.1.0: $(PLATFORM_OBJECTS)
+$(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so.1.0: $(PLATFORM_REGRESSION_OBJECTS)
+
+# Mirror the extensions linux installation in /usr/lib provides so
+# that we can use -lbsg_manycore_runtime
+$(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so.1: %: %.0
+	ln -sf $@.0 $@
+
+$(BSG_PLATFORM_PATH)/libbsgmc_cuda_legacy_pod_repl.so.1: %: %.0
+	ln -sf $@.0 $@
+
+$(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so.1: %: %.0
+	ln -sf $@.0 $@
+
+$(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so: %: %.1
+	ln -sf $@.1 $@
+
+$(BSG_PLATFORM_PATH)/libbsgmc_cuda_legacy_pod_repl.so: %: %.1
+	ln -sf $@.1 $@
+
+$(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so: %: %.1
+	ln -sf $@.1 $@
+
+platform.clean:
+	rm -f $(PLATFORM_OBJECTS) $(PLATFORM_REGRESSION_OBJECTS) $(PLATFORM_LAUNCHER_OBJECTS)
+	rm -f $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so
+	rm -f $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so.1
+	rm -f $(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so*
+	rm -f $(BSG_PLATFORM_PATH)/libbsgmc_cuda_legacy_pod_repl.so*
+	rm -f $(BSG_PLATFORM_PATH)/bsg_manycore_model
+
+libraries.clean: platform.clean
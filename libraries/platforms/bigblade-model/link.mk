@@ -0,0 +1,74 @@
+# Copyright (c) 2019, University of Washington All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this list
+# of conditions and the following disclaimer.
+#
+# Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+#
+# Neither the name of the copyright holder nor the names of its contributors may
+# be used to endorse or promote products derived from this software without
+# specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+# ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# This Makefile fragment defines all of the rules for linking
+# bigblade-model binaries
+
+ORANGE=\033[0;33m
+RED=\033[0;31m
+NC=\033[0m
+
+# This file REQUIRES several variables to be set. They are typically set by the
+# Makefile that includes this fragment...
+
+# BSG_PLATFORM_PATH: The path to the testbenches folder in BSG F1
+ifndef BSG_PLATFORM_PATH
+$(error $(shell echo -e "$(RED)BSG MAKE ERROR: BSG_PLATFORM_PATH is not defined$(NC)"))
+endif
+
+# hardware.mk is the file list for the simulation RTL. The model has
+# no RTL, but hardware.mk also defines how to build the machine's
+# configuration ROM, which the model reads at runtime.
+include $(HARDWARE_PATH)/hardware.mk
+
+# libraries.mk defines how to build libbsg_manycore_runtime.so, which is
+# pre-linked against all other simulation binaries.
+include $(LIBRARIES_PATH)/libraries.mk
+
+# bsg_manycore_model is the stand-in for a simulator executable. It
+# loads main.so and calls vcs_main (see
+# bsg_manycore_regression_platform.c).
+MODEL_LDFLAGS += -L$(BSG_PLATFORM_PATH) -Wl,-rpath=$(BSG_PLATFORM_PATH)
+MODEL_LDFLAGS += -lbsg_manycore_regression -lbsg_manycore_runtime -ldl -lm
+
+$(BSG_PLATFORM_PATH)/bsg_manycore_model: $(PLATFORM_LAUNCHER_OBJECTS) | $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so $(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so
+	$(CXX) -o $@ $(PLATFORM_LAUNCHER_OBJECTS) $(MODEL_LDFLAGS)
+
+.PRECIOUS: $(BSG_PLATFORM_PATH)/bsg_manycore_model
+
+# See bigblade-vcs/link.mk for a description of REGRESSION_PREBUILD
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/bsg_manycore_model
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so
+REGRESSION_PREBUILD += $(BSG_MACHINE_PATH)/bsg_bladerunner_configuration.rom
+
+.PHONY: platform.link.clean
+platform.link.clean:
+	rm -f $(BSG_PLATFORM_PATH)/bsg_manycore_model
+
+link.clean: platform.link.clean ;
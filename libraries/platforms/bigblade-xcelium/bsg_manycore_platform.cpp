@@ -38,8 +38,11 @@
 #include <bsg_nonsynth_dpi_clock_gen.hpp>
 
 #include <cstring>
+#include <cstdlib>
+#include <chrono>
 #include <set>
 #include <map>
+#include <vector>
 #include <xmmintrin.h>
 
 /* these are convenience macros that are only good for one line prints */
@@ -61,8 +64,92 @@ typedef struct hb_mc_platform_t {
         hb_mc_manycore_id_t id;
         bsg_nonsynth_dpi::dpi_cycle_counter<uint64_t> *ctr;
         hb_mc_tracer_t tracer;
+        // Packets deferred by hb_mc_platform_transmit() while a bulk
+        // transfer is open, and the bulk transfer nesting depth.
+        std::vector<hb_mc_packet_t> batch;
+        unsigned int batch_depth;
+        // Wall-clock bound on any single transmit or receive, in
+        // seconds. Zero if unbounded.
+        double wall_timeout;
 } hb_mc_platform_t;
 
+// Set this environment variable to a number of seconds to bound every
+// transmit and receive in wall-clock time, even those that are
+// otherwise allowed to wait forever. This is a safety net for
+// unattended regressions where a lost packet would hang simulation.
+#define HB_MC_PLATFORM_WALL_TIMEOUT_ENV "BSG_PLATFORM_WALL_TIMEOUT"
+
+// Checking the wall clock is comparatively expensive, so it is only
+// checked once every this many iterations of a wait loop.
+#define HB_MC_PLATFORM_WALL_CHECK_INTERVAL 1024
+
+/* The point at which a transmit or receive gives up */
+typedef struct hb_mc_platform_deadline {
+        bool cycle_bound;                               //!< whether cycle_limit applies
+        uint64_t cycle_limit;                           //!< cycle count at which to time out
+        bool wall_bound;                                //!< whether wall_limit applies
+        std::chrono::steady_clock::time_point wall_limit; //!< wall-clock time at which to time out
+        unsigned int polls;                             //!< iterations since the wall clock was checked
+} hb_mc_platform_deadline_t;
+
+/**
+ * Start a deadline for a transmit or receive
+ * @param[in]  platform  Platform state
+ * @param[in]  timeout   A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @param[out] deadline  A deadline to check with hb_mc_platform_deadline_expired()
+ */
+static void hb_mc_platform_deadline_init(hb_mc_platform_t *platform, long timeout,
+                                         hb_mc_platform_deadline_t *deadline)
+{
+        uint64_t now;
+
+        deadline->cycle_bound = timeout >= 0;
+        if (deadline->cycle_bound) {
+                platform->ctr->read(now);
+                deadline->cycle_limit = now + timeout;
+        }
+
+        deadline->wall_bound = platform->wall_timeout > 0;
+        if (deadline->wall_bound) {
+                deadline->wall_limit = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(platform->wall_timeout));
+        }
+
+        deadline->polls = 0;
+}
+
+/**
+ * Check whether a deadline has passed
+ * @param[in]  platform  Platform state
+ * @param[in]  deadline  A deadline initialized with hb_mc_platform_deadline_init()
+ * @return true if the wait should give up, false otherwise
+ */
+static bool hb_mc_platform_deadline_expired(hb_mc_platform_t *platform,
+                                            hb_mc_platform_deadline_t *deadline)
+{
+        uint64_t now;
+
+        if (deadline->cycle_bound) {
+                platform->ctr->read(now);
+                if (now >= deadline->cycle_limit)
+                        return true;
+        }
+
+        if (deadline->wall_bound &&
+            ++deadline->polls >= HB_MC_PLATFORM_WALL_CHECK_INTERVAL) {
+                deadline->polls = 0;
+                if (std::chrono::steady_clock::now() >= deadline->wall_limit)
+                        return true;
+        }
+
+        return false;
+}
+
+// The maximum number of packets deferred during a bulk transfer
+// before they are sent.
+#define HB_MC_PLATFORM_BATCH_MAX 1024
+
 /* read all unread packets from a fifo (rx only) */
 int hb_mc_platform_drain(hb_mc_manycore_t *mc, hb_mc_fifo_rx_t type)
 {
@@ -153,6 +240,10 @@ void hb_mc_platform_cleanup(hb_mc_manycore_t *mc)
 {
         hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
 
+        if (!platform->batch.empty())
+                manycore_pr_warn(mc, "%s: Discarding %zu packets from an unfinished bulk transfer\n",
+                                 __func__, platform->batch.size());
+
         hb_mc_tracer_cleanup(&(platform->tracer));
 
 
@@ -214,6 +305,11 @@ int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
 
         active_ids.insert(id);
         platform->id = id;
+        platform->batch_depth = 0;
+        platform->batch.reserve(HB_MC_PLATFORM_BATCH_MAX);
+
+        const char *wall = getenv(HB_MC_PLATFORM_WALL_TIMEOUT_ENV);
+        platform->wall_timeout = wall ? atof(wall) : 0;
 
         // Instantiate the top-level platform simulation and put it in
         // the map. If it has already been instantiated, don't
@@ -262,12 +358,106 @@ int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
 
 }
 
+/**
+ * Check whether a request packet will produce a response
+ * @param[in] packet  A request packet
+ * @return true if #packet will produce a response, false otherwise
+ */
+static bool hb_mc_platform_expect_response(const hb_mc_packet_t *packet)
+{
+        // The DPI interface doesn't understand packets, but it does
+        // track response fifo occupancy. However, only some requests
+        // produce responses because we use the endpoint standard
+        // (which filters write responses). We use expect_response to
+        // indicate that this request will produce a response, so that
+        // the DPI interface can track the response fifo capacity.
+        return (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_STORE) &&
+                (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_SW) &&
+                (packet->request.op_v2 != HB_MC_PACKET_OP_CACHE_OP);
+}
+
+/**
+ * Transmit an array of request packets, in order, through the DPI interface
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n request packets
+ * @param[in] n       The number of packets in #packets
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success, HB_MC_TIMEOUT if #timeout expired.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+static int hb_mc_platform_transmit_internal(hb_mc_manycore_t *mc,
+                                            hb_mc_packet_t *packets,
+                                            size_t n,
+                                            long timeout)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        SimulationWrapper *top = platform->top;
+        hb_mc_platform_deadline_t deadline;
+        size_t sent = 0;
+        int err;
+
+        hb_mc_platform_deadline_init(platform, timeout, &deadline);
+
+        while (sent < n) {
+                top->eval();
+
+                // Push packets until the interface stops accepting
+                // them (no credits, or it is busy this cycle) before
+                // advancing time again.
+                do {
+                        __m128i *pkt = reinterpret_cast<__m128i*>(&packets[sent]);
+                        err = platform->dpi->tx_req(*pkt, hb_mc_platform_expect_response(&packets[sent]));
+                        if (err == BSG_NONSYNTH_DPI_SUCCESS)
+                                sent++;
+                } while (err == BSG_NONSYNTH_DPI_SUCCESS && sent < n);
+
+                if (err != BSG_NONSYNTH_DPI_SUCCESS &&
+                    err != BSG_NONSYNTH_DPI_NO_CREDITS &&
+                    err != BSG_NONSYNTH_DPI_NO_CAPACITY &&
+                    err != BSG_NONSYNTH_DPI_NOT_WINDOW &&
+                    err != BSG_NONSYNTH_DPI_BUSY &&
+                    err != BSG_NONSYNTH_DPI_NOT_READY) {
+                        manycore_pr_err(mc, "%s: Failed to transmit packet: %s\n",
+                                        __func__, bsg_nonsynth_dpi_strerror(err));
+                        return HB_MC_INVALID;
+                }
+
+                if (sent < n && hb_mc_platform_deadline_expired(platform, &deadline)) {
+                        manycore_pr_dbg(mc, "%s: Timed out with %zu of %zu packets sent\n",
+                                        __func__, sent, n);
+                        return HB_MC_TIMEOUT;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Transmit all packets deferred by an open bulk transfer
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+static int hb_mc_platform_flush(hb_mc_manycore_t *mc)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        int err;
+
+        if (platform->batch.empty())
+                return HB_MC_SUCCESS;
+
+        err = hb_mc_platform_transmit_internal(mc, platform->batch.data(), platform->batch.size(), -1);
+        platform->batch.clear();
+
+        return err;
+}
+
 /**
  * Transmit a packet to manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A request packet to transmit to manycore hardware
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
- * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success, HB_MC_TIMEOUT if #timeout expired.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
                             hb_mc_packet_t *packet,
@@ -275,59 +465,68 @@ int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
                             long timeout)
 {
         hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
-        SimulationWrapper *top = platform->top;
-        __m128i *pkt = reinterpret_cast<__m128i*>(packet);
         const char *typestr = hb_mc_fifo_tx_to_string(type);
-
         int err;
-        if (timeout != -1) {
-                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
-                                __func__);
-                return HB_MC_INVALID;
-        }
 
         if (type == HB_MC_FIFO_TX_RSP) {
                 manycore_pr_err(mc, "TX Response Not Supported!\n", typestr);
                 return HB_MC_NOIMPL;
         }
 
-        // The DPI interface doesn't understand packets, but it does
-        // track response fifo occupancy. However, only some requests
-        // produce responses because we use the endpoint standard
-        // (which filters write responses). We use expect_response to
-        // indicate that this request will produce a response, so that
-        // the DPI interface can track the response fifo capacity.
-        bool expect_response =
-                (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_STORE) &&
-                (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_SW) &&
-                (packet->request.op_v2 != HB_MC_PACKET_OP_CACHE_OP);
+        // Defer the packet if a bulk transfer is open. A bounded
+        // transmit is sent immediately so its timeout is meaningful.
+        if (platform->batch_depth > 0 && timeout == -1) {
+                platform->batch.push_back(*packet);
+                if (platform->batch.size() >= HB_MC_PLATFORM_BATCH_MAX)
+                        return hb_mc_platform_flush(mc);
+                return HB_MC_SUCCESS;
+        }
 
-        do {
-                top->eval();
-                err = platform->dpi->tx_req(*pkt, expect_response);
+        err = hb_mc_platform_flush(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
-        } while (err != BSG_NONSYNTH_DPI_SUCCESS &&
-                 (err == BSG_NONSYNTH_DPI_NO_CREDITS ||
-                  err == BSG_NONSYNTH_DPI_NO_CAPACITY ||
-                  err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
-                  err == BSG_NONSYNTH_DPI_BUSY ||
-                  err == BSG_NONSYNTH_DPI_NOT_READY ));
+        return hb_mc_platform_transmit_internal(mc, packet, 1, timeout);
+}
 
-        if(err != BSG_NONSYNTH_DPI_SUCCESS){
-                manycore_pr_err(mc, "%s: Failed to transmit packet: %s\n",
-                                __func__, bsg_nonsynth_dpi_strerror(err));
-                return HB_MC_INVALID;
+/**
+ * Transmit a batch of packets to manycore hardware, in order
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets in #packets
+ * @param[in] type    The FIFO to transmit #packets on
+ * @param[in] timeout A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS if all packets were transmitted, HB_MC_TIMEOUT if #timeout expired.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
+{
+        int err;
+
+        if (type == HB_MC_FIFO_TX_RSP) {
+                manycore_pr_err(mc, "TX Response Not Supported!\n");
+                return HB_MC_NOIMPL;
         }
 
-        return HB_MC_SUCCESS;
+        // Preserve ordering with any deferred packets
+        err = hb_mc_platform_flush(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        return hb_mc_platform_transmit_internal(mc, packets, n, timeout);
 }
 
 /**
  * Receive a packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response A packet into which data should be read
- * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
- * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ * @param[in] timeout  A number of simulated cycles to wait. Set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success, HB_MC_TIMEOUT if #timeout expired.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_platform_receive(hb_mc_manycore_t *mc,
                            hb_mc_packet_t *packet,
@@ -339,12 +538,14 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
         hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
         SimulationWrapper *top = platform->top;
         __m128i *pkt = reinterpret_cast<__m128i*>(packet);
+        hb_mc_platform_deadline_t deadline;
 
-        if (timeout != -1) {
-                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
-                                __func__);
-                return HB_MC_INVALID;
-        }
+        // Deferred requests may be what we are waiting on
+        err = hb_mc_platform_flush(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_platform_deadline_init(platform, timeout, &deadline);
 
         do {
                 top->eval();
@@ -361,6 +562,13 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
                         return HB_MC_NOIMPL;
                 }
 
+                if (err != BSG_NONSYNTH_DPI_SUCCESS &&
+                    hb_mc_platform_deadline_expired(platform, &deadline)) {
+                        manycore_pr_dbg(mc, "%s: Timed out waiting for %s packet\n",
+                                        __func__, hb_mc_fifo_rx_to_string(type));
+                        return HB_MC_TIMEOUT;
+                }
+
         } while (err != BSG_NONSYNTH_DPI_SUCCESS &&
                  (err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
                   err == BSG_NONSYNTH_DPI_BUSY ||
@@ -396,6 +604,23 @@ int hb_mc_platform_get_config_at(hb_mc_manycore_t *mc,
         return HB_MC_INVALID;
 }
 
+/**
+ * Read the whole configuration ROM
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] config An array of HB_MC_CONFIG_MAX configuration values
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config(hb_mc_manycore_t *mc,
+                              hb_mc_config_raw_t config[HB_MC_CONFIG_MAX])
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        for (unsigned int idx = HB_MC_CONFIG_MIN; idx < HB_MC_CONFIG_MAX; idx++)
+                config[idx] = platform->dpi->config[idx];
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Read the count of credits currently in use
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -491,6 +716,10 @@ int hb_mc_platform_fence(hb_mc_manycore_t *mc, long timeout)
                 return HB_MC_NOIMPL;
         }
 
+        err = hb_mc_platform_flush(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
         do {
                 err = hb_mc_platform_get_credits_used(mc, &credits_used, timeout);
                 platform->dpi->tx_is_vacant(isvacant);
@@ -506,6 +735,10 @@ int hb_mc_platform_fence(hb_mc_manycore_t *mc, long timeout)
  */
 int hb_mc_platform_start_bulk_transfer(hb_mc_manycore_t *mc)
 {
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        platform->batch_depth++;
+
         return HB_MC_SUCCESS;
 }
 
@@ -516,7 +749,17 @@ int hb_mc_platform_start_bulk_transfer(hb_mc_manycore_t *mc)
  */
 int hb_mc_platform_finish_bulk_transfer(hb_mc_manycore_t *mc)
 {
-        return HB_MC_SUCCESS;
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        if (platform->batch_depth == 0) {
+                manycore_pr_err(mc, "%s: No bulk transfer in progress\n", __func__);
+                return HB_MC_INVALID;
+        }
+
+        if (--platform->batch_depth > 0)
+                return HB_MC_SUCCESS;
+
+        return hb_mc_platform_flush(mc);
 }
 
 
@@ -549,6 +792,33 @@ int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int
          return HB_MC_NOIMPL;
 }
 
+/**
+ * Get the performance counters of every tile
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with counters
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Get the PC histogram of every tile since reset
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] samples  An array of at least #n samples
+ * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+ * @param[out] nsamples The number of nonzero (tile, PC) samples
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                    size_t n, size_t *nsamples){
+        return HB_MC_NOIMPL;
+}
+
 /**
  * Enable trace file generation (vanilla_operation_trace.csv)
  * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
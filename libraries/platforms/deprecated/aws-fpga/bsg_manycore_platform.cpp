@@ -249,6 +249,31 @@ int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Transmit a batch of packets to manycore hardware, in order. This
+ * platform has no batched interface, so packets go out one at a time.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets in #packets
+ * @param[in] type    The FIFO to transmit #packets on
+ * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @return HB_MC_SUCCESS if all packets were transmitted. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
+{
+        int err;
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_platform_transmit(mc, &packets[i], type, timeout);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Receive a packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
@@ -268,9 +293,9 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
         int err;
 
         if (timeout != -1) {
-                platform_pr_err(pl, "%s: Only a timeout value of -1 is supported\n",
+                platform_pr_dbg(pl, "%s: Only a timeout value of -1 is supported\n",
                                 __func__);
-                return HB_MC_INVALID;
+                return HB_MC_NOIMPL;
         }
 
         data_addr = hb_mc_mmio_fifo_get_addr(type, HB_MC_MMIO_FIFO_RX_DATA_OFFSET);
@@ -332,6 +357,27 @@ int hb_mc_platform_get_config_at(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Read the whole configuration ROM
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] config An array of HB_MC_CONFIG_MAX configuration values
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config(hb_mc_manycore_t *mc,
+                              hb_mc_config_raw_t config[HB_MC_CONFIG_MAX])
+{
+        int err;
+
+        // the ROM is only accessible one word at a time over MMIO
+        for (unsigned int idx = HB_MC_CONFIG_MIN; idx < HB_MC_CONFIG_MAX; idx++) {
+                err = hb_mc_platform_get_config_at(mc, idx, &config[idx]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Read the number of remaining manycore network credits
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -585,6 +631,35 @@ int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int
         return hb_mc_profiler_get_icount(pl->prof, itype, count);
 }
 
+/**
+ * Get the performance counters of every tile
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with counters
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        hb_mc_platform_t *pl = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        return hb_mc_profiler_get_counters(pl->prof, counters, n, ntiles, delta);
+}
+
+/**
+ * Get the PC histogram of every tile since reset
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] samples  An array of at least #n samples
+ * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+ * @param[out] nsamples The number of nonzero (tile, PC) samples
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                    size_t n, size_t *nsamples){
+        return HB_MC_NOIMPL;
+}
+
 /**
  * Enable trace file generation (vanilla_operation_trace.csv)
  * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
@@ -313,6 +313,31 @@ int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Transmit a batch of packets to manycore hardware, in order. This
+ * platform has no batched interface, so packets go out one at a time.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets in #packets
+ * @param[in] type    The FIFO to transmit #packets on
+ * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @return HB_MC_SUCCESS if all packets were transmitted. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
+{
+        int err;
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_platform_transmit(mc, &packets[i], type, timeout);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Receive a packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
@@ -332,9 +357,9 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
         __m128i *pkt = reinterpret_cast<__m128i*>(packet);
 
         if (timeout != -1) {
-                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
+                manycore_pr_dbg(mc, "%s: Only a timeout value of -1 is supported\n",
                                 __func__);
-                return HB_MC_INVALID;
+                return HB_MC_NOIMPL;
         }
 
         do {
@@ -387,6 +412,23 @@ int hb_mc_platform_get_config_at(hb_mc_manycore_t *mc,
         return HB_MC_INVALID;
 }
 
+/**
+ * Read the whole configuration ROM
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] config An array of HB_MC_CONFIG_MAX configuration values
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config(hb_mc_manycore_t *mc,
+                              hb_mc_config_raw_t config[HB_MC_CONFIG_MAX])
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        for (unsigned int idx = HB_MC_CONFIG_MIN; idx < HB_MC_CONFIG_MAX; idx++)
+                config[idx] = platform->dpi->config[idx];
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Read the count of credits currently in use
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -540,6 +582,33 @@ int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int
          return HB_MC_NOIMPL;
 }
 
+/**
+ * Get the performance counters of every tile
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] counters An array of at least #n counters
+ * @param[in]  n        The number of counters to get. Set to 0 to get only #ntiles.
+ * @param[out] ntiles   The number of tiles with counters
+ * @param[in]  delta    If nonzero, get the change since the last call with #delta set
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_counters(hb_mc_manycore_t *mc, hb_mc_tile_counters_t *counters,
+                                size_t n, size_t *ntiles, int delta){
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Get the PC histogram of every tile since reset
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] samples  An array of at least #n samples
+ * @param[in]  n        The number of samples to get. Set to 0 to get only #nsamples.
+ * @param[out] nsamples The number of nonzero (tile, PC) samples
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_pc_histogram(hb_mc_manycore_t *mc, hb_mc_pc_sample_t *samples,
+                                    size_t n, size_t *nsamples){
+        return HB_MC_NOIMPL;
+}
+
 /**
  * Enable trace file generation (vanilla_operation_trace.csv)
  * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()